@@ -0,0 +1,95 @@
+/**
+ * @file bench_accumulate.cpp
+ *
+ * @brief Benchmarks for the accumulation policies (core/accumulate.hpp).
+ *
+ * Each benchmark also reports `relative_error`, the error of one float dot
+ * product against a long double reference. Together with the timing, that
+ * shows what each policy costs and what it buys. The SIMD dot product of
+ * DynVector is included as a reference.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cmath>   // std::abs
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::DynVector;
+using svector::Kahan;
+using svector::MultiAccumulator;
+using svector::Naive;
+using svector::Neumaier;
+using svector::Pairwise;
+using svector::Reproducible;
+using svector::Widened;
+using svector::bench::doNotOptimize;
+using svector::bench::Random;
+using svector::bench::State;
+
+template <typename T>
+DynVector<T> randomDynVector(const std::size_t size, const std::uint32_t seed) {
+  Random random(seed);
+  DynVector<T> vec(size);
+  for (std::size_t i = 0; i < size; i++) {
+    vec[i] = random.next<T>();
+  }
+
+  return vec;
+}
+
+template <typename T>
+double relativeError(const T result, const DynVector<T> &lhs,
+                     const DynVector<T> &rhs) {
+  long double reference = 0;
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    reference += static_cast<long double>(lhs[i]) * rhs[i];
+  }
+
+  return static_cast<double>(std::abs((result - reference) / reference));
+}
+
+template <std::size_t Size, typename Policy> void accumulateDot(State &state) {
+  const DynVector<float> lhs = randomDynVector<float>(Size, 1);
+  const DynVector<float> rhs = randomDynVector<float>(Size, 2);
+  state.counters["relative_error"] =
+      relativeError(svector::dot(lhs, rhs, Policy()), lhs, rhs);
+
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs.data());
+    doNotOptimize(svector::dot(lhs, rhs, Policy()));
+  }
+}
+
+template <std::size_t Size> void accumulateSimdDot(State &state) {
+  const DynVector<float> lhs = randomDynVector<float>(Size, 1);
+  const DynVector<float> rhs = randomDynVector<float>(Size, 2);
+  state.counters["relative_error"] = relativeError(lhs.dot(rhs), lhs, rhs);
+
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs.data());
+    doNotOptimize(lhs.dot(rhs));
+  }
+}
+
+#define SVECTOR_BENCHMARK_ACCUMULATE(size)                                     \
+  SVECTOR_BENCHMARK_TEMPLATE(accumulateDot, size, Naive);                      \
+  SVECTOR_BENCHMARK_TEMPLATE(accumulateDot, size, MultiAccumulator<4>);        \
+  SVECTOR_BENCHMARK_TEMPLATE(accumulateDot, size, MultiAccumulator<8>);        \
+  SVECTOR_BENCHMARK_TEMPLATE(accumulateDot, size, Pairwise);                   \
+  SVECTOR_BENCHMARK_TEMPLATE(accumulateDot, size, Widened);                    \
+  SVECTOR_BENCHMARK_TEMPLATE(accumulateDot, size, Kahan);                      \
+  SVECTOR_BENCHMARK_TEMPLATE(accumulateDot, size, Neumaier);                   \
+  SVECTOR_BENCHMARK_TEMPLATE(accumulateDot, size, Reproducible);               \
+  SVECTOR_BENCHMARK_TEMPLATE(accumulateSimdDot, size)
+
+SVECTOR_BENCHMARK_ACCUMULATE(1024);
+SVECTOR_BENCHMARK_ACCUMULATE(65536);
+} // namespace
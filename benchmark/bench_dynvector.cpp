@@ -0,0 +1,86 @@
+/**
+ * @file bench_dynvector.cpp
+ *
+ * @brief Benchmarks for svector::DynVector (core/dynvector.hpp).
+ *
+ * The sizes are typical embedding sizes. The fixed-size dot product of the
+ * same size is included as a reference for the SIMD kernels.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::DynVector;
+using svector::Vector;
+using svector::bench::doNotOptimize;
+using svector::bench::randomVector;
+using svector::bench::State;
+
+template <std::size_t D, typename T> DynVector<T> randomDynVector(int seed) {
+  return DynVector<T>(randomVector<D, T>(seed));
+}
+
+template <std::size_t D, typename T> void dynVectorDot(State &state) {
+  const DynVector<T> lhs = randomDynVector<D, T>(1);
+  const DynVector<T> rhs = randomDynVector<D, T>(2);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs.data());
+    doNotOptimize(lhs.dot(rhs));
+  }
+}
+
+template <std::size_t D, typename T> void fixedVectorDot(State &state) {
+  const Vector<D, T> lhs = randomVector<D, T>(1);
+  const Vector<D, T> rhs = randomVector<D, T>(2);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    doNotOptimize(lhs.dot(rhs));
+  }
+}
+
+template <std::size_t D, typename T> void dynVectorAddInPlace(State &state) {
+  DynVector<T> lhs = randomDynVector<D, T>(1);
+  const DynVector<T> rhs = randomDynVector<D, T>(2);
+  while (state.keepRunning()) {
+    lhs += rhs;
+    doNotOptimize(lhs.data());
+  }
+}
+
+template <std::size_t D, typename T> void dynVectorNormalize(State &state) {
+  const DynVector<T> vec = randomDynVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec.data());
+    const DynVector<T> normalized = vec.normalize();
+    doNotOptimize(normalized.data());
+  }
+}
+
+template <std::size_t D, typename T> void dynVectorToVector(State &state) {
+  const DynVector<T> vec = randomDynVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec.data());
+    Vector<D, T> fixed = vec.template toVector<D>();
+    doNotOptimize(fixed);
+  }
+}
+
+#define SVECTOR_BENCHMARK_DYN(fn)                                              \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 16, float);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 128, float);                                  \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 384, float);                                  \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 768, float);                                  \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 768, double)
+
+SVECTOR_BENCHMARK_DYN(dynVectorDot);
+SVECTOR_BENCHMARK_DYN(fixedVectorDot);
+SVECTOR_BENCHMARK_DYN(dynVectorAddInPlace);
+SVECTOR_BENCHMARK_DYN(dynVectorNormalize);
+SVECTOR_BENCHMARK_DYN(dynVectorToVector);
+} // namespace
@@ -0,0 +1,38 @@
+/**
+ * @file bench_embed.cpp
+ *
+ * @brief Benchmarks for the vectors in embed.hpp.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <string> // std::string
+
+#include "simplevectors/embed.hpp"
+
+#include "embed_common.hpp"
+
+namespace {
+using svector::Vec2D;
+using svector::Vec3D;
+
+template <> Vec2D embedLhs<Vec2D>() { return Vec2D{3, 4}; }
+template <> Vec2D embedRhs<Vec2D>() { return Vec2D{-1, 2}; }
+template <> Vec3D embedLhs<Vec3D>() { return Vec3D{3, 4, 5}; }
+template <> Vec3D embedRhs<Vec3D>() { return Vec3D{-1, 2, 7}; }
+
+template <typename V> void embedToString(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    std::string str = svector::toString(vec);
+    doNotOptimize(str);
+  }
+}
+
+SVECTOR_BENCHMARK_EMBED_2D(Vec2D);
+SVECTOR_BENCHMARK_EMBED_3D(Vec3D);
+SVECTOR_BENCHMARK_TEMPLATE(embedToString, Vec2D);
+SVECTOR_BENCHMARK_TEMPLATE(embedToString, Vec3D);
+} // namespace
@@ -0,0 +1,103 @@
+/**
+ * @file bench_embed_no_stl.cpp
+ *
+ * @brief Benchmarks for the vectors in embed.h.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include "simplevectors/embed.h"
+
+#include "embed_common.hpp"
+
+namespace {
+using svector::EmbVec2D;
+using svector::EmbVec3D;
+
+template <> EmbVec2D embedLhs<EmbVec2D>() { return EmbVec2D{3, 4}; }
+template <> EmbVec2D embedRhs<EmbVec2D>() { return EmbVec2D{-1, 2}; }
+template <> EmbVec3D embedLhs<EmbVec3D>() { return EmbVec3D{3, 4, 5}; }
+template <> EmbVec3D embedRhs<EmbVec3D>() { return EmbVec3D{-1, 2, 7}; }
+
+void embedCordicRotate(State &state) {
+  EmbVec2D vec = embedLhs<EmbVec2D>();
+  float ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    EmbVec2D result = svector::cordicRotate(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+void embedCordicPolar(State &state) {
+  EmbVec2D vec = embedLhs<EmbVec2D>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    svector::EmbPolar2D result = svector::cordicPolar(vec);
+    doNotOptimize(result);
+  }
+}
+
+template <unsigned int Iterations> void embedCordicAngle(State &state) {
+  EmbVec2D vec = embedLhs<EmbVec2D>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(svector::cordicAngle(vec, Iterations));
+  }
+}
+
+void embedCordicMagn(State &state) {
+  EmbVec2D vec = embedLhs<EmbVec2D>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(svector::cordicMagn(vec));
+  }
+}
+
+void embedCordicRotateAlpha(State &state) {
+  EmbVec3D vec = embedLhs<EmbVec3D>();
+  float ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    EmbVec3D result = svector::cordicRotateAlpha(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+void embedCordicRotateBeta(State &state) {
+  EmbVec3D vec = embedLhs<EmbVec3D>();
+  float ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    EmbVec3D result = svector::cordicRotateBeta(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+void embedCordicRotateGamma(State &state) {
+  EmbVec3D vec = embedLhs<EmbVec3D>();
+  float ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    EmbVec3D result = svector::cordicRotateGamma(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+SVECTOR_BENCHMARK_EMBED_2D(EmbVec2D);
+SVECTOR_BENCHMARK_EMBED_3D(EmbVec3D);
+SVECTOR_BENCHMARK(embedCordicRotate);
+SVECTOR_BENCHMARK(embedCordicPolar);
+SVECTOR_BENCHMARK_TEMPLATE(embedCordicAngle, 8);
+SVECTOR_BENCHMARK_TEMPLATE(embedCordicAngle, 16);
+SVECTOR_BENCHMARK_TEMPLATE(embedCordicAngle, 24);
+SVECTOR_BENCHMARK(embedCordicMagn);
+SVECTOR_BENCHMARK(embedCordicRotateAlpha);
+SVECTOR_BENCHMARK(embedCordicRotateBeta);
+SVECTOR_BENCHMARK(embedCordicRotateGamma);
+} // namespace
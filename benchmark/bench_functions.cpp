@@ -0,0 +1,346 @@
+/**
+ * @file bench_functions.cpp
+ *
+ * @brief Benchmarks for the free functions and operators in functions.hpp.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <array>   // std::array
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcpy
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Vector;
+using svector::Vector2D;
+using svector::Vector3D;
+using svector::bench::doNotOptimize;
+using svector::bench::randomVector;
+using svector::bench::State;
+
+template <std::size_t D, typename T> void makeVectorArray(State &state) {
+  std::array<T, D> array;
+  array.fill(1);
+  while (state.keepRunning()) {
+    doNotOptimize(array);
+    Vector<D, T> vec = svector::makeVector(array);
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T> void makeVectorStdVector(State &state) {
+  std::vector<T> vector(D, 1);
+  while (state.keepRunning()) {
+    doNotOptimize(vector);
+    Vector<D, T> vec = svector::makeVector<D>(vector);
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T> void makeVectorPointer(State &state) {
+  std::vector<T> buffer(D, 1);
+  const T *data = buffer.data();
+  while (state.keepRunning()) {
+    doNotOptimize(data);
+    Vector<D, T> vec = svector::makeVector<D>(data, D);
+    doNotOptimize(vec);
+  }
+}
+
+// number of vectors converted per iteration by the flat array benchmarks
+const std::size_t FLAT_COUNT = 1024;
+
+template <std::size_t D, typename T> void fromFlatArray(State &state) {
+  std::vector<T> flat(FLAT_COUNT * D, 1);
+  std::vector<Vector<D, T>> vecs(FLAT_COUNT);
+  state.setItemsPerIteration(FLAT_COUNT);
+  while (state.keepRunning()) {
+    doNotOptimize(flat.data());
+    svector::fromFlatArray(flat.data(), FLAT_COUNT, vecs.data());
+    doNotOptimize(vecs.data());
+  }
+}
+
+template <std::size_t D, typename T> void toFlatArray(State &state) {
+  std::vector<Vector<D, T>> vecs(FLAT_COUNT, randomVector<D, T>(1));
+  std::vector<T> flat(FLAT_COUNT * D);
+  state.setItemsPerIteration(FLAT_COUNT);
+  while (state.keepRunning()) {
+    doNotOptimize(vecs.data());
+    svector::toFlatArray(vecs.data(), FLAT_COUNT, flat.data());
+    doNotOptimize(flat.data());
+  }
+}
+
+// lower bound for the flat array conversions: copying the same number of
+// components between two flat buffers
+template <std::size_t D, typename T> void flatMemcpy(State &state) {
+  std::vector<T> src(FLAT_COUNT * D, 1);
+  std::vector<T> dst(FLAT_COUNT * D);
+  state.setItemsPerIteration(FLAT_COUNT);
+  while (state.keepRunning()) {
+    doNotOptimize(src.data());
+    std::memcpy(dst.data(), src.data(), FLAT_COUNT * D * sizeof(T));
+    doNotOptimize(dst.data());
+  }
+}
+
+template <std::size_t D, typename T>
+void makeVectorInitializerList(State &state) {
+  T a = 1;
+  T b = 2;
+  T c = 3;
+  while (state.keepRunning()) {
+    doNotOptimize(a);
+    Vector<D, T> vec = svector::makeVector<D, T>({a, b, c});
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T> void dot(State &state) {
+  Vector<D, T> lhs = randomVector<D, T>(1);
+  Vector<D, T> rhs = randomVector<D, T>(2);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    doNotOptimize(svector::dot(lhs, rhs));
+  }
+}
+
+// same as dot, on views of a flat buffer instead of vectors
+template <std::size_t D, typename T> void dotView(State &state) {
+  std::vector<T> buffer(2 * D, 1);
+  const svector::VectorView<D, const T> lhs(buffer.data());
+  const svector::VectorView<D, const T> rhs(buffer.data() + D);
+  while (state.keepRunning()) {
+    doNotOptimize(buffer.data());
+    doNotOptimize(svector::dot(lhs, rhs));
+  }
+}
+
+template <std::size_t D, typename T> void magn(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(svector::magn(vec));
+  }
+}
+
+template <std::size_t D, typename T> void normalize(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    Vector<D, T> result = svector::normalize(vec);
+    doNotOptimize(result);
+  }
+}
+
+template <std::size_t D, typename T> void isZero(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(svector::isZero(vec));
+  }
+}
+
+template <std::size_t D, typename T> void add(State &state) {
+  Vector<D, T> lhs = randomVector<D, T>(1);
+  Vector<D, T> rhs = randomVector<D, T>(2);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    Vector<D, T> result = lhs + rhs;
+    doNotOptimize(result);
+  }
+}
+
+template <std::size_t D, typename T> void subtract(State &state) {
+  Vector<D, T> lhs = randomVector<D, T>(1);
+  Vector<D, T> rhs = randomVector<D, T>(2);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    Vector<D, T> result = lhs - rhs;
+    doNotOptimize(result);
+  }
+}
+
+template <std::size_t D, typename T> void multiply(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  T scalar = 3;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(scalar);
+    Vector<D, T> result = vec * scalar;
+    doNotOptimize(result);
+  }
+}
+
+template <std::size_t D, typename T> void divide(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  T scalar = 3;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(scalar);
+    Vector<D, T> result = vec / scalar;
+    doNotOptimize(result);
+  }
+}
+
+template <std::size_t D, typename T> void equal(State &state) {
+  Vector<D, T> lhs = randomVector<D, T>(1);
+  Vector<D, T> rhs = lhs;
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    doNotOptimize(lhs == rhs);
+  }
+}
+
+template <std::size_t D, typename T> void notEqual(State &state) {
+  Vector<D, T> lhs = randomVector<D, T>(1);
+  Vector<D, T> rhs = lhs;
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    doNotOptimize(lhs != rhs);
+  }
+}
+
+void components2D(State &state) {
+  Vector2D vec(3, 4);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    svector::x(vec, svector::y(vec));
+    svector::y(vec, svector::x(vec));
+    doNotOptimize(vec);
+  }
+}
+
+void components3D(State &state) {
+  Vector3D vec(3, 4, 5);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    svector::x(vec, svector::z(vec));
+    svector::y(vec, svector::x(vec));
+    svector::z(vec, svector::y(vec));
+    doNotOptimize(vec);
+  }
+}
+
+void angle(State &state) {
+  Vector2D vec(3, 4);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(svector::angle(vec));
+  }
+}
+
+void rotate(State &state) {
+  Vector2D vec(3, 4);
+  double ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    Vector2D result = svector::rotate(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+void cross(State &state) {
+  Vector3D lhs(3, 4, 5);
+  Vector3D rhs(-1, 2, 7);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    Vector3D result = svector::cross(lhs, rhs);
+    doNotOptimize(result);
+  }
+}
+
+void alpha(State &state) {
+  Vector3D vec(3, 4, 5);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(svector::alpha(vec));
+  }
+}
+
+void beta(State &state) {
+  Vector3D vec(3, 4, 5);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(svector::beta(vec));
+  }
+}
+
+void gamma(State &state) {
+  Vector3D vec(3, 4, 5);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(svector::gamma(vec));
+  }
+}
+
+void rotateAlpha(State &state) {
+  Vector3D vec(3, 4, 5);
+  double ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    Vector3D result = svector::rotateAlpha(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+void rotateBeta(State &state) {
+  Vector3D vec(3, 4, 5);
+  double ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    Vector3D result = svector::rotateBeta(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+void rotateGamma(State &state) {
+  Vector3D vec(3, 4, 5);
+  double ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    Vector3D result = svector::rotateGamma(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+SVECTOR_BENCHMARK_DT(makeVectorArray);
+SVECTOR_BENCHMARK_DT(makeVectorStdVector);
+SVECTOR_BENCHMARK_DT(makeVectorPointer);
+SVECTOR_BENCHMARK_DT(makeVectorInitializerList);
+SVECTOR_BENCHMARK_DT(fromFlatArray);
+SVECTOR_BENCHMARK_DT(toFlatArray);
+SVECTOR_BENCHMARK_DT(flatMemcpy);
+SVECTOR_BENCHMARK_DT(dot);
+SVECTOR_BENCHMARK_DT(dotView);
+SVECTOR_BENCHMARK_DT(magn);
+SVECTOR_BENCHMARK_DT(normalize);
+SVECTOR_BENCHMARK_DT(isZero);
+SVECTOR_BENCHMARK_DT(add);
+SVECTOR_BENCHMARK_DT(subtract);
+SVECTOR_BENCHMARK_DT(multiply);
+SVECTOR_BENCHMARK_DT(divide);
+SVECTOR_BENCHMARK_DT(equal);
+SVECTOR_BENCHMARK_DT(notEqual);
+SVECTOR_BENCHMARK(components2D);
+SVECTOR_BENCHMARK(components3D);
+SVECTOR_BENCHMARK(angle);
+SVECTOR_BENCHMARK(rotate);
+SVECTOR_BENCHMARK(cross);
+SVECTOR_BENCHMARK(alpha);
+SVECTOR_BENCHMARK(beta);
+SVECTOR_BENCHMARK(gamma);
+SVECTOR_BENCHMARK(rotateAlpha);
+SVECTOR_BENCHMARK(rotateBeta);
+SVECTOR_BENCHMARK(rotateGamma);
+} // namespace
@@ -0,0 +1,90 @@
+/**
+ * @file bench_half.cpp
+ *
+ * @brief Benchmarks for the 16-bit storage types (core/half.hpp).
+ *
+ * The dot products use a typical embedding size, with the float SIMD dot
+ * product of the same size as a reference. Build with -mf16c (or
+ * -march=native) to measure the F16C conversions instead of the software
+ * ones.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::BFloat16;
+using svector::Half;
+using svector::bench::doNotOptimize;
+using svector::bench::Random;
+using svector::bench::State;
+
+template <typename S>
+std::vector<S> randomArray(const std::size_t size, const std::uint32_t seed) {
+  Random random(seed);
+  std::vector<S> array(size);
+  for (std::size_t i = 0; i < size; i++) {
+    array[i] = static_cast<S>(random.next<float>());
+  }
+
+  return array;
+}
+
+template <std::size_t Size, typename S> void halfToFloat(State &state) {
+  const std::vector<S> in = randomArray<S>(Size, 1);
+  std::vector<float> out(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    svector::half::toFloat(in.data(), out.data(), Size);
+    doNotOptimize(out.data());
+  }
+}
+
+template <std::size_t Size, typename S> void halfFromFloat(State &state) {
+  const std::vector<float> in = randomArray<float>(Size, 1);
+  std::vector<S> out(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    svector::half::fromFloat(in.data(), out.data(), Size);
+    doNotOptimize(out.data());
+  }
+}
+
+template <std::size_t Size, typename S, typename R>
+void halfDot(State &state) {
+  const std::vector<S> lhs = randomArray<S>(Size, 1);
+  const std::vector<R> rhs = randomArray<R>(Size, 2);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs.data());
+    doNotOptimize(svector::half::dot(lhs.data(), rhs.data(), Size));
+  }
+}
+
+template <std::size_t Size> void floatDot(State &state) {
+  const std::vector<float> lhs = randomArray<float>(Size, 1);
+  const std::vector<float> rhs = randomArray<float>(Size, 2);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs.data());
+    doNotOptimize(svector::simd::dot(lhs.data(), rhs.data(), Size));
+  }
+}
+
+SVECTOR_BENCHMARK_TEMPLATE(halfToFloat, 4096, Half);
+SVECTOR_BENCHMARK_TEMPLATE(halfToFloat, 4096, BFloat16);
+SVECTOR_BENCHMARK_TEMPLATE(halfFromFloat, 4096, Half);
+SVECTOR_BENCHMARK_TEMPLATE(halfFromFloat, 4096, BFloat16);
+SVECTOR_BENCHMARK_TEMPLATE(halfDot, 768, Half, Half);
+SVECTOR_BENCHMARK_TEMPLATE(halfDot, 768, Half, float);
+SVECTOR_BENCHMARK_TEMPLATE(halfDot, 768, BFloat16, BFloat16);
+SVECTOR_BENCHMARK_TEMPLATE(halfDot, 768, BFloat16, float);
+SVECTOR_BENCHMARK_TEMPLATE(floatDot, 768);
+} // namespace
@@ -0,0 +1,158 @@
+/**
+ * @file bench_matrix.cpp
+ *
+ * @brief Benchmarks for the matrices and affine transforms
+ * (core/matrix.hpp).
+ *
+ * Rotating and translating a point cloud with three chained
+ * Vector3D::rotate() calls, which compute a sine and a cosine for every
+ * point, is compared with one composed Affine3D applied point by point, with
+ * transform() over the whole array, and with transformComponents() over the
+ * same points stored as one array for each component.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Affine3D;
+using svector::Matrix4D;
+using svector::Vector3D;
+using svector::bench::doNotOptimize;
+using svector::bench::Random;
+using svector::bench::State;
+
+const std::size_t POINTS = 4096;
+
+std::vector<Vector3D> randomPoints() {
+  Random random(1);
+  std::vector<Vector3D> points(POINTS);
+  for (std::size_t i = 0; i < POINTS; i++) {
+    points[i] = random.vector<Vector3D, double>();
+  }
+
+  return points;
+}
+
+Affine3D composed(const double a, const double b, const double c,
+                  const Vector3D &offset) {
+  return svector::translationMatrix(offset) *
+         svector::affineMatrix(svector::rotationMatrix<svector::GAMMA>(c) *
+                               svector::rotationMatrix<svector::BETA>(b) *
+                               svector::rotationMatrix<svector::ALPHA>(a));
+}
+
+void matrixChainedRotate(State &state) {
+  const std::vector<Vector3D> points = randomPoints();
+  std::vector<Vector3D> out(POINTS);
+  const Vector3D offset{1, 2, 3};
+  double a = 0.1;
+  state.setItemsPerIteration(POINTS);
+  while (state.keepRunning()) {
+    doNotOptimize(a);
+    for (std::size_t i = 0; i < POINTS; i++) {
+      out[i] = points[i]
+                   .rotate<svector::ALPHA>(a)
+                   .rotate<svector::BETA>(0.2)
+                   .rotate<svector::GAMMA>(0.3) +
+               offset;
+    }
+    doNotOptimize(out[0]);
+  }
+}
+
+void matrixComposedApply(State &state) {
+  const std::vector<Vector3D> points = randomPoints();
+  std::vector<Vector3D> out(POINTS);
+  const Vector3D offset{1, 2, 3};
+  double a = 0.1;
+  state.setItemsPerIteration(POINTS);
+  while (state.keepRunning()) {
+    doNotOptimize(a);
+    const Affine3D m = composed(a, 0.2, 0.3, offset);
+    for (std::size_t i = 0; i < POINTS; i++) {
+      out[i] = m * points[i];
+    }
+    doNotOptimize(out[0]);
+  }
+}
+
+void matrixTransform(State &state) {
+  const std::vector<Vector3D> points = randomPoints();
+  std::vector<Vector3D> out(POINTS);
+  const Vector3D offset{1, 2, 3};
+  double a = 0.1;
+  state.setItemsPerIteration(POINTS);
+  while (state.keepRunning()) {
+    doNotOptimize(a);
+    svector::transform(composed(a, 0.2, 0.3, offset), points.data(), POINTS,
+                       out.data());
+    doNotOptimize(out[0]);
+  }
+}
+
+void matrixTransformComponents(State &state) {
+  const std::vector<Vector3D> points = randomPoints();
+  std::vector<double> components[3];
+  std::vector<double> outComponents[3];
+  for (std::size_t c = 0; c < 3; c++) {
+    outComponents[c].resize(POINTS);
+    for (std::size_t i = 0; i < POINTS; i++) {
+      components[c].push_back(points[i][c]);
+    }
+  }
+  const double *in[] = {components[0].data(), components[1].data(),
+                        components[2].data()};
+  double *out[] = {outComponents[0].data(), outComponents[1].data(),
+                   outComponents[2].data()};
+  const Vector3D offset{1, 2, 3};
+  double a = 0.1;
+  state.setItemsPerIteration(POINTS);
+  while (state.keepRunning()) {
+    doNotOptimize(a);
+    svector::transformComponents(composed(a, 0.2, 0.3, offset), in, out,
+                                 POINTS);
+    doNotOptimize(out[0][0]);
+  }
+}
+
+void matrixMultiply4D(State &state) {
+  Random random(2);
+  Matrix4D lhs;
+  Matrix4D rhs;
+  for (std::size_t i = 0; i < 4; i++) {
+    for (std::size_t j = 0; j < 4; j++) {
+      lhs(i, j) = random.next<double>();
+      rhs(i, j) = random.next<double>();
+    }
+  }
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    doNotOptimize(lhs * rhs);
+  }
+}
+
+void matrixInverse4D(State &state) {
+  Matrix4D m = Matrix4D::identity();
+  m(0, 1) = 2;
+  m(2, 3) = -1;
+  m(3, 0) = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(m);
+    doNotOptimize(svector::inverse(m));
+  }
+}
+
+SVECTOR_BENCHMARK(matrixChainedRotate);
+SVECTOR_BENCHMARK(matrixComposedApply);
+SVECTOR_BENCHMARK(matrixTransform);
+SVECTOR_BENCHMARK(matrixTransformComponents);
+SVECTOR_BENCHMARK(matrixMultiply4D);
+SVECTOR_BENCHMARK(matrixInverse4D);
+} // namespace
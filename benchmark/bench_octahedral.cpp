@@ -0,0 +1,102 @@
+/**
+ * @file bench_octahedral.cpp
+ *
+ * @brief Benchmarks for the octahedral direction encoding
+ * (core/octahedral.hpp).
+ *
+ * The batch functions are compared with encoding and decoding one
+ * direction at a time.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Octahedral;
+using svector::bench::doNotOptimize;
+using svector::bench::Random;
+using svector::bench::State;
+
+std::vector<svector::Vector<3, double>>
+randomDirections(const std::size_t size) {
+  // components in [-4.5, 4.5), so every octant is covered
+  Random random(1);
+  std::vector<svector::Vector<3, double>> directions(size);
+  for (std::size_t i = 0; i < size; i++) {
+    for (std::size_t j = 0; j < 3; j++) {
+      directions[i][j] = random.next<double>() - 5.5;
+    }
+  }
+
+  return directions;
+}
+
+template <std::size_t Size, std::size_t Bits>
+void octahedralEncode(State &state) {
+  const std::vector<svector::Vector<3, double>> in = randomDirections(Size);
+  std::vector<Octahedral<Bits>> out(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    svector::octahedral::encode(in.data(), out.data(), Size);
+    doNotOptimize(out.data());
+  }
+}
+
+template <std::size_t Size, std::size_t Bits>
+void octahedralEncodeEach(State &state) {
+  const std::vector<svector::Vector<3, double>> in = randomDirections(Size);
+  std::vector<Octahedral<Bits>> out(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    for (std::size_t i = 0; i < Size; i++) {
+      out[i] = Octahedral<Bits>(in[i]);
+    }
+    doNotOptimize(out.data());
+  }
+}
+
+template <std::size_t Size, std::size_t Bits>
+void octahedralDecode(State &state) {
+  std::vector<Octahedral<Bits>> in(Size);
+  const std::vector<svector::Vector<3, double>> directions =
+      randomDirections(Size);
+  svector::octahedral::encode(directions.data(), in.data(), Size);
+  std::vector<svector::Vector<3, double>> out(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    svector::octahedral::decode(in.data(), out.data(), Size);
+    doNotOptimize(out.data());
+  }
+}
+
+template <std::size_t Size, std::size_t Bits>
+void octahedralDecodeEach(State &state) {
+  std::vector<Octahedral<Bits>> in(Size);
+  const std::vector<svector::Vector<3, double>> directions =
+      randomDirections(Size);
+  svector::octahedral::encode(directions.data(), in.data(), Size);
+  std::vector<svector::Vector<3, double>> out(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    for (std::size_t i = 0; i < Size; i++) {
+      out[i] = in[i].toVector();
+    }
+    doNotOptimize(out.data());
+  }
+}
+
+SVECTOR_BENCHMARK_TEMPLATE(octahedralEncode, 4096, 16);
+SVECTOR_BENCHMARK_TEMPLATE(octahedralEncode, 4096, 24);
+SVECTOR_BENCHMARK_TEMPLATE(octahedralEncode, 4096, 32);
+SVECTOR_BENCHMARK_TEMPLATE(octahedralEncodeEach, 4096, 32);
+SVECTOR_BENCHMARK_TEMPLATE(octahedralDecode, 4096, 16);
+SVECTOR_BENCHMARK_TEMPLATE(octahedralDecode, 4096, 24);
+SVECTOR_BENCHMARK_TEMPLATE(octahedralDecode, 4096, 32);
+SVECTOR_BENCHMARK_TEMPLATE(octahedralDecodeEach, 4096, 32);
+} // namespace
@@ -0,0 +1,93 @@
+/**
+ * @file bench_pipeline.cpp
+ *
+ * @brief Benchmarks for lazy pipelines (core/pipeline.hpp).
+ *
+ * Rotates, scales, filters by magnitude, and normalizes an array of 3D
+ * vectors, once with a std::vector after each step and once with a
+ * pipeline. Both make the result array in every iteration.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Vector3D;
+using svector::bench::doNotOptimize;
+using svector::bench::Random;
+using svector::bench::State;
+
+std::vector<Vector3D> randomVectors(const std::size_t size) {
+  Random random(1);
+  std::vector<Vector3D> vectors(size);
+  for (std::size_t i = 0; i < size; i++) {
+    vectors[i] = Vector3D(random.next<double>(), random.next<double>(),
+                          random.next<double>());
+  }
+
+  return vectors;
+}
+
+Vector3D rotateStep(const Vector3D &v) { return svector::rotateGamma(v, 0.3); }
+
+Vector3D scaleStep(const Vector3D &v) { return v * 0.5; }
+
+// keeps about half of the vectors
+bool magnitudeStep(const Vector3D &v) { return svector::magn(v) > 5.0; }
+
+Vector3D normalizeStep(const Vector3D &v) { return svector::normalize(v); }
+
+template <std::size_t Size> void pipelineMaterialized(State &state) {
+  const std::vector<Vector3D> in = randomVectors(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    std::vector<Vector3D> rotated(Size);
+    for (std::size_t i = 0; i < Size; i++) {
+      rotated[i] = rotateStep(in[i]);
+    }
+    std::vector<Vector3D> scaled(Size);
+    for (std::size_t i = 0; i < Size; i++) {
+      scaled[i] = scaleStep(rotated[i]);
+    }
+    std::vector<Vector3D> filtered;
+    filtered.reserve(Size);
+    for (std::size_t i = 0; i < Size; i++) {
+      if (magnitudeStep(scaled[i])) {
+        filtered.push_back(scaled[i]);
+      }
+    }
+    std::vector<Vector3D> normalized(filtered.size());
+    for (std::size_t i = 0; i < filtered.size(); i++) {
+      normalized[i] = normalizeStep(filtered[i]);
+    }
+    doNotOptimize(normalized.data());
+  }
+}
+
+template <std::size_t Size, std::size_t Threads>
+void pipelineFused(State &state) {
+  const std::vector<Vector3D> in = randomVectors(Size);
+  const svector::Pipeline<Vector3D> pipeline =
+      svector::Pipeline<Vector3D>()
+          .map(rotateStep)
+          .map(scaleStep)
+          .filter(magnitudeStep)
+          .map(normalizeStep);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    const std::vector<Vector3D> out =
+        pipeline.collect(in.data(), Size, Threads);
+    doNotOptimize(out.data());
+  }
+}
+
+SVECTOR_BENCHMARK_TEMPLATE(pipelineMaterialized, 1 << 20);
+SVECTOR_BENCHMARK_TEMPLATE(pipelineFused, 1 << 20, 1);
+SVECTOR_BENCHMARK_TEMPLATE(pipelineFused, 1 << 20, 4);
+} // namespace
@@ -0,0 +1,79 @@
+/**
+ * @file bench_quantize.cpp
+ *
+ * @brief Benchmarks for the quantized vector array (core/quantize.hpp).
+ *
+ * Encoding allocates the codes, so only decoding is checked for
+ * allocations. The decoded error is reported as max_error.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint16_t
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::bench::doNotOptimize;
+using svector::bench::Random;
+using svector::bench::State;
+
+template <typename T>
+std::vector<svector::Vector<3, T>> randomPositions(const std::size_t size) {
+  Random random(1);
+  std::vector<svector::Vector<3, T>> positions(size);
+  for (std::size_t i = 0; i < size; i++) {
+    for (std::size_t j = 0; j < 3; j++) {
+      positions[i][j] = random.next<T>() * 100;
+    }
+  }
+
+  return positions;
+}
+
+template <std::size_t Size, typename T> void quantizeEncode(State &state) {
+  const std::vector<svector::Vector<3, T>> in = randomPositions<T>(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    const svector::QuantizedArray<3, T> array(in.data(), Size);
+    doNotOptimize(array.maxError());
+  }
+}
+
+template <std::size_t Size, typename T> void quantizeDecode(State &state) {
+  const std::vector<svector::Vector<3, T>> in = randomPositions<T>(Size);
+  const svector::QuantizedArray<3, T> array(in.data(), Size);
+  std::vector<svector::Vector<3, T>> out(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    array.decode(out.data());
+    doNotOptimize(out.data());
+  }
+
+  state.counters["max_error"] = static_cast<double>(array.maxError());
+}
+
+template <std::size_t Size, typename T>
+void quantizeDecodeBlock(State &state) {
+  const std::vector<svector::Vector<3, T>> in = randomPositions<T>(Size);
+  const svector::QuantizedArray<3, T> array(in.data(), Size);
+  std::vector<svector::Vector<3, T>> out(array.blockSize());
+  std::size_t block = 0;
+  state.setItemsPerIteration(array.blockSize());
+  while (state.keepRunning()) {
+    array.decodeBlock(block, out.data());
+    doNotOptimize(out.data());
+    block = (block + 7) % array.numBlocks();
+  }
+}
+
+SVECTOR_BENCHMARK_TEMPLATE(quantizeEncode, 65536, float);
+SVECTOR_BENCHMARK_TEMPLATE(quantizeEncode, 65536, double);
+SVECTOR_BENCHMARK_TEMPLATE(quantizeDecode, 65536, float);
+SVECTOR_BENCHMARK_TEMPLATE(quantizeDecode, 65536, double);
+SVECTOR_BENCHMARK_TEMPLATE(quantizeDecodeBlock, 65536, float);
+} // namespace
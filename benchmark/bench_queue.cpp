@@ -0,0 +1,168 @@
+/**
+ * @file bench_queue.cpp
+ *
+ * @brief Benchmarks for the lock-free queues (core/queue.hpp).
+ *
+ * A producer thread hands 3D vectors to the benchmark thread through a
+ * queue, in batches of 1 or 64, and the lock-free queues are compared with
+ * a std::deque behind a std::mutex. The latency benchmarks also record how
+ * long each vector waits between being pushed and being popped, and report
+ * its percentiles in nanoseconds.
+ *
+ * Both sides yield when the queue is full or empty, so that the benchmarks
+ * also finish on a single core.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <algorithm> // std::copy, std::fill, std::min, std::sort
+#include <chrono>    // std::chrono::steady_clock
+#include <cstddef>   // std::size_t
+#include <deque>     // std::deque
+#include <mutex>     // std::mutex, std::lock_guard
+#include <thread>    // std::thread, std::this_thread::yield
+#include <vector>    // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Vector3D;
+using svector::bench::doNotOptimize;
+using svector::bench::State;
+
+typedef std::chrono::steady_clock Clock;
+
+const std::size_t ITEMS = 1 << 16;
+
+// the queue that the lock-free ones replace
+class MutexQueue {
+public:
+  std::size_t pushBatch(const Vector3D *data, const std::size_t count) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    const std::size_t pushed = std::min(count, 1024 - m_items.size());
+    m_items.insert(m_items.end(), data, data + pushed);
+    return pushed;
+  }
+
+  std::size_t popBatch(Vector3D *out, const std::size_t maxCount) {
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    const std::size_t popped = std::min(maxCount, m_items.size());
+    std::copy(m_items.begin(), m_items.begin() + popped, out);
+    m_items.erase(m_items.begin(), m_items.begin() + popped);
+    return popped;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::deque<Vector3D> m_items;
+};
+
+typedef svector::SpscQueue<Vector3D, 1024> Spsc;
+typedef svector::MpmcQueue<Vector3D, 1024> Mpmc;
+
+/**
+ * @brief Sends ITEMS vectors through a queue from another thread.
+ *
+ * @param sent If not null, the time each vector was pushed.
+ * @param received If not null, the time each vector was popped.
+ */
+template <typename Queue, std::size_t Batch>
+void transfer(Queue &queue, Clock::time_point *sent,
+              Clock::time_point *received) {
+  std::thread producer([&queue, sent]() {
+    Vector3D batch[Batch];
+    for (std::size_t i = 0; i < ITEMS; i += Batch) {
+      for (std::size_t j = 0; j < Batch; j++) {
+        batch[j] = Vector3D(static_cast<double>(i + j), 1, 2);
+      }
+
+      std::size_t pushed = 0;
+      while (pushed < Batch) {
+        const Clock::time_point now =
+            sent != nullptr ? Clock::now() : Clock::time_point();
+        const std::size_t count =
+            queue.pushBatch(batch + pushed, Batch - pushed);
+        if (sent != nullptr) {
+          std::fill(sent + i + pushed, sent + i + pushed + count, now);
+        }
+        pushed += count;
+        if (count == 0) {
+          std::this_thread::yield();
+        }
+      }
+    }
+  });
+
+  Vector3D batch[Batch];
+  std::size_t popped = 0;
+  while (popped < ITEMS) {
+    const std::size_t count = queue.popBatch(batch, Batch);
+    if (received != nullptr && count > 0) {
+      const Clock::time_point now = Clock::now();
+      for (std::size_t j = 0; j < count; j++) {
+        received[popped + j] = now;
+      }
+    }
+    doNotOptimize(batch[0]);
+    popped += count;
+    if (count == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+}
+
+template <typename Queue, std::size_t Batch>
+void queueThroughput(State &state) {
+  Queue queue;
+  state.setItemsPerIteration(ITEMS);
+  while (state.keepRunning()) {
+    transfer<Queue, Batch>(queue, nullptr, nullptr);
+  }
+}
+
+template <typename Queue, std::size_t Batch> void queueLatency(State &state) {
+  Queue queue;
+  std::vector<Clock::time_point> sent(ITEMS);
+  std::vector<Clock::time_point> received(ITEMS);
+  // the percentiles come from the first iterations only, so that the
+  // samples fit in memory however many iterations there are
+  std::vector<double> latencies;
+  const std::size_t maxSamples = ITEMS * 16;
+  state.setItemsPerIteration(ITEMS);
+  while (state.keepRunning()) {
+    transfer<Queue, Batch>(queue, sent.data(), received.data());
+
+    state.pauseTiming();
+    for (std::size_t i = 0; i < ITEMS && latencies.size() < maxSamples;
+         i++) {
+      latencies.push_back(
+          std::chrono::duration<double, std::nano>(received[i] - sent[i])
+              .count());
+    }
+    state.resumeTiming();
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  const double percentiles[] = {50, 99, 99.9};
+  const char *names[] = {"p50_ns", "p99_ns", "p999_ns"};
+  for (std::size_t i = 0; i < 3 && !latencies.empty(); i++) {
+    const std::size_t index = static_cast<std::size_t>(
+        percentiles[i] / 100 * static_cast<double>(latencies.size() - 1));
+    state.counters[names[i]] = latencies[index];
+  }
+}
+
+SVECTOR_BENCHMARK_TEMPLATE(queueThroughput, MutexQueue, 1);
+SVECTOR_BENCHMARK_TEMPLATE(queueThroughput, MutexQueue, 64);
+SVECTOR_BENCHMARK_TEMPLATE(queueThroughput, Spsc, 1);
+SVECTOR_BENCHMARK_TEMPLATE(queueThroughput, Spsc, 64);
+SVECTOR_BENCHMARK_TEMPLATE(queueThroughput, Mpmc, 1);
+SVECTOR_BENCHMARK_TEMPLATE(queueThroughput, Mpmc, 64);
+SVECTOR_BENCHMARK_TEMPLATE(queueLatency, MutexQueue, 1);
+SVECTOR_BENCHMARK_TEMPLATE(queueLatency, Spsc, 1);
+SVECTOR_BENCHMARK_TEMPLATE(queueLatency, Mpmc, 1);
+SVECTOR_BENCHMARK_TEMPLATE(queueLatency, Spsc, 64);
+} // namespace
@@ -0,0 +1,60 @@
+/**
+ * @file bench_reduce.cpp
+ *
+ * @brief Benchmarks for sums of vector arrays (core/reduce.hpp).
+ *
+ * Compares the fast sum, whose result depends on the number of threads,
+ * with the reproducible one, on 1 and 4 threads.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Vector;
+using svector::bench::doNotOptimize;
+using svector::bench::Random;
+using svector::bench::State;
+
+template <typename T>
+std::vector<Vector<3, T>> randomVectors(const std::size_t size) {
+  Random random(1);
+  std::vector<Vector<3, T>> vectors(size);
+  for (std::size_t i = 0; i < size; i++) {
+    vectors[i] = random.vector<Vector<3, T>, T>();
+  }
+
+  return vectors;
+}
+
+template <typename T, std::size_t Threads> void reduceSum(State &state) {
+  const std::vector<Vector<3, T>> data = randomVectors<T>(1 << 20);
+  state.setItemsPerIteration(data.size());
+  while (state.keepRunning()) {
+    doNotOptimize(svector::sum(data.data(), data.size(), Threads));
+  }
+}
+
+template <typename T, std::size_t Threads>
+void reduceSumReproducible(State &state) {
+  const std::vector<Vector<3, T>> data = randomVectors<T>(1 << 20);
+  state.setItemsPerIteration(data.size());
+  while (state.keepRunning()) {
+    doNotOptimize(svector::sum(data.data(), data.size(), Threads,
+                               svector::Reproducible()));
+  }
+}
+
+SVECTOR_BENCHMARK_TEMPLATE(reduceSum, float, 1);
+SVECTOR_BENCHMARK_TEMPLATE(reduceSumReproducible, float, 1);
+SVECTOR_BENCHMARK_TEMPLATE(reduceSum, double, 1);
+SVECTOR_BENCHMARK_TEMPLATE(reduceSumReproducible, double, 1);
+SVECTOR_BENCHMARK_TEMPLATE(reduceSum, double, 4);
+SVECTOR_BENCHMARK_TEMPLATE(reduceSumReproducible, double, 4);
+} // namespace
@@ -0,0 +1,110 @@
+/**
+ * @file bench_rotation.cpp
+ *
+ * @brief Benchmarks for the 2D rotations (core/rotation.hpp).
+ *
+ * Rotating an array of 2D vectors by the same angle with
+ * Vector2D::rotate(), which computes a cosine and a sine for every vector,
+ * is compared with a Rotation2D applied to the array and to the same
+ * vectors stored as component arrays. The angle is passed through
+ * doNotOptimize() for each vector, so that the compiler cannot compute the
+ * cosine and sine once itself. Stepping an angle is compared with
+ * computing the rotation for each step.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Rotation2D;
+using svector::Vector2D;
+using svector::bench::doNotOptimize;
+using svector::bench::Random;
+using svector::bench::State;
+
+const std::size_t POINTS = 4096;
+
+std::vector<Vector2D> randomPoints() {
+  Random random(1);
+  std::vector<Vector2D> points(POINTS);
+  for (std::size_t i = 0; i < POINTS; i++) {
+    points[i] = random.vector<Vector2D, double>();
+  }
+
+  return points;
+}
+
+void rotationVectorRotate(State &state) {
+  const std::vector<Vector2D> points = randomPoints();
+  std::vector<Vector2D> out(POINTS);
+  state.setItemsPerIteration(POINTS);
+  while (state.keepRunning()) {
+    for (std::size_t i = 0; i < POINTS; i++) {
+      double ang = 0.3;
+      doNotOptimize(ang);
+      out[i] = points[i].rotate(ang);
+    }
+    doNotOptimize(out[0]);
+  }
+}
+
+void rotationApply(State &state) {
+  const std::vector<Vector2D> points = randomPoints();
+  std::vector<Vector2D> out(POINTS);
+  state.setItemsPerIteration(POINTS);
+  while (state.keepRunning()) {
+    double ang = 0.3;
+    doNotOptimize(ang);
+    Rotation2D(ang).apply(points.data(), POINTS, out.data());
+    doNotOptimize(out[0]);
+  }
+}
+
+void rotationApplyComponents(State &state) {
+  const std::vector<Vector2D> points = randomPoints();
+  std::vector<double> xs(POINTS);
+  std::vector<double> ys(POINTS);
+  for (std::size_t i = 0; i < POINTS; i++) {
+    xs[i] = points[i].x();
+    ys[i] = points[i].y();
+  }
+  std::vector<double> outXs(POINTS);
+  std::vector<double> outYs(POINTS);
+  state.setItemsPerIteration(POINTS);
+  while (state.keepRunning()) {
+    double ang = 0.3;
+    doNotOptimize(ang);
+    Rotation2D(ang).applyComponents(xs.data(), ys.data(), outXs.data(),
+                                    outYs.data(), POINTS);
+    doNotOptimize(outXs[0]);
+  }
+}
+
+void rotationStepRecompute(State &state) {
+  std::size_t steps = 0;
+  while (state.keepRunning()) {
+    steps++;
+    doNotOptimize(Rotation2D(0.25 + static_cast<double>(steps) * 1e-3));
+  }
+}
+
+void rotationStepper(State &state) {
+  svector::RotationStepper2D stepper(0.25, 1e-3);
+  while (state.keepRunning()) {
+    stepper.advance();
+    doNotOptimize(stepper.current());
+  }
+}
+
+SVECTOR_BENCHMARK(rotationVectorRotate);
+SVECTOR_BENCHMARK(rotationApply);
+SVECTOR_BENCHMARK(rotationApplyComponents);
+SVECTOR_BENCHMARK(rotationStepRecompute);
+SVECTOR_BENCHMARK(rotationStepper);
+} // namespace
@@ -0,0 +1,132 @@
+/**
+ * @file bench_scatter.cpp
+ *
+ * @brief Benchmarks for scatter accumulators (core/scatter.hpp).
+ *
+ * Each iteration adds equal and opposite forces for a list of random pairs
+ * of particles, on several threads, into one array of 3D vectors: once
+ * with a lock for every 64 particles, and once with a ScatterAccumulator.
+ * With 4 pairs per particle, the buffers are dense; with 1 pair for every
+ * 64 particles, they stay sparse. The serial version is the baseline.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <mutex>   // std::mutex, std::lock_guard
+#include <thread>  // std::thread
+#include <utility> // std::pair
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Vector3D;
+using svector::bench::doNotOptimize;
+using svector::bench::State;
+
+const std::size_t PARTICLES = 1 << 16;
+
+typedef std::vector<std::pair<std::size_t, std::size_t>> Pairs;
+
+Pairs randomPairs(const std::size_t count) {
+  std::uint32_t state = 1;
+  Pairs pairs(count);
+  for (std::size_t k = 0; k < count; k++) {
+    state = state * 1664525U + 1013904223U;
+    pairs[k].first = (state >> 8) % PARTICLES;
+    state = state * 1664525U + 1013904223U;
+    pairs[k].second = (state >> 8) % PARTICLES;
+  }
+
+  return pairs;
+}
+
+Vector3D pairForce(const std::size_t k) {
+  return Vector3D(1, static_cast<double>(k % 7), -2);
+}
+
+// runs body(t, begin, end) on Threads threads, splitting count between them
+template <std::size_t Threads, typename F>
+void parallelFor(const std::size_t count, F body) {
+  std::vector<std::thread> pool;
+  for (std::size_t t = 1; t < Threads; t++) {
+    pool.emplace_back([&body, t, count]() {
+      body(t, count * t / Threads, count * (t + 1) / Threads);
+    });
+  }
+  body(0, 0, count / Threads);
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+}
+
+template <std::size_t PairsPer64> void scatterSerial(State &state) {
+  const Pairs pairs = randomPairs(PARTICLES / 64 * PairsPer64);
+  std::vector<Vector3D> forces(PARTICLES);
+  state.setItemsPerIteration(pairs.size());
+  while (state.keepRunning()) {
+    for (std::size_t k = 0; k < pairs.size(); k++) {
+      forces[pairs[k].first] += pairForce(k);
+      forces[pairs[k].second] -= pairForce(k);
+    }
+    doNotOptimize(forces.data());
+  }
+}
+
+template <std::size_t PairsPer64, std::size_t Threads>
+void scatterLocked(State &state) {
+  const Pairs pairs = randomPairs(PARTICLES / 64 * PairsPer64);
+  std::vector<Vector3D> forces(PARTICLES);
+  std::vector<std::mutex> locks(PARTICLES / 64);
+  state.setItemsPerIteration(pairs.size());
+  while (state.keepRunning()) {
+    parallelFor<Threads>(pairs.size(), [&](const std::size_t,
+                                           const std::size_t begin,
+                                           const std::size_t end) {
+      for (std::size_t k = begin; k < end; k++) {
+        {
+          const std::lock_guard<std::mutex> lock(
+              locks[pairs[k].first / 64]);
+          forces[pairs[k].first] += pairForce(k);
+        }
+        const std::lock_guard<std::mutex> lock(locks[pairs[k].second / 64]);
+        forces[pairs[k].second] -= pairForce(k);
+      }
+    });
+    doNotOptimize(forces.data());
+  }
+}
+
+template <std::size_t PairsPer64, std::size_t Threads>
+void scatterPrivate(State &state) {
+  const Pairs pairs = randomPairs(PARTICLES / 64 * PairsPer64);
+  std::vector<Vector3D> forces(PARTICLES);
+  svector::ScatterAccumulator<3, double> accumulator(PARTICLES, Threads);
+  state.setItemsPerIteration(pairs.size());
+  while (state.keepRunning()) {
+    parallelFor<Threads>(pairs.size(), [&](const std::size_t t,
+                                           const std::size_t begin,
+                                           const std::size_t end) {
+      for (std::size_t k = begin; k < end; k++) {
+        accumulator.add(t, pairs[k].first, pairForce(k));
+        accumulator.add(t, pairs[k].second, -pairForce(k));
+      }
+    });
+    accumulator.reduce(forces.data(), Threads);
+    doNotOptimize(forces.data());
+  }
+  state.counters["dense"] = accumulator.isDense(0) ? 1 : 0;
+}
+
+SVECTOR_BENCHMARK_TEMPLATE(scatterSerial, 256);
+SVECTOR_BENCHMARK_TEMPLATE(scatterLocked, 256, 4);
+SVECTOR_BENCHMARK_TEMPLATE(scatterPrivate, 256, 1);
+SVECTOR_BENCHMARK_TEMPLATE(scatterPrivate, 256, 4);
+SVECTOR_BENCHMARK_TEMPLATE(scatterSerial, 1);
+SVECTOR_BENCHMARK_TEMPLATE(scatterLocked, 1, 4);
+SVECTOR_BENCHMARK_TEMPLATE(scatterPrivate, 1, 4);
+} // namespace
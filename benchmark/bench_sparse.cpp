@@ -0,0 +1,96 @@
+/**
+ * @file bench_sparse.cpp
+ *
+ * @brief Benchmarks for svector::SparseVector (core/sparse.hpp).
+ *
+ * The vectors have 100000 dimensions. The names give the percentage of
+ * non-zero components of each operand. The dense dot product of the same
+ * size is included as a reference.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::DynVector;
+using svector::SparseVector;
+using svector::bench::doNotOptimize;
+using svector::bench::Random;
+using svector::bench::State;
+
+const std::size_t SPARSE_SIZE = 100000;
+
+// every component is non-zero with a probability of percent / 100
+SparseVector<float> randomSparse(const double percent,
+                                 const std::uint32_t seed) {
+  Random random(seed);
+  SparseVector<float> vec(SPARSE_SIZE);
+  for (std::size_t i = 0; i < SPARSE_SIZE; i++) {
+    // next() is in [1, 10)
+    if ((random.next<double>() - 1) / 9 * 100 < percent) {
+      vec.append(i, random.next<float>());
+    }
+  }
+
+  return vec;
+}
+
+void sparseDotMerge(State &state) {
+  const SparseVector<float> lhs = randomSparse(5, 1);
+  const SparseVector<float> rhs = randomSparse(5, 2);
+  state.setItemsPerIteration(lhs.nonZeros() + rhs.nonZeros());
+  while (state.keepRunning()) {
+    doNotOptimize(lhs.dot(rhs));
+  }
+}
+
+void sparseDotGallop(State &state) {
+  const SparseVector<float> lhs = randomSparse(0.1, 1);
+  const SparseVector<float> rhs = randomSparse(5, 2);
+  state.setItemsPerIteration(lhs.nonZeros() + rhs.nonZeros());
+  while (state.keepRunning()) {
+    doNotOptimize(lhs.dot(rhs));
+  }
+}
+
+void sparseDotDense(State &state) {
+  const SparseVector<float> lhs = randomSparse(5, 1);
+  const std::vector<float> rhs(SPARSE_SIZE, 1);
+  state.setItemsPerIteration(lhs.nonZeros());
+  while (state.keepRunning()) {
+    doNotOptimize(lhs.dot(rhs.data()));
+  }
+}
+
+void denseDot(State &state) {
+  const DynVector<float> lhs(SPARSE_SIZE, 1);
+  const DynVector<float> rhs(SPARSE_SIZE, 2);
+  state.setItemsPerIteration(SPARSE_SIZE);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs.dot(rhs));
+  }
+}
+
+void sparseAdd(State &state) {
+  const SparseVector<float> lhs = randomSparse(5, 1);
+  const SparseVector<float> rhs = randomSparse(5, 2);
+  state.setItemsPerIteration(lhs.nonZeros() + rhs.nonZeros());
+  while (state.keepRunning()) {
+    const SparseVector<float> sum = lhs + rhs;
+    doNotOptimize(sum.nonZeros());
+  }
+}
+
+SVECTOR_BENCHMARK_NAMED("sparseDot<5%, 5%>", sparseDotMerge);
+SVECTOR_BENCHMARK_NAMED("sparseDot<0.1%, 5%>", sparseDotGallop);
+SVECTOR_BENCHMARK_NAMED("sparseDotDense<5%>", sparseDotDense);
+SVECTOR_BENCHMARK_NAMED("denseDot<100%>", denseDot);
+SVECTOR_BENCHMARK_NAMED("sparseAdd<5%, 5%>", sparseAdd);
+} // namespace
@@ -0,0 +1,70 @@
+/**
+ * @file bench_trajectory.cpp
+ *
+ * @brief Benchmarks for the compressed trajectory (core/trajectory.hpp).
+ *
+ * The trajectory is a smooth curve sampled at a fixed rate. Encoding
+ * appends to a growing buffer, so only decoding is checked for allocations.
+ * The encoded size is reported as bytes_per_component.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cmath>   // std::cos, std::sin
+#include <cstddef> // std::size_t
+#include <vector>  // std::vector
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::PREDICT_LINEAR;
+using svector::PREDICT_PREVIOUS;
+using svector::bench::doNotOptimize;
+using svector::bench::State;
+
+template <typename T>
+std::vector<svector::Vector<3, T>> sampledCurve(const std::size_t size) {
+  std::vector<svector::Vector<3, T>> points(size);
+  for (std::size_t i = 0; i < size; i++) {
+    const double t = static_cast<double>(i) * 0.001;
+    points[i][0] = static_cast<T>(std::cos(t) * 500);
+    points[i][1] = static_cast<T>(std::sin(t * 0.7) * 300);
+    points[i][2] = static_cast<T>(t * 20);
+  }
+
+  return points;
+}
+
+template <std::size_t Size, typename T, svector::TrajectoryPredictor P>
+void trajectoryEncode(State &state) {
+  const std::vector<svector::Vector<3, T>> in = sampledCurve<T>(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    const svector::CompressedTrajectory<3, T> compressed(in.data(), Size, P);
+    doNotOptimize(compressed.encodedSize());
+  }
+}
+
+template <std::size_t Size, typename T, svector::TrajectoryPredictor P>
+void trajectoryDecode(State &state) {
+  const std::vector<svector::Vector<3, T>> in = sampledCurve<T>(Size);
+  const svector::CompressedTrajectory<3, T> compressed(in.data(), Size, P);
+  std::vector<svector::Vector<3, T>> out(Size);
+  state.setItemsPerIteration(Size);
+  while (state.keepRunning()) {
+    compressed.decode(out.data());
+    doNotOptimize(out.data());
+  }
+
+  state.counters["bytes_per_component"] =
+      static_cast<double>(compressed.encodedSize()) / (Size * 3);
+}
+
+SVECTOR_BENCHMARK_TEMPLATE(trajectoryEncode, 65536, float, PREDICT_LINEAR);
+SVECTOR_BENCHMARK_TEMPLATE(trajectoryEncode, 65536, double, PREDICT_LINEAR);
+SVECTOR_BENCHMARK_TEMPLATE(trajectoryDecode, 65536, float, PREDICT_PREVIOUS);
+SVECTOR_BENCHMARK_TEMPLATE(trajectoryDecode, 65536, float, PREDICT_LINEAR);
+SVECTOR_BENCHMARK_TEMPLATE(trajectoryDecode, 65536, double, PREDICT_LINEAR);
+} // namespace
@@ -0,0 +1,233 @@
+/**
+ * @file bench_vector.cpp
+ *
+ * @brief Benchmarks for the members of svector::Vector (core/vector.hpp).
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <cstddef> // std::size_t
+#include <string>  // std::string
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Vector;
+using svector::bench::doNotOptimize;
+using svector::bench::randomVector;
+using svector::bench::State;
+
+template <std::size_t D, typename T> void vectorDefaultConstruct(State &state) {
+  while (state.keepRunning()) {
+    Vector<D, T> vec;
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T>
+void vectorInitializerListConstruct(State &state) {
+  T a = 1;
+  T b = 2;
+  T c = 3;
+  while (state.keepRunning()) {
+    doNotOptimize(a);
+    Vector<D, T> vec{a, b, c};
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T> void vectorCopyConstruct(State &state) {
+  Vector<D, T> src = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(src);
+    Vector<D, T> vec(src);
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T> void vectorCopyAssign(State &state) {
+  Vector<D, T> src = randomVector<D, T>(1);
+  Vector<D, T> dst;
+  while (state.keepRunning()) {
+    doNotOptimize(src);
+    dst = src;
+    doNotOptimize(dst);
+  }
+}
+
+template <std::size_t D, typename T> void vectorToString(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    std::string str = vec.toString();
+    doNotOptimize(str);
+  }
+}
+
+template <std::size_t D, typename T> void vectorNegate(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    Vector<D, T> result = -vec;
+    doNotOptimize(result);
+  }
+}
+
+template <std::size_t D, typename T> void vectorUnaryPlus(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    Vector<D, T> result = +vec;
+    doNotOptimize(result);
+  }
+}
+
+template <std::size_t D, typename T> void vectorAddInPlace(State &state) {
+  Vector<D, T> lhs = randomVector<D, T>(1);
+  Vector<D, T> rhs = randomVector<D, T>(2);
+  while (state.keepRunning()) {
+    doNotOptimize(rhs);
+    lhs += rhs;
+    doNotOptimize(lhs);
+  }
+}
+
+template <std::size_t D, typename T> void vectorSubtractInPlace(State &state) {
+  Vector<D, T> lhs = randomVector<D, T>(1);
+  Vector<D, T> rhs = randomVector<D, T>(2);
+  while (state.keepRunning()) {
+    doNotOptimize(rhs);
+    lhs -= rhs;
+    doNotOptimize(lhs);
+  }
+}
+
+template <std::size_t D, typename T> void vectorMultiplyInPlace(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  T scalar = 1;
+  while (state.keepRunning()) {
+    doNotOptimize(scalar);
+    vec *= scalar;
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T> void vectorDivideInPlace(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  T scalar = 1;
+  while (state.keepRunning()) {
+    doNotOptimize(scalar);
+    vec /= scalar;
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T> void vectorDot(State &state) {
+  Vector<D, T> lhs = randomVector<D, T>(1);
+  Vector<D, T> rhs = randomVector<D, T>(2);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    doNotOptimize(lhs.dot(rhs));
+  }
+}
+
+template <std::size_t D, typename T> void vectorMagn(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(vec.magn());
+  }
+}
+
+template <std::size_t D, typename T> void vectorNormalize(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    Vector<D, T> result = vec.normalize();
+    doNotOptimize(result);
+  }
+}
+
+template <std::size_t D, typename T> void vectorNumDimensions(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(vec.numDimensions());
+  }
+}
+
+template <std::size_t D, typename T> void vectorIsZero(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(vec.isZero());
+  }
+}
+
+template <std::size_t D, typename T> void vectorSubscript(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  std::size_t index = D - 1;
+  while (state.keepRunning()) {
+    doNotOptimize(index);
+    vec[index] = vec[0];
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T> void vectorAt(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  std::size_t index = D - 1;
+  while (state.keepRunning()) {
+    doNotOptimize(index);
+    vec.at(index) = vec.at(0);
+    doNotOptimize(vec);
+  }
+}
+
+template <std::size_t D, typename T> void vectorIterate(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    T sum = 0;
+    for (const auto &component : vec) {
+      sum += component;
+    }
+    doNotOptimize(sum);
+  }
+}
+
+template <std::size_t D, typename T> void vectorReverseIterate(State &state) {
+  Vector<D, T> vec = randomVector<D, T>(1);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    T sum = 0;
+    for (auto it = vec.rbegin(); it != vec.rend(); ++it) {
+      sum += *it;
+    }
+    doNotOptimize(sum);
+  }
+}
+
+SVECTOR_BENCHMARK_DT(vectorDefaultConstruct);
+SVECTOR_BENCHMARK_DT(vectorInitializerListConstruct);
+SVECTOR_BENCHMARK_DT(vectorCopyConstruct);
+SVECTOR_BENCHMARK_DT(vectorCopyAssign);
+SVECTOR_BENCHMARK_DT(vectorToString);
+SVECTOR_BENCHMARK_DT(vectorNegate);
+SVECTOR_BENCHMARK_DT(vectorUnaryPlus);
+SVECTOR_BENCHMARK_DT(vectorAddInPlace);
+SVECTOR_BENCHMARK_DT(vectorSubtractInPlace);
+SVECTOR_BENCHMARK_DT(vectorMultiplyInPlace);
+SVECTOR_BENCHMARK_DT(vectorDivideInPlace);
+SVECTOR_BENCHMARK_DT(vectorDot);
+SVECTOR_BENCHMARK_DT(vectorMagn);
+SVECTOR_BENCHMARK_DT(vectorNormalize);
+SVECTOR_BENCHMARK_DT(vectorNumDimensions);
+SVECTOR_BENCHMARK_DT(vectorIsZero);
+SVECTOR_BENCHMARK_DT(vectorSubscript);
+SVECTOR_BENCHMARK_DT(vectorAt);
+SVECTOR_BENCHMARK_DT(vectorIterate);
+SVECTOR_BENCHMARK_DT(vectorReverseIterate);
+} // namespace
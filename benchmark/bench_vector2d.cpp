@@ -0,0 +1,84 @@
+/**
+ * @file bench_vector2d.cpp
+ *
+ * @brief Benchmarks for the members of svector::Vector2D (core/vector2d.hpp).
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <utility> // std::pair
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Vector2D;
+using svector::bench::doNotOptimize;
+using svector::bench::State;
+
+void vector2DConstruct(State &state) {
+  double x = 3;
+  double y = 4;
+  while (state.keepRunning()) {
+    doNotOptimize(x);
+    Vector2D vec(x, y);
+    doNotOptimize(vec);
+  }
+}
+
+void vector2DBaseConstruct(State &state) {
+  svector::Vector<2> base{3, 4};
+  while (state.keepRunning()) {
+    doNotOptimize(base);
+    Vector2D vec(base);
+    doNotOptimize(vec);
+  }
+}
+
+void vector2DComponents(State &state) {
+  Vector2D vec(3, 4);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    vec.x(vec.y());
+    vec.y(vec.x());
+    doNotOptimize(vec);
+  }
+}
+
+void vector2DAngle(State &state) {
+  Vector2D vec(3, 4);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(vec.angle());
+  }
+}
+
+void vector2DRotate(State &state) {
+  Vector2D vec(3, 4);
+  double ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    Vector2D result = vec.rotate(ang);
+    doNotOptimize(result);
+  }
+}
+
+void vector2DComponentsAs(State &state) {
+  Vector2D vec(3, 4);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    std::pair<double, double> result =
+        vec.componentsAs<std::pair<double, double>>();
+    doNotOptimize(result);
+  }
+}
+
+SVECTOR_BENCHMARK(vector2DConstruct);
+SVECTOR_BENCHMARK(vector2DBaseConstruct);
+SVECTOR_BENCHMARK(vector2DComponents);
+SVECTOR_BENCHMARK(vector2DAngle);
+SVECTOR_BENCHMARK(vector2DRotate);
+SVECTOR_BENCHMARK(vector2DComponentsAs);
+} // namespace
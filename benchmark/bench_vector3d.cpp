@@ -0,0 +1,120 @@
+/**
+ * @file bench_vector3d.cpp
+ *
+ * @brief Benchmarks for the members of svector::Vector3D (core/vector3d.hpp).
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include "harness.hpp"
+#include "simplevectors/vectors.hpp"
+
+namespace {
+using svector::Vector3D;
+using svector::bench::doNotOptimize;
+using svector::bench::State;
+
+/**
+ * @brief Three doubles, used for componentsAs() and anglesAs().
+ */
+struct Triple {
+  Triple(const double first, const double second, const double third)
+      : a{first}, b{second}, c{third} {}
+
+  double a;
+  double b;
+  double c;
+};
+
+void vector3DConstruct(State &state) {
+  double x = 3;
+  double y = 4;
+  double z = 5;
+  while (state.keepRunning()) {
+    doNotOptimize(x);
+    Vector3D vec(x, y, z);
+    doNotOptimize(vec);
+  }
+}
+
+void vector3DBaseConstruct(State &state) {
+  svector::Vector<3> base{3, 4, 5};
+  while (state.keepRunning()) {
+    doNotOptimize(base);
+    Vector3D vec(base);
+    doNotOptimize(vec);
+  }
+}
+
+void vector3DComponents(State &state) {
+  Vector3D vec(3, 4, 5);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    vec.x(vec.z());
+    vec.y(vec.x());
+    vec.z(vec.y());
+    doNotOptimize(vec);
+  }
+}
+
+void vector3DCross(State &state) {
+  Vector3D lhs(3, 4, 5);
+  Vector3D rhs(-1, 2, 7);
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    Vector3D result = lhs.cross(rhs);
+    doNotOptimize(result);
+  }
+}
+
+template <svector::AngleDir Dir> void vector3DAngle(State &state) {
+  Vector3D vec(3, 4, 5);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(vec.angle<Dir>());
+  }
+}
+
+template <svector::AngleDir Dir> void vector3DRotate(State &state) {
+  Vector3D vec(3, 4, 5);
+  double ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    Vector3D result = vec.rotate<Dir>(ang);
+    doNotOptimize(result);
+  }
+}
+
+void vector3DComponentsAs(State &state) {
+  Vector3D vec(3, 4, 5);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    Triple result = vec.componentsAs<Triple>();
+    doNotOptimize(result);
+  }
+}
+
+void vector3DAnglesAs(State &state) {
+  Vector3D vec(3, 4, 5);
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    Triple result = vec.anglesAs<Triple>();
+    doNotOptimize(result);
+  }
+}
+
+SVECTOR_BENCHMARK(vector3DConstruct);
+SVECTOR_BENCHMARK(vector3DBaseConstruct);
+SVECTOR_BENCHMARK(vector3DComponents);
+SVECTOR_BENCHMARK(vector3DCross);
+SVECTOR_BENCHMARK_TEMPLATE(vector3DAngle, svector::ALPHA);
+SVECTOR_BENCHMARK_TEMPLATE(vector3DAngle, svector::BETA);
+SVECTOR_BENCHMARK_TEMPLATE(vector3DAngle, svector::GAMMA);
+SVECTOR_BENCHMARK_TEMPLATE(vector3DRotate, svector::ALPHA);
+SVECTOR_BENCHMARK_TEMPLATE(vector3DRotate, svector::BETA);
+SVECTOR_BENCHMARK_TEMPLATE(vector3DRotate, svector::GAMMA);
+SVECTOR_BENCHMARK(vector3DComponentsAs);
+SVECTOR_BENCHMARK(vector3DAnglesAs);
+} // namespace
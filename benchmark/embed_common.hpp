@@ -0,0 +1,325 @@
+/**
+ * @file embed_common.hpp
+ *
+ * @brief Benchmarks shared by the embed.hpp and embed.h vector types.
+ *
+ * Both headers define the same set of free functions for their 2D and 3D
+ * structs, so the benchmarks are templates over the vector type and call the
+ * functions unqualified. Include embed.hpp or embed.h before this file.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef BENCHMARK_SVECTOR_EMBED_COMMON_HPP_
+#define BENCHMARK_SVECTOR_EMBED_COMMON_HPP_
+
+#include "harness.hpp"
+
+namespace {
+using svector::bench::doNotOptimize;
+using svector::bench::State;
+
+/**
+ * @brief Creates the left-hand operand of the benchmarks.
+ */
+template <typename V> V embedLhs();
+
+/**
+ * @brief Creates the right-hand operand of the benchmarks.
+ */
+template <typename V> V embedRhs();
+
+template <typename V> void embedAdd(State &state) {
+  V lhs = embedLhs<V>();
+  V rhs = embedRhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    V result = lhs + rhs;
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedSubtract(State &state) {
+  V lhs = embedLhs<V>();
+  V rhs = embedRhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    V result = lhs - rhs;
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedNegate(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    V result = -vec;
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedUnaryPlus(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    V result = +vec;
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedMultiply(State &state) {
+  V vec = embedLhs<V>();
+  float scalar = 3;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(scalar);
+    V result = vec * scalar;
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedDivide(State &state) {
+  V vec = embedLhs<V>();
+  float scalar = 3;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(scalar);
+    V result = vec / scalar;
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedEqual(State &state) {
+  V lhs = embedLhs<V>();
+  V rhs = lhs;
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    doNotOptimize(lhs == rhs);
+  }
+}
+
+template <typename V> void embedNotEqual(State &state) {
+  V lhs = embedLhs<V>();
+  V rhs = lhs;
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    doNotOptimize(lhs != rhs);
+  }
+}
+
+template <typename V> void embedAddInPlace(State &state) {
+  V lhs = embedLhs<V>();
+  V rhs = embedRhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(rhs);
+    lhs += rhs;
+    doNotOptimize(lhs);
+  }
+}
+
+template <typename V> void embedSubtractInPlace(State &state) {
+  V lhs = embedLhs<V>();
+  V rhs = embedRhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(rhs);
+    lhs -= rhs;
+    doNotOptimize(lhs);
+  }
+}
+
+template <typename V> void embedMultiplyInPlace(State &state) {
+  V vec = embedLhs<V>();
+  float scalar = 1;
+  while (state.keepRunning()) {
+    doNotOptimize(scalar);
+    vec *= scalar;
+    doNotOptimize(vec);
+  }
+}
+
+template <typename V> void embedDivideInPlace(State &state) {
+  V vec = embedLhs<V>();
+  float scalar = 1;
+  while (state.keepRunning()) {
+    doNotOptimize(scalar);
+    vec /= scalar;
+    doNotOptimize(vec);
+  }
+}
+
+template <typename V> void embedDot(State &state) {
+  V lhs = embedLhs<V>();
+  V rhs = embedRhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    doNotOptimize(dot(lhs, rhs));
+  }
+}
+
+template <typename V> void embedMagn(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(magn(vec));
+  }
+}
+
+template <typename V> void embedNormalize(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    V result = normalize(vec);
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedIsZero(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(isZero(vec));
+  }
+}
+
+template <typename V> void embedComponents(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    x(vec, y(vec));
+    y(vec, x(vec));
+    doNotOptimize(vec);
+  }
+}
+
+template <typename V> void embedAngle(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(angle(vec));
+  }
+}
+
+template <typename V> void embedRotate(State &state) {
+  V vec = embedLhs<V>();
+  float ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    V result = rotate(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedCross(State &state) {
+  V lhs = embedLhs<V>();
+  V rhs = embedRhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(lhs);
+    V result = cross(lhs, rhs);
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedAlpha(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(alpha(vec));
+  }
+}
+
+template <typename V> void embedBeta(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(beta(vec));
+  }
+}
+
+template <typename V> void embedGamma(State &state) {
+  V vec = embedLhs<V>();
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(gamma(vec));
+  }
+}
+
+template <typename V> void embedRotateAlpha(State &state) {
+  V vec = embedLhs<V>();
+  float ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    V result = rotateAlpha(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedRotateBeta(State &state) {
+  V vec = embedLhs<V>();
+  float ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    V result = rotateBeta(vec, ang);
+    doNotOptimize(result);
+  }
+}
+
+template <typename V> void embedRotateGamma(State &state) {
+  V vec = embedLhs<V>();
+  float ang = 0.5;
+  while (state.keepRunning()) {
+    doNotOptimize(vec);
+    doNotOptimize(ang);
+    V result = rotateGamma(vec, ang);
+    doNotOptimize(result);
+  }
+}
+} // namespace
+
+/**
+ * @brief Registers the benchmarks that both 2D and 3D embed vectors support.
+ */
+#define SVECTOR_BENCHMARK_EMBED_COMMON(V)                                      \
+  SVECTOR_BENCHMARK_TEMPLATE(embedAdd, V);                                     \
+  SVECTOR_BENCHMARK_TEMPLATE(embedSubtract, V);                                \
+  SVECTOR_BENCHMARK_TEMPLATE(embedNegate, V);                                  \
+  SVECTOR_BENCHMARK_TEMPLATE(embedUnaryPlus, V);                               \
+  SVECTOR_BENCHMARK_TEMPLATE(embedMultiply, V);                                \
+  SVECTOR_BENCHMARK_TEMPLATE(embedDivide, V);                                  \
+  SVECTOR_BENCHMARK_TEMPLATE(embedEqual, V);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(embedNotEqual, V);                                \
+  SVECTOR_BENCHMARK_TEMPLATE(embedAddInPlace, V);                              \
+  SVECTOR_BENCHMARK_TEMPLATE(embedSubtractInPlace, V);                         \
+  SVECTOR_BENCHMARK_TEMPLATE(embedMultiplyInPlace, V);                         \
+  SVECTOR_BENCHMARK_TEMPLATE(embedDivideInPlace, V);                           \
+  SVECTOR_BENCHMARK_TEMPLATE(embedDot, V);                                     \
+  SVECTOR_BENCHMARK_TEMPLATE(embedMagn, V);                                    \
+  SVECTOR_BENCHMARK_TEMPLATE(embedNormalize, V);                               \
+  SVECTOR_BENCHMARK_TEMPLATE(embedIsZero, V);                                  \
+  SVECTOR_BENCHMARK_TEMPLATE(embedComponents, V)
+
+/**
+ * @brief Registers the benchmarks for a 2D embed vector.
+ */
+#define SVECTOR_BENCHMARK_EMBED_2D(V)                                          \
+  SVECTOR_BENCHMARK_EMBED_COMMON(V);                                           \
+  SVECTOR_BENCHMARK_TEMPLATE(embedAngle, V);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(embedRotate, V)
+
+/**
+ * @brief Registers the benchmarks for a 3D embed vector.
+ */
+#define SVECTOR_BENCHMARK_EMBED_3D(V)                                          \
+  SVECTOR_BENCHMARK_EMBED_COMMON(V);                                           \
+  SVECTOR_BENCHMARK_TEMPLATE(embedCross, V);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(embedAlpha, V);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(embedBeta, V);                                    \
+  SVECTOR_BENCHMARK_TEMPLATE(embedGamma, V);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(embedRotateAlpha, V);                             \
+  SVECTOR_BENCHMARK_TEMPLATE(embedRotateBeta, V);                              \
+  SVECTOR_BENCHMARK_TEMPLATE(embedRotateGamma, V)
+
+#endif
@@ -0,0 +1,368 @@
+/**
+ * @file harness.hpp
+ *
+ * @brief A small self-contained benchmark harness for simplevectors.
+ *
+ * Benchmarks are free functions taking a svector::bench::State, registered
+ * with SVECTOR_BENCHMARK() or SVECTOR_BENCHMARK_TEMPLATE(). The runner in
+ * main.cpp times them and writes the results as JSON.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef BENCHMARK_SVECTOR_HARNESS_HPP_
+#define BENCHMARK_SVECTOR_HARNESS_HPP_
+
+#include <chrono>  // std::chrono::steady_clock
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint32_t, std::uint64_t
+#include <map>     // std::map
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+#include "perf_counters.hpp"
+#include "simplevectors/core/alloc.hpp"  // svector::alloc::threadStats
+#include "simplevectors/core/vector.hpp" // svector::Vector
+
+namespace svector {
+namespace bench {
+/**
+ * @brief Keeps track of the timed loop of a single benchmark run.
+ *
+ * A benchmark body should look like this:
+ *
+ * @code
+ * void myBenchmark(svector::bench::State &state) {
+ *   // setup, not timed
+ *   while (state.keepRunning()) {
+ *     // timed code
+ *   }
+ * }
+ * @endcode
+ */
+class State {
+public:
+  typedef std::chrono::steady_clock clock; //!< Clock used for timing.
+
+  /**
+   * @brief Creates a state that runs the timed loop a fixed number of times.
+   *
+   * @param iterations The number of times keepRunning() returns true.
+   */
+  explicit State(const std::uint64_t iterations)
+      : m_iterations{iterations}, m_count{0}, m_elapsed{0}, m_running{false},
+        m_itemsPerIteration{1}, m_perf{nullptr}, m_allocations{0},
+        m_allocatedBytes{0}, m_allocStart(alloc::Stats{0, 0, 0}) {}
+
+  /**
+   * @brief Advances the timed loop.
+   *
+   * Starts the timer on the first call and stops it once the requested
+   * number of iterations has run.
+   *
+   * @returns Whether the loop body should run again.
+   */
+  bool keepRunning() {
+    if (m_count == 0) {
+      this->resumeTiming();
+    }
+
+    if (m_count < m_iterations) {
+      m_count++;
+      return true;
+    }
+
+    this->pauseTiming();
+    return false;
+  }
+
+  /**
+   * @brief Stops the timer, for setup work inside the timed loop.
+   */
+  void pauseTiming() {
+    if (m_running) {
+      m_elapsed += clock::now() - m_start;
+      m_running = false;
+      if (m_perf != nullptr) {
+        m_perf->stop();
+      }
+
+      const alloc::Stats allocs = alloc::threadStats();
+      m_allocations += allocs.allocations - m_allocStart.allocations;
+      m_allocatedBytes += allocs.bytes - m_allocStart.bytes;
+    }
+  }
+
+  /**
+   * @brief Restarts the timer after pauseTiming().
+   */
+  void resumeTiming() {
+    if (!m_running) {
+      m_allocStart = alloc::threadStats();
+      if (m_perf != nullptr) {
+        m_perf->start();
+      }
+      m_start = clock::now();
+      m_running = true;
+    }
+  }
+
+  /**
+   * @brief Sets how many items (vectors, components, ...) one iteration
+   * processes.
+   *
+   * This is used to report per-item figures for batch benchmarks.
+   *
+   * @param items Items processed per iteration.
+   */
+  void setItemsPerIteration(const std::uint64_t items) {
+    m_itemsPerIteration = items;
+  }
+
+  /**
+   * @brief Gets the number of items one iteration processes.
+   */
+  std::uint64_t itemsPerIteration() const { return m_itemsPerIteration; }
+
+  /**
+   * @brief Counts hardware events while the timer is running.
+   *
+   * @param perf The counters to start and stop with the timer, or nullptr
+   * to only time.
+   */
+  void setPerfCounters(PerfCounters *perf) { m_perf = perf; }
+
+  /**
+   * @brief Gets the number of iterations that were requested.
+   */
+  std::uint64_t iterations() const { return m_iterations; }
+
+  /**
+   * @brief Gets the number of heap allocations in the timed loop.
+   *
+   * This is always 0 unless the benchmarks are built with
+   * SVECTOR_TRACK_ALLOCS and the allocation hooks.
+   */
+  std::uint64_t allocations() const { return m_allocations; }
+
+  /**
+   * @brief Gets the number of bytes allocated in the timed loop.
+   */
+  std::uint64_t allocatedBytes() const { return m_allocatedBytes; }
+
+  /**
+   * @brief Gets the total time spent in the timed loop.
+   *
+   * @returns The elapsed time in nanoseconds.
+   */
+  double elapsedNs() const {
+    return std::chrono::duration<double, std::nano>(m_elapsed).count();
+  }
+
+  /**
+   * @brief Custom values reported alongside the timing in the JSON output.
+   */
+  std::map<std::string, double> counters;
+
+private:
+  std::uint64_t m_iterations;
+  std::uint64_t m_count;
+  clock::duration m_elapsed;
+  clock::time_point m_start;
+  bool m_running;
+  std::uint64_t m_itemsPerIteration;
+  PerfCounters *m_perf;
+  std::uint64_t m_allocations;
+  std::uint64_t m_allocatedBytes;
+  alloc::Stats m_allocStart;
+};
+
+typedef void (*BenchmarkFn)(State &); //!< Signature of a benchmark.
+
+/**
+ * @brief A registered benchmark.
+ */
+struct Benchmark {
+  std::string name; //!< The unique name of the benchmark.
+  BenchmarkFn fn;   //!< The benchmark function.
+};
+
+/**
+ * @brief Gets every registered benchmark.
+ *
+ * @returns The benchmark registry, in registration order.
+ */
+inline std::vector<Benchmark> &registry() {
+  static std::vector<Benchmark> benchmarks;
+  return benchmarks;
+}
+
+/**
+ * @brief Registers a benchmark when constructed.
+ *
+ * Use SVECTOR_BENCHMARK() rather than creating this directly.
+ */
+struct Registrar {
+  /**
+   * @brief Adds a benchmark to the registry.
+   *
+   * @param name The unique name of the benchmark.
+   * @param fn The benchmark function.
+   */
+  Registrar(const char *name, BenchmarkFn fn) {
+    registry().push_back(Benchmark{name, fn});
+  }
+};
+
+/**
+ * @brief Prevents the compiler from optimizing away a value.
+ *
+ * The value is treated as if it were read and written by an unknown
+ * function, so it must be computed and cannot be constant-folded across
+ * loop iterations.
+ *
+ * @param value The value to keep.
+ */
+template <typename T> inline void doNotOptimize(T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : "+m,r"(value) : : "memory");
+#else
+  static volatile const void *sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * @brief Prevents the compiler from optimizing away a value.
+ *
+ * @param value The value to keep.
+ */
+template <typename T> inline void doNotOptimize(const T &value) {
+#if defined(__GNUC__) || defined(__clang__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static volatile const void *sink;
+  sink = &value;
+#endif
+}
+
+/**
+ * @brief Generates deterministic pseudo-random values for benchmark inputs.
+ *
+ * Values are in [1, 10) so that magnitudes, angles, and divisions are well
+ * defined for every vector type, including integer vectors.
+ */
+class Random {
+public:
+  /**
+   * @brief Creates a generator with a fixed seed.
+   *
+   * @param seed The seed.
+   */
+  explicit Random(const std::uint32_t seed)
+      : m_state{seed * 2654435761U + 1} {}
+
+  /**
+   * @brief Gets the next value.
+   *
+   * @tparam T The value type.
+   *
+   * @returns A value in [1, 10).
+   */
+  template <typename T> T next() {
+    // Numerical Recipes LCG
+    m_state = m_state * 1664525U + 1013904223U;
+    const double unit = static_cast<double>(m_state >> 8) / (1U << 24);
+    return static_cast<T>(1 + unit * 9);
+  }
+
+  /**
+   * @brief Gets a vector with random components.
+   *
+   * @tparam V A vector type with operator[] and numDimensions().
+   * @tparam T The component type.
+   *
+   * @returns A vector whose components are in [1, 10).
+   */
+  template <typename V, typename T> V vector() {
+    V vec;
+    for (std::size_t i = 0; i < vec.numDimensions(); i++) {
+      vec[i] = this->next<T>();
+    }
+
+    return vec;
+  }
+
+private:
+  std::uint32_t m_state;
+};
+
+/**
+ * @brief Creates a vector with random components.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ *
+ * @param seed The seed of the generator.
+ *
+ * @returns A vector whose components are in [1, 10).
+ */
+template <std::size_t D, typename T>
+Vector<D, T> randomVector(const std::uint32_t seed) {
+  Random random(seed);
+  return random.vector<Vector<D, T>, T>();
+}
+} // namespace bench
+} // namespace svector
+
+#define SVECTOR_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define SVECTOR_BENCHMARK_CONCAT(a, b) SVECTOR_BENCHMARK_CONCAT_IMPL(a, b)
+#define SVECTOR_BENCHMARK_UNIQUE(prefix)                                       \
+  SVECTOR_BENCHMARK_CONCAT(prefix, __COUNTER__)
+
+/**
+ * @brief Registers a benchmark function under a name.
+ *
+ * The macro is variadic so that template arguments containing commas can
+ * be passed through.
+ *
+ * @param name A string literal with the benchmark name.
+ */
+#define SVECTOR_BENCHMARK_NAMED(name, ...)                                     \
+  static const ::svector::bench::Registrar SVECTOR_BENCHMARK_UNIQUE(           \
+      svectorBenchmarkRegistrar)(name, __VA_ARGS__)
+
+/**
+ * @brief Registers a benchmark function, named after the function.
+ */
+#define SVECTOR_BENCHMARK(fn) SVECTOR_BENCHMARK_NAMED(#fn, fn)
+
+/**
+ * @brief Registers an instantiation of a benchmark function template.
+ *
+ * For example, `SVECTOR_BENCHMARK_TEMPLATE(dot, 3, double)` is named
+ * `dot<3, double>`.
+ */
+#define SVECTOR_BENCHMARK_TEMPLATE(fn, ...)                                    \
+  SVECTOR_BENCHMARK_NAMED(#fn "<" #__VA_ARGS__ ">", fn<__VA_ARGS__>)
+
+/**
+ * @brief Registers a benchmark function template for every dimension and
+ * type combination that the benchmarks cover.
+ */
+#define SVECTOR_BENCHMARK_DT(fn)                                               \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 2, int);                                      \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 2, float);                                    \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 2, double);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 3, int);                                      \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 3, float);                                    \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 3, double);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 16, int);                                     \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 16, float);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 16, double);                                  \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 64, int);                                     \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 64, float);                                   \
+  SVECTOR_BENCHMARK_TEMPLATE(fn, 64, double)
+
+#endif
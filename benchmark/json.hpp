@@ -0,0 +1,294 @@
+/**
+ * @file json.hpp
+ *
+ * @brief Minimal JSON reading and writing for benchmark results.
+ *
+ * This only supports what the benchmark runner needs: reading back its own
+ * output (for baselines) and formatting strings and numbers.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef BENCHMARK_SVECTOR_JSON_HPP_
+#define BENCHMARK_SVECTOR_JSON_HPP_
+
+#include <cmath>     // std::isfinite
+#include <cstddef>   // std::size_t
+#include <cstdio>    // std::snprintf
+#include <cstdlib>   // std::strtod, std::strtol
+#include <stdexcept> // std::runtime_error
+#include <string>    // std::string
+#include <utility>   // std::pair
+#include <vector>    // std::vector
+
+namespace svector {
+namespace bench {
+namespace json {
+/**
+ * @brief A parsed JSON value.
+ */
+struct Value {
+  /**
+   * @brief The kind of JSON value.
+   */
+  enum Type { NUL, BOOLEAN, NUMBER, STRING, ARRAY, OBJECT };
+
+  Value() : type{NUL}, boolean{false}, number{0} {}
+
+  /**
+   * @brief Looks up a member of an object.
+   *
+   * @param key The member name.
+   *
+   * @returns The member, or nullptr if this is not an object or the member
+   * does not exist.
+   */
+  const Value *find(const std::string &key) const {
+    for (const auto &member : object) {
+      if (member.first == key) {
+        return &member.second;
+      }
+    }
+
+    return nullptr;
+  }
+
+  Type type;                                         //!< The kind of value.
+  bool boolean;                                      //!< Set for BOOLEAN.
+  double number;                                     //!< Set for NUMBER.
+  std::string string;                                //!< Set for STRING.
+  std::vector<Value> array;                          //!< Set for ARRAY.
+  std::vector<std::pair<std::string, Value>> object; //!< Set for OBJECT.
+};
+
+/**
+ * @brief Recursive descent JSON parser.
+ */
+class Parser {
+public:
+  /**
+   * @brief Creates a parser over a string.
+   *
+   * @param text The JSON text.
+   */
+  explicit Parser(const std::string &text) : m_text{text}, m_pos{0} {}
+
+  /**
+   * @brief Parses the whole text as one value.
+   *
+   * Throws std::runtime_error if the text is not valid JSON.
+   *
+   * @returns The parsed value.
+   */
+  Value parse() {
+    Value value = this->parseValue();
+    this->skipSpace();
+    if (m_pos != m_text.size()) {
+      this->fail("trailing characters");
+    }
+
+    return value;
+  }
+
+private:
+  void fail(const std::string &message) const {
+    throw std::runtime_error("JSON parse error at offset " +
+                             std::to_string(m_pos) + ": " + message);
+  }
+
+  void skipSpace() {
+    while (m_pos < m_text.size() &&
+           (m_text[m_pos] == ' ' || m_text[m_pos] == '\n' ||
+            m_text[m_pos] == '\r' || m_text[m_pos] == '\t')) {
+      m_pos++;
+    }
+  }
+
+  bool consume(const char c) {
+    this->skipSpace();
+    if (m_pos < m_text.size() && m_text[m_pos] == c) {
+      m_pos++;
+      return true;
+    }
+
+    return false;
+  }
+
+  void expect(const char c) {
+    if (!this->consume(c)) {
+      this->fail(std::string("expected '") + c + "'");
+    }
+  }
+
+  bool consumeWord(const std::string &word) {
+    if (m_text.compare(m_pos, word.size(), word) == 0) {
+      m_pos += word.size();
+      return true;
+    }
+
+    return false;
+  }
+
+  Value parseValue() {
+    this->skipSpace();
+    if (m_pos >= m_text.size()) {
+      this->fail("unexpected end of input");
+    }
+
+    Value value;
+    const char c = m_text[m_pos];
+    if (c == '{') {
+      value.type = Value::OBJECT;
+      m_pos++;
+      if (!this->consume('}')) {
+        do {
+          this->skipSpace();
+          std::string key = this->parseString();
+          this->expect(':');
+          value.object.emplace_back(key, this->parseValue());
+        } while (this->consume(','));
+        this->expect('}');
+      }
+    } else if (c == '[') {
+      value.type = Value::ARRAY;
+      m_pos++;
+      if (!this->consume(']')) {
+        do {
+          value.array.push_back(this->parseValue());
+        } while (this->consume(','));
+        this->expect(']');
+      }
+    } else if (c == '"') {
+      value.type = Value::STRING;
+      value.string = this->parseString();
+    } else if (this->consumeWord("true")) {
+      value.type = Value::BOOLEAN;
+      value.boolean = true;
+    } else if (this->consumeWord("false")) {
+      value.type = Value::BOOLEAN;
+    } else if (this->consumeWord("null")) {
+      value.type = Value::NUL;
+    } else {
+      const char *begin = m_text.c_str() + m_pos;
+      char *end = nullptr;
+      value.type = Value::NUMBER;
+      value.number = std::strtod(begin, &end);
+      if (end == begin) {
+        this->fail("unexpected character");
+      }
+      m_pos += static_cast<std::size_t>(end - begin);
+    }
+
+    return value;
+  }
+
+  std::string parseString() {
+    if (m_pos >= m_text.size() || m_text[m_pos] != '"') {
+      this->fail("expected string");
+    }
+    m_pos++;
+
+    std::string str;
+    while (m_pos < m_text.size() && m_text[m_pos] != '"') {
+      char c = m_text[m_pos++];
+      if (c == '\\') {
+        if (m_pos >= m_text.size()) {
+          break;
+        }
+
+        c = m_text[m_pos++];
+        switch (c) {
+        case 'n':
+          c = '\n';
+          break;
+        case 't':
+          c = '\t';
+          break;
+        case 'r':
+          c = '\r';
+          break;
+        case 'u':
+          // only control characters are escaped by escape()
+          c = static_cast<char>(
+              std::strtol(m_text.substr(m_pos, 4).c_str(), nullptr, 16));
+          m_pos += 4;
+          break;
+        default:
+          break;
+        }
+      }
+      str += c;
+    }
+
+    if (m_pos >= m_text.size()) {
+      this->fail("unterminated string");
+    }
+    m_pos++;
+
+    return str;
+  }
+
+  const std::string &m_text;
+  std::size_t m_pos;
+};
+
+/**
+ * @brief Parses JSON text.
+ *
+ * Throws std::runtime_error if the text is not valid JSON.
+ *
+ * @param text The JSON text.
+ *
+ * @returns The parsed value.
+ */
+inline Value parse(const std::string &text) { return Parser(text).parse(); }
+
+/**
+ * @brief Escapes a string for use inside a JSON string literal.
+ *
+ * @param str The string to escape.
+ *
+ * @returns The escaped string, without surrounding quotes.
+ */
+inline std::string escape(const std::string &str) {
+  std::string escaped;
+  for (const char c : str) {
+    if (c == '"' || c == '\\') {
+      escaped += '\\';
+      escaped += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+      escaped += buf;
+    } else {
+      escaped += c;
+    }
+  }
+
+  return escaped;
+}
+
+/**
+ * @brief Formats a number so that it reads back exactly.
+ *
+ * JSON has no NaN or infinity, so those are written as null.
+ *
+ * @param value The number.
+ *
+ * @returns The formatted number.
+ */
+inline std::string number(const double value) {
+  if (!std::isfinite(value)) {
+    return "null";
+  }
+
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%.17g", value);
+  return buf;
+}
+} // namespace json
+} // namespace bench
+} // namespace svector
+
+#endif
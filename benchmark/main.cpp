@@ -0,0 +1,657 @@
+/**
+ * @file main.cpp
+ *
+ * @brief Runs the registered benchmarks and writes the results as JSON.
+ *
+ * Usage:
+ *
+ *   benchmark [--filter=REGEX] [--min-time=SECONDS] [--repetitions=N]
+ *             [--out=FILE] [--list] [--perf-counters] [--check-allocs]
+ *             [--save-baseline=FILE]
+ *             [--compare=FILE] [--threshold=FRACTION] [--alpha=P]
+ *
+ * With --save-baseline, the samples of every benchmark that ran are stored
+ * in (or merged into) the baseline file. With --compare, each benchmark is
+ * tested against the baseline with a one-sided Mann-Whitney U test, and the
+ * program exits with status 1 if any benchmark is significantly slower by
+ * more than the threshold. With either option, the default number of
+ * repetitions is BASELINE_REPETITIONS instead of 1. If a benchmark has too
+ * few baseline or current samples for any slowdown to be significant, the
+ * program exits with status 2 before running anything.
+ *
+ * With --perf-counters, hardware events (cycles, instructions, cache and
+ * branch misses, floating point instructions) are counted during the timed
+ * loops and reported per item, e.g. `cycles_per_item`. Counters that the
+ * system does not allow are left out.
+ *
+ * With --check-allocs, heap allocations in the timed loops are counted and
+ * reported per iteration, and the program exits with status 1 if any
+ * benchmark allocates. This needs the benchmark_allocs executable, which is
+ * built with allocation tracking.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#include <algorithm> // std::any_of, std::find, std::min, std::max
+#include <cstdint>   // std::uint64_t
+#include <cstdio>    // std::fprintf
+#include <cstdlib>   // std::strtod, std::strtoul
+#include <ctime>     // std::time, std::strftime
+#include <fstream>   // std::ifstream, std::ofstream
+#include <iostream>  // std::cout, std::cerr
+#include <iterator>  // std::begin, std::end
+#include <map>       // std::map
+#include <memory>    // std::unique_ptr
+#include <regex>     // std::regex, std::regex_search
+#include <sstream>   // std::ostringstream
+#include <stdexcept> // std::runtime_error
+#include <string>    // std::string
+#include <thread>    // std::thread::hardware_concurrency
+#include <vector>    // std::vector
+
+#include "harness.hpp"
+#include "json.hpp"
+#include "perf_counters.hpp"
+#include "simplevectors/core/alloc.hpp" // SVECTOR_DEFINE_ALLOC_HOOKS
+#include "stats.hpp"
+
+#ifndef SVECTOR_VERSION
+#define SVECTOR_VERSION "unknown"
+#endif
+
+#ifndef SVECTOR_BENCHMARK_BUILD_TYPE
+#define SVECTOR_BENCHMARK_BUILD_TYPE "unknown"
+#endif
+
+namespace {
+namespace json = svector::bench::json;
+
+// default repetitions with --save-baseline or --compare, so that a
+// comparison has enough samples on both sides to be significant
+const unsigned long BASELINE_REPETITIONS = 10;
+
+/**
+ * @brief Command line options.
+ */
+struct Options {
+  std::string filter = ".*";
+  double minTime = 0.1;
+  unsigned long repetitions = 0; // 0 means the default
+  std::string out;
+  bool list = false;
+  bool perfCounters = false;
+  bool checkAllocs = false;
+  std::string saveBaseline;
+  std::string compare;
+  double threshold = 0.05; // allowed slowdown of the median
+  double alpha = 0.01;     // significance level
+};
+
+/**
+ * @brief Comparison of one benchmark against its baseline.
+ */
+struct Comparison {
+  bool compared = false;
+  double baselineNs = 0;
+  double change = 0; // relative change of the median
+  double pValue = 1;
+  bool regression = false;
+};
+
+/**
+ * @brief Result of one benchmark.
+ */
+struct Result {
+  std::string name;
+  std::uint64_t iterations = 0;
+  std::vector<double> samples; // ns per iteration, one per repetition
+  std::uint64_t itemsPerIteration = 1;
+  std::map<std::string, double> counters;
+  std::uint64_t allocations = 0; // in all timed loops
+  Comparison comparison;
+
+  double realTimeNs() const { return svector::bench::median(samples); }
+};
+
+void printUsage() {
+  std::cerr << "usage: benchmark [--filter=REGEX] [--min-time=SECONDS] "
+               "[--repetitions=N]\n"
+               "                 [--out=FILE] [--list] [--perf-counters] "
+               "[--check-allocs]\n"
+               "                 [--save-baseline=FILE]\n"
+               "                 [--compare=FILE] [--threshold=FRACTION] "
+               "[--alpha=P]\n";
+}
+
+bool startsWith(const std::string &str, const std::string &prefix) {
+  return str.compare(0, prefix.size(), prefix) == 0;
+}
+
+bool parseOptions(const int argc, char **argv, Options &options) {
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const std::size_t eq = arg.find('=');
+    const std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+    if (startsWith(arg, "--filter=")) {
+      options.filter = value;
+    } else if (startsWith(arg, "--min-time=")) {
+      options.minTime = std::strtod(value.c_str(), nullptr);
+    } else if (startsWith(arg, "--repetitions=")) {
+      options.repetitions =
+          std::max(1UL, std::strtoul(value.c_str(), nullptr, 10));
+    } else if (startsWith(arg, "--out=")) {
+      options.out = value;
+    } else if (arg == "--list") {
+      options.list = true;
+    } else if (arg == "--perf-counters") {
+      options.perfCounters = true;
+    } else if (arg == "--check-allocs") {
+      options.checkAllocs = true;
+    } else if (startsWith(arg, "--save-baseline=")) {
+      options.saveBaseline = value;
+    } else if (startsWith(arg, "--compare=")) {
+      options.compare = value;
+    } else if (startsWith(arg, "--threshold=")) {
+      options.threshold = std::strtod(value.c_str(), nullptr);
+    } else if (startsWith(arg, "--alpha=")) {
+      options.alpha = std::strtod(value.c_str(), nullptr);
+    } else {
+      std::cerr << "unknown argument: " << arg << "\n";
+      return false;
+    }
+  }
+
+  if (options.repetitions == 0) {
+    options.repetitions =
+        options.saveBaseline.empty() && options.compare.empty()
+            ? 1
+            : BASELINE_REPETITIONS;
+  }
+
+  return true;
+}
+
+/**
+ * @brief Runs a benchmark for a fixed number of iterations.
+ */
+svector::bench::State runOnce(const svector::bench::Benchmark &benchmark,
+                              const std::uint64_t iterations,
+                              svector::bench::PerfCounters *perf = nullptr) {
+  svector::bench::State state(iterations);
+  state.setPerfCounters(perf);
+  benchmark.fn(state);
+  return state;
+}
+
+/**
+ * @brief Finds an iteration count whose timed loop takes at least the
+ * minimum time.
+ */
+std::uint64_t calibrate(const svector::bench::Benchmark &benchmark,
+                        const double minTime) {
+  const double minTimeNs = minTime * 1e9;
+  const std::uint64_t maxIterations = 1000000000;
+
+  std::uint64_t iterations = 1;
+  svector::bench::State state = runOnce(benchmark, iterations);
+
+  while (state.elapsedNs() < minTimeNs && iterations < maxIterations) {
+    // aim a bit past the minimum time, growing at most 10x per round
+    double multiplier = 10;
+    if (state.elapsedNs() > 0) {
+      multiplier = std::min(10.0, 1.4 * minTimeNs / state.elapsedNs());
+    }
+    multiplier = std::max(multiplier, 2.0);
+
+    iterations = std::min<std::uint64_t>(
+        maxIterations,
+        static_cast<std::uint64_t>(static_cast<double>(iterations) *
+                                   multiplier));
+    state = runOnce(benchmark, iterations);
+  }
+
+  return iterations;
+}
+
+/**
+ * @brief Runs a benchmark once per repetition with a calibrated iteration
+ * count.
+ *
+ * If perf is not nullptr, hardware events are counted over all repetitions
+ * and added to the counters as `<event>_per_item`, along with
+ * `instructions_per_cycle`.
+ */
+Result run(const svector::bench::Benchmark &benchmark, const Options &options,
+           svector::bench::PerfCounters *perf) {
+  Result result;
+  result.name = benchmark.name;
+  result.iterations = calibrate(benchmark, options.minTime);
+
+  if (perf != nullptr) {
+    perf->reset();
+  }
+
+  std::uint64_t allocatedBytes = 0;
+
+  for (unsigned long i = 0; i < options.repetitions; i++) {
+    const svector::bench::State state =
+        runOnce(benchmark, result.iterations, perf);
+    result.samples.push_back(state.elapsedNs() /
+                             static_cast<double>(result.iterations));
+    result.itemsPerIteration = state.itemsPerIteration();
+    result.counters = state.counters;
+    result.allocations += state.allocations();
+    allocatedBytes += state.allocatedBytes();
+  }
+
+  if (options.checkAllocs) {
+    const double iterations = static_cast<double>(result.iterations) *
+                              static_cast<double>(options.repetitions);
+    result.counters["allocations_per_iteration"] =
+        static_cast<double>(result.allocations) / iterations;
+    result.counters["allocated_bytes_per_iteration"] =
+        static_cast<double>(allocatedBytes) / iterations;
+  }
+
+  if (perf != nullptr) {
+    const std::map<std::string, double> events = perf->read();
+    const double items = static_cast<double>(result.iterations) *
+                         static_cast<double>(result.itemsPerIteration) *
+                         static_cast<double>(options.repetitions);
+    for (const auto &event : events) {
+      result.counters[event.first + "_per_item"] = event.second / items;
+    }
+
+    const auto cycles = events.find("cycles");
+    const auto instructions = events.find("instructions");
+    if (cycles != events.end() && instructions != events.end() &&
+        cycles->second > 0) {
+      result.counters["instructions_per_cycle"] =
+          instructions->second / cycles->second;
+    }
+  }
+
+  return result;
+}
+
+std::string currentDate() {
+  char buf[32];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+  return buf;
+}
+
+std::string compiler() {
+#if defined(__clang__)
+  return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+  return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+  return "msvc " + std::to_string(_MSC_VER);
+#else
+  return "unknown";
+#endif
+}
+
+std::string toJSON(const std::vector<Result> &results) {
+  std::ostringstream out;
+  out << "{\n";
+  out << "  \"context\": {\n";
+  out << "    \"date\": \"" << currentDate() << "\",\n";
+  out << "    \"library_version\": \"" << SVECTOR_VERSION << "\",\n";
+  out << "    \"build_type\": \"" << SVECTOR_BENCHMARK_BUILD_TYPE << "\",\n";
+  out << "    \"compiler\": \"" << json::escape(compiler()) << "\",\n";
+  out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << "\n";
+  out << "  },\n";
+  out << "  \"benchmarks\": [";
+
+  for (std::size_t i = 0; i < results.size(); i++) {
+    const Result &result = results[i];
+    const double realTime = result.realTimeNs();
+    const double itemsPerSecond =
+        static_cast<double>(result.itemsPerIteration) * 1e9 / realTime;
+
+    out << (i == 0 ? "\n" : ",\n");
+    out << "    {\n";
+    out << "      \"name\": \"" << json::escape(result.name) << "\",\n";
+    out << "      \"iterations\": " << result.iterations << ",\n";
+    out << "      \"repetitions\": " << result.samples.size() << ",\n";
+    out << "      \"real_time\": " << json::number(realTime) << ",\n";
+    out << "      \"real_time_mean\": "
+        << json::number(svector::bench::mean(result.samples)) << ",\n";
+    out << "      \"real_time_stddev\": "
+        << json::number(svector::bench::stddev(result.samples)) << ",\n";
+    out << "      \"time_unit\": \"ns\",\n";
+    out << "      \"samples\": [";
+    for (std::size_t j = 0; j < result.samples.size(); j++) {
+      out << (j == 0 ? "" : ", ") << json::number(result.samples[j]);
+    }
+    out << "],\n";
+    out << "      \"items_per_iteration\": " << result.itemsPerIteration
+        << ",\n";
+    out << "      \"items_per_second\": " << json::number(itemsPerSecond);
+
+    for (const auto &counter : result.counters) {
+      out << ",\n      \"" << json::escape(counter.first)
+          << "\": " << json::number(counter.second);
+    }
+
+    if (result.comparison.compared) {
+      const Comparison &comparison = result.comparison;
+      out << ",\n      \"baseline_real_time\": "
+          << json::number(comparison.baselineNs);
+      out << ",\n      \"change\": " << json::number(comparison.change);
+      out << ",\n      \"p_value\": " << json::number(comparison.pValue);
+      out << ",\n      \"regression\": "
+          << (comparison.regression ? "true" : "false");
+    }
+
+    out << "\n    }";
+  }
+
+  out << "\n  ]\n}\n";
+  return out.str();
+}
+
+/**
+ * @brief Reads results previously written by toJSON().
+ *
+ * Returns an empty list if the file does not exist. Throws
+ * std::runtime_error if the file is not valid.
+ */
+std::vector<Result> readResults(const std::string &path) {
+  std::ifstream file(path);
+  if (!file) {
+    return std::vector<Result>();
+  }
+
+  std::ostringstream text;
+  text << file.rdbuf();
+  const json::Value root = json::parse(text.str());
+
+  const json::Value *benchmarks = root.find("benchmarks");
+  if (benchmarks == nullptr || benchmarks->type != json::Value::ARRAY) {
+    throw std::runtime_error(path + " has no \"benchmarks\" array");
+  }
+
+  // fields written by toJSON() that are not custom counters
+  const char *const known[] = {"iterations",       "repetitions",
+                               "real_time",        "real_time_mean",
+                               "real_time_stddev", "items_per_iteration",
+                               "items_per_second", "baseline_real_time",
+                               "change",           "p_value"};
+
+  std::vector<Result> results;
+  for (const json::Value &entry : benchmarks->array) {
+    const json::Value *name = entry.find("name");
+    const json::Value *samples = entry.find("samples");
+    if (name == nullptr || samples == nullptr) {
+      throw std::runtime_error(path + " has an entry without name or samples");
+    }
+
+    Result result;
+    result.name = name->string;
+    for (const json::Value &sample : samples->array) {
+      result.samples.push_back(sample.number);
+    }
+
+    for (const auto &member : entry.object) {
+      if (member.first == "iterations") {
+        result.iterations = static_cast<std::uint64_t>(member.second.number);
+      } else if (member.first == "items_per_iteration") {
+        result.itemsPerIteration =
+            static_cast<std::uint64_t>(member.second.number);
+      } else if (member.second.type == json::Value::NUMBER &&
+                 std::find(std::begin(known), std::end(known), member.first) ==
+                     std::end(known)) {
+        result.counters[member.first] = member.second.number;
+      }
+    }
+
+    if (!result.samples.empty()) {
+      results.push_back(result);
+    }
+  }
+
+  return results;
+}
+
+bool writeFile(const std::string &path, const std::string &contents) {
+  std::ofstream file(path);
+  if (!file) {
+    std::cerr << "could not open " << path << "\n";
+    return false;
+  }
+
+  file << contents;
+  return true;
+}
+
+/**
+ * @brief Checks that every benchmark that will run can be significantly
+ * slower than its baseline with the number of repetitions.
+ *
+ * @returns Whether the comparison can detect a slowdown, after printing a
+ * message for each benchmark that it cannot.
+ */
+bool checkPower(const std::vector<Result> &baseline, const std::regex &filter,
+                const Options &options) {
+  bool powerful = true;
+  for (const Result &result : baseline) {
+    const bool runs =
+        std::regex_search(result.name, filter) &&
+        std::any_of(svector::bench::registry().begin(),
+                    svector::bench::registry().end(),
+                    [&result](const svector::bench::Benchmark &benchmark) {
+                      return benchmark.name == result.name;
+                    });
+    if (!runs) {
+      continue;
+    }
+
+    const double minP = svector::bench::minPValue(result.samples.size(),
+                                                  options.repetitions);
+    if (minP >= options.alpha) {
+      std::fprintf(stderr,
+                   "%s: %zu baseline and %lu current samples can never reach "
+                   "p < %g (at best p = %.4f); use more repetitions\n",
+                   result.name.c_str(), result.samples.size(),
+                   options.repetitions, options.alpha, minP);
+      powerful = false;
+    }
+  }
+
+  return powerful;
+}
+
+/**
+ * @brief Compares results against a baseline and prints a summary.
+ *
+ * @returns Whether any benchmark regressed.
+ */
+bool compare(std::vector<Result> &results, const std::vector<Result> &baseline,
+             const Options &options) {
+  std::map<std::string, const Result *> byName;
+  for (const Result &result : baseline) {
+    byName[result.name] = &result;
+  }
+
+  bool regressed = false;
+  std::fprintf(stderr, "\n%-48s %12s %12s %8s %8s\n", "benchmark",
+               "baseline ns", "current ns", "change", "p");
+
+  for (Result &result : results) {
+    const auto found = byName.find(result.name);
+    if (found == byName.end()) {
+      std::fprintf(stderr, "%-48s %12s %12.3f %8s %8s\n", result.name.c_str(),
+                   "-", result.realTimeNs(), "new", "-");
+      continue;
+    }
+
+    Comparison &comparison = result.comparison;
+    comparison.compared = true;
+    comparison.baselineNs = found->second->realTimeNs();
+    comparison.change = result.realTimeNs() / comparison.baselineNs - 1;
+    comparison.pValue =
+        svector::bench::mannWhitney(found->second->samples, result.samples)
+            .pValue;
+
+    // must be both significant and large enough to matter
+    comparison.regression = comparison.pValue < options.alpha &&
+                            comparison.change > options.threshold;
+    regressed = regressed || comparison.regression;
+
+    std::fprintf(stderr, "%-48s %12.3f %12.3f %+7.1f%% %8.4f%s\n",
+                 result.name.c_str(), comparison.baselineNs,
+                 result.realTimeNs(), comparison.change * 100,
+                 comparison.pValue,
+                 comparison.regression ? "  REGRESSION" : "");
+  }
+
+  return regressed;
+}
+
+/**
+ * @brief Replaces or adds results in a baseline, keeping the other entries.
+ */
+std::vector<Result> merge(std::vector<Result> baseline,
+                          const std::vector<Result> &results) {
+  for (const Result &result : results) {
+    Result stored = result;
+    stored.comparison = Comparison();
+
+    bool replaced = false;
+    for (Result &entry : baseline) {
+      if (entry.name == result.name) {
+        entry = stored;
+        replaced = true;
+        break;
+      }
+    }
+
+    if (!replaced) {
+      baseline.push_back(stored);
+    }
+  }
+
+  return baseline;
+}
+} // namespace
+
+SVECTOR_DEFINE_ALLOC_HOOKS
+
+int main(int argc, char **argv) {
+  Options options;
+  if (!parseOptions(argc, argv, options)) {
+    printUsage();
+    return 2;
+  }
+
+  std::regex filter;
+  try {
+    filter = std::regex(options.filter);
+  } catch (const std::regex_error &) {
+    std::cerr << "invalid filter: " << options.filter << "\n";
+    return 2;
+  }
+
+  std::vector<Result> baseline;
+  if (!options.compare.empty()) {
+    try {
+      baseline = readResults(options.compare);
+    } catch (const std::runtime_error &e) {
+      std::cerr << e.what() << "\n";
+      return 2;
+    }
+
+    if (baseline.empty()) {
+      std::cerr << "no baseline results in " << options.compare << "\n";
+      return 2;
+    }
+
+    if (!options.list && !checkPower(baseline, filter, options)) {
+      return 2;
+    }
+  }
+
+#ifndef SVECTOR_TRACK_ALLOCS
+  if (options.checkAllocs) {
+    std::cerr << "--check-allocs needs the benchmark_allocs executable\n";
+    return 2;
+  }
+#endif
+
+  std::unique_ptr<svector::bench::PerfCounters> perf;
+  if (options.perfCounters && !options.list) {
+    perf.reset(new svector::bench::PerfCounters());
+    if (!perf->available()) {
+      std::cerr << "performance counters unavailable: " << perf->error()
+                << "\n";
+      perf.reset();
+    } else if (!perf->error().empty()) {
+      std::cerr << "some performance counters unavailable: " << perf->error()
+                << "\n";
+    }
+  }
+
+  std::vector<Result> results;
+  for (const auto &benchmark : svector::bench::registry()) {
+    if (!std::regex_search(benchmark.name, filter)) {
+      continue;
+    }
+
+    if (options.list) {
+      std::cout << benchmark.name << "\n";
+      continue;
+    }
+
+    results.push_back(run(benchmark, options, perf.get()));
+    std::cerr << results.back().name << ": " << results.back().realTimeNs()
+              << " ns\n";
+  }
+
+  if (options.list) {
+    return 0;
+  }
+
+  bool regressed = false;
+  if (!options.compare.empty()) {
+    regressed = compare(results, baseline, options);
+  }
+
+  bool allocated = false;
+  if (options.checkAllocs) {
+    for (const Result &result : results) {
+      if (result.allocations != 0) {
+        std::cerr << result.name << ": "
+                  << result.counters.at("allocations_per_iteration")
+                  << " allocations per iteration\n";
+        allocated = true;
+      }
+    }
+  }
+
+  const std::string json = toJSON(results);
+  if (options.out.empty()) {
+    std::cout << json;
+  } else if (!writeFile(options.out, json)) {
+    return 2;
+  }
+
+  if (!options.saveBaseline.empty()) {
+    try {
+      const std::vector<Result> stored =
+          merge(readResults(options.saveBaseline), results);
+      if (!writeFile(options.saveBaseline, toJSON(stored))) {
+        return 2;
+      }
+    } catch (const std::runtime_error &e) {
+      std::cerr << e.what() << "\n";
+      return 2;
+    }
+  }
+
+  return regressed || allocated ? 1 : 0;
+}
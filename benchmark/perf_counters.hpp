@@ -0,0 +1,245 @@
+/**
+ * @file perf_counters.hpp
+ *
+ * @brief Hardware performance counters for the benchmark harness.
+ *
+ * On Linux the counters are read with perf_event_open(2). Each event is
+ * opened separately, so an event that the CPU or kernel does not support is
+ * simply left out. If no event can be opened (other platforms, containers,
+ * or a restrictive kernel.perf_event_paranoid), available() returns false
+ * and the benchmarks run with timing only.
+ *
+ * The counters are inherited by threads that the calling thread starts
+ * after they are opened, so the benchmarks that start worker threads count
+ * the work of those threads too. A thread's counts are added when it exits,
+ * which the library's threaded functions do before they return.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef BENCHMARK_SVECTOR_PERF_COUNTERS_HPP_
+#define BENCHMARK_SVECTOR_PERF_COUNTERS_HPP_
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <map>     // std::map
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+#ifdef __linux__
+#include <cerrno>   // errno
+#include <cstring>  // std::memset, std::strerror
+#include <fstream>  // std::ifstream
+#include <iterator> // std::istreambuf_iterator
+
+#include <linux/perf_event.h> // perf_event_attr
+#include <sys/ioctl.h>        // ioctl
+#include <sys/syscall.h>      // SYS_perf_event_open
+#include <unistd.h>           // syscall, read, close
+#endif
+
+namespace svector {
+namespace bench {
+/**
+ * @brief A set of hardware performance counters for the calling thread and
+ * the threads it starts.
+ *
+ * Counting is off until start() is called, and stop() pauses it. The
+ * counts add up across start() and stop() pairs until reset() is called.
+ *
+ * These events are opened, if the system supports them:
+ *
+ * - `cycles`: CPU cycles.
+ * - `instructions`: retired instructions.
+ * - `branch_misses`: mispredicted branches.
+ * - `l1d_misses`: L1 data cache read misses.
+ * - `llc_misses`: last level cache misses.
+ * - `fp_scalar_ops`, `fp_packed_ops`: retired scalar and packed (SIMD)
+ *   floating point instructions. These use raw Intel events, so they are
+ *   only opened on Intel CPUs. One packed instruction counts once, whatever
+ *   its width.
+ */
+class PerfCounters {
+public:
+  /**
+   * @brief Opens every supported counter.
+   */
+  PerfCounters() {
+#ifdef __linux__
+    this->open("cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    this->open("instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    this->open("branch_misses", PERF_TYPE_HARDWARE,
+               PERF_COUNT_HW_BRANCH_MISSES);
+    this->open("l1d_misses", PERF_TYPE_HW_CACHE,
+               PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                   (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    this->open("llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+
+    if (isIntel()) {
+      // FP_ARITH_INST_RETIRED (event 0xc7), Broadwell and later
+      this->open("fp_scalar_ops", PERF_TYPE_RAW, 0x03c7);
+      this->open("fp_packed_ops", PERF_TYPE_RAW, 0x3cc7);
+    }
+
+    if (m_counters.empty() && m_error.empty()) {
+      m_error = "no performance counters could be opened";
+    }
+#else
+    m_error = "performance counters are only supported on Linux";
+#endif
+  }
+
+  /**
+   * @brief Closes the counters.
+   */
+  ~PerfCounters() {
+#ifdef __linux__
+    for (const Counter &counter : m_counters) {
+      close(counter.fd);
+    }
+#endif
+  }
+
+  PerfCounters(const PerfCounters &) = delete;
+  PerfCounters &operator=(const PerfCounters &) = delete;
+
+  /**
+   * @brief Checks whether any counter could be opened.
+   */
+  bool available() const { return !m_counters.empty(); }
+
+  /**
+   * @brief Gets why counters are missing.
+   *
+   * @returns The reason the first counter failed to open, or an empty
+   * string if every counter opened.
+   */
+  const std::string &error() const { return m_error; }
+
+  /**
+   * @brief Starts or resumes counting.
+   */
+  void start() {
+#ifdef __linux__
+    for (const Counter &counter : m_counters) {
+      ioctl(counter.fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+  }
+
+  /**
+   * @brief Pauses counting.
+   */
+  void stop() {
+#ifdef __linux__
+    for (const Counter &counter : m_counters) {
+      ioctl(counter.fd, PERF_EVENT_IOC_DISABLE, 0);
+    }
+#endif
+  }
+
+  /**
+   * @brief Sets every count back to zero.
+   */
+  void reset() {
+#ifdef __linux__
+    for (Counter &counter : m_counters) {
+      ioctl(counter.fd, PERF_EVENT_IOC_RESET, 0);
+      // the reset does not clear what exited threads added, so remember it
+      readRaw(counter.fd, counter.base);
+    }
+#endif
+  }
+
+  /**
+   * @brief Reads the counts.
+   *
+   * When there are more events than hardware counters, the kernel takes
+   * turns between them. The counts are then scaled up by the fraction of
+   * time each event was actually counted. An event that was never counted
+   * is left out.
+   *
+   * @returns The counts by event name.
+   */
+  std::map<std::string, double> read() const {
+    std::map<std::string, double> values;
+#ifdef __linux__
+    for (const Counter &counter : m_counters) {
+      // value, time enabled, time running
+      std::uint64_t buf[3] = {0, 0, 0};
+      if (!readRaw(counter.fd, buf)) {
+        continue;
+      }
+      for (std::size_t i = 0; i < 3; i++) {
+        buf[i] -= counter.base[i];
+      }
+      if (buf[2] == 0) {
+        continue;
+      }
+
+      values[counter.name] = static_cast<double>(buf[0]) *
+                             static_cast<double>(buf[1]) /
+                             static_cast<double>(buf[2]);
+    }
+#endif
+    return values;
+  }
+
+private:
+#ifdef __linux__
+  struct Counter {
+    std::string name;
+    int fd;
+    std::uint64_t base[3]; // raw values at the last reset()
+  };
+
+  static bool readRaw(const int fd, std::uint64_t *buf) {
+    return ::read(fd, buf, 3 * sizeof(std::uint64_t)) ==
+           static_cast<ssize_t>(3 * sizeof(std::uint64_t));
+  }
+
+  static bool isIntel() {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    const std::string text((std::istreambuf_iterator<char>(cpuinfo)),
+                           std::istreambuf_iterator<char>());
+    return text.find("GenuineIntel") != std::string::npos;
+  }
+
+  void open(const std::string &name, const std::uint32_t type,
+            const std::uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = 1;
+    attr.read_format =
+        PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1,
+                            PERF_FLAG_FD_CLOEXEC);
+    if (fd < 0) {
+      if (m_error.empty()) {
+        m_error = name + ": " + std::strerror(errno);
+        if (errno == EACCES || errno == EPERM) {
+          m_error += " (check /proc/sys/kernel/perf_event_paranoid)";
+        }
+      }
+      return;
+    }
+
+    m_counters.push_back(Counter{name, static_cast<int>(fd), {0, 0, 0}});
+  }
+
+  std::vector<Counter> m_counters;
+#endif
+  std::string m_error;
+};
+} // namespace bench
+} // namespace svector
+
+#endif
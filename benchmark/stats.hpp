@@ -0,0 +1,191 @@
+/**
+ * @file stats.hpp
+ *
+ * @brief Statistics for comparing benchmark samples against a baseline.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef BENCHMARK_SVECTOR_STATS_HPP_
+#define BENCHMARK_SVECTOR_STATS_HPP_
+
+#include <algorithm> // std::sort
+#include <cmath>     // std::erfc, std::sqrt
+#include <cstddef>   // std::size_t
+#include <utility>   // std::pair
+#include <vector>    // std::vector
+
+namespace svector {
+namespace bench {
+/**
+ * @brief Gets the median of a set of samples.
+ *
+ * @param samples The samples, which must not be empty.
+ *
+ * @returns The median.
+ */
+inline double median(std::vector<double> samples) {
+  std::sort(samples.begin(), samples.end());
+  const std::size_t mid = samples.size() / 2;
+  if (samples.size() % 2 == 0) {
+    return (samples[mid - 1] + samples[mid]) / 2;
+  }
+
+  return samples[mid];
+}
+
+/**
+ * @brief Gets the arithmetic mean of a set of samples.
+ *
+ * @param samples The samples, which must not be empty.
+ *
+ * @returns The mean.
+ */
+inline double mean(const std::vector<double> &samples) {
+  double sum = 0;
+  for (const double sample : samples) {
+    sum += sample;
+  }
+
+  return sum / static_cast<double>(samples.size());
+}
+
+/**
+ * @brief Gets the sample standard deviation of a set of samples.
+ *
+ * @param samples The samples.
+ *
+ * @returns The standard deviation, or 0 for fewer than two samples.
+ */
+inline double stddev(const std::vector<double> &samples) {
+  if (samples.size() < 2) {
+    return 0;
+  }
+
+  const double avg = mean(samples);
+  double sum = 0;
+  for (const double sample : samples) {
+    sum += (sample - avg) * (sample - avg);
+  }
+
+  return std::sqrt(sum / static_cast<double>(samples.size() - 1));
+}
+
+/**
+ * @brief Result of a one-sided Mann-Whitney U test.
+ */
+struct MannWhitneyResult {
+  double u;      //!< The U statistic of the second sample.
+  double z;      //!< The normal approximation of U.
+  double pValue; //!< Probability of a U this large if nothing changed.
+};
+
+/**
+ * @brief Tests whether the second set of samples tends to be larger than the
+ * first.
+ *
+ * Uses the Mann-Whitney U test with the normal approximation, a tie
+ * correction, and a continuity correction. It makes no assumption about the
+ * distribution of the timings, which are usually skewed by outliers. The
+ * approximation needs about 8 or more samples per side to be reliable.
+ *
+ * @param baseline The baseline samples.
+ * @param current The samples to test.
+ *
+ * @returns The U statistic and the one-sided p-value.
+ */
+inline MannWhitneyResult mannWhitney(const std::vector<double> &baseline,
+                                     const std::vector<double> &current) {
+  const std::size_t n1 = baseline.size();
+  const std::size_t n2 = current.size();
+  const std::size_t n = n1 + n2;
+
+  // (value, belongs to current)
+  std::vector<std::pair<double, bool>> all;
+  all.reserve(n);
+  for (const double sample : baseline) {
+    all.emplace_back(sample, false);
+  }
+  for (const double sample : current) {
+    all.emplace_back(sample, true);
+  }
+  std::sort(all.begin(), all.end());
+
+  // rank with ties getting the average of their ranks
+  double rankSum = 0;
+  double tieTerm = 0;
+  std::size_t i = 0;
+  while (i < n) {
+    std::size_t j = i;
+    while (j + 1 < n && all[j + 1].first == all[i].first) {
+      j++;
+    }
+
+    const double rank = static_cast<double>(i + j) / 2 + 1;
+    for (std::size_t k = i; k <= j; k++) {
+      if (all[k].second) {
+        rankSum += rank;
+      }
+    }
+
+    const double ties = static_cast<double>(j - i + 1);
+    tieTerm += ties * ties * ties - ties;
+    i = j + 1;
+  }
+
+  const double dn1 = static_cast<double>(n1);
+  const double dn2 = static_cast<double>(n2);
+  const double dn = static_cast<double>(n);
+
+  MannWhitneyResult result;
+  result.u = rankSum - dn2 * (dn2 + 1) / 2;
+
+  const double meanU = dn1 * dn2 / 2;
+  double variance = dn1 * dn2 / 12 * (dn + 1);
+  if (n > 1) {
+    variance -= dn1 * dn2 / 12 * tieTerm / (dn * (dn - 1));
+  }
+
+  if (variance <= 0) {
+    // every sample is equal
+    result.z = 0;
+    result.pValue = 1;
+    return result;
+  }
+
+  result.z = (result.u - meanU - 0.5) / std::sqrt(variance);
+  result.pValue = 0.5 * std::erfc(result.z / std::sqrt(2.0));
+  return result;
+}
+
+/**
+ * @brief Gets the smallest p-value that mannWhitney() can return for the
+ * given sample sizes.
+ *
+ * That is the p-value when every current sample is larger than every
+ * baseline sample, with no ties. If it is not below the significance level,
+ * no slowdown can ever be detected with that many samples.
+ *
+ * @param baselineSize The number of baseline samples.
+ * @param currentSize The number of current samples.
+ *
+ * @returns The smallest possible one-sided p-value.
+ */
+inline double minPValue(const std::size_t baselineSize,
+                        const std::size_t currentSize) {
+  std::vector<double> baseline;
+  std::vector<double> current;
+  for (std::size_t i = 0; i < baselineSize; i++) {
+    baseline.push_back(static_cast<double>(i));
+  }
+  for (std::size_t i = 0; i < currentSize; i++) {
+    current.push_back(static_cast<double>(baselineSize + i));
+  }
+
+  return mannWhitney(baseline, current).pValue;
+}
+} // namespace bench
+} // namespace svector
+
+#endif
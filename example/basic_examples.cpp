@@ -65,6 +65,34 @@ int main() {
   std::cout << vec_from_std_vector.toString() << std::endl; // "<1, 0>"
   std::cout << vec_from_initializer_list.toString() << std::endl; // "<1, 4>"
 
+  const float samples[] = {1, 2, 3, 4};
+  svector::Vector<3, float> vec_from_pointer =
+      svector::makeVector<3>(samples + 1); // <2, 3, 4>
+  svector::Vector<3, float> vec_from_buffer =
+      svector::makeVector<3>(samples, 2); // <1, 2, 0>
+
+  std::cout << vec_from_pointer.toString() << std::endl; // "<2, 3, 4>"
+  std::cout << vec_from_buffer.toString() << std::endl;  // "<1, 2, 0>"
+
+  const float flat[] = {1, 2, 3, 4, 5, 6};
+  std::vector<svector::Vector3D> points(2);
+  svector::fromFlatArray(flat, points.size(),
+                         points.data()); // <1, 2, 3>, <4, 5, 6>
+
+  float out[6];
+  svector::toFlatArray(points.data(), points.size(), out); // 1, 2, 3, 4, 5, 6
+
+  std::cout << points[1].toString() << std::endl; // "<4, 5, 6>"
+
+  float viewed[] = {1, 2, 3, 4, 5, 6};
+  svector::VectorView<3, float> first(viewed);      // <1, 2, 3>
+  svector::VectorView<3, float> second(viewed + 3); // <4, 5, 6>
+  svector::Vector<3, float> crossed = svector::cross(first, second);
+  first += second; // writes into viewed
+
+  std::cout << crossed.toString() << std::endl; // "<-3, 6, -3>"
+  std::cout << viewed[0] << std::endl;          // 5
+
   std::cout << "TO STRING TEST" << std::endl;
   std::cout << zero2d.toString() << std::endl; // "<0.000, 0.000>"
   std::cout << v3d.toString() << std::endl;    // "<2.000, 4.000, 5.000>"
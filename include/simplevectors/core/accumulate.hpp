@@ -0,0 +1,526 @@
+/**
+ * @file accumulate.hpp
+ *
+ * @brief Accumulation policies for dot products and magnitudes.
+ *
+ * By default, dot() and magn() add every product into one accumulator of the
+ * component type. On large vectors, that loses accuracy, and every addition
+ * waits on the previous one. Passing a policy tag as the last argument, as in
+ * `svector::dot(a, b, svector::Kahan())`, selects another way to add:
+ *
+ * | Policy              | Speed                  | Error bound            |
+ * | ------------------- | ---------------------- | ---------------------- |
+ * | Naive               | one add chain          | grows with n           |
+ * | MultiAccumulator<K> | K add chains in flight | grows with n / K       |
+ * | Pairwise            | close to K chains      | grows with log(n)      |
+ * | Widened             | one add chain          | that of the wider type |
+ * | Kahan, Neumaier     | 2 to 4 times slower    | independent of n       |
+ * | Reproducible        | 5 to 6 times slower    | independent of n       |
+ *
+ * @note The compensated policies rely on the exact order of floating-point
+ * operations. They do not work with -ffast-math or similar options.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_ACCUMULATE_HPP_
+#define INCLUDE_SVECTOR_ACCUMULATE_HPP_
+
+#include <cmath>       // std::abs, std::frexp, std::isfinite, std::ldexp
+#include <cstddef>     // std::size_t
+#include <limits>      // std::numeric_limits
+#include <stdexcept>   // std::overflow_error
+#include <type_traits> // std::conditional, std::is_floating_point
+
+namespace svector {
+// COMBINER_PY_START
+/**
+ * @brief Adds every product into one accumulator, in order.
+ *
+ * This is what dot() and magn() do without a policy.
+ */
+struct Naive {};
+
+/**
+ * @brief Adds the products into K independent accumulators.
+ *
+ * The accumulators are added together at the end. The additions into
+ * different accumulators do not wait on each other, so the processor (or the
+ * compiler, with SIMD instructions) can run K of them at once.
+ *
+ * @tparam K The number of accumulators, a power of two.
+ */
+template <std::size_t K = 8> struct MultiAccumulator {
+  static_assert(K > 0 && (K & (K - 1)) == 0,
+                "The number of accumulators must be a power of two");
+};
+
+/**
+ * @brief Adds the products in a binary tree.
+ *
+ * The components are split in half until blocks of 128 are left, which are
+ * added with MultiAccumulator<8>. The rounding error grows with the
+ * logarithm of the number of dimensions rather than linearly.
+ */
+struct Pairwise {};
+
+/**
+ * @brief Multiplies and adds in a wider type.
+ *
+ * float components are added as double, double components as long double,
+ * and integers as long long (or unsigned long long), which also avoids
+ * overflow. The result is converted back to the component type at the end.
+ */
+struct Widened {};
+
+/**
+ * @brief Kahan summation.
+ *
+ * Keeps a running compensation for the low-order bits lost by each
+ * addition. Only for floating-point components.
+ */
+struct Kahan {};
+
+/**
+ * @brief Neumaier's improved Kahan summation.
+ *
+ * Like Kahan, but also correct when a product is larger than the running
+ * sum. Only for floating-point components.
+ */
+struct Neumaier {};
+
+/**
+ * @brief Gives the same result, bit for bit, whatever the order of the
+ * additions.
+ *
+ * The other policies give results that depend on the order the products are
+ * added in, which changes with the SIMD width of the machine and, for the
+ * array functions in reduce.hpp, with the number of threads. This policy
+ * rounds every product to a few fixed grids chosen from the largest product
+ * and the number of products, and adds the rounded parts exactly (Demmel
+ * and Nguyen's reproducible summation, with 3 grids). Since exact additions
+ * can happen in any order, the result only depends on the values.
+ *
+ * For up to a million doubles, the error is at most about
+ * n * max|product| * 2^-90, smaller than that of Kahan in most cases. float
+ * components are added as double, and integer components as usual, since
+ * integer addition is exact.
+ *
+ * @note Besides -ffast-math, fusing a multiplication and an addition into
+ * one instruction changes the result, so results are only the same across
+ * machines with -ffp-contract=off (GCC's default with -std=c++11, but not
+ * with -std=gnu++11).
+ */
+struct Reproducible {};
+
+namespace accumulate {
+/**
+ * @brief The type that Widened accumulates T in.
+ */
+template <typename T> struct Wider {
+  typedef typename std::conditional<std::is_signed<T>::value, long long,
+                                    unsigned long long>::type
+      type; //!< The wider type.
+};
+
+template <> struct Wider<float> {
+  typedef double type; //!< The wider type.
+};
+
+template <> struct Wider<double> {
+  typedef long double type; //!< The wider type.
+};
+
+template <> struct Wider<long double> {
+  typedef long double type; //!< The wider type.
+};
+
+/**
+ * @brief Calculates a dot product, adding in order.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+template <typename T>
+T dot(const T *lhs, const T *rhs, const std::size_t size, Naive) {
+  T result = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    result += lhs[i] * rhs[i];
+  }
+
+  return result;
+}
+
+/**
+ * @brief Calculates a dot product with K independent accumulators.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+template <typename T, std::size_t K>
+T dot(const T *lhs, const T *rhs, const std::size_t size,
+      MultiAccumulator<K>) {
+  T acc[K] = {};
+
+  const std::size_t blockSize = size - size % K;
+  std::size_t i = 0;
+  for (; i < blockSize; i += K) {
+    for (std::size_t k = 0; k < K; k++) {
+      acc[k] += lhs[i + k] * rhs[i + k];
+    }
+  }
+  for (; i < size; i++) {
+    acc[i - blockSize] += lhs[i] * rhs[i];
+  }
+
+  // add the accumulators in pairs too
+  for (std::size_t width = K / 2; width > 0; width /= 2) {
+    for (std::size_t k = 0; k < width; k++) {
+      acc[k] += acc[k + width];
+    }
+  }
+
+  return acc[0];
+}
+
+/**
+ * @brief Calculates a dot product by pairwise summation.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+template <typename T>
+T dot(const T *lhs, const T *rhs, const std::size_t size, Pairwise) {
+  if (size <= 128) {
+    return dot(lhs, rhs, size, MultiAccumulator<8>());
+  }
+
+  const std::size_t half = size / 2;
+  return dot(lhs, rhs, half, Pairwise()) +
+         dot(lhs + half, rhs + half, size - half, Pairwise());
+}
+
+/**
+ * @brief Calculates a dot product in a wider type.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+template <typename T>
+T dot(const T *lhs, const T *rhs, const std::size_t size, Widened) {
+  typedef typename Wider<T>::type wide;
+
+  wide result = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    result += static_cast<wide>(lhs[i]) * static_cast<wide>(rhs[i]);
+  }
+
+  return static_cast<T>(result);
+}
+
+/**
+ * @brief Calculates a dot product by Kahan summation.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+template <typename T>
+T dot(const T *lhs, const T *rhs, const std::size_t size, Kahan) {
+  static_assert(std::is_floating_point<T>::value,
+                "Kahan summation needs floating-point components");
+
+  T sum = 0;
+  T compensation = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    const T term = lhs[i] * rhs[i] - compensation;
+    const T next = sum + term;
+    compensation = (next - sum) - term;
+    sum = next;
+  }
+
+  return sum;
+}
+
+/**
+ * @brief Calculates a dot product by Neumaier summation.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+template <typename T>
+T dot(const T *lhs, const T *rhs, const std::size_t size, Neumaier) {
+  static_assert(std::is_floating_point<T>::value,
+                "Neumaier summation needs floating-point components");
+
+  T sum = 0;
+  T compensation = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    const T term = lhs[i] * rhs[i];
+    const T next = sum + term;
+    if (std::abs(sum) >= std::abs(term)) {
+      compensation += (sum - next) + term;
+    } else {
+      compensation += (term - next) + sum;
+    }
+    sum = next;
+  }
+
+  return sum + compensation;
+}
+
+/**
+ * @brief A sum that gives the same result, bit for bit, whatever the order
+ * of the additions and however it is split up.
+ *
+ * The largest absolute value and the number of values have to be known
+ * beforehand; the sums of parts of the same values can then be merged in
+ * any order. See Reproducible.
+ *
+ * @tparam T A floating-point type.
+ */
+template <typename T> class ReproducibleSum {
+  static_assert(std::is_floating_point<T>::value,
+                "ReproducibleSum needs a floating-point type");
+
+public:
+  static constexpr int LEVELS = 3; //!< The number of grids.
+
+  /**
+   * @brief Creates an empty sum for values up to a size.
+   *
+   * Throws an overflow_error exception if count * maxAbs is too close to
+   * the largest value of T.
+   *
+   * @param maxAbs The largest absolute value of all the values that will
+   * be added, including the ones added to other sums that will be merged.
+   * @param count The number of values, including those of the other sums.
+   */
+  ReproducibleSum(const T maxAbs, const std::size_t count)
+      : m_levels{0}, m_sigma(), m_sum() {
+    if (!std::isfinite(maxAbs)) {
+      // inf and nan just pass through as the result of the first grid
+      m_levels = -1;
+      return;
+    }
+    if (maxAbs == 0) {
+      return;
+    }
+
+    int countBits = 0;
+    while (countBits < std::numeric_limits<std::size_t>::digits - 1 &&
+           (std::size_t{1} << countBits) < count) {
+      countBits++;
+    }
+
+    // the grid of each level is the ulp of 1.5 * 2^exponent; the values it
+    // extracts are at most 2^(exponent - 1) and add up to at most
+    // 2^(exponent + 1), which T holds exactly on that grid
+    int maxExponent = 0;
+    std::frexp(maxAbs, &maxExponent);
+    int exponent = maxExponent + countBits + 1;
+    if (exponent >= std::numeric_limits<T>::max_exponent - 1) {
+      throw std::overflow_error("ReproducibleSum: values are too large");
+    }
+
+    for (; m_levels < LEVELS; m_levels++) {
+      if (exponent < std::numeric_limits<T>::min_exponent) {
+        break;
+      }
+      m_sigma[m_levels] = std::ldexp(T(1.5), exponent);
+
+      // what is left after a level is at most half its grid
+      exponent += countBits + 1 - std::numeric_limits<T>::digits;
+    }
+  }
+
+  /**
+   * @brief Adds a value, which must be at most maxAbs.
+   */
+  void add(T value) {
+    if (m_levels < 0) {
+      m_sum[0] += value;
+      return;
+    }
+
+    for (int level = 0; level < m_levels; level++) {
+      const T rounded = (m_sigma[level] + value) - m_sigma[level];
+      m_sum[level] += rounded;
+      value -= rounded;
+    }
+  }
+
+  /**
+   * @brief Adds an array of values, which must be at most maxAbs.
+   *
+   * Faster than adding them one at a time: the sums stay in registers, and
+   * since the additions are exact, the values are split between 4 sets of
+   * sums that do not wait on each other.
+   *
+   * @param values The values.
+   * @param count The number of values.
+   */
+  void add(const T *values, const std::size_t count) {
+    if (m_levels != LEVELS) {
+      for (std::size_t i = 0; i < count; i++) {
+        this->add(values[i]);
+      }
+      return;
+    }
+
+    const T sigma0 = m_sigma[0];
+    const T sigma1 = m_sigma[1];
+    const T sigma2 = m_sigma[2];
+    T sums[4][LEVELS] = {};
+
+    const std::size_t blockSize = count - count % 4;
+    for (std::size_t i = 0; i < blockSize; i += 4) {
+      for (std::size_t k = 0; k < 4; k++) {
+        T value = values[i + k];
+        T rounded = (sigma0 + value) - sigma0;
+        sums[k][0] += rounded;
+        value -= rounded;
+        rounded = (sigma1 + value) - sigma1;
+        sums[k][1] += rounded;
+        value -= rounded;
+        sums[k][2] += (sigma2 + value) - sigma2;
+      }
+    }
+    for (std::size_t i = blockSize; i < count; i++) {
+      this->add(values[i]);
+    }
+
+    for (std::size_t k = 0; k < 4; k++) {
+      for (int level = 0; level < LEVELS; level++) {
+        m_sum[level] += sums[k][level];
+      }
+    }
+  }
+
+  /**
+   * @brief Adds the values of another sum, made with the same maxAbs and
+   * count.
+   */
+  void merge(const ReproducibleSum &other) {
+    for (int level = 0; level < LEVELS; level++) {
+      m_sum[level] += other.m_sum[level];
+    }
+  }
+
+  /**
+   * @brief Gets the sum, rounded to T.
+   */
+  T result() const {
+    T result = 0;
+    for (int level = LEVELS - 1; level >= 0; level--) {
+      result += m_sum[level];
+    }
+
+    return result;
+  }
+
+private:
+  int m_levels; // -1 when the values are not finite
+  T m_sigma[LEVELS];
+  T m_sum[LEVELS];
+};
+
+/**
+ * @brief The type that Reproducible adds T in.
+ *
+ * float is added as double, where the products of two floats are exact and
+ * the sum keeps many more bits. long double is not widened, since it is a
+ * different type on different machines.
+ */
+template <typename T> struct ReproducibleType {
+  typedef T type; //!< The type to add in.
+};
+
+template <> struct ReproducibleType<float> {
+  typedef double type; //!< The type to add in.
+};
+
+namespace detail {
+/**
+ * @brief Calculates a dot product of integers, which is exact in any order.
+ */
+template <typename T>
+T reproducibleDot(const T *lhs, const T *rhs, const std::size_t size,
+                  std::false_type) {
+  return dot(lhs, rhs, size, Naive());
+}
+
+/**
+ * @brief Calculates a floating-point dot product with a ReproducibleSum.
+ *
+ * The products are calculated twice, once to find the largest one, so that
+ * only a block of them has to be stored at a time.
+ */
+template <typename T>
+T reproducibleDot(const T *lhs, const T *rhs, const std::size_t size,
+                  std::true_type) {
+  typedef typename ReproducibleType<T>::type wide;
+
+  wide maxAbs = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    const wide product = static_cast<wide>(lhs[i]) * static_cast<wide>(rhs[i]);
+    if (!std::isfinite(product)) {
+      maxAbs = std::numeric_limits<wide>::infinity();
+      break;
+    }
+    maxAbs = std::abs(product) > maxAbs ? std::abs(product) : maxAbs;
+  }
+
+  ReproducibleSum<wide> sum(maxAbs, size);
+  wide products[256];
+  for (std::size_t start = 0; start < size; start += 256) {
+    const std::size_t count = size - start < 256 ? size - start : 256;
+    for (std::size_t i = 0; i < count; i++) {
+      products[i] = static_cast<wide>(lhs[start + i]) *
+                    static_cast<wide>(rhs[start + i]);
+    }
+    sum.add(products, count);
+  }
+
+  return static_cast<T>(sum.result());
+}
+} // namespace detail
+
+/**
+ * @brief Calculates a dot product that does not depend on the order of the
+ * additions.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+template <typename T>
+T dot(const T *lhs, const T *rhs, const std::size_t size, Reproducible) {
+  return detail::reproducibleDot(lhs, rhs, size,
+                                 std::is_floating_point<T>());
+}
+} // namespace accumulate
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
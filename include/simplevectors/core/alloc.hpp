@@ -0,0 +1,442 @@
+/**
+ * @file alloc.hpp
+ *
+ * @brief Opt-in heap allocation tracking.
+ *
+ * Allocation tracking is off by default. In that case, the hooks expand to
+ * nothing, the statistics are always zero, and CountingAllocator behaves
+ * like std::allocator.
+ *
+ * To turn it on, define SVECTOR_TRACK_ALLOCS before including
+ * simplevectors. Allocations made through CountingAllocator are then
+ * counted. To also count every other allocation (std::string,
+ * std::vector, ...), write SVECTOR_DEFINE_ALLOC_HOOKS in exactly one source
+ * file of the program. This replaces the global operator new and operator
+ * delete with counting versions.
+ *
+ * Allocations are counted per thread. They are attributed to the innermost
+ * library function (or SVECTOR_ALLOC_SCOPE()) that is running when they
+ * happen.
+ *
+ * @note Define SVECTOR_TRACK_ALLOCS the same way in every translation unit
+ * of a program. Otherwise, the program breaks the one definition rule.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_ALLOC_HPP_
+#define INCLUDE_SVECTOR_ALLOC_HPP_
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t, std::uintptr_t
+#include <cstdlib> // std::malloc, std::free
+#include <new>     // std::bad_alloc, std::align_val_t
+#include <string>  // std::string
+#include <vector>  // std::vector
+
+#ifdef SVECTOR_TRACK_ALLOCS
+#include <cstring> // std::strcmp
+#endif
+
+namespace svector {
+// COMBINER_PY_START
+namespace alloc {
+/**
+ * @brief Allocation counts.
+ */
+struct Stats {
+  std::uint64_t allocations;   //!< Number of allocations.
+  std::uint64_t deallocations; //!< Number of deallocations.
+  std::uint64_t bytes;         //!< Total bytes allocated.
+};
+
+/**
+ * @brief Allocation counts attributed to one scope.
+ */
+struct Entry {
+  std::string scope;         //!< The library function or scope name.
+  std::uint64_t allocations; //!< Number of allocations.
+  std::uint64_t bytes;       //!< Total bytes allocated.
+};
+
+#ifdef SVECTOR_TRACK_ALLOCS
+#ifndef SVECTOR_ALLOC_MAX_SCOPES
+/**
+ * @brief Maximum number of distinct scope names counted per thread.
+ *
+ * Allocations in scopes past this limit are only counted in the totals.
+ */
+#define SVECTOR_ALLOC_MAX_SCOPES 64
+#endif
+
+#ifndef SVECTOR_ALLOC_MAX_DEPTH
+/**
+ * @brief Maximum nesting depth of scopes.
+ *
+ * Allocations in deeper scopes are attributed to the deepest tracked one.
+ */
+#define SVECTOR_ALLOC_MAX_DEPTH 32
+#endif
+
+namespace detail {
+/**
+ * @brief Counts of one scope name.
+ */
+struct ScopeCounts {
+  const char *name;
+  std::uint64_t allocations;
+  std::uint64_t bytes;
+};
+
+/**
+ * @brief Counts of one thread.
+ *
+ * This is a plain aggregate so that it is constant-initialized. Recording
+ * never allocates, which would otherwise recurse through operator new.
+ */
+struct ThreadState {
+  Stats totals;
+  ScopeCounts scopes[SVECTOR_ALLOC_MAX_SCOPES];
+  std::size_t numScopes;
+  const char *stack[SVECTOR_ALLOC_MAX_DEPTH];
+  std::size_t depth;
+};
+
+/**
+ * @brief Gets the counts of the calling thread.
+ */
+inline ThreadState &threadState() {
+  static thread_local ThreadState state;
+  return state;
+}
+
+/**
+ * @brief Counts an allocation.
+ *
+ * @param bytes The size of the allocation.
+ */
+inline void recordAllocation(const std::size_t bytes) {
+  ThreadState &state = threadState();
+  state.totals.allocations++;
+  state.totals.bytes += bytes;
+
+  if (state.depth == 0) {
+    return;
+  }
+
+  const std::size_t top = state.depth < SVECTOR_ALLOC_MAX_DEPTH
+                              ? state.depth - 1
+                              : SVECTOR_ALLOC_MAX_DEPTH - 1;
+  const char *name = state.stack[top];
+
+  for (std::size_t i = 0; i < state.numScopes; i++) {
+    ScopeCounts &scope = state.scopes[i];
+    if (scope.name == name || std::strcmp(scope.name, name) == 0) {
+      scope.allocations++;
+      scope.bytes += bytes;
+      return;
+    }
+  }
+
+  if (state.numScopes < SVECTOR_ALLOC_MAX_SCOPES) {
+    state.scopes[state.numScopes] = ScopeCounts{name, 1, bytes};
+    state.numScopes++;
+  }
+}
+
+/**
+ * @brief Counts a deallocation.
+ */
+inline void recordDeallocation() { threadState().totals.deallocations++; }
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SVECTOR_ALLOC_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define SVECTOR_ALLOC_NOINLINE __declspec(noinline)
+#else
+#define SVECTOR_ALLOC_NOINLINE
+#endif
+
+/**
+ * @brief Allocates and counts memory for the replaced operator new.
+ *
+ * This and release() are not inlined into the hooks. Otherwise GCC sees
+ * std::free() called on a pointer from a new expression and warns
+ * (-Wmismatched-new-delete), although the hooks pair them correctly.
+ */
+SVECTOR_ALLOC_NOINLINE inline void *allocate(const std::size_t size) {
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+
+  recordAllocation(size);
+  return ptr;
+}
+
+/**
+ * @brief Counts and frees memory from allocate().
+ */
+SVECTOR_ALLOC_NOINLINE inline void release(void *ptr) noexcept {
+  if (ptr != nullptr) {
+    recordDeallocation();
+    std::free(ptr);
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Attributes allocations to a name for the lifetime of the object.
+ *
+ * Use SVECTOR_ALLOC_SCOPE() rather than creating this directly.
+ */
+class Scope {
+public:
+  /**
+   * @brief Enters the scope.
+   *
+   * @param name A string literal naming the scope.
+   */
+  explicit Scope(const char *name) {
+    detail::ThreadState &state = detail::threadState();
+    if (state.depth < SVECTOR_ALLOC_MAX_DEPTH) {
+      state.stack[state.depth] = name;
+    }
+    state.depth++;
+  }
+
+  /**
+   * @brief Leaves the scope.
+   */
+  ~Scope() { detail::threadState().depth--; }
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+};
+
+/**
+ * @brief Gets the allocation totals of the calling thread.
+ *
+ * @returns The totals since the thread started or since the last reset().
+ */
+inline Stats threadStats() { return detail::threadState().totals; }
+
+/**
+ * @brief Gets the allocations of the calling thread by scope.
+ *
+ * @returns One entry for each scope that allocated.
+ */
+inline std::vector<Entry> threadSnapshot() {
+  const detail::ThreadState &state = detail::threadState();
+
+  std::vector<Entry> entries;
+  for (std::size_t i = 0; i < state.numScopes; i++) {
+    entries.push_back(Entry{state.scopes[i].name, state.scopes[i].allocations,
+                            state.scopes[i].bytes});
+  }
+
+  return entries;
+}
+
+/**
+ * @brief Sets the counts of the calling thread back to zero.
+ */
+inline void reset() {
+  detail::ThreadState &state = detail::threadState();
+  state.totals = Stats{0, 0, 0};
+  state.numScopes = 0;
+}
+
+#define SVECTOR_ALLOC_CONCAT_IMPL(a, b) a##b
+#define SVECTOR_ALLOC_CONCAT(a, b) SVECTOR_ALLOC_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Attributes allocations from here to the end of the enclosing scope
+ * to a name.
+ *
+ * @param name A string literal naming the scope.
+ */
+#define SVECTOR_ALLOC_SCOPE(name)                                              \
+  const ::svector::alloc::Scope SVECTOR_ALLOC_CONCAT(svectorAllocScope,        \
+                                                     __LINE__)(name)
+
+#if defined(__cpp_aligned_new) && __cpp_aligned_new >= 201606L
+namespace detail {
+/**
+ * @brief Allocates memory with an alignment larger than std::malloc gives.
+ *
+ * The pointer returned by std::malloc is stored just before the aligned
+ * block, so that alignedFree() can find it.
+ */
+inline void *alignedAllocate(const std::size_t size, const std::size_t align) {
+  void *raw = std::malloc(size + align + sizeof(void *));
+  if (raw == nullptr) {
+    return nullptr;
+  }
+
+  const std::uintptr_t start =
+      reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+  const std::uintptr_t aligned =
+      (start + align - 1) & ~static_cast<std::uintptr_t>(align - 1);
+  reinterpret_cast<void **>(aligned)[-1] = raw;
+  return reinterpret_cast<void *>(aligned);
+}
+
+/**
+ * @brief Frees memory from alignedAllocate().
+ */
+inline void alignedFree(void *ptr) {
+  std::free(static_cast<void **>(ptr)[-1]);
+}
+} // namespace detail
+
+/**
+ * @brief The over-aligned forms of the hooks, for types with an alignment
+ * larger than std::max_align_t.
+ */
+#define SVECTOR_DEFINE_ALIGNED_ALLOC_HOOKS                                     \
+  void *operator new(std::size_t size, std::align_val_t align) {               \
+    void *ptr = ::svector::alloc::detail::alignedAllocate(                     \
+        size == 0 ? 1 : size, static_cast<std::size_t>(align));                \
+    if (ptr == nullptr) {                                                      \
+      throw std::bad_alloc();                                                  \
+    }                                                                          \
+    ::svector::alloc::detail::recordAllocation(size);                          \
+    return ptr;                                                                \
+  }                                                                            \
+  void *operator new[](std::size_t size, std::align_val_t align) {             \
+    return operator new(size, align);                                          \
+  }                                                                            \
+  void operator delete(void *ptr, std::align_val_t) noexcept {                 \
+    if (ptr != nullptr) {                                                      \
+      ::svector::alloc::detail::recordDeallocation();                          \
+      ::svector::alloc::detail::alignedFree(ptr);                              \
+    }                                                                          \
+  }                                                                            \
+  void operator delete[](void *ptr, std::align_val_t align) noexcept {         \
+    operator delete(ptr, align);                                               \
+  }                                                                            \
+  void operator delete(void *ptr, std::size_t,                                 \
+                       std::align_val_t align) noexcept {                      \
+    operator delete(ptr, align);                                               \
+  }                                                                            \
+  void operator delete[](void *ptr, std::size_t,                               \
+                         std::align_val_t align) noexcept {                    \
+    operator delete(ptr, align);                                               \
+  }
+#else
+#define SVECTOR_DEFINE_ALIGNED_ALLOC_HOOKS
+#endif
+
+/**
+ * @brief Replaces the global operator new and operator delete with versions
+ * that count allocations.
+ *
+ * Write this at global scope in exactly one source file. The sized forms of
+ * operator delete and, in C++17, the over-aligned forms are replaced as
+ * well; the nothrow forms forward to these by default.
+ */
+#define SVECTOR_DEFINE_ALLOC_HOOKS                                             \
+  void *operator new(std::size_t size) {                                       \
+    return ::svector::alloc::detail::allocate(size);                           \
+  }                                                                            \
+  void *operator new[](std::size_t size) { return operator new(size); }        \
+  void operator delete(void *ptr) noexcept {                                   \
+    ::svector::alloc::detail::release(ptr);                                    \
+  }                                                                            \
+  void operator delete[](void *ptr) noexcept { operator delete(ptr); }         \
+  void operator delete(void *ptr, std::size_t) noexcept {                      \
+    operator delete(ptr);                                                      \
+  }                                                                            \
+  void operator delete[](void *ptr, std::size_t) noexcept {                    \
+    operator delete(ptr);                                                      \
+  }                                                                            \
+  SVECTOR_DEFINE_ALIGNED_ALLOC_HOOKS
+#else
+inline Stats threadStats() { return Stats{0, 0, 0}; }
+inline std::vector<Entry> threadSnapshot() { return std::vector<Entry>(); }
+inline void reset() {}
+
+#define SVECTOR_ALLOC_SCOPE(name) static_cast<void>(0)
+#define SVECTOR_DEFINE_ALLOC_HOOKS
+#endif
+
+/**
+ * @brief An allocator that counts its allocations.
+ *
+ * It can be used with standard containers to count their allocations
+ * without replacing the global operator new. Memory comes from std::malloc,
+ * so the allocations are not counted twice when SVECTOR_DEFINE_ALLOC_HOOKS
+ * is used as well.
+ *
+ * @tparam T The allocated type.
+ */
+template <typename T> class CountingAllocator {
+public:
+  typedef T value_type; //!< The allocated type.
+
+  CountingAllocator() noexcept = default;
+
+  /**
+   * @brief Converts from an allocator of another type.
+   */
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U> &) noexcept {}
+
+  /**
+   * @brief Allocates memory for n objects.
+   *
+   * Throws std::bad_alloc if the memory cannot be allocated.
+   *
+   * @param n The number of objects.
+   *
+   * @returns The uninitialized memory.
+   */
+  T *allocate(const std::size_t n) {
+    void *ptr = std::malloc(n * sizeof(T) == 0 ? 1 : n * sizeof(T));
+    if (ptr == nullptr) {
+      throw std::bad_alloc();
+    }
+
+#ifdef SVECTOR_TRACK_ALLOCS
+    detail::recordAllocation(n * sizeof(T));
+#endif
+    return static_cast<T *>(ptr);
+  }
+
+  /**
+   * @brief Frees memory from allocate().
+   *
+   * @param ptr The memory.
+   */
+  void deallocate(T *ptr, const std::size_t) noexcept {
+#ifdef SVECTOR_TRACK_ALLOCS
+    detail::recordDeallocation();
+#endif
+    std::free(ptr);
+  }
+};
+
+/**
+ * @brief Compares counting allocators, which are always equal.
+ */
+template <typename T, typename U>
+bool operator==(const CountingAllocator<T> &,
+                const CountingAllocator<U> &) noexcept {
+  return true;
+}
+
+/**
+ * @brief Compares counting allocators, which are always equal.
+ */
+template <typename T, typename U>
+bool operator!=(const CountingAllocator<T> &,
+                const CountingAllocator<U> &) noexcept {
+  return false;
+}
+} // namespace alloc
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
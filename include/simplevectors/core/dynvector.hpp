@@ -0,0 +1,594 @@
+/**
+ * @file dynvector.hpp
+ *
+ * @brief Contains a vector whose number of dimensions is chosen at runtime.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_DYNVECTOR_HPP_
+#define INCLUDE_SVECTOR_DYNVECTOR_HPP_
+
+#include <cmath>            // std::sqrt
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uintptr_t
+#include <initializer_list> // std::initializer_list
+#include <new>              // operator new, operator delete
+#include <stdexcept>        // std::invalid_argument, std::out_of_range
+#include <type_traits>      // std::is_arithmetic
+
+#include "simplevectors/core/alloc.hpp"      // SVECTOR_ALLOC_SCOPE
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_CALL
+#include "simplevectors/core/simd.hpp"
+#include "simplevectors/core/vector.hpp"
+
+namespace svector {
+// COMBINER_PY_START
+#ifndef SVECTOR_DYNVECTOR_ALIGNMENT
+/**
+ * @brief Alignment, in bytes, of the heap buffers of DynVector.
+ *
+ * The default is the size of a cache line, so SIMD loads never straddle
+ * two lines. It must be a power of two.
+ */
+#define SVECTOR_DYNVECTOR_ALIGNMENT 64
+#endif
+
+namespace detail {
+/**
+ * @brief Allocates a block aligned to SVECTOR_DYNVECTOR_ALIGNMENT, or to
+ * another alignment.
+ *
+ * Throws std::bad_alloc if the memory cannot be allocated.
+ *
+ * @param bytes The size of the block.
+ * @param alignment The alignment, a power of two.
+ *
+ * @returns The block, to be freed with alignedFree().
+ */
+inline void *
+alignedAllocate(const std::size_t bytes,
+                const std::size_t alignment = SVECTOR_DYNVECTOR_ALIGNMENT) {
+  // room to align the block and to store the pointer from operator new in
+  // front of it
+  void *raw = ::operator new(bytes + alignment + sizeof(void *));
+
+  const std::uintptr_t first =
+      reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *);
+  const std::uintptr_t address =
+      (first + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+
+  void **aligned = reinterpret_cast<void **>(address);
+  aligned[-1] = raw;
+  return aligned;
+}
+
+/**
+ * @brief Frees a block from alignedAllocate().
+ *
+ * @param ptr The block, or nullptr.
+ */
+inline void alignedFree(void *ptr) noexcept {
+  if (ptr != nullptr) {
+    ::operator delete(static_cast<void **>(ptr)[-1]);
+  }
+}
+} // namespace detail
+
+/**
+ * @brief A vector whose number of dimensions is chosen at runtime.
+ *
+ * Up to N components are stored inside the object, so small vectors never
+ * touch the heap. Larger vectors spill to a heap buffer aligned to
+ * SVECTOR_DYNVECTOR_ALIGNMENT. Choose N to fit the sizes a program usually
+ * uses, keeping in mind that every DynVector is at least N components
+ * large.
+ *
+ * The operations on float and double components use the SIMD kernels in
+ * simd.hpp. Binary operations throw std::invalid_argument if the two
+ * vectors have different sizes.
+ *
+ * @tparam T Vector type.
+ * @tparam N The number of components stored without heap allocation.
+ */
+template <typename T = double, std::size_t N = 16> class DynVector {
+public:
+  // makes sure that type is numeric
+  static_assert(std::is_arithmetic<T>::value, "Vector type must be numeric");
+  static_assert(N > 0, "Inline capacity must be at least 1");
+
+  typedef T value_type;            //!< The component type.
+  typedef T *iterator;             //!< An iterator over the components.
+  typedef const T *const_iterator; //!< A constant iterator.
+
+  /**
+   * @brief No-argument constructor
+   *
+   * Creates a vector with no dimensions.
+   */
+  DynVector() noexcept : m_data{m_inline}, m_size{0}, m_capacity{N} {}
+
+  /**
+   * @brief Creates a zero vector.
+   *
+   * @param size The number of dimensions.
+   */
+  explicit DynVector(const std::size_t size) : DynVector() {
+    this->resize(size);
+  }
+
+  /**
+   * @brief Creates a vector with every component set to a value.
+   *
+   * @param size The number of dimensions.
+   * @param value The value of each component.
+   */
+  DynVector(const std::size_t size, const T value) : DynVector() {
+    this->allocate(size);
+    for (std::size_t i = 0; i < size; i++) {
+      this->m_data[i] = value;
+    }
+  }
+
+  /**
+   * @brief Initializes a vector given initializer list
+   *
+   * The vector has one dimension for each element in the list.
+   *
+   * @param args the initializer list.
+   */
+  DynVector(const std::initializer_list<T> args) : DynVector() {
+    this->allocate(args.size());
+
+    std::size_t counter = 0;
+    for (const auto &num : args) {
+      this->m_data[counter] = num;
+      counter++;
+    }
+  }
+
+  /**
+   * @brief Copies the components of a buffer.
+   *
+   * @param data A pointer to the first component.
+   * @param size The number of dimensions.
+   */
+  DynVector(const T *data, const std::size_t size) : DynVector() {
+    this->allocate(size);
+    for (std::size_t i = 0; i < size; i++) {
+      this->m_data[i] = data[i];
+    }
+  }
+
+  /**
+   * @brief Copies the components of a fixed-size vector.
+   *
+   * @param vec The vector.
+   */
+  template <std::size_t D>
+  explicit DynVector(const Vector<D, T> &vec) : DynVector() {
+    this->allocate(D);
+    for (std::size_t i = 0; i < D; i++) {
+      this->m_data[i] = vec[i];
+    }
+  }
+
+  /**
+   * @brief Copy constructor
+   */
+  DynVector(const DynVector<T, N> &other)
+      : DynVector(other.m_data, other.m_size) {}
+
+  /**
+   * @brief Move constructor
+   *
+   * Takes over the heap buffer of the other vector, which becomes empty.
+   */
+  DynVector(DynVector<T, N> &&other) noexcept : DynVector() {
+    this->steal(other);
+  }
+
+  /**
+   * @brief Assignment operator
+   *
+   * Reuses the current buffer if it is large enough.
+   */
+  DynVector<T, N> &operator=(const DynVector<T, N> &other) {
+    // check if assigning to self
+    if (this == &other) {
+      return *this;
+    }
+
+    this->allocate(other.m_size);
+    for (std::size_t i = 0; i < other.m_size; i++) {
+      this->m_data[i] = other.m_data[i];
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Move assignment operator
+   *
+   * Takes over the heap buffer of the other vector, which becomes empty.
+   */
+  DynVector<T, N> &operator=(DynVector<T, N> &&other) noexcept {
+    if (this != &other) {
+      this->release();
+      this->steal(other);
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Destructor
+   */
+  ~DynVector() { this->release(); }
+
+  /**
+   * @brief Negates a vector.
+   *
+   * @returns A new vector where each component is negated.
+   */
+  DynVector<T, N> operator-() const {
+    DynVector<T, N> tmp;
+    tmp.allocate(this->m_size);
+    for (std::size_t i = 0; i < this->m_size; i++) {
+      tmp[i] = -this->m_data[i];
+    }
+
+    return tmp;
+  }
+
+  /**
+   * @brief Unary plus
+   *
+   * @returns A copy of the vector.
+   */
+  DynVector<T, N> operator+() const { return *this; }
+
+  /**
+   * @brief Adds another vector to the current vector.
+   *
+   * @param other The other vector, with the same size.
+   *
+   * @returns A reference to the modified vector.
+   */
+  DynVector<T, N> &operator+=(const DynVector<T, N> &other) {
+    this->checkSize(other);
+    simd::add(this->m_data, other.m_data, this->m_data, this->m_size);
+    return *this;
+  }
+
+  /**
+   * @brief Subtracts another vector from the current vector.
+   *
+   * @param other The other vector, with the same size.
+   *
+   * @returns A reference to the modified vector.
+   */
+  DynVector<T, N> &operator-=(const DynVector<T, N> &other) {
+    this->checkSize(other);
+    simd::subtract(this->m_data, other.m_data, this->m_data, this->m_size);
+    return *this;
+  }
+
+  /**
+   * @brief Multiplies the current vector by a scalar.
+   *
+   * @param other The scalar.
+   *
+   * @returns A reference to the modified vector.
+   */
+  DynVector<T, N> &operator*=(const T other) {
+    simd::multiply(this->m_data, other, this->m_data, this->m_size);
+    return *this;
+  }
+
+  /**
+   * @brief Divides the current vector by a scalar.
+   *
+   * @param other The scalar.
+   *
+   * @returns A reference to the modified vector.
+   */
+  DynVector<T, N> &operator/=(const T other) {
+    simd::divide(this->m_data, other, this->m_data, this->m_size);
+    return *this;
+  }
+
+  /**
+   * @brief Dot product
+   *
+   * @param other The other vector, with the same size.
+   *
+   * @returns The dot product of the two vectors.
+   */
+  T dot(const DynVector<T, N> &other) const {
+    this->checkSize(other);
+    return simd::dot(this->m_data, other.m_data, this->m_size);
+  }
+
+  /**
+   * @brief Magnitude
+   *
+   * @returns The magnitude of the vector.
+   */
+  T magn() const {
+    SVECTOR_INSTRUMENT_CALL("magn", 0, T);
+    return this->magnitude();
+  }
+
+  /**
+   * @brief Normalizes a vector.
+   *
+   * @note This method will result in undefined behavior if the vector is a zero
+   * vector (if the magnitude equals zero).
+   *
+   * @returns A new vector representing the normalized vector.
+   */
+  DynVector<T, N> normalize() const {
+    SVECTOR_INSTRUMENT_CALL("normalize", 0, T);
+
+    DynVector<T, N> tmp;
+    tmp.allocate(this->m_size);
+    simd::divide(this->m_data, this->magnitude(), tmp.m_data, this->m_size);
+    return tmp;
+  }
+
+  /**
+   * @brief Determines whether the current vector is a zero vector.
+   *
+   * @returns Whether the current vector is a zero vector.
+   */
+  bool isZero() const { return this->magnitude() == 0; }
+
+  /**
+   * @brief Gets the number of dimensions.
+   *
+   * @returns Number of dimensions.
+   */
+  std::size_t size() const noexcept { return this->m_size; }
+
+  /**
+   * @brief Gets the number of dimensions.
+   *
+   * @returns Number of dimensions.
+   */
+  std::size_t numDimensions() const noexcept { return this->m_size; }
+
+  /**
+   * @brief Gets the number of components that fit in the current buffer.
+   *
+   * @returns At least N.
+   */
+  std::size_t capacity() const noexcept { return this->m_capacity; }
+
+  /**
+   * @brief Determines whether the components are stored inside the object.
+   *
+   * @returns Whether the vector has no heap buffer.
+   */
+  bool isInline() const noexcept { return this->m_data == this->m_inline; }
+
+  /**
+   * @brief Changes the number of dimensions.
+   *
+   * Existing components are kept, and new components are 0. Growing past the
+   * capacity moves the components to a new heap buffer.
+   *
+   * @param size The new number of dimensions.
+   */
+  void resize(const std::size_t size) {
+    const std::size_t oldSize = this->m_size;
+    if (size > this->m_capacity) {
+      SVECTOR_ALLOC_SCOPE("DynVector");
+      T *data = static_cast<T *>(detail::alignedAllocate(size * sizeof(T)));
+      for (std::size_t i = 0; i < oldSize; i++) {
+        data[i] = this->m_data[i];
+      }
+
+      this->release();
+      this->m_data = data;
+      this->m_capacity = size;
+    }
+
+    for (std::size_t i = oldSize; i < size; i++) {
+      this->m_data[i] = 0;
+    }
+    this->m_size = size;
+  }
+
+  /**
+   * @brief Gets the pointer to the first component.
+   *
+   * @returns The components, stored next to each other.
+   */
+  T *data() noexcept { return this->m_data; }
+
+  /**
+   * @brief Gets the pointer to the first component.
+   *
+   * @returns The components, stored next to each other.
+   */
+  const T *data() const noexcept { return this->m_data; }
+
+  /**
+   * @brief Value of a certain component of a vector
+   *
+   * @param index The dimension number.
+   *
+   * @returns A constant reference to that dimension's component of the vector.
+   */
+  const T &operator[](const std::size_t index) const {
+    return this->m_data[index];
+  }
+
+  /**
+   * @brief Sets value of a certain component
+   *
+   * @param index The dimension number.
+   */
+  T &operator[](const std::size_t index) { return this->m_data[index]; }
+
+  /**
+   * @brief Value of a certain component of a vector
+   *
+   * Throws an out_of_range exception if the given number is out of bounds.
+   *
+   * @param index The dimension number.
+   *
+   * @returns A constant reference to that dimension's component of the vector.
+   */
+  const T &at(const std::size_t index) const {
+    if (index >= this->m_size) {
+      throw std::out_of_range("DynVector::at: index out of range");
+    }
+
+    return this->m_data[index];
+  }
+
+  /**
+   * @brief Sets value of a certain component
+   *
+   * Throws an out_of_range exception if the given number is out of bounds.
+   *
+   * @param index The dimension number.
+   */
+  T &at(const std::size_t index) {
+    if (index >= this->m_size) {
+      throw std::out_of_range("DynVector::at: index out of range");
+    }
+
+    return this->m_data[index];
+  }
+
+  /**
+   * @brief Iterator of first element
+   *
+   * @returns An iterator to the first dimension of the vector.
+   */
+  iterator begin() noexcept { return this->m_data; }
+
+  /**
+   * @brief Const interator of first element
+   *
+   * @returns A constant iterator to the first dimension of the vector.
+   */
+  const_iterator begin() const noexcept { return this->m_data; }
+
+  /**
+   * @brief Interator of last element + 1
+   *
+   * @returns An iterator to the element following the last dimension.
+   */
+  iterator end() noexcept { return this->m_data + this->m_size; }
+
+  /**
+   * @brief Const interator of last element + 1
+   *
+   * @returns A constant iterator to the element following the last dimension.
+   */
+  const_iterator end() const noexcept { return this->m_data + this->m_size; }
+
+  /**
+   * @brief Converts to a fixed-size vector.
+   *
+   * Throws an invalid_argument exception if the vector does not have exactly
+   * D dimensions.
+   *
+   * @tparam D The number of dimensions.
+   *
+   * @returns A vector with a copy of the components.
+   */
+  template <std::size_t D> Vector<D, T> toVector() const {
+    if (this->m_size != D) {
+      throw std::invalid_argument(
+          "DynVector::toVector: number of dimensions does not match");
+    }
+
+    Vector<D, T> vec;
+    for (std::size_t i = 0; i < D; i++) {
+      vec[i] = this->m_data[i];
+    }
+
+    return vec;
+  }
+
+private:
+  T *m_data;
+  std::size_t m_size;
+  std::size_t m_capacity;
+  T m_inline[N];
+
+  /**
+   * @brief Magnitude, without counting a call to magn().
+   */
+  T magnitude() const {
+    return std::sqrt(simd::dot(this->m_data, this->m_data, this->m_size));
+  }
+
+  /**
+   * @brief Throws if another vector has a different size.
+   */
+  void checkSize(const DynVector<T, N> &other) const {
+    if (this->m_size != other.m_size) {
+      throw std::invalid_argument("DynVector sizes do not match");
+    }
+  }
+
+  /**
+   * @brief Sets the size without keeping the components.
+   */
+  void allocate(const std::size_t size) {
+    if (size > this->m_capacity) {
+      SVECTOR_ALLOC_SCOPE("DynVector");
+      T *data = static_cast<T *>(detail::alignedAllocate(size * sizeof(T)));
+      this->release();
+      this->m_data = data;
+      this->m_capacity = size;
+    }
+
+    this->m_size = size;
+  }
+
+  /**
+   * @brief Frees the heap buffer, if any, and goes back to the inline one.
+   */
+  void release() noexcept {
+    if (!this->isInline()) {
+      detail::alignedFree(this->m_data);
+    }
+
+    this->m_data = this->m_inline;
+    this->m_size = 0;
+    this->m_capacity = N;
+  }
+
+  /**
+   * @brief Takes the contents of another vector, leaving it empty.
+   *
+   * The current vector must have no heap buffer.
+   */
+  void steal(DynVector<T, N> &other) noexcept {
+    if (other.isInline()) {
+      for (std::size_t i = 0; i < other.m_size; i++) {
+        this->m_inline[i] = other.m_inline[i];
+      }
+    } else {
+      this->m_data = other.m_data;
+      this->m_capacity = other.m_capacity;
+    }
+    this->m_size = other.m_size;
+
+    other.m_data = other.m_inline;
+    other.m_size = 0;
+    other.m_capacity = N;
+  }
+};
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
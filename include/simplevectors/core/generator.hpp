@@ -0,0 +1,371 @@
+/**
+ * @file generator.hpp
+ *
+ * @brief Contains C++20 coroutine generators that stream chunks of vectors.
+ *
+ * Everything in this file needs C++20 coroutines. When the compiler does
+ * not support them, SVECTOR_HAS_COROUTINES is not defined and this file is
+ * empty, so it can always be included.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_GENERATOR_HPP_
+#define INCLUDE_SVECTOR_GENERATOR_HPP_
+
+#if defined(__has_include)
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine) &&           \
+    (__cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L))
+#define SVECTOR_HAS_COROUTINES
+#endif
+#endif
+
+#ifdef SVECTOR_HAS_COROUTINES
+#include <algorithm> // std::min
+#include <coroutine> // std::coroutine_handle, std::suspend_always
+#include <cstddef>   // std::size_t, std::ptrdiff_t
+#include <exception> // std::exception_ptr, std::rethrow_exception
+#include <istream>   // std::istream, std::streamsize
+#include <iterator>  // std::input_iterator_tag
+#include <memory>    // std::addressof
+#include <span>      // std::span
+#include <stdexcept> // std::invalid_argument
+#include <utility>   // std::exchange, std::move
+#include <vector>    // std::vector
+
+#include "simplevectors/core/pipeline.hpp" // svector::Pipeline
+#include "simplevectors/core/vector.hpp"   // svector::Vector
+#endif
+
+namespace svector {
+// COMBINER_PY_START
+#ifdef SVECTOR_HAS_COROUTINES
+#ifndef SVECTOR_STREAM_CHUNK_SIZE
+/**
+ * @brief The default number of vectors in each chunk of a stream.
+ */
+#define SVECTOR_STREAM_CHUNK_SIZE 4096
+#endif
+
+/**
+ * @brief A coroutine that produces values one at a time, when they are
+ * asked for.
+ *
+ * The coroutine runs only while the caller is waiting for the next value,
+ * and is suspended at each co_yield until the caller asks again. A yielded
+ * value stays valid until then. Exceptions thrown by the coroutine are
+ * rethrown to the caller.
+ *
+ * It can be used in a range-based for loop, or with next() and value().
+ *
+ * @tparam T The type of the values.
+ */
+template <typename T> class Generator {
+public:
+  /**
+   * @brief The promise type used by the compiler.
+   */
+  class promise_type {
+  public:
+    Generator get_return_object() {
+      return Generator{
+          std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+
+    std::suspend_always yield_value(const T &value) noexcept {
+      m_value = std::addressof(value);
+      return {};
+    }
+
+    void return_void() noexcept {}
+    void unhandled_exception() { m_error = std::current_exception(); }
+
+    // a generator cannot wait for anything else
+    template <typename U> void await_transform(U &&) = delete;
+
+    const T &value() const { return *m_value; }
+
+    void rethrow() const {
+      if (m_error) {
+        std::rethrow_exception(m_error);
+      }
+    }
+
+  private:
+    const T *m_value = nullptr;
+    std::exception_ptr m_error;
+  };
+
+  /**
+   * @brief An input iterator over the values.
+   */
+  class iterator {
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef std::ptrdiff_t difference_type;
+    typedef T value_type;
+    typedef const T &reference;
+    typedef const T *pointer;
+
+    iterator() = default;
+    explicit iterator(Generator *generator) : m_generator{generator} {}
+
+    reference operator*() const { return m_generator->value(); }
+    pointer operator->() const { return std::addressof(**this); }
+
+    iterator &operator++() {
+      if (!m_generator->next()) {
+        m_generator = nullptr;
+      }
+      return *this;
+    }
+
+    void operator++(int) { ++*this; }
+
+    bool operator==(const iterator &other) const {
+      return m_generator == other.m_generator;
+    }
+
+  private:
+    Generator *m_generator = nullptr;
+  };
+
+  Generator(const Generator &) = delete;
+  Generator &operator=(const Generator &) = delete;
+
+  Generator(Generator &&other) noexcept
+      : m_handle{std::exchange(other.m_handle, nullptr)} {}
+
+  Generator &operator=(Generator &&other) noexcept {
+    if (this != &other) {
+      this->destroy();
+      m_handle = std::exchange(other.m_handle, nullptr);
+    }
+    return *this;
+  }
+
+  ~Generator() { this->destroy(); }
+
+  /**
+   * @brief Runs the coroutine until its next value.
+   *
+   * @returns Whether there is a next value; false once the coroutine ends.
+   */
+  bool next() {
+    if (!m_handle || m_handle.done()) {
+      return false;
+    }
+
+    m_handle.resume();
+    m_handle.promise().rethrow();
+    return !m_handle.done();
+  }
+
+  /**
+   * @brief Gets the current value, after next() returned true.
+   */
+  const T &value() const { return m_handle.promise().value(); }
+
+  /**
+   * @brief Runs the coroutine until its first value.
+   */
+  iterator begin() { return this->next() ? iterator{this} : iterator{}; }
+
+  /**
+   * @brief Gets the iterator that stands for the end of the values.
+   */
+  iterator end() { return iterator{}; }
+
+private:
+  std::coroutine_handle<promise_type> m_handle;
+
+  explicit Generator(const std::coroutine_handle<promise_type> handle)
+      : m_handle{handle} {}
+
+  void destroy() {
+    if (m_handle) {
+      m_handle.destroy();
+    }
+  }
+};
+
+/**
+ * @brief A stream of chunks of vectors.
+ *
+ * Each chunk is a span that stays valid until the next chunk is asked for.
+ * The stages below reuse one buffer each, so a chain of stages keeps at
+ * most one chunk per stage in memory, however long the stream is. Since a
+ * stage only runs when the stage after it asks for a chunk, a slow consumer
+ * slows down the whole chain instead of letting chunks pile up.
+ */
+template <typename V> using VectorStream = Generator<std::span<const V>>;
+
+namespace detail {
+/**
+ * @brief Gets the number of vectors in each chunk of a stream, where 0
+ * means the default, as for Pipeline.
+ */
+inline std::size_t streamChunkSize(const std::size_t chunkSize) {
+  return chunkSize == 0 ? SVECTOR_STREAM_CHUNK_SIZE : chunkSize;
+}
+} // namespace detail
+
+namespace stream {
+/**
+ * @brief Streams an array in chunks, without copying it.
+ *
+ * @param data The vectors, which must outlive the stream.
+ * @param size The number of vectors.
+ * @param chunkSize The number of vectors in each chunk. 0 means the default.
+ *
+ * @returns The stream.
+ */
+template <typename V>
+VectorStream<V>
+fromArray(const V *data, const std::size_t size,
+          const std::size_t chunkSize = SVECTOR_STREAM_CHUNK_SIZE) {
+  const std::size_t length = detail::streamChunkSize(chunkSize);
+  for (std::size_t start = 0; start < size; start += length) {
+    co_yield std::span<const V>(data + start, std::min(length, size - start));
+  }
+}
+
+/**
+ * @brief Parses vectors from text, with D whitespace-separated numbers for
+ * each vector.
+ *
+ * The stream throws an invalid_argument exception if it finds something
+ * that is not a number, or if the last vector is not complete.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ *
+ * @param in The text to read, which must outlive the stream.
+ * @param chunkSize The number of vectors in each chunk. 0 means the default.
+ *
+ * @returns The stream.
+ */
+template <std::size_t D, typename T = double>
+VectorStream<Vector<D, T>>
+readText(std::istream &in,
+         const std::size_t chunkSize = SVECTOR_STREAM_CHUNK_SIZE) {
+  std::vector<Vector<D, T>> buffer(detail::streamChunkSize(chunkSize));
+  std::size_t count = 0;
+  while (true) {
+    std::size_t read = 0;
+    while (read < D && in >> buffer[count][read]) {
+      read++;
+    }
+
+    if (read == 0) {
+      break;
+    }
+    if (read < D) {
+      throw std::invalid_argument("readText: incomplete vector");
+    }
+
+    if (++count == buffer.size()) {
+      co_yield std::span<const Vector<D, T>>(buffer.data(), count);
+      count = 0;
+    }
+  }
+
+  if (!in.eof()) {
+    throw std::invalid_argument("readText: not a number");
+  }
+  if (count > 0) {
+    co_yield std::span<const Vector<D, T>>(buffer.data(), count);
+  }
+}
+
+/**
+ * @brief Reads vectors stored as raw components, D at a time, in the byte
+ * order of this machine.
+ *
+ * The stream throws an invalid_argument exception if the data ends in the
+ * middle of a vector.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ *
+ * @param in The data to read, opened in binary mode, which must outlive
+ * the stream.
+ * @param chunkSize The number of vectors in each chunk. 0 means the default.
+ *
+ * @returns The stream.
+ */
+template <std::size_t D, typename T = double>
+VectorStream<Vector<D, T>>
+readBinary(std::istream &in,
+           const std::size_t chunkSize = SVECTOR_STREAM_CHUNK_SIZE) {
+  std::vector<Vector<D, T>> buffer(detail::streamChunkSize(chunkSize));
+  std::vector<T> components(buffer.size() * D);
+  while (in) {
+    in.read(reinterpret_cast<char *>(components.data()),
+            static_cast<std::streamsize>(components.size() * sizeof(T)));
+    const std::size_t bytes = static_cast<std::size_t>(in.gcount());
+    if (bytes % (D * sizeof(T)) != 0) {
+      throw std::invalid_argument("readBinary: incomplete vector");
+    }
+
+    const std::size_t count = bytes / (D * sizeof(T));
+    for (std::size_t i = 0; i < count; i++) {
+      for (std::size_t j = 0; j < D; j++) {
+        buffer[i][j] = components[i * D + j];
+      }
+    }
+
+    if (count > 0) {
+      co_yield std::span<const Vector<D, T>>(buffer.data(), count);
+    }
+  }
+}
+
+/**
+ * @brief Runs a pipeline over each chunk of a stream.
+ *
+ * Chunks with no vectors left after the pipeline are skipped.
+ *
+ * @param source The stream to read from.
+ * @param steps The pipeline to run.
+ *
+ * @returns The stream of the vectors that are left.
+ */
+template <typename V>
+VectorStream<V> pipe(VectorStream<V> source, const Pipeline<V> steps) {
+  std::vector<V> buffer;
+  for (const std::span<const V> chunk : source) {
+    buffer.resize(chunk.size());
+    const std::size_t left =
+        steps.run(chunk.data(), chunk.size(), buffer.data());
+    if (left > 0) {
+      co_yield std::span<const V>(buffer.data(), left);
+    }
+  }
+}
+
+/**
+ * @brief Reads every chunk of a stream into one vector.
+ *
+ * @param source The stream to read from.
+ *
+ * @returns Every vector of the stream, in order.
+ */
+template <typename V> std::vector<V> collect(VectorStream<V> source) {
+  std::vector<V> result;
+  for (const std::span<const V> chunk : source) {
+    result.insert(result.end(), chunk.begin(), chunk.end());
+  }
+
+  return result;
+}
+} // namespace stream
+#endif
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
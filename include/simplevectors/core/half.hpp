@@ -0,0 +1,550 @@
+/**
+ * @file half.hpp
+ *
+ * @brief 16-bit storage types for arrays of components.
+ *
+ * svector::Half is an IEEE 754 half-precision float (the same bits as
+ * `_Float16`), and svector::BFloat16 is the upper half of a float. Both
+ * are only meant for storage: they convert to float, and the functions in
+ * svector::half compute in float.
+ *
+ * The conversions between Half and float use F16C instructions when the
+ * compiler targets them (for example with -mf16c or -march=native), and a
+ * software version otherwise. Both round to nearest, ties to even, so they
+ * give the same results. The BFloat16 kernels use SSE2 where available.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_HALF_HPP_
+#define INCLUDE_SVECTOR_HALF_HPP_
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint16_t, std::uint32_t
+#include <cstring> // std::memcpy
+
+#include "simplevectors/core/simd.hpp"   // SVECTOR_SIMD_AVX, SVECTOR_SIMD_SSE2
+#include "simplevectors/core/vector.hpp" // svector::Vector
+
+#if defined(SVECTOR_SIMD_AVX) && defined(__F16C__)
+#define SVECTOR_SIMD_F16C
+#endif
+
+namespace svector {
+// COMBINER_PY_START
+namespace detail {
+/**
+ * @brief Converts a float to the bits of a half-precision float.
+ *
+ * Rounds to nearest, ties to even. Values too large for a half become
+ * infinity, and NaNs stay NaNs.
+ */
+inline std::uint16_t floatToHalf(const float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  const std::uint32_t sign = (bits >> 16) & 0x8000U;
+  const std::uint32_t absBits = bits & 0x7FFFFFFFU;
+
+  if (absBits >= 0x7F800000U) {
+    // infinity, or NaN (made quiet, keeping the upper bits of the payload)
+    const std::uint32_t nan =
+        absBits > 0x7F800000U ? 0x200U | ((absBits >> 13) & 0x3FFU) : 0;
+    return static_cast<std::uint16_t>(sign | 0x7C00U | nan);
+  }
+  if (absBits >= 0x477FF000U) {
+    // 65520 and above round to infinity
+    return static_cast<std::uint16_t>(sign | 0x7C00U);
+  }
+  if (absBits >= 0x38800000U) {
+    // normal: rebias the exponent and round away the low 13 bits
+    const std::uint32_t rounded = absBits + 0xFFFU + ((absBits >> 13) & 1U);
+    return static_cast<std::uint16_t>(sign | ((rounded - 0x38000000U) >> 13));
+  }
+  if (absBits <= 0x33000000U) {
+    // 2^-25 and below round to zero
+    return static_cast<std::uint16_t>(sign);
+  }
+
+  // subnormal: the result is the full mantissa shifted right and rounded
+  const std::uint32_t shift = 126 - (absBits >> 23);
+  const std::uint32_t mantissa = (absBits & 0x7FFFFFU) | 0x800000U;
+  const std::uint32_t halfway = 1U << (shift - 1);
+  const std::uint32_t remainder = mantissa & ((1U << shift) - 1);
+  std::uint32_t result = mantissa >> shift;
+  if (remainder > halfway || (remainder == halfway && (result & 1U) != 0)) {
+    result++;
+  }
+
+  return static_cast<std::uint16_t>(sign | result);
+}
+
+/**
+ * @brief Converts the bits of a half-precision float to a float.
+ *
+ * This is exact, except that NaNs are made quiet.
+ */
+inline float halfToFloat(const std::uint16_t half) {
+  // move the exponent and mantissa into place and rebias the exponent
+  std::uint32_t bits = static_cast<std::uint32_t>(half & 0x7FFFU) << 13;
+  const std::uint32_t exponent = bits & 0x0F800000U;
+  bits += 0x38000000U;
+
+  if (exponent == 0x0F800000U) {
+    // infinity, or NaN (made quiet)
+    bits += 0x38000000U;
+    if ((bits & 0x7FFFFFU) != 0) {
+      bits |= 0x400000U;
+    }
+  } else if (exponent == 0) {
+    // zero or subnormal: let the float unit normalize it
+    bits += 0x800000U;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    value -= 6.103515625e-05F; // 2^-14
+    std::memcpy(&bits, &value, sizeof(bits));
+  }
+
+  bits |= static_cast<std::uint32_t>(half & 0x8000U) << 16;
+
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+/**
+ * @brief Converts a float to the bits of a bfloat16.
+ *
+ * Rounds to nearest, ties to even. NaNs stay NaNs.
+ */
+inline std::uint16_t floatToBFloat16(const float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  // no branches, so that loops over arrays are vectorized
+  const std::uint32_t rounded = (bits + 0x7FFFU + ((bits >> 16) & 1U)) >> 16;
+  const std::uint32_t quiet = (bits >> 16) | 0x40U;
+  return static_cast<std::uint16_t>(
+      (bits & 0x7FFFFFFFU) > 0x7F800000U ? quiet : rounded);
+}
+
+/**
+ * @brief Converts the bits of a bfloat16 to a float.
+ *
+ * This is exact.
+ */
+inline float bfloat16ToFloat(const std::uint16_t bfloat) {
+  const std::uint32_t bits = static_cast<std::uint32_t>(bfloat) << 16;
+
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+} // namespace detail
+
+/**
+ * @brief An IEEE 754 half-precision float, for storage.
+ *
+ * It has 1 sign bit, 5 exponent bits, and 10 mantissa bits, so it holds
+ * about 3 significant decimal digits, up to 65504. It converts implicitly
+ * to float; the conversion from float is explicit because it rounds.
+ */
+class Half {
+public:
+  /**
+   * @brief Leaves the bits uninitialized, like a float.
+   */
+  Half() = default;
+
+  /**
+   * @brief Rounds a float to the nearest half.
+   *
+   * @param value The value to round.
+   */
+  explicit Half(const float value) : m_bits(detail::floatToHalf(value)) {}
+
+  /**
+   * @brief Creates a half from its bits.
+   *
+   * @param bits The bits, as stored in memory.
+   *
+   * @returns The half.
+   */
+  static Half fromBits(const std::uint16_t bits) {
+    Half half;
+    half.m_bits = bits;
+    return half;
+  }
+
+  /**
+   * @brief Gets the bits of the half.
+   */
+  std::uint16_t bits() const { return m_bits; }
+
+  /**
+   * @brief Converts the half to a float.
+   */
+  operator float() const { return detail::halfToFloat(m_bits); }
+
+private:
+  std::uint16_t m_bits;
+};
+
+/**
+ * @brief A bfloat16, for storage.
+ *
+ * It is the upper 16 bits of a float: 1 sign bit, 8 exponent bits, and 7
+ * mantissa bits. It has the range of a float, with about 2 significant
+ * decimal digits. It converts implicitly to float; the conversion from
+ * float is explicit because it rounds.
+ */
+class BFloat16 {
+public:
+  /**
+   * @brief Leaves the bits uninitialized, like a float.
+   */
+  BFloat16() = default;
+
+  /**
+   * @brief Rounds a float to the nearest bfloat16.
+   *
+   * @param value The value to round.
+   */
+  explicit BFloat16(const float value)
+      : m_bits(detail::floatToBFloat16(value)) {}
+
+  /**
+   * @brief Creates a bfloat16 from its bits.
+   *
+   * @param bits The bits, as stored in memory.
+   *
+   * @returns The bfloat16.
+   */
+  static BFloat16 fromBits(const std::uint16_t bits) {
+    BFloat16 bfloat;
+    bfloat.m_bits = bits;
+    return bfloat;
+  }
+
+  /**
+   * @brief Gets the bits of the bfloat16.
+   */
+  std::uint16_t bits() const { return m_bits; }
+
+  /**
+   * @brief Converts the bfloat16 to a float.
+   */
+  operator float() const { return detail::bfloat16ToFloat(m_bits); }
+
+private:
+  std::uint16_t m_bits;
+};
+
+static_assert(sizeof(Half) == 2, "Half must be 16 bits");
+static_assert(sizeof(BFloat16) == 2, "BFloat16 must be 16 bits");
+
+namespace half {
+namespace detail {
+#if defined(SVECTOR_SIMD_F16C)
+/**
+ * @brief Loads 8 elements as a register of floats.
+ */
+inline __m256 load(const Half *ptr) {
+  return _mm256_cvtph_ps(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)));
+}
+
+inline __m256 load(const float *ptr) { return _mm256_loadu_ps(ptr); }
+#endif
+
+#if defined(SVECTOR_SIMD_AVX) || defined(SVECTOR_SIMD_SSE2)
+/**
+ * @brief Loads 8 elements as two registers of 4 floats.
+ */
+inline void load(const BFloat16 *ptr, __m128 &low, __m128 &high) {
+  const __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr));
+  low = _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), bits));
+  high = _mm_castsi128_ps(_mm_unpackhi_epi16(_mm_setzero_si128(), bits));
+}
+
+inline void load(const float *ptr, __m128 &low, __m128 &high) {
+  low = _mm_loadu_ps(ptr);
+  high = _mm_loadu_ps(ptr + 4);
+}
+
+/**
+ * @brief Rounds 4 floats to bfloat16s, like svector::detail::floatToBFloat16.
+ *
+ * The results are sign-extended to 32 bits, so that _mm_packs_epi32 keeps
+ * their bits.
+ */
+inline __m128i round(const __m128i bits) {
+  const __m128i lsb =
+      _mm_and_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(1));
+  const __m128i rounded = _mm_srli_epi32(
+      _mm_add_epi32(bits, _mm_add_epi32(lsb, _mm_set1_epi32(0x7FFF))), 16);
+  const __m128i quiet =
+      _mm_or_si128(_mm_srli_epi32(bits, 16), _mm_set1_epi32(0x40));
+  const __m128i nan =
+      _mm_cmpgt_epi32(_mm_and_si128(bits, _mm_set1_epi32(0x7FFFFFFF)),
+                      _mm_set1_epi32(0x7F800000));
+  const __m128i result = _mm_or_si128(_mm_and_si128(nan, quiet),
+                                      _mm_andnot_si128(nan, rounded));
+  return _mm_srai_epi32(_mm_slli_epi32(result, 16), 16);
+}
+#endif
+
+/**
+ * @brief Calculates the dot product of halves and halves or floats.
+ */
+template <typename R>
+float dot(const Half *lhs, const R *rhs, const std::size_t size) {
+  float result = 0;
+  std::size_t i = 0;
+#if defined(SVECTOR_SIMD_F16C)
+  // two accumulators, so that consecutive additions do not wait on each other
+  __m256 acc0 = _mm256_setzero_ps();
+  __m256 acc1 = _mm256_setzero_ps();
+  const std::size_t pairSize = size - size % 16;
+  for (; i < pairSize; i += 16) {
+    acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(load(lhs + i), load(rhs + i)));
+    acc1 = _mm256_add_ps(acc1,
+                         _mm256_mul_ps(load(lhs + i + 8), load(rhs + i + 8)));
+  }
+  if (size - i >= 8) {
+    acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(load(lhs + i), load(rhs + i)));
+    i += 8;
+  }
+  result = simd::detail::Lanes<float>::sum(_mm256_add_ps(acc0, acc1));
+#endif
+  for (; i < size; i++) {
+    result += static_cast<float>(lhs[i]) * static_cast<float>(rhs[i]);
+  }
+
+  return result;
+}
+
+/**
+ * @brief Calculates the dot product of bfloat16s and bfloat16s or floats.
+ */
+template <typename R>
+float dot(const BFloat16 *lhs, const R *rhs, const std::size_t size) {
+  float result = 0;
+  std::size_t i = 0;
+#if defined(SVECTOR_SIMD_AVX) || defined(SVECTOR_SIMD_SSE2)
+  // one accumulator for each half of the 8 elements
+  __m128 acc0 = _mm_setzero_ps();
+  __m128 acc1 = _mm_setzero_ps();
+  const std::size_t simdSize = size - size % 8;
+  for (; i < simdSize; i += 8) {
+    __m128 lhsLow;
+    __m128 lhsHigh;
+    __m128 rhsLow;
+    __m128 rhsHigh;
+    load(lhs + i, lhsLow, lhsHigh);
+    load(rhs + i, rhsLow, rhsHigh);
+    acc0 = _mm_add_ps(acc0, _mm_mul_ps(lhsLow, rhsLow));
+    acc1 = _mm_add_ps(acc1, _mm_mul_ps(lhsHigh, rhsHigh));
+  }
+  float partial[4];
+  _mm_storeu_ps(partial, _mm_add_ps(acc0, acc1));
+  result = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+#endif
+  for (; i < size; i++) {
+    result += static_cast<float>(lhs[i]) * static_cast<float>(rhs[i]);
+  }
+
+  return result;
+}
+} // namespace detail
+
+/**
+ * @brief Converts an array of halves to floats.
+ *
+ * @param in The halves.
+ * @param out The array to write the floats to.
+ * @param size The number of elements in each array.
+ */
+inline void toFloat(const Half *in, float *out, const std::size_t size) {
+  std::size_t i = 0;
+#if defined(SVECTOR_SIMD_F16C)
+  const std::size_t simdSize = size - size % 8;
+  for (; i < simdSize; i += 8) {
+    _mm256_storeu_ps(out + i, detail::load(in + i));
+  }
+#endif
+  for (; i < size; i++) {
+    out[i] = in[i];
+  }
+}
+
+/**
+ * @brief Converts an array of floats to halves.
+ *
+ * @param in The floats.
+ * @param out The array to write the halves to.
+ * @param size The number of elements in each array.
+ */
+inline void fromFloat(const float *in, Half *out, const std::size_t size) {
+  std::size_t i = 0;
+#if defined(SVECTOR_SIMD_F16C)
+  const std::size_t simdSize = size - size % 8;
+  for (; i < simdSize; i += 8) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(out + i),
+        _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+  }
+#endif
+  for (; i < size; i++) {
+    out[i] = Half(in[i]);
+  }
+}
+
+/**
+ * @brief Converts an array of bfloat16s to floats.
+ *
+ * @param in The bfloat16s.
+ * @param out The array to write the floats to.
+ * @param size The number of elements in each array.
+ */
+inline void toFloat(const BFloat16 *in, float *out, const std::size_t size) {
+  std::size_t i = 0;
+#if defined(SVECTOR_SIMD_AVX) || defined(SVECTOR_SIMD_SSE2)
+  const std::size_t simdSize = size - size % 8;
+  for (; i < simdSize; i += 8) {
+    __m128 low;
+    __m128 high;
+    detail::load(in + i, low, high);
+    _mm_storeu_ps(out + i, low);
+    _mm_storeu_ps(out + i + 4, high);
+  }
+#endif
+  for (; i < size; i++) {
+    out[i] = in[i];
+  }
+}
+
+/**
+ * @brief Converts an array of floats to bfloat16s.
+ *
+ * @param in The floats.
+ * @param out The array to write the bfloat16s to.
+ * @param size The number of elements in each array.
+ */
+inline void fromFloat(const float *in, BFloat16 *out, const std::size_t size) {
+  std::size_t i = 0;
+#if defined(SVECTOR_SIMD_AVX) || defined(SVECTOR_SIMD_SSE2)
+  const std::size_t simdSize = size - size % 8;
+  for (; i < simdSize; i += 8) {
+    const __m128i low = detail::round(_mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(in + i)));
+    const __m128i high = detail::round(_mm_loadu_si128(
+        reinterpret_cast<const __m128i *>(in + i + 4)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                     _mm_packs_epi32(low, high));
+  }
+#endif
+  for (; i < size; i++) {
+    out[i] = BFloat16(in[i]);
+  }
+}
+
+/**
+ * @brief Calculates the dot product of two arrays of halves.
+ *
+ * The elements are converted to float as they are read, and the products
+ * are added in float.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+inline float dot(const Half *lhs, const Half *rhs, const std::size_t size) {
+  return detail::dot(lhs, rhs, size);
+}
+
+/**
+ * @brief Calculates the dot product of an array of halves and an array of
+ * floats.
+ *
+ * This is the usual case for a float query against stored vectors.
+ *
+ * @param lhs The halves.
+ * @param rhs The floats.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+inline float dot(const Half *lhs, const float *rhs, const std::size_t size) {
+  return detail::dot(lhs, rhs, size);
+}
+
+/**
+ * @brief Calculates the dot product of two arrays of bfloat16s.
+ *
+ * The elements are converted to float as they are read, and the products
+ * are added in float.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+inline float dot(const BFloat16 *lhs, const BFloat16 *rhs,
+                 const std::size_t size) {
+  return detail::dot(lhs, rhs, size);
+}
+
+/**
+ * @brief Calculates the dot product of an array of bfloat16s and an array
+ * of floats.
+ *
+ * @param lhs The bfloat16s.
+ * @param rhs The floats.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+inline float dot(const BFloat16 *lhs, const float *rhs,
+                 const std::size_t size) {
+  return detail::dot(lhs, rhs, size);
+}
+
+/**
+ * @brief Converts D stored components to a float vector.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam S Half or BFloat16.
+ *
+ * @param in The stored components.
+ *
+ * @returns A vector with the components converted to float.
+ */
+template <std::size_t D, typename S> Vector<D, float> toVector(const S *in) {
+  Vector<D, float> vec;
+  toFloat(in, &vec[0], D);
+  return vec;
+}
+
+/**
+ * @brief Stores the components of a float vector.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam S Half or BFloat16.
+ *
+ * @param vec The vector.
+ * @param out The array to write the D components to.
+ */
+template <std::size_t D, typename S>
+void fromVector(const Vector<D, float> &vec, S *out) {
+  fromFloat(&vec[0], out, D);
+}
+} // namespace half
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
@@ -0,0 +1,476 @@
+/**
+ * @file instrument.hpp
+ *
+ * @brief Opt-in call counters and batch timing for profiling.
+ *
+ * Instrumentation is off by default. In that case, the hooks expand to
+ * nothing, and snapshot() and dumpJSON() report no counters.
+ *
+ * To turn it on, define SVECTOR_INSTRUMENT before including simplevectors.
+ * Every instrumented function then counts its calls, grouped by function
+ * name, number of dimensions, and component type. Also define
+ * SVECTOR_INSTRUMENT_TIMING to time the scopes marked with
+ * SVECTOR_INSTRUMENT_BATCH(). Those scopes are also recorded as trace spans
+ * when SVECTOR_TRACE is defined (see trace.hpp).
+ *
+ * @note Define the macros the same way in every translation unit of a
+ * program. Otherwise, the program breaks the one definition rule.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_INSTRUMENT_HPP_
+#define INCLUDE_SVECTOR_INSTRUMENT_HPP_
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <string>  // std::string, std::to_string
+#include <vector>  // std::vector
+
+#include "simplevectors/core/trace.hpp" // SVECTOR_TRACE_BATCH
+
+#ifdef SVECTOR_INSTRUMENT
+#include <atomic>  // std::atomic
+#include <chrono>  // std::chrono::steady_clock
+#include <cstring> // std::strcmp
+#include <mutex>   // std::mutex, std::lock_guard
+#endif
+
+namespace svector {
+// COMBINER_PY_START
+namespace instrument {
+/**
+ * @brief Counters of one instrumented function for one vector type.
+ */
+struct Entry {
+  std::string op;            //!< The function name.
+  std::size_t dims;          //!< The number of dimensions.
+  std::string type;          //!< The component type, e.g. "double".
+  std::uint64_t calls;       //!< Number of calls.
+  std::uint64_t batches;     //!< Number of batch scopes.
+  std::uint64_t items;       //!< Total items processed in batch scopes.
+  std::uint64_t nanoseconds; //!< Total time in batch scopes, if timed.
+};
+
+#ifdef SVECTOR_INSTRUMENT
+#ifndef SVECTOR_INSTRUMENT_MAX_SLOTS
+/**
+ * @brief Maximum number of distinct function, dimension, and type
+ * combinations that can be counted.
+ *
+ * Combinations past this limit are not counted.
+ */
+#define SVECTOR_INSTRUMENT_MAX_SLOTS 256
+#endif
+
+namespace detail {
+/**
+ * @brief Counters of one slot (function, dimension, and type combination).
+ */
+struct Counts {
+  std::atomic<std::uint64_t> calls;
+  std::atomic<std::uint64_t> batches;
+  std::atomic<std::uint64_t> items;
+  std::atomic<std::uint64_t> nanoseconds;
+};
+
+/**
+ * @brief Identifies a slot.
+ */
+struct Slot {
+  const char *op;
+  std::size_t dims;
+  const char *type;
+};
+
+struct ThreadCounters;
+
+/**
+ * @brief Global state shared by every thread.
+ */
+struct Registry {
+  std::mutex mutex;
+  std::vector<Slot> slots;
+  std::vector<ThreadCounters *> threads;
+
+  // totals of threads that have exited
+  std::vector<std::uint64_t> calls =
+      std::vector<std::uint64_t>(SVECTOR_INSTRUMENT_MAX_SLOTS);
+  std::vector<std::uint64_t> batches =
+      std::vector<std::uint64_t>(SVECTOR_INSTRUMENT_MAX_SLOTS);
+  std::vector<std::uint64_t> items =
+      std::vector<std::uint64_t>(SVECTOR_INSTRUMENT_MAX_SLOTS);
+  std::vector<std::uint64_t> nanoseconds =
+      std::vector<std::uint64_t>(SVECTOR_INSTRUMENT_MAX_SLOTS);
+};
+
+/**
+ * @brief Gets the global registry.
+ */
+inline Registry &registry() {
+  static Registry reg;
+  return reg;
+}
+
+/**
+ * @brief Counters owned by one thread.
+ *
+ * Only the owning thread increments them, so increments never contend.
+ * Other threads read them for snapshots and clear them on reset.
+ */
+struct ThreadCounters {
+  ThreadCounters() {
+    for (auto &slot : this->counts) {
+      slot.calls.store(0, std::memory_order_relaxed);
+      slot.batches.store(0, std::memory_order_relaxed);
+      slot.items.store(0, std::memory_order_relaxed);
+      slot.nanoseconds.store(0, std::memory_order_relaxed);
+    }
+
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.threads.push_back(this);
+  }
+
+  ~ThreadCounters() {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+
+    // keep the counts of exited threads
+    for (std::size_t i = 0; i < SVECTOR_INSTRUMENT_MAX_SLOTS; i++) {
+      reg.calls[i] += this->counts[i].calls.load(std::memory_order_relaxed);
+      reg.batches[i] += this->counts[i].batches.load(std::memory_order_relaxed);
+      reg.items[i] += this->counts[i].items.load(std::memory_order_relaxed);
+      reg.nanoseconds[i] +=
+          this->counts[i].nanoseconds.load(std::memory_order_relaxed);
+    }
+
+    for (std::size_t i = 0; i < reg.threads.size(); i++) {
+      if (reg.threads[i] == this) {
+        reg.threads.erase(reg.threads.begin() +
+                          static_cast<std::ptrdiff_t>(i));
+        break;
+      }
+    }
+  }
+
+  ThreadCounters(const ThreadCounters &) = delete;
+  ThreadCounters &operator=(const ThreadCounters &) = delete;
+
+  Counts counts[SVECTOR_INSTRUMENT_MAX_SLOTS];
+};
+
+/**
+ * @brief Gets the counters of the calling thread.
+ */
+inline ThreadCounters &threadCounters() {
+  static thread_local ThreadCounters counters;
+  return counters;
+}
+
+/**
+ * @brief Gets the name of a component type.
+ *
+ * @tparam T The component type.
+ */
+template <typename T> inline const char *typeName() { return "other"; }
+
+#define SVECTOR_INSTRUMENT_TYPE_NAME(T)                                        \
+  template <> inline const char *typeName<T>() { return #T; }
+SVECTOR_INSTRUMENT_TYPE_NAME(bool)
+SVECTOR_INSTRUMENT_TYPE_NAME(char)
+SVECTOR_INSTRUMENT_TYPE_NAME(signed char)
+SVECTOR_INSTRUMENT_TYPE_NAME(unsigned char)
+SVECTOR_INSTRUMENT_TYPE_NAME(short)
+SVECTOR_INSTRUMENT_TYPE_NAME(unsigned short)
+SVECTOR_INSTRUMENT_TYPE_NAME(int)
+SVECTOR_INSTRUMENT_TYPE_NAME(unsigned int)
+SVECTOR_INSTRUMENT_TYPE_NAME(long)
+SVECTOR_INSTRUMENT_TYPE_NAME(unsigned long)
+SVECTOR_INSTRUMENT_TYPE_NAME(long long)
+SVECTOR_INSTRUMENT_TYPE_NAME(unsigned long long)
+SVECTOR_INSTRUMENT_TYPE_NAME(float)
+SVECTOR_INSTRUMENT_TYPE_NAME(double)
+SVECTOR_INSTRUMENT_TYPE_NAME(long double)
+#undef SVECTOR_INSTRUMENT_TYPE_NAME
+
+/**
+ * @brief Gets the slot of a function, dimension, and type combination,
+ * adding it if it is new.
+ *
+ * Each hook calls this once and caches the result.
+ *
+ * @returns The slot index, or SVECTOR_INSTRUMENT_MAX_SLOTS if there is no
+ * room left.
+ */
+inline std::size_t registerSlot(const char *op, const std::size_t dims,
+                                const char *type) {
+  Registry &reg = registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+
+  for (std::size_t i = 0; i < reg.slots.size(); i++) {
+    const Slot &slot = reg.slots[i];
+    if (slot.dims == dims && std::strcmp(slot.op, op) == 0 &&
+        std::strcmp(slot.type, type) == 0) {
+      return i;
+    }
+  }
+
+  if (reg.slots.size() >= SVECTOR_INSTRUMENT_MAX_SLOTS) {
+    return SVECTOR_INSTRUMENT_MAX_SLOTS;
+  }
+
+  reg.slots.push_back(Slot{op, dims, type});
+  return reg.slots.size() - 1;
+}
+
+/**
+ * @brief Counts a call.
+ */
+inline void countCall(const std::size_t slot) {
+  if (slot < SVECTOR_INSTRUMENT_MAX_SLOTS) {
+    threadCounters().counts[slot].calls.fetch_add(1,
+                                                  std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Counts a batch scope.
+ */
+inline void countBatch(const std::size_t slot, const std::uint64_t items,
+                       const std::uint64_t nanoseconds) {
+  if (slot < SVECTOR_INSTRUMENT_MAX_SLOTS) {
+    Counts &counts = threadCounters().counts[slot];
+    counts.batches.fetch_add(1, std::memory_order_relaxed);
+    counts.items.fetch_add(items, std::memory_order_relaxed);
+    counts.nanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Builds entries from the counts of the given threads.
+ *
+ * The registry mutex must be held.
+ */
+inline std::vector<Entry>
+collect(const Registry &reg, const std::vector<ThreadCounters *> &threads,
+        const bool includeExited) {
+  std::vector<Entry> entries;
+  for (std::size_t i = 0; i < reg.slots.size(); i++) {
+    Entry entry{reg.slots[i].op, reg.slots[i].dims, reg.slots[i].type, 0, 0,
+                0, 0};
+
+    if (includeExited) {
+      entry.calls = reg.calls[i];
+      entry.batches = reg.batches[i];
+      entry.items = reg.items[i];
+      entry.nanoseconds = reg.nanoseconds[i];
+    }
+
+    for (const ThreadCounters *thread : threads) {
+      const Counts &counts = thread->counts[i];
+      entry.calls += counts.calls.load(std::memory_order_relaxed);
+      entry.batches += counts.batches.load(std::memory_order_relaxed);
+      entry.items += counts.items.load(std::memory_order_relaxed);
+      entry.nanoseconds += counts.nanoseconds.load(std::memory_order_relaxed);
+    }
+
+    if (entry.calls != 0 || entry.batches != 0) {
+      entries.push_back(entry);
+    }
+  }
+
+  return entries;
+}
+} // namespace detail
+
+/**
+ * @brief Counts and optionally times one batch scope.
+ *
+ * Use SVECTOR_INSTRUMENT_BATCH() rather than creating this directly.
+ */
+class BatchScope {
+public:
+  /**
+   * @brief Starts the scope.
+   *
+   * @param slot The slot from detail::registerSlot().
+   * @param items The number of items the batch processes.
+   */
+  BatchScope(const std::size_t slot, const std::uint64_t items)
+      : m_slot{slot}, m_items{items}
+#ifdef SVECTOR_INSTRUMENT_TIMING
+        ,
+        m_start{std::chrono::steady_clock::now()}
+#endif
+  {
+  }
+
+  /**
+   * @brief Ends the scope and records it.
+   */
+  ~BatchScope() {
+    std::uint64_t nanoseconds = 0;
+#ifdef SVECTOR_INSTRUMENT_TIMING
+    nanoseconds = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - m_start)
+            .count());
+#endif
+    detail::countBatch(m_slot, m_items, nanoseconds);
+  }
+
+  BatchScope(const BatchScope &) = delete;
+  BatchScope &operator=(const BatchScope &) = delete;
+
+private:
+  std::size_t m_slot;
+  std::uint64_t m_items;
+#ifdef SVECTOR_INSTRUMENT_TIMING
+  std::chrono::steady_clock::time_point m_start;
+#endif
+};
+
+/**
+ * @brief Gets the counters of every thread, including exited threads.
+ *
+ * @returns One entry for each function, dimension, and type combination
+ * that has been called.
+ */
+inline std::vector<Entry> snapshot() {
+  detail::Registry &reg = detail::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return detail::collect(reg, reg.threads, true);
+}
+
+/**
+ * @brief Gets the counters of the calling thread only.
+ *
+ * This can be used to attribute calls to the subsystem running on a thread.
+ *
+ * @returns One entry for each function, dimension, and type combination
+ * that the calling thread has called.
+ */
+inline std::vector<Entry> threadSnapshot() {
+  detail::ThreadCounters *const counters = &detail::threadCounters();
+  detail::Registry &reg = detail::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  return detail::collect(reg, std::vector<detail::ThreadCounters *>{counters},
+                         false);
+}
+
+/**
+ * @brief Sets every counter of every thread back to zero.
+ */
+inline void reset() {
+  detail::Registry &reg = detail::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+
+  for (std::size_t i = 0; i < SVECTOR_INSTRUMENT_MAX_SLOTS; i++) {
+    reg.calls[i] = 0;
+    reg.batches[i] = 0;
+    reg.items[i] = 0;
+    reg.nanoseconds[i] = 0;
+  }
+
+  for (detail::ThreadCounters *thread : reg.threads) {
+    for (auto &counts : thread->counts) {
+      counts.calls.store(0, std::memory_order_relaxed);
+      counts.batches.store(0, std::memory_order_relaxed);
+      counts.items.store(0, std::memory_order_relaxed);
+      counts.nanoseconds.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+#define SVECTOR_INSTRUMENT_SLOT(op, D, T)                                      \
+  ::svector::instrument::detail::registerSlot(                                 \
+      op, D, ::svector::instrument::detail::typeName<T>())
+
+#define SVECTOR_INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define SVECTOR_INSTRUMENT_CONCAT(a, b) SVECTOR_INSTRUMENT_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Counts a call of an instrumented function.
+ *
+ * @param op A string literal with the function name.
+ * @param D The number of dimensions.
+ * @param T The component type.
+ */
+#define SVECTOR_INSTRUMENT_CALL(op, D, T)                                      \
+  do {                                                                         \
+    static const std::size_t svectorInstrumentSlot =                           \
+        SVECTOR_INSTRUMENT_SLOT(op, D, T);                                     \
+    ::svector::instrument::detail::countCall(svectorInstrumentSlot);           \
+  } while (0)
+
+/**
+ * @brief Counts, and with SVECTOR_INSTRUMENT_TIMING times, the rest of the
+ * enclosing scope as one batch.
+ *
+ * With SVECTOR_TRACE, the scope is also recorded as a trace span.
+ *
+ * @param op A string literal with the function name.
+ * @param D The number of dimensions.
+ * @param T The component type.
+ * @param count The number of items in the batch.
+ */
+#define SVECTOR_INSTRUMENT_BATCH(op, D, T, count)                              \
+  static const std::size_t SVECTOR_INSTRUMENT_CONCAT(svectorInstrumentSlot,    \
+                                                     __LINE__) =               \
+      SVECTOR_INSTRUMENT_SLOT(op, D, T);                                       \
+  const ::svector::instrument::BatchScope SVECTOR_INSTRUMENT_CONCAT(           \
+      svectorInstrumentBatch, __LINE__)(                                       \
+      SVECTOR_INSTRUMENT_CONCAT(svectorInstrumentSlot, __LINE__),              \
+      static_cast<std::uint64_t>(count));                                      \
+  SVECTOR_TRACE_BATCH(op, count)
+#else
+inline std::vector<Entry> snapshot() { return std::vector<Entry>(); }
+inline std::vector<Entry> threadSnapshot() { return std::vector<Entry>(); }
+inline void reset() {}
+
+#define SVECTOR_INSTRUMENT_CALL(op, D, T) static_cast<void>(0)
+#define SVECTOR_INSTRUMENT_BATCH(op, D, T, count) SVECTOR_TRACE_BATCH(op, count)
+#endif
+
+/**
+ * @brief Formats counters as JSON.
+ *
+ * The output is an object with a "counters" array holding one object per
+ * entry, with the keys "op", "dims", "type", "calls", "batches", "items",
+ * and "nanoseconds".
+ *
+ * @param entries The counters, from snapshot() or threadSnapshot().
+ *
+ * @returns The JSON text.
+ */
+inline std::string dumpJSON(const std::vector<Entry> &entries) {
+  std::string json = "{\"counters\": [";
+  for (std::size_t i = 0; i < entries.size(); i++) {
+    const Entry &entry = entries[i];
+    json += i == 0 ? "\n" : ",\n";
+    json += "  {\"op\": \"" + entry.op + "\", ";
+    json += "\"dims\": " + std::to_string(entry.dims) + ", ";
+    json += "\"type\": \"" + entry.type + "\", ";
+    json += "\"calls\": " + std::to_string(entry.calls) + ", ";
+    json += "\"batches\": " + std::to_string(entry.batches) + ", ";
+    json += "\"items\": " + std::to_string(entry.items) + ", ";
+    json += "\"nanoseconds\": " + std::to_string(entry.nanoseconds) + "}";
+  }
+
+  json += entries.empty() ? "]}\n" : "\n]}\n";
+  return json;
+}
+
+/**
+ * @brief Formats the counters of every thread as JSON.
+ *
+ * @returns The JSON text, see dumpJSON(const std::vector<Entry> &).
+ */
+inline std::string dumpJSON() { return dumpJSON(snapshot()); }
+} // namespace instrument
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
@@ -0,0 +1,666 @@
+/**
+ * @file matrix.hpp
+ *
+ * @brief Contains small fixed-size matrices and affine transforms that can be
+ * applied to arrays of vectors.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_MATRIX_HPP_
+#define INCLUDE_SVECTOR_MATRIX_HPP_
+
+#include <array>            // std::array
+#include <cmath>            // std::abs, std::cos, std::sin
+#include <cstddef>          // std::size_t
+#include <initializer_list> // std::initializer_list
+#include <stdexcept>        // std::invalid_argument
+#include <type_traits>      // std::integral_constant, std::is_base_of, ...
+#include <utility>          // std::swap
+
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_BATCH
+#include "simplevectors/core/simd.hpp"       // svector::simd::detail::Lanes
+#include "simplevectors/core/units.hpp"      // svector::AngleDir
+#include "simplevectors/core/vector.hpp"     // svector::Vector
+
+namespace svector {
+// COMBINER_PY_START
+/**
+ * @brief A matrix with a fixed number of rows and columns.
+ *
+ * The elements are stored in row-major order. A matrix with R rows and R + 1
+ * columns is also used as an affine transform: the first R columns are the
+ * linear part, and the last column is the translation. So a Matrix<3, 4>
+ * (svector::Affine3D) rotates, scales, and translates 3D vectors, and two of
+ * them compose with operator*() as if each had an implicit last row of
+ * `0 0 0 1`.
+ *
+ * Composing transforms into one matrix computes their sines and cosines
+ * once, and transform() then applies the matrix to a whole array:
+ *
+ * ```cpp
+ * const svector::Affine3D m =
+ *     svector::translationMatrix(offset) *
+ *     svector::affineMatrix(svector::rotationMatrix<svector::GAMMA>(c) *
+ *                           svector::rotationMatrix<svector::BETA>(b) *
+ *                           svector::rotationMatrix<svector::ALPHA>(a));
+ * svector::transform(m, points.data(), points.size(), points.data());
+ * ```
+ *
+ * @tparam R The number of rows.
+ * @tparam C The number of columns.
+ * @tparam T Element type.
+ */
+template <std::size_t R, std::size_t C, typename T = double> class Matrix {
+public:
+  typedef T value_type; //!< Element type.
+
+  /**
+   * @brief Creates a matrix of zeros.
+   */
+  Matrix() { this->m_elements.fill(0); }
+
+  /**
+   * @brief Creates a matrix from its elements, in row-major order.
+   *
+   * Like the initializer list constructor of svector::Vector, extra elements
+   * are ignored and missing elements are 0.
+   *
+   * @param args The elements, row by row.
+   */
+  Matrix(const std::initializer_list<T> args) {
+    this->m_elements.fill(0);
+
+    std::size_t counter = 0;
+    for (const auto &num : args) {
+      if (counter >= R * C) {
+        break;
+      }
+
+      this->m_elements[counter] = num;
+      counter++;
+    }
+  }
+
+  /**
+   * @brief Creates a matrix with ones on the diagonal and zeros elsewhere.
+   *
+   * For an affine matrix, this is the transform that does nothing.
+   */
+  static Matrix identity() {
+    Matrix result;
+    for (std::size_t i = 0; i < R && i < C; i++) {
+      result(i, i) = 1;
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Gets the number of rows.
+   */
+  static constexpr std::size_t rows() { return R; }
+
+  /**
+   * @brief Gets the number of columns.
+   */
+  static constexpr std::size_t cols() { return C; }
+
+  /**
+   * @brief Gets an element.
+   *
+   * @param row The row, less than R.
+   * @param col The column, less than C.
+   */
+  const T &operator()(const std::size_t row, const std::size_t col) const {
+    return this->m_elements[row * C + col];
+  }
+
+  /**
+   * @brief Gets a reference to an element.
+   *
+   * @param row The row, less than R.
+   * @param col The column, less than C.
+   */
+  T &operator()(const std::size_t row, const std::size_t col) {
+    return this->m_elements[row * C + col];
+  }
+
+  /**
+   * @brief Gets the elements, in row-major order.
+   */
+  const T *data() const { return this->m_elements.data(); }
+
+  /**
+   * @brief Gets the elements, in row-major order.
+   */
+  T *data() { return this->m_elements.data(); }
+
+  /**
+   * @brief Swaps the rows and columns.
+   *
+   * @returns The transposed matrix.
+   */
+  Matrix<C, R, T> transpose() const {
+    Matrix<C, R, T> result;
+    for (std::size_t i = 0; i < R; i++) {
+      for (std::size_t j = 0; j < C; j++) {
+        result(j, i) = (*this)(i, j);
+      }
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Compares each element of two matrices.
+   */
+  bool operator==(const Matrix &other) const {
+    return this->m_elements == other.m_elements;
+  }
+
+  /**
+   * @brief Compares each element of two matrices.
+   */
+  bool operator!=(const Matrix &other) const { return !(*this == other); }
+
+private:
+  std::array<T, R * C> m_elements;
+};
+
+typedef Matrix<2, 2, double> Matrix2D; //!< A 2x2 matrix of doubles.
+typedef Matrix<3, 3, double> Matrix3D; //!< A 3x3 matrix of doubles.
+typedef Matrix<4, 4, double> Matrix4D; //!< A 4x4 matrix of doubles.
+typedef Matrix<2, 3, double> Affine2D; //!< A 2D affine transform of doubles.
+typedef Matrix<3, 4, double> Affine3D; //!< A 3D affine transform of doubles.
+
+namespace detail {
+/**
+ * @brief Checks whether rows of N elements of T split evenly into SIMD
+ * registers.
+ */
+template <typename T, std::size_t N, bool = simd::detail::Lanes<T>::enabled>
+struct RowFitsLanes : std::false_type {};
+
+template <typename T, std::size_t N>
+struct RowFitsLanes<T, N, true>
+    : std::integral_constant<bool,
+                             N % simd::detail::Lanes<T>::width == 0> {};
+
+/**
+ * @brief Multiplies two matrices one element at a time.
+ */
+template <std::size_t R, std::size_t N, std::size_t C, typename T>
+Matrix<R, C, T> matrixProduct(const Matrix<R, N, T> &lhs,
+                              const Matrix<N, C, T> &rhs, std::false_type) {
+  Matrix<R, C, T> result;
+  for (std::size_t i = 0; i < R; i++) {
+    for (std::size_t j = 0; j < C; j++) {
+      T sum = 0;
+      for (std::size_t k = 0; k < N; k++) {
+        sum += lhs(i, k) * rhs(k, j);
+      }
+      result(i, j) = sum;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Multiplies two matrices a whole register of a row at a time, when
+ * the rows of the result fill whole registers, such as 4x4 matrices.
+ *
+ * Each row of the result is a sum of the rows of rhs scaled by the row of
+ * lhs, added in the same order as the plain loop.
+ */
+template <std::size_t R, std::size_t N, std::size_t C, typename T>
+Matrix<R, C, T> matrixProduct(const Matrix<R, N, T> &lhs,
+                              const Matrix<N, C, T> &rhs, std::true_type) {
+  typedef simd::detail::Lanes<T> L;
+
+  Matrix<R, C, T> result;
+  for (std::size_t i = 0; i < R; i++) {
+    for (std::size_t j = 0; j < C; j += L::width) {
+      typename L::reg sum = L::zero();
+      for (std::size_t k = 0; k < N; k++) {
+        sum = L::add(sum, L::mul(L::set(lhs(i, k)), L::load(&rhs(k, j))));
+      }
+      L::store(&result(i, j), sum);
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Applies an affine matrix to vectors stored as one array for each
+ * component.
+ */
+template <std::size_t D, typename T>
+void transformComponents(const Matrix<D, D + 1, T> &m, const T *const *in,
+                         T *const *out, const std::size_t size,
+                         std::false_type) {
+  for (std::size_t i = 0; i < size; i++) {
+    T x[D];
+    for (std::size_t c = 0; c < D; c++) {
+      x[c] = in[c][i];
+    }
+    for (std::size_t r = 0; r < D; r++) {
+      T sum = m(r, D);
+      for (std::size_t c = 0; c < D; c++) {
+        sum += m(r, c) * x[c];
+      }
+      out[r][i] = sum;
+    }
+  }
+}
+
+template <std::size_t D, typename T>
+void transformComponents(const Matrix<D, D + 1, T> &m, const T *const *in,
+                         T *const *out, const std::size_t size,
+                         std::true_type) {
+  typedef simd::detail::Lanes<T> L;
+
+  // each element of the matrix is broadcast to a whole register once
+  typename L::reg coeff[D][D + 1];
+  for (std::size_t r = 0; r < D; r++) {
+    for (std::size_t c = 0; c <= D; c++) {
+      coeff[r][c] = L::set(m(r, c));
+    }
+  }
+
+  const std::size_t simdSize = size - size % L::width;
+  std::size_t i = 0;
+  for (; i < simdSize; i += L::width) {
+    typename L::reg x[D];
+    for (std::size_t c = 0; c < D; c++) {
+      x[c] = L::load(in[c] + i);
+    }
+    for (std::size_t r = 0; r < D; r++) {
+      typename L::reg sum = coeff[r][D];
+      for (std::size_t c = 0; c < D; c++) {
+        sum = L::add(sum, L::mul(coeff[r][c], x[c]));
+      }
+      L::store(out[r] + i, sum);
+    }
+  }
+
+  const T *tailIn[D];
+  T *tailOut[D];
+  for (std::size_t c = 0; c < D; c++) {
+    tailIn[c] = in[c] + i;
+    tailOut[c] = out[c] + i;
+  }
+  transformComponents(m, tailIn, tailOut, size - i, std::false_type());
+}
+} // namespace detail
+
+/**
+ * @brief Multiplies two matrices.
+ *
+ * Products of float or double matrices whose rows fill whole SIMD registers,
+ * such as 4x4 matrices, are computed a register at a time.
+ *
+ * @param lhs An R by N matrix.
+ * @param rhs An N by C matrix.
+ *
+ * @returns The R by C product.
+ */
+template <std::size_t R, std::size_t N, std::size_t C, typename T>
+Matrix<R, C, T> operator*(const Matrix<R, N, T> &lhs,
+                          const Matrix<N, C, T> &rhs) {
+  return detail::matrixProduct(lhs, rhs, detail::RowFitsLanes<T, C>());
+}
+
+/**
+ * @brief Composes two affine transforms.
+ *
+ * The result applies rhs first and then lhs.
+ *
+ * @param lhs The transform applied second.
+ * @param rhs The transform applied first.
+ *
+ * @returns The composed transform.
+ */
+template <std::size_t D, typename T>
+Matrix<D, D + 1, T> operator*(const Matrix<D, D + 1, T> &lhs,
+                              const Matrix<D, D + 1, T> &rhs) {
+  Matrix<D, D + 1, T> result;
+  for (std::size_t i = 0; i < D; i++) {
+    for (std::size_t j = 0; j <= D; j++) {
+      // the implicit last row of rhs adds the translation of lhs
+      T sum = j == D ? lhs(i, D) : 0;
+      for (std::size_t k = 0; k < D; k++) {
+        sum += lhs(i, k) * rhs(k, j);
+      }
+      result(i, j) = sum;
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Multiplies a matrix by a column vector.
+ *
+ * @param lhs An R by C matrix.
+ * @param rhs A vector with C dimensions.
+ *
+ * @returns The product, with R dimensions.
+ */
+template <std::size_t R, std::size_t C, typename T>
+Vector<R, T> operator*(const Matrix<R, C, T> &lhs, const Vector<C, T> &rhs) {
+  Vector<R, T> result;
+  for (std::size_t i = 0; i < R; i++) {
+    T sum = 0;
+    for (std::size_t j = 0; j < C; j++) {
+      sum += lhs(i, j) * rhs[j];
+    }
+    result[i] = sum;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Applies an affine transform to a vector.
+ *
+ * @param lhs The transform.
+ * @param rhs The vector.
+ *
+ * @returns The transformed vector.
+ */
+template <std::size_t D, typename T>
+Vector<D, T> operator*(const Matrix<D, D + 1, T> &lhs,
+                       const Vector<D, T> &rhs) {
+  Vector<D, T> result;
+  for (std::size_t i = 0; i < D; i++) {
+    T sum = lhs(i, D);
+    for (std::size_t j = 0; j < D; j++) {
+      sum += lhs(i, j) * rhs[j];
+    }
+    result[i] = sum;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Inverts a square matrix.
+ *
+ * Uses Gauss-Jordan elimination with partial pivoting.
+ *
+ * @param m The matrix.
+ *
+ * @returns The inverse of the matrix.
+ *
+ * @throws std::invalid_argument If the matrix is singular.
+ */
+template <std::size_t N, typename T>
+Matrix<N, N, T> inverse(const Matrix<N, N, T> &m) {
+  static_assert(std::is_floating_point<T>::value,
+                "Only matrices of floating-point numbers can be inverted");
+
+  Matrix<N, N, T> left = m;
+  Matrix<N, N, T> result = Matrix<N, N, T>::identity();
+  for (std::size_t col = 0; col < N; col++) {
+    std::size_t pivot = col;
+    for (std::size_t row = col + 1; row < N; row++) {
+      if (std::abs(left(row, col)) > std::abs(left(pivot, col))) {
+        pivot = row;
+      }
+    }
+    if (left(pivot, col) == 0) {
+      throw std::invalid_argument("Matrix: cannot invert a singular matrix");
+    }
+
+    if (pivot != col) {
+      for (std::size_t j = 0; j < N; j++) {
+        std::swap(left(pivot, j), left(col, j));
+        std::swap(result(pivot, j), result(col, j));
+      }
+    }
+
+    const T scale = 1 / left(col, col);
+    for (std::size_t j = 0; j < N; j++) {
+      left(col, j) *= scale;
+      result(col, j) *= scale;
+    }
+
+    for (std::size_t row = 0; row < N; row++) {
+      const T factor = left(row, col);
+      if (row == col || factor == 0) {
+        continue;
+      }
+      for (std::size_t j = 0; j < N; j++) {
+        left(row, j) -= factor * left(col, j);
+        result(row, j) -= factor * result(col, j);
+      }
+    }
+  }
+
+  return result;
+}
+
+/**
+ * @brief Inverts an affine transform.
+ *
+ * Only the linear part is inverted as a matrix; the translation of the
+ * inverse is the negated translation passed through the inverted linear
+ * part.
+ *
+ * @param m The transform.
+ *
+ * @returns The transform that undoes m.
+ *
+ * @throws std::invalid_argument If the linear part is singular.
+ */
+template <std::size_t D, typename T>
+Matrix<D, D + 1, T> inverse(const Matrix<D, D + 1, T> &m) {
+  Matrix<D, D, T> linear;
+  for (std::size_t i = 0; i < D; i++) {
+    for (std::size_t j = 0; j < D; j++) {
+      linear(i, j) = m(i, j);
+    }
+  }
+  const Matrix<D, D, T> linearInv = inverse(linear);
+
+  Matrix<D, D + 1, T> result;
+  for (std::size_t i = 0; i < D; i++) {
+    T translation = 0;
+    for (std::size_t j = 0; j < D; j++) {
+      result(i, j) = linearInv(i, j);
+      translation -= linearInv(i, j) * m(j, D);
+    }
+    result(i, D) = translation;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Makes the matrix that rotates a 2D vector counterclockwise.
+ *
+ * @param ang The angle, in radians.
+ *
+ * @returns The rotation matrix.
+ */
+template <typename T> Matrix<2, 2, T> rotationMatrix(const T ang) {
+  const T c = std::cos(ang);
+  const T s = std::sin(ang);
+  return Matrix<2, 2, T>{c, -s, s, c};
+}
+
+/**
+ * @brief Makes the matrix that rotates a 3D vector around an axis.
+ *
+ * The matrices are the same as the ones svector::BasicVector3D::rotate()
+ * uses: ALPHA rotates around the x-axis, BETA around the y-axis, and GAMMA
+ * around the z-axis.
+ *
+ * @see svector::AngleDir
+ *
+ * @param ang The angle, in radians.
+ *
+ * @returns The rotation matrix.
+ */
+template <AngleDir Dir, typename T>
+Matrix<3, 3, T> rotationMatrix(const T ang) {
+  const T c = std::cos(ang);
+  const T s = std::sin(ang);
+  switch (Dir) {
+  case ALPHA:
+    return Matrix<3, 3, T>{1, 0, 0, 0, c, -s, 0, s, c};
+  case BETA:
+    return Matrix<3, 3, T>{c, 0, s, 0, 1, 0, -s, 0, c};
+  default:
+    return Matrix<3, 3, T>{c, -s, 0, s, c, 0, 0, 0, 1};
+  }
+}
+
+/**
+ * @brief Makes the matrix that scales each component of a vector.
+ *
+ * @param factors The factor for each component.
+ *
+ * @returns The diagonal matrix of the factors.
+ */
+template <std::size_t D, typename T>
+Matrix<D, D, T> scalingMatrix(const Vector<D, T> &factors) {
+  Matrix<D, D, T> result;
+  for (std::size_t i = 0; i < D; i++) {
+    result(i, i) = factors[i];
+  }
+
+  return result;
+}
+
+/**
+ * @brief Makes an affine transform from a linear part and a translation.
+ *
+ * The transform applies the linear part first and then adds the
+ * translation.
+ *
+ * @param linear The linear part.
+ * @param translation The translation.
+ *
+ * @returns The affine transform.
+ */
+template <std::size_t D, typename T>
+Matrix<D, D + 1, T>
+affineMatrix(const Matrix<D, D, T> &linear,
+             const Vector<D, T> &translation = Vector<D, T>()) {
+  Matrix<D, D + 1, T> result;
+  for (std::size_t i = 0; i < D; i++) {
+    for (std::size_t j = 0; j < D; j++) {
+      result(i, j) = linear(i, j);
+    }
+    result(i, D) = translation[i];
+  }
+
+  return result;
+}
+
+/**
+ * @brief Makes the affine transform that adds a vector.
+ *
+ * @param offset The vector to add.
+ *
+ * @returns The translation.
+ */
+template <std::size_t D, typename T>
+Matrix<D, D + 1, T> translationMatrix(const Vector<D, T> &offset) {
+  return affineMatrix(Matrix<D, D, T>::identity(), offset);
+}
+
+/**
+ * @brief Applies an affine transform to an array of vectors.
+ *
+ * The matrix is read once, instead of computing the sines and cosines of
+ * each rotation for every vector. The components of svector::Vector are
+ * stored after its virtual table pointer, so they are not contiguous across
+ * an array of vectors; store the components in separate arrays and use
+ * transformComponents() to transform several vectors at a time with SIMD.
+ *
+ * The output may be the same array as the input.
+ *
+ * @tparam V The vector type, such as svector::Vector3D or
+ * svector::Vector<3, double>.
+ *
+ * @param matrix The transform.
+ * @param in The vectors.
+ * @param size The number of vectors.
+ * @param out The array to write the transformed vectors to.
+ */
+template <std::size_t D, typename T, typename V>
+void transform(const Matrix<D, D + 1, T> &matrix, const V *in,
+               const std::size_t size, V *out) {
+  static_assert(std::is_base_of<Vector<D, T>, V>::value,
+                "The vectors must have the dimensions and type of the matrix");
+  SVECTOR_INSTRUMENT_BATCH("transform", D, T, size);
+
+  // a copy, since writing to out could otherwise change the matrix as far
+  // as the compiler knows, and make it read the matrix again for each vector
+  const Matrix<D, D + 1, T> m = matrix;
+  for (std::size_t i = 0; i < size; i++) {
+    T x[D];
+    for (std::size_t c = 0; c < D; c++) {
+      x[c] = in[i][c];
+    }
+    for (std::size_t r = 0; r < D; r++) {
+      T sum = m(r, D);
+      for (std::size_t c = 0; c < D; c++) {
+        sum += m(r, c) * x[c];
+      }
+      out[i][r] = sum;
+    }
+  }
+}
+
+/**
+ * @brief Applies a square matrix to an array of vectors.
+ *
+ * The same as the affine transform() with no translation.
+ *
+ * @param m The matrix.
+ * @param in The vectors.
+ * @param size The number of vectors.
+ * @param out The array to write the transformed vectors to.
+ */
+template <std::size_t D, typename T, typename V>
+void transform(const Matrix<D, D, T> &m, const V *in, const std::size_t size,
+               V *out) {
+  transform(affineMatrix(m), in, size, out);
+}
+
+/**
+ * @brief Applies an affine transform to vectors stored as one array for each
+ * component.
+ *
+ * Float and double components are transformed several vectors at a time
+ * with SIMD (see simd.hpp). The output arrays may be the same as the input
+ * arrays.
+ *
+ * ```cpp
+ * const double *in[] = {xs.data(), ys.data(), zs.data()};
+ * double *out[] = {xs.data(), ys.data(), zs.data()};
+ * svector::transformComponents(m, in, out, xs.size());
+ * ```
+ *
+ * @param m The transform.
+ * @param in D arrays, the ith of which has the ith component of each vector.
+ * @param out D arrays to write the components of the transformed vectors to.
+ * @param size The number of vectors.
+ */
+template <std::size_t D, typename T>
+void transformComponents(const Matrix<D, D + 1, T> &m, const T *const *in,
+                         T *const *out, const std::size_t size) {
+  SVECTOR_INSTRUMENT_BATCH("transformComponents", D, T, size);
+  detail::transformComponents(m, in, out, size, simd::detail::HasLanes<T>());
+}
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
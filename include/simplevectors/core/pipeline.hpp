@@ -0,0 +1,382 @@
+/**
+ * @file pipeline.hpp
+ *
+ * @brief Contains lazy pipelines of element-wise steps over vector arrays.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_PIPELINE_HPP_
+#define INCLUDE_SVECTOR_PIPELINE_HPP_
+
+#include <algorithm> // std::copy, std::min, std::move
+#include <cstddef>   // std::size_t
+#include <exception> // std::exception_ptr, std::current_exception, ...
+#include <memory>    // std::shared_ptr, std::make_shared
+#include <thread>    // std::thread
+#include <utility>   // std::move
+#include <vector>    // std::vector
+
+#include "simplevectors/core/alloc.hpp"      // SVECTOR_ALLOC_SCOPE
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_BATCH
+#include "simplevectors/core/vector.hpp"     // svector::Vector
+
+namespace svector {
+// COMBINER_PY_START
+#ifndef SVECTOR_PIPELINE_CHUNK_SIZE
+/**
+ * @brief The default number of elements that a Pipeline processes at a time.
+ *
+ * 256 3D double vectors take 8 KiB, which fits in the L1 cache.
+ */
+#define SVECTOR_PIPELINE_CHUNK_SIZE 256
+#endif
+
+namespace detail {
+// only used in decltype() to find the Vector base of an element type
+template <std::size_t D, typename T>
+Vector<D, T> pipelineVectorBase(const Vector<D, T> *);
+void pipelineVectorBase(const void *);
+
+/**
+ * @brief Finds the number of dimensions and the component type that a
+ * Pipeline reports to the instrumentation counters.
+ *
+ * Elements that are not vectors are reported with 0 dimensions and their
+ * own type.
+ */
+template <typename V, typename Base = decltype(pipelineVectorBase(
+                          static_cast<const V *>(nullptr)))>
+struct PipelineElement {
+  static constexpr std::size_t dims = 0; //!< The number of dimensions.
+  typedef V component;                   //!< The component type.
+};
+
+template <typename V, std::size_t D, typename T>
+struct PipelineElement<V, Vector<D, T>> {
+  static constexpr std::size_t dims = D; //!< The number of dimensions.
+  typedef T component;                   //!< The component type.
+};
+
+/**
+ * @brief One step of a Pipeline, applied to a chunk in place.
+ */
+template <typename V> class PipelineStage {
+public:
+  virtual ~PipelineStage() = default;
+
+  /**
+   * @brief Applies the step to a chunk.
+   *
+   * @param data The elements of the chunk.
+   * @param size The number of elements.
+   *
+   * @returns The number of elements left at the start of the chunk.
+   */
+  virtual std::size_t apply(V *data, std::size_t size) const = 0;
+};
+
+/**
+ * @brief Replaces each element with the result of a function.
+ */
+template <typename V, typename F> class MapStage : public PipelineStage<V> {
+public:
+  explicit MapStage(const F &fn) : m_fn(fn) {}
+
+  std::size_t apply(V *data, const std::size_t size) const override {
+    for (std::size_t i = 0; i < size; i++) {
+      data[i] = m_fn(data[i]);
+    }
+
+    return size;
+  }
+
+private:
+  F m_fn;
+};
+
+/**
+ * @brief Keeps the elements that a predicate is true for, in order.
+ */
+template <typename V, typename F> class FilterStage : public PipelineStage<V> {
+public:
+  explicit FilterStage(const F &predicate) : m_predicate(predicate) {}
+
+  std::size_t apply(V *data, const std::size_t size) const override {
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < size; i++) {
+      if (m_predicate(data[i])) {
+        if (kept != i) {
+          data[kept] = std::move(data[i]);
+        }
+        kept++;
+      }
+    }
+
+    return kept;
+  }
+
+private:
+  F m_predicate;
+};
+
+/**
+ * @brief Calls a function on the whole chunk.
+ */
+template <typename V, typename F>
+class TransformStage : public PipelineStage<V> {
+public:
+  explicit TransformStage(const F &fn) : m_fn(fn) {}
+
+  std::size_t apply(V *data, const std::size_t size) const override {
+    m_fn(data, size);
+    return size;
+  }
+
+private:
+  F m_fn;
+};
+} // namespace detail
+
+/**
+ * @brief A lazy sequence of element-wise steps over an array.
+ *
+ * map(), filter(), and transform() each return a new pipeline with one
+ * more step; nothing runs until run() or collect(). Instead of making an
+ * array for the result of each step, the pipeline copies a chunk of the
+ * input (SVECTOR_PIPELINE_CHUNK_SIZE elements) to the output and applies
+ * every step to that chunk while it is still in the cache. The chunks can
+ * also be split between threads.
+ *
+ * The steps are stored by value, and a pipeline can be run any number of
+ * times, from any number of threads at once, as long as the steps can.
+ *
+ * ```cpp
+ * const auto steps =
+ *     svector::Pipeline<svector::Vector3D>()
+ *         .map([](const svector::Vector3D &v) { return v * 2.0; })
+ *         .filter([](const svector::Vector3D &v) { return v.z() > 0; })
+ *         .map([](const svector::Vector3D &v) {
+ *           return svector::normalize(v);
+ *         });
+ * std::vector<svector::Vector3D> result =
+ *     steps.collect(points.data(), points.size());
+ * ```
+ *
+ * @tparam V The element type, for example Vector3D.
+ */
+template <typename V> class Pipeline {
+public:
+  typedef V value_type; //!< The element type.
+
+  /**
+   * @brief Creates a pipeline with no steps, which copies its input.
+   *
+   * @param chunkSize The number of elements processed at a time. 0 means
+   * the default.
+   */
+  explicit Pipeline(const std::size_t chunkSize = SVECTOR_PIPELINE_CHUNK_SIZE)
+      : m_chunkSize{chunkSize == 0 ? SVECTOR_PIPELINE_CHUNK_SIZE : chunkSize} {
+  }
+
+  /**
+   * @brief Adds a step that replaces each element with fn(element).
+   *
+   * @param fn A function taking a const V& and returning something that
+   * converts to V.
+   *
+   * @returns The new pipeline.
+   */
+  template <typename F> Pipeline map(F fn) const {
+    return this->with(std::make_shared<detail::MapStage<V, F>>(fn));
+  }
+
+  /**
+   * @brief Adds a step that only keeps the elements where predicate(element)
+   * is true.
+   *
+   * @param predicate A function taking a const V& and returning bool.
+   *
+   * @returns The new pipeline.
+   */
+  template <typename F> Pipeline filter(F predicate) const {
+    return this->with(
+        std::make_shared<detail::FilterStage<V, F>>(predicate));
+  }
+
+  /**
+   * @brief Adds a step that calls fn(data, size) on each chunk.
+   *
+   * This is for functions that work on arrays, such as the SIMD kernels,
+   * and that change the elements in place.
+   *
+   * @param fn A function taking a V* and a std::size_t.
+   *
+   * @returns The new pipeline.
+   */
+  template <typename F> Pipeline transform(F fn) const {
+    return this->with(std::make_shared<detail::TransformStage<V, F>>(fn));
+  }
+
+  /**
+   * @brief Gets the number of steps.
+   */
+  std::size_t numStages() const { return m_stages.size(); }
+
+  /**
+   * @brief Gets the number of elements processed at a time.
+   */
+  std::size_t chunkSize() const { return m_chunkSize; }
+
+  /**
+   * @brief Runs the pipeline over an array.
+   *
+   * The output can be the same array as the input. The elements that are
+   * left are written to the start of the output in order.
+   *
+   * If a step throws, the exception is passed on after every thread
+   * finishes, and the output is unspecified.
+   *
+   * @param in The input elements.
+   * @param size The number of input elements.
+   * @param out The array to write to, with room for size elements.
+   * @param threads The number of threads to split the chunks between. 0
+   * or 1 runs on the calling thread only.
+   *
+   * @returns The number of elements written.
+   */
+  std::size_t run(const V *in, const std::size_t size, V *out,
+                  const std::size_t threads = 1) const {
+    SVECTOR_INSTRUMENT_BATCH("pipeline", element::dims,
+                             typename element::component, size);
+
+    const std::size_t chunks = (size + m_chunkSize - 1) / m_chunkSize;
+    const std::size_t workers = std::min(threads, chunks);
+    if (workers <= 1) {
+      return this->runRange(in, size, out);
+    }
+
+    SVECTOR_ALLOC_SCOPE("Pipeline::run");
+
+    // each thread writes to the same range of the output as its input, so
+    // the ranges only have to be joined together at the end
+    std::vector<std::size_t> begins(workers + 1);
+    for (std::size_t t = 0; t <= workers; t++) {
+      begins[t] = std::min(chunks * t / workers * m_chunkSize, size);
+    }
+
+    std::vector<std::size_t> counts(workers);
+    std::vector<std::exception_ptr> errors(workers);
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t t = 1; t < workers; t++) {
+      pool.emplace_back([this, in, out, &begins, &counts, &errors, t]() {
+        this->runWorker(in, out, begins[t], begins[t + 1], counts[t],
+                        errors[t]);
+      });
+    }
+    this->runWorker(in, out, begins[0], begins[1], counts[0], errors[0]);
+    for (std::thread &worker : pool) {
+      worker.join();
+    }
+
+    for (const std::exception_ptr &error : errors) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+
+    std::size_t written = counts[0];
+    for (std::size_t t = 1; t < workers; t++) {
+      if (written != begins[t]) {
+        std::move(out + begins[t], out + begins[t] + counts[t],
+                  out + written);
+      }
+      written += counts[t];
+    }
+
+    return written;
+  }
+
+  /**
+   * @brief Runs the pipeline over an array into a new vector.
+   *
+   * @param in The input elements.
+   * @param size The number of input elements.
+   * @param threads The number of threads to split the chunks between.
+   *
+   * @returns The elements that are left.
+   */
+  std::vector<V> collect(const V *in, const std::size_t size,
+                         const std::size_t threads = 1) const {
+    SVECTOR_ALLOC_SCOPE("Pipeline::collect");
+
+    std::vector<V> out(size);
+    out.resize(this->run(in, size, out.data(), threads));
+    return out;
+  }
+
+private:
+  typedef detail::PipelineElement<V> element;
+
+  std::size_t m_chunkSize;
+  std::vector<std::shared_ptr<const detail::PipelineStage<V>>> m_stages;
+
+  Pipeline
+  with(const std::shared_ptr<const detail::PipelineStage<V>> &stage) const {
+    SVECTOR_ALLOC_SCOPE("Pipeline");
+
+    Pipeline pipeline(*this);
+    pipeline.m_stages.push_back(stage);
+    return pipeline;
+  }
+
+  /**
+   * @brief Runs every chunk of a range, on the calling thread.
+   *
+   * @returns The number of elements written.
+   */
+  std::size_t runRange(const V *in, const std::size_t size, V *out) const {
+    std::size_t written = 0;
+    for (std::size_t start = 0; start < size; start += m_chunkSize) {
+      const std::size_t length = std::min(m_chunkSize, size - start);
+
+      // the output never gets ahead of the input, so this also works in
+      // place
+      V *chunk = out + written;
+      if (chunk != in + start) {
+        std::copy(in + start, in + start + length, chunk);
+      }
+
+      std::size_t left = length;
+      for (std::size_t s = 0; s < m_stages.size() && left > 0; s++) {
+        left = m_stages[s]->apply(chunk, left);
+      }
+      written += left;
+    }
+
+    return written;
+  }
+
+  /**
+   * @brief Runs a range on a thread, keeping any exception for later.
+   */
+  void runWorker(const V *in, V *out, const std::size_t begin,
+                 const std::size_t end, std::size_t &count,
+                 std::exception_ptr &error) const {
+    SVECTOR_INSTRUMENT_BATCH("pipelineWorker", element::dims,
+                             typename element::component, end - begin);
+
+    try {
+      count = this->runRange(in + begin, end - begin, out + begin);
+    } catch (...) {
+      count = 0;
+      error = std::current_exception();
+    }
+  }
+};
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
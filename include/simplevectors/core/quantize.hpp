@@ -0,0 +1,707 @@
+/**
+ * @file quantize.hpp
+ *
+ * @brief Contains an array of vectors stored as quantized integers.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_QUANTIZE_HPP_
+#define INCLUDE_SVECTOR_QUANTIZE_HPP_
+
+#include <algorithm>        // std::max, std::min
+#include <cmath>            // std::abs, std::isfinite
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint8_t, std::uint16_t, std::uint32_t, ...
+#include <cstring>          // std::memcmp, std::memcpy
+#include <initializer_list> // std::initializer_list
+#include <limits>           // std::numeric_limits
+#include <stdexcept>        // std::invalid_argument, std::out_of_range
+#include <type_traits>      // std::conditional, std::is_floating_point, ...
+#include <vector>           // std::vector
+
+#include "simplevectors/core/alloc.hpp"      // SVECTOR_ALLOC_SCOPE
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_BATCH
+#include "simplevectors/core/simd.hpp"       // SVECTOR_SIMD_AVX, ...
+#include "simplevectors/core/vector.hpp"     // svector::Vector
+
+namespace svector {
+// COMBINER_PY_START
+#ifndef SVECTOR_QUANTIZED_BLOCK_SIZE
+/**
+ * @brief The default number of vectors in each block of a QuantizedArray.
+ */
+#define SVECTOR_QUANTIZED_BLOCK_SIZE 1024
+#endif
+
+namespace detail {
+/**
+ * @brief Quantizes an array of components with a scale and an offset.
+ *
+ * Each component becomes round((value - offset) * invScale), clamped to
+ * the range of the codes.
+ */
+template <typename T, typename Q>
+void quantize(const T *in, const std::size_t size, const T offset,
+              const T invScale, Q *out) {
+  const T levels = static_cast<T>(std::numeric_limits<Q>::max());
+  for (std::size_t i = 0; i < size; i++) {
+    const T level = (in[i] - offset) * invScale;
+    out[i] = static_cast<Q>(std::min(std::max(level, T(0)), levels) + T(0.5));
+  }
+}
+
+/**
+ * @brief Dequantizes an array of codes with a scale and an offset.
+ */
+template <typename T, typename Q>
+void dequantize(const Q *in, const std::size_t size, const T scale,
+                const T offset, T *out) {
+  for (std::size_t i = 0; i < size; i++) {
+    out[i] = static_cast<T>(in[i]) * scale + offset;
+  }
+}
+
+#if defined(SVECTOR_SIMD_AVX) || defined(SVECTOR_SIMD_SSE2)
+template <>
+inline void quantize(const float *in, const std::size_t size,
+                     const float offset, const float invScale,
+                     std::uint16_t *out) {
+  const __m128 off = _mm_set1_ps(offset);
+  const __m128 inv = _mm_set1_ps(invScale);
+  const __m128 levels = _mm_set1_ps(65535);
+  const __m128 half = _mm_set1_ps(0.5F);
+  // SSE2 can only pack to signed 16-bit integers, so the codes are shifted
+  // down by 32768 before packing and back up after
+  const __m128i bias = _mm_set1_epi32(32768);
+  const __m128i flip = _mm_set1_epi16(-32768);
+
+  const std::size_t simdSize = size - size % 8;
+  std::size_t i = 0;
+  for (; i < simdSize; i += 8) {
+    __m128 low = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(in + i), off), inv);
+    __m128 high = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(in + i + 4), off), inv);
+    low = _mm_min_ps(_mm_max_ps(low, _mm_setzero_ps()), levels);
+    high = _mm_min_ps(_mm_max_ps(high, _mm_setzero_ps()), levels);
+
+    const __m128i lowCodes =
+        _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(low, half)), bias);
+    const __m128i highCodes =
+        _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(high, half)), bias);
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i *>(out + i),
+        _mm_xor_si128(_mm_packs_epi32(lowCodes, highCodes), flip));
+  }
+
+  for (; i < size; i++) {
+    const float level = (in[i] - offset) * invScale;
+    out[i] = static_cast<std::uint16_t>(
+        std::min(std::max(level, 0.0F), 65535.0F) + 0.5F);
+  }
+}
+
+template <>
+inline void dequantize(const std::uint16_t *in, const std::size_t size,
+                       const float scale, const float offset, float *out) {
+  const __m128 factor = _mm_set1_ps(scale);
+  const __m128 off = _mm_set1_ps(offset);
+
+  const std::size_t simdSize = size - size % 8;
+  std::size_t i = 0;
+  for (; i < simdSize; i += 8) {
+    const __m128i codes =
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    const __m128 low = _mm_cvtepi32_ps(
+        _mm_unpacklo_epi16(codes, _mm_setzero_si128()));
+    const __m128 high = _mm_cvtepi32_ps(
+        _mm_unpackhi_epi16(codes, _mm_setzero_si128()));
+    _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(low, factor), off));
+    _mm_storeu_ps(out + i + 4, _mm_add_ps(_mm_mul_ps(high, factor), off));
+  }
+
+  for (; i < size; i++) {
+    out[i] = static_cast<float>(in[i]) * scale + offset;
+  }
+}
+
+/**
+ * @brief Quantizes 8 doubles to 32-bit codes, 4 in each register.
+ */
+inline void quantizeDoubles(const double *in, const __m128d off,
+                            const __m128d inv, const __m128d levels,
+                            __m128i &low, __m128i &high) {
+  const __m128d half = _mm_set1_pd(0.5);
+  __m128i codes[4];
+  for (std::size_t k = 0; k < 4; k++) {
+    __m128d level = _mm_mul_pd(_mm_sub_pd(_mm_loadu_pd(in + 2 * k), off), inv);
+    level = _mm_min_pd(_mm_max_pd(level, _mm_setzero_pd()), levels);
+    // the two codes are in the lower half of the register
+    codes[k] = _mm_cvttpd_epi32(_mm_add_pd(level, half));
+  }
+
+  low = _mm_unpacklo_epi64(codes[0], codes[1]);
+  high = _mm_unpacklo_epi64(codes[2], codes[3]);
+}
+
+/**
+ * @brief Dequantizes 8 codes, widened to 16 bits, to doubles.
+ */
+inline void dequantizeDoubles(const __m128i codes, const __m128d factor,
+                              const __m128d off, double *out) {
+  const __m128i halves[2] = {_mm_unpacklo_epi16(codes, _mm_setzero_si128()),
+                             _mm_unpackhi_epi16(codes, _mm_setzero_si128())};
+  for (std::size_t k = 0; k < 2; k++) {
+    const __m128d low = _mm_cvtepi32_pd(halves[k]);
+    const __m128d high = _mm_cvtepi32_pd(_mm_srli_si128(halves[k], 8));
+    _mm_storeu_pd(out + 4 * k, _mm_add_pd(_mm_mul_pd(low, factor), off));
+    _mm_storeu_pd(out + 4 * k + 2,
+                  _mm_add_pd(_mm_mul_pd(high, factor), off));
+  }
+}
+
+template <>
+inline void quantize(const double *in, const std::size_t size,
+                     const double offset, const double invScale,
+                     std::uint16_t *out) {
+  const __m128d off = _mm_set1_pd(offset);
+  const __m128d inv = _mm_set1_pd(invScale);
+  const __m128d levels = _mm_set1_pd(65535);
+  // shifted to signed 16-bit for packing, as for floats
+  const __m128i bias = _mm_set1_epi32(32768);
+  const __m128i flip = _mm_set1_epi16(-32768);
+
+  const std::size_t simdSize = size - size % 8;
+  std::size_t i = 0;
+  for (; i < simdSize; i += 8) {
+    __m128i low;
+    __m128i high;
+    quantizeDoubles(in + i, off, inv, levels, low, high);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                     _mm_xor_si128(_mm_packs_epi32(_mm_sub_epi32(low, bias),
+                                                   _mm_sub_epi32(high, bias)),
+                                   flip));
+  }
+
+  for (; i < size; i++) {
+    const double level = (in[i] - offset) * invScale;
+    out[i] = static_cast<std::uint16_t>(
+        std::min(std::max(level, 0.0), 65535.0) + 0.5);
+  }
+}
+
+template <>
+inline void quantize(const double *in, const std::size_t size,
+                     const double offset, const double invScale,
+                     std::uint8_t *out) {
+  const __m128d off = _mm_set1_pd(offset);
+  const __m128d inv = _mm_set1_pd(invScale);
+  const __m128d levels = _mm_set1_pd(255);
+
+  const std::size_t simdSize = size - size % 8;
+  std::size_t i = 0;
+  for (; i < simdSize; i += 8) {
+    __m128i low;
+    __m128i high;
+    quantizeDoubles(in + i, off, inv, levels, low, high);
+    // the codes fit in signed 16-bit, so both packs are exact
+    const __m128i words = _mm_packs_epi32(low, high);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i),
+                     _mm_packus_epi16(words, words));
+  }
+
+  for (; i < size; i++) {
+    const double level = (in[i] - offset) * invScale;
+    out[i] =
+        static_cast<std::uint8_t>(std::min(std::max(level, 0.0), 255.0) + 0.5);
+  }
+}
+
+template <>
+inline void dequantize(const std::uint16_t *in, const std::size_t size,
+                       const double scale, const double offset, double *out) {
+  const __m128d factor = _mm_set1_pd(scale);
+  const __m128d off = _mm_set1_pd(offset);
+
+  const std::size_t simdSize = size - size % 8;
+  std::size_t i = 0;
+  for (; i < simdSize; i += 8) {
+    dequantizeDoubles(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), factor,
+        off, out + i);
+  }
+
+  for (; i < size; i++) {
+    out[i] = static_cast<double>(in[i]) * scale + offset;
+  }
+}
+
+template <>
+inline void dequantize(const std::uint8_t *in, const std::size_t size,
+                       const double scale, const double offset, double *out) {
+  const __m128d factor = _mm_set1_pd(scale);
+  const __m128d off = _mm_set1_pd(offset);
+
+  const std::size_t simdSize = size - size % 8;
+  std::size_t i = 0;
+  for (; i < simdSize; i += 8) {
+    const __m128i bytes =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + i));
+    dequantizeDoubles(_mm_unpacklo_epi8(bytes, _mm_setzero_si128()), factor,
+                      off, out + i);
+  }
+
+  for (; i < size; i++) {
+    out[i] = static_cast<double>(in[i]) * scale + offset;
+  }
+}
+#endif
+
+/**
+ * @brief Appends an unsigned integer in little-endian byte order.
+ */
+template <typename U>
+void putBytes(std::vector<std::uint8_t> &bytes, const U value) {
+  for (std::size_t i = 0; i < sizeof(U); i++) {
+    bytes.push_back(static_cast<std::uint8_t>(value >> (8 * i)));
+  }
+}
+
+/**
+ * @brief Reads an unsigned integer in little-endian byte order.
+ */
+template <typename U> U getBytes(const std::uint8_t *bytes) {
+  U value = 0;
+  for (std::size_t i = 0; i < sizeof(U); i++) {
+    value = static_cast<U>(value | static_cast<U>(bytes[i]) << (8 * i));
+  }
+
+  return value;
+}
+
+/**
+ * @brief An unsigned integer with the same size as T, for the bits of a
+ * floating-point value.
+ */
+template <typename T> struct BitsOf {
+  typedef typename std::conditional<sizeof(T) == 4, std::uint32_t,
+                                    std::uint64_t>::type type;
+};
+} // namespace detail
+
+/**
+ * @brief An array of vectors stored as quantized integers.
+ *
+ * The vectors are split into blocks of a fixed number of vectors. In each
+ * block, every dimension is calibrated to the smallest and largest value
+ * of that dimension in the block, and each component is stored as an
+ * unsigned integer code between them:
+ *
+ *     value ≈ code * scale + offset
+ *
+ * With 16-bit codes, the array takes a quarter of the memory of double
+ * components (half of float components). The largest error of any decoded
+ * component is measured when encoding, and is available as maxError().
+ *
+ * A block can be decoded on its own. For float components with 16-bit
+ * codes, and for double components with 8 or 16-bit codes, encoding and
+ * decoding use SSE2.
+ *
+ * toBytes() and fromBytes() store the array in a little-endian format:
+ *
+ * | Bytes        | Content                                     |
+ * | ------------ | ------------------------------------------- |
+ * | 4            | "SVQA"                                      |
+ * | 1            | format version (1)                          |
+ * | 1            | bytes per component (4 or 8)                |
+ * | 1            | bytes per code (1, 2, or 4)                 |
+ * | 1            | reserved (0)                                |
+ * | 4            | number of dimensions                        |
+ * | 4            | vectors per block                           |
+ * | 8            | number of vectors                           |
+ * | 8            | maximum error, as a double                  |
+ * | per block    | D offsets, then D scales                    |
+ * | rest         | codes, by block, then by dimension          |
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type, float or double.
+ * @tparam Q The code type: std::uint8_t, std::uint16_t, or std::uint32_t
+ * (only with double).
+ */
+template <std::size_t D, typename T = double, typename Q = std::uint16_t>
+class QuantizedArray {
+public:
+  static_assert(std::is_floating_point<T>::value && sizeof(T) <= 8,
+                "QuantizedArray components must be float or double");
+  static_assert(std::is_same<Q, std::uint8_t>::value ||
+                    std::is_same<Q, std::uint16_t>::value ||
+                    std::is_same<Q, std::uint32_t>::value,
+                "QuantizedArray codes must be 8, 16, or 32-bit unsigned");
+  static_assert(std::numeric_limits<Q>::digits <
+                    std::numeric_limits<T>::digits,
+                "QuantizedArray codes must fit in the component mantissa");
+
+  typedef T value_type; //!< The component type.
+  typedef Q code_type;  //!< The type of the stored codes.
+
+  /**
+   * @brief No-argument constructor
+   *
+   * Creates an empty array.
+   */
+  QuantizedArray()
+      : m_size{0}, m_blockSize{SVECTOR_QUANTIZED_BLOCK_SIZE}, m_maxError{0} {}
+
+  /**
+   * @brief Encodes an array of vectors.
+   *
+   * Throws an invalid_argument exception if a component is not finite, or
+   * if blockSize is 0 or does not fit in 32 bits.
+   *
+   * @param vectors The vectors to encode.
+   * @param count The number of vectors.
+   * @param blockSize The number of vectors in each block.
+   */
+  QuantizedArray(const Vector<D, T> *vectors, const std::size_t count,
+                 const std::size_t blockSize = SVECTOR_QUANTIZED_BLOCK_SIZE)
+      : m_size{count}, m_blockSize{blockSize}, m_maxError{0} {
+    SVECTOR_INSTRUMENT_BATCH("quantize", D, T, count);
+    SVECTOR_ALLOC_SCOPE("QuantizedArray");
+
+    if (blockSize == 0 || blockSize > 0xFFFFFFFFU) {
+      throw std::invalid_argument(
+          "QuantizedArray: block size must be between 1 and 2^32 - 1");
+    }
+
+    m_offsets.resize(this->numBlocks() * D);
+    m_scales.resize(this->numBlocks() * D);
+    m_codes.resize(count * D);
+
+    T column[ColumnChunk];
+    T decoded[ColumnChunk];
+    for (std::size_t block = 0; block < this->numBlocks(); block++) {
+      const std::size_t start = block * m_blockSize;
+      const std::size_t length = this->blockLength(block);
+      this->calibrate(vectors + start, length, block);
+
+      for (std::size_t j = 0; j < D; j++) {
+        const T offset = m_offsets[block * D + j];
+        const T scale = m_scales[block * D + j];
+        // a subnormal scale would overflow the inverse, so the block is
+        // stored as its offset instead; the error is still measured below
+        const T invScale =
+            scale >= std::numeric_limits<T>::min() ? 1 / scale : 0;
+        Q *codes = this->codes(block, j);
+
+        for (std::size_t k = 0; k < length; k += ColumnChunk) {
+          const std::size_t chunk =
+              std::min<std::size_t>(length - k, ColumnChunk);
+          for (std::size_t c = 0; c < chunk; c++) {
+            column[c] = vectors[start + k + c][j];
+          }
+
+          detail::quantize(column, chunk, offset, invScale, codes + k);
+
+          // measure the error, rather than estimating it
+          detail::dequantize(codes + k, chunk, scale, offset, decoded);
+          for (std::size_t c = 0; c < chunk; c++) {
+            const T error = std::abs(decoded[c] - column[c]);
+            m_maxError = std::max(m_maxError, error);
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Gets the number of vectors.
+   */
+  std::size_t size() const { return m_size; }
+
+  /**
+   * @brief Gets the number of vectors in each block.
+   *
+   * The last block can have fewer.
+   */
+  std::size_t blockSize() const { return m_blockSize; }
+
+  /**
+   * @brief Gets the number of blocks.
+   */
+  std::size_t numBlocks() const {
+    return (m_size + m_blockSize - 1) / m_blockSize;
+  }
+
+  /**
+   * @brief Gets the number of vectors in a block.
+   *
+   * @param block The index of the block.
+   */
+  std::size_t blockLength(const std::size_t block) const {
+    return std::min(m_blockSize, m_size - block * m_blockSize);
+  }
+
+  /**
+   * @brief Gets the largest error of any decoded component.
+   *
+   * @returns The largest absolute difference between a component and its
+   * decoded value.
+   */
+  T maxError() const { return m_maxError; }
+
+  /**
+   * @brief Decodes one block.
+   *
+   * Throws an out_of_range exception if the block does not exist.
+   *
+   * @param block The index of the block.
+   * @param out The vectors to write to, with room for blockLength(block)
+   * vectors.
+   */
+  void decodeBlock(const std::size_t block, Vector<D, T> *out) const {
+    if (block >= this->numBlocks()) {
+      throw std::out_of_range("QuantizedArray: block out of range");
+    }
+
+    const std::size_t length = this->blockLength(block);
+    SVECTOR_INSTRUMENT_BATCH("dequantize", D, T, length);
+
+    T column[ColumnChunk];
+    for (std::size_t j = 0; j < D; j++) {
+      const T offset = m_offsets[block * D + j];
+      const T scale = m_scales[block * D + j];
+      const Q *codes = this->codes(block, j);
+
+      for (std::size_t k = 0; k < length; k += ColumnChunk) {
+        const std::size_t chunk =
+            std::min<std::size_t>(length - k, ColumnChunk);
+        detail::dequantize(codes + k, chunk, scale, offset, column);
+        for (std::size_t c = 0; c < chunk; c++) {
+          out[k + c][j] = column[c];
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Decodes every vector.
+   *
+   * @param out The vectors to write to, with room for size() vectors.
+   */
+  void decode(Vector<D, T> *out) const {
+    for (std::size_t block = 0; block < this->numBlocks(); block++) {
+      this->decodeBlock(block, out + block * m_blockSize);
+    }
+  }
+
+  /**
+   * @brief Decodes one vector.
+   *
+   * Throws an out_of_range exception if the index is out of range.
+   *
+   * @param index The index of the vector.
+   *
+   * @returns The decoded vector.
+   */
+  Vector<D, T> at(const std::size_t index) const {
+    if (index >= m_size) {
+      throw std::out_of_range("QuantizedArray: index out of range");
+    }
+
+    const std::size_t block = index / m_blockSize;
+    const std::size_t k = index % m_blockSize;
+
+    Vector<D, T> vec;
+    for (std::size_t j = 0; j < D; j++) {
+      vec[j] = static_cast<T>(this->codes(block, j)[k]) *
+                   m_scales[block * D + j] +
+               m_offsets[block * D + j];
+    }
+
+    return vec;
+  }
+
+  /**
+   * @brief Stores the array as bytes.
+   *
+   * See the class description for the format.
+   *
+   * @returns The bytes.
+   */
+  std::vector<std::uint8_t> toBytes() const {
+    SVECTOR_ALLOC_SCOPE("QuantizedArray");
+
+    std::vector<std::uint8_t> bytes;
+    bytes.reserve(HeaderSize + m_offsets.size() * 2 * sizeof(T) +
+                  m_codes.size() * sizeof(Q));
+
+    for (const char c : {'S', 'V', 'Q', 'A'}) {
+      bytes.push_back(static_cast<std::uint8_t>(c));
+    }
+    bytes.push_back(static_cast<std::uint8_t>(FormatVersion));
+    bytes.push_back(static_cast<std::uint8_t>(sizeof(T)));
+    bytes.push_back(static_cast<std::uint8_t>(sizeof(Q)));
+    bytes.push_back(0);
+    detail::putBytes(bytes, static_cast<std::uint32_t>(D));
+    detail::putBytes(bytes, static_cast<std::uint32_t>(m_blockSize));
+    detail::putBytes(bytes, static_cast<std::uint64_t>(m_size));
+    detail::putBytes(bytes, bitsOf(static_cast<double>(m_maxError)));
+
+    for (std::size_t block = 0; block < this->numBlocks(); block++) {
+      for (std::size_t j = 0; j < D; j++) {
+        detail::putBytes(bytes, bitsOf(m_offsets[block * D + j]));
+      }
+      for (std::size_t j = 0; j < D; j++) {
+        detail::putBytes(bytes, bitsOf(m_scales[block * D + j]));
+      }
+    }
+
+    for (const Q code : m_codes) {
+      detail::putBytes(bytes, code);
+    }
+
+    return bytes;
+  }
+
+  /**
+   * @brief Loads an array stored with toBytes().
+   *
+   * Throws an invalid_argument exception if the bytes are not an array
+   * with the same number of dimensions, component type, and code type.
+   *
+   * @param bytes The bytes.
+   * @param size The number of bytes.
+   *
+   * @returns The array.
+   */
+  static QuantizedArray fromBytes(const std::uint8_t *bytes,
+                                  const std::size_t size) {
+    typedef typename detail::BitsOf<T>::type bits_type;
+    SVECTOR_ALLOC_SCOPE("QuantizedArray");
+
+    if (size < HeaderSize || std::memcmp(bytes, "SVQA", 4) != 0 ||
+        bytes[4] != FormatVersion) {
+      throw std::invalid_argument("QuantizedArray: not a quantized array");
+    }
+    if (bytes[5] != sizeof(T) || bytes[6] != sizeof(Q) ||
+        detail::getBytes<std::uint32_t>(bytes + 8) != D) {
+      throw std::invalid_argument(
+          "QuantizedArray: dimensions or types do not match");
+    }
+
+    QuantizedArray array;
+    array.m_blockSize = detail::getBytes<std::uint32_t>(bytes + 12);
+    const std::uint64_t count = detail::getBytes<std::uint64_t>(bytes + 16);
+    array.m_maxError = static_cast<T>(
+        fromBitsOf<double>(detail::getBytes<std::uint64_t>(bytes + 24)));
+
+    // checked before multiplying, so that a corrupt count cannot overflow
+    const std::uint64_t available = (size - HeaderSize) / (D * sizeof(Q));
+    if (array.m_blockSize == 0 || count > available) {
+      throw std::invalid_argument("QuantizedArray: truncated data");
+    }
+    array.m_size = static_cast<std::size_t>(count);
+
+    const std::size_t parameters = array.numBlocks() * D;
+    if (size != HeaderSize + parameters * 2 * sizeof(T) +
+                    array.m_size * D * sizeof(Q)) {
+      throw std::invalid_argument("QuantizedArray: truncated data");
+    }
+
+    array.m_offsets.resize(parameters);
+    array.m_scales.resize(parameters);
+    const std::uint8_t *ptr = bytes + HeaderSize;
+    for (std::size_t block = 0; block < array.numBlocks(); block++) {
+      for (std::size_t j = 0; j < D; j++, ptr += sizeof(T)) {
+        array.m_offsets[block * D + j] =
+            fromBitsOf<T>(detail::getBytes<bits_type>(ptr));
+      }
+      for (std::size_t j = 0; j < D; j++, ptr += sizeof(T)) {
+        array.m_scales[block * D + j] =
+            fromBitsOf<T>(detail::getBytes<bits_type>(ptr));
+      }
+    }
+
+    array.m_codes.resize(array.m_size * D);
+    for (std::size_t i = 0; i < array.m_codes.size(); i++, ptr += sizeof(Q)) {
+      array.m_codes[i] = detail::getBytes<Q>(ptr);
+    }
+
+    return array;
+  }
+
+private:
+  enum : std::size_t {
+    HeaderSize = 32,   // bytes before the blocks
+    FormatVersion = 1, // changed with the format
+    ColumnChunk = 256  // components converted in one pass
+  };
+
+  std::size_t m_size;
+  std::size_t m_blockSize;
+  T m_maxError;
+  std::vector<T> m_offsets; // D per block
+  std::vector<T> m_scales;  // D per block
+  std::vector<Q> m_codes;   // block by block, dimension by dimension
+
+  /**
+   * @brief Gets the codes of one dimension of one block.
+   */
+  Q *codes(const std::size_t block, const std::size_t dim) {
+    return m_codes.data() + block * m_blockSize * D +
+           dim * this->blockLength(block);
+  }
+
+  const Q *codes(const std::size_t block, const std::size_t dim) const {
+    return m_codes.data() + block * m_blockSize * D +
+           dim * this->blockLength(block);
+  }
+
+  /**
+   * @brief Finds the offset and scale of each dimension of a block.
+   */
+  void calibrate(const Vector<D, T> *vectors, const std::size_t length,
+                 const std::size_t block) {
+    for (std::size_t j = 0; j < D; j++) {
+      T low = vectors[0][j];
+      T high = vectors[0][j];
+      for (std::size_t k = 0; k < length; k++) {
+        const T value = vectors[k][j];
+        if (!std::isfinite(value)) {
+          throw std::invalid_argument(
+              "QuantizedArray: components must be finite");
+        }
+        low = std::min(low, value);
+        high = std::max(high, value);
+      }
+
+      m_offsets[block * D + j] = low;
+      m_scales[block * D + j] =
+          (high - low) / static_cast<T>(std::numeric_limits<Q>::max());
+    }
+  }
+
+  /**
+   * @brief Gets the bits of a floating-point value.
+   */
+  template <typename F>
+  static typename detail::BitsOf<F>::type bitsOf(const F value) {
+    typename detail::BitsOf<F>::type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  /**
+   * @brief Makes a floating-point value from its bits.
+   */
+  template <typename F>
+  static F fromBitsOf(const typename detail::BitsOf<F>::type bits) {
+    F value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+};
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
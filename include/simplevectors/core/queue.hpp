@@ -0,0 +1,371 @@
+/**
+ * @file queue.hpp
+ *
+ * @brief Contains bounded lock-free queues for passing vectors between
+ * threads.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_QUEUE_HPP_
+#define INCLUDE_SVECTOR_QUEUE_HPP_
+
+#include <algorithm> // std::min
+#include <atomic>    // std::atomic, std::memory_order_*
+#include <cstddef>   // std::size_t, std::ptrdiff_t
+#include <utility>   // std::move
+
+namespace svector {
+// COMBINER_PY_START
+#ifndef SVECTOR_CACHE_LINE_SIZE
+/**
+ * @brief The size of a cache line in bytes.
+ *
+ * The indices of the queues are kept this far apart, so that a producer and
+ * a consumer on different cores do not keep taking the same cache line from
+ * each other.
+ */
+#define SVECTOR_CACHE_LINE_SIZE 64
+#endif
+
+/**
+ * @brief A bounded queue for exactly one producer thread and one consumer
+ * thread.
+ *
+ * The elements are stored in the queue itself, in a ring of Capacity slots,
+ * so pushing and popping never allocate and never lock. Each side keeps a
+ * copy of the other side's index and only reads the shared one when the
+ * copy says the queue is full (or empty), so most batches touch one shared
+ * cache line.
+ *
+ * Only one thread may push and only one thread may pop at a time; use
+ * MpmcQueue for more. The elements can be vectors or whole batches of them,
+ * such as `std::array<svector::Vector3D, 64>`.
+ *
+ * ```cpp
+ * svector::SpscQueue<svector::Vector3D, 1024> queue;
+ *
+ * // producer thread
+ * std::size_t sent = 0;
+ * while (sent < size) {
+ *   sent += queue.pushBatch(samples + sent, size - sent);
+ * }
+ *
+ * // consumer thread
+ * svector::Vector3D batch[64];
+ * const std::size_t count = queue.popBatch(batch, 64);
+ * ```
+ *
+ * @tparam T The element type, which must be default constructible and must
+ * not throw when assigned.
+ * @tparam Capacity The maximum number of elements, a power of 2.
+ */
+template <typename T, std::size_t Capacity> class SpscQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of 2");
+
+public:
+  typedef T value_type; //!< The element type.
+
+  /**
+   * @brief Creates an empty queue.
+   */
+  SpscQueue() : m_tail{0}, m_cachedHead{0}, m_head{0}, m_cachedTail{0} {}
+
+  SpscQueue(const SpscQueue &) = delete;
+  SpscQueue &operator=(const SpscQueue &) = delete;
+
+  /**
+   * @brief Gets the maximum number of elements.
+   */
+  static constexpr std::size_t capacity() { return Capacity; }
+
+  /**
+   * @brief Adds an element, if there is room. Producer only.
+   *
+   * @param value The element.
+   *
+   * @returns Whether the element was added.
+   */
+  bool tryPush(const T &value) { return this->pushBatch(&value, 1) == 1; }
+
+  /**
+   * @brief Adds as many elements of an array as there is room for, in
+   * order. Producer only.
+   *
+   * The consumer sees all of them at once.
+   *
+   * @param data The elements.
+   * @param count The number of elements.
+   *
+   * @returns The number of elements added, from the start of the array.
+   */
+  std::size_t pushBatch(const T *data, const std::size_t count) {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (Capacity - (tail - m_cachedHead) < count) {
+      m_cachedHead = m_head.load(std::memory_order_acquire);
+    }
+
+    const std::size_t pushed =
+        std::min(count, Capacity - (tail - m_cachedHead));
+    for (std::size_t i = 0; i < pushed; i++) {
+      m_slots[(tail + i) & (Capacity - 1)] = data[i];
+    }
+
+    m_tail.store(tail + pushed, std::memory_order_release);
+    return pushed;
+  }
+
+  /**
+   * @brief Removes the oldest element, if there is one. Consumer only.
+   *
+   * @param value Where to move the element.
+   *
+   * @returns Whether an element was removed.
+   */
+  bool tryPop(T &value) { return this->popBatch(&value, 1) == 1; }
+
+  /**
+   * @brief Removes up to a number of the oldest elements, in order.
+   * Consumer only.
+   *
+   * @param out Where to move the elements.
+   * @param maxCount The largest number of elements to remove.
+   *
+   * @returns The number of elements removed.
+   */
+  std::size_t popBatch(T *out, const std::size_t maxCount) {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    if (m_cachedTail - head < maxCount) {
+      m_cachedTail = m_tail.load(std::memory_order_acquire);
+    }
+
+    const std::size_t popped = std::min(maxCount, m_cachedTail - head);
+    for (std::size_t i = 0; i < popped; i++) {
+      out[i] = std::move(m_slots[(head + i) & (Capacity - 1)]);
+    }
+
+    m_head.store(head + popped, std::memory_order_release);
+    return popped;
+  }
+
+  /**
+   * @brief Gets the number of elements.
+   *
+   * This can be out of date by the time it returns if the other thread is
+   * using the queue.
+   */
+  std::size_t sizeApprox() const {
+    const std::size_t head = m_head.load(std::memory_order_acquire);
+    const std::size_t tail = m_tail.load(std::memory_order_acquire);
+    return tail - head;
+  }
+
+private:
+  // the indices only ever increase; the slot is the index mod Capacity
+
+  // written by the producer
+  alignas(SVECTOR_CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail;
+  std::size_t m_cachedHead;
+
+  // written by the consumer
+  alignas(SVECTOR_CACHE_LINE_SIZE) std::atomic<std::size_t> m_head;
+  std::size_t m_cachedTail;
+
+  alignas(SVECTOR_CACHE_LINE_SIZE) T m_slots[Capacity];
+};
+
+/**
+ * @brief A bounded queue for any number of producer and consumer threads.
+ *
+ * Like SpscQueue, the elements are stored in the queue itself and pushing
+ * and popping never allocate or lock. Each slot has a sequence number that
+ * says whether it is free for the next push or ready for the next pop
+ * (Dmitry Vyukov's bounded MPMC queue). A batch claims a whole run of slots
+ * with one compare-and-swap on the shared index, so the index is contended
+ * once per batch instead of once per element.
+ *
+ * The elements of one batch stay together and in order, but batches from
+ * different producers can be interleaved.
+ *
+ * @tparam T The element type, which must be default constructible and must
+ * not throw when assigned.
+ * @tparam Capacity The maximum number of elements, a power of 2.
+ */
+template <typename T, std::size_t Capacity> class MpmcQueue {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "MpmcQueue capacity must be a power of 2");
+
+public:
+  typedef T value_type; //!< The element type.
+
+  /**
+   * @brief Creates an empty queue.
+   */
+  MpmcQueue() : m_tail{0}, m_head{0} {
+    for (std::size_t i = 0; i < Capacity; i++) {
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpmcQueue(const MpmcQueue &) = delete;
+  MpmcQueue &operator=(const MpmcQueue &) = delete;
+
+  /**
+   * @brief Gets the maximum number of elements.
+   */
+  static constexpr std::size_t capacity() { return Capacity; }
+
+  /**
+   * @brief Adds an element, if there is room.
+   *
+   * @param value The element.
+   *
+   * @returns Whether the element was added.
+   */
+  bool tryPush(const T &value) { return this->pushBatch(&value, 1) == 1; }
+
+  /**
+   * @brief Adds as many elements of an array as there are free slots in a
+   * row, in order.
+   *
+   * @param data The elements.
+   * @param count The number of elements.
+   *
+   * @returns The number of elements added, from the start of the array.
+   */
+  std::size_t pushBatch(const T *data, const std::size_t count) {
+    if (count == 0) {
+      return 0;
+    }
+
+    std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    while (true) {
+      // a slot is free for the push at index i when its sequence is i
+      const std::size_t claimed = this->countReady(tail, count, 0);
+      if (claimed == 0) {
+        if (this->distance(tail, 0) < 0) {
+          return 0; // full
+        }
+        tail = m_tail.load(std::memory_order_relaxed);
+        continue;
+      }
+
+      // on failure, tail is reloaded and the slots are checked again
+      if (m_tail.compare_exchange_weak(tail, tail + claimed,
+                                       std::memory_order_relaxed)) {
+        for (std::size_t i = 0; i < claimed; i++) {
+          Cell &cell = m_cells[(tail + i) & (Capacity - 1)];
+          cell.value = data[i];
+          cell.sequence.store(tail + i + 1, std::memory_order_release);
+        }
+
+        return claimed;
+      }
+    }
+  }
+
+  /**
+   * @brief Removes the oldest element, if there is one.
+   *
+   * @param value Where to move the element.
+   *
+   * @returns Whether an element was removed.
+   */
+  bool tryPop(T &value) { return this->popBatch(&value, 1) == 1; }
+
+  /**
+   * @brief Removes up to a number of the oldest elements, as many as are
+   * ready in a row, in order.
+   *
+   * @param out Where to move the elements.
+   * @param maxCount The largest number of elements to remove.
+   *
+   * @returns The number of elements removed.
+   */
+  std::size_t popBatch(T *out, const std::size_t maxCount) {
+    if (maxCount == 0) {
+      return 0;
+    }
+
+    std::size_t head = m_head.load(std::memory_order_relaxed);
+    while (true) {
+      // a slot is ready for the pop at index i when its sequence is i + 1
+      const std::size_t claimed = this->countReady(head, maxCount, 1);
+      if (claimed == 0) {
+        if (this->distance(head, 1) < 0) {
+          return 0; // empty
+        }
+        head = m_head.load(std::memory_order_relaxed);
+        continue;
+      }
+
+      if (m_head.compare_exchange_weak(head, head + claimed,
+                                       std::memory_order_relaxed)) {
+        for (std::size_t i = 0; i < claimed; i++) {
+          Cell &cell = m_cells[(head + i) & (Capacity - 1)];
+          out[i] = std::move(cell.value);
+          cell.sequence.store(head + i + Capacity, std::memory_order_release);
+        }
+
+        return claimed;
+      }
+    }
+  }
+
+  /**
+   * @brief Gets the number of elements, including the ones that are being
+   * pushed or popped.
+   *
+   * This can be out of date by the time it returns if other threads are
+   * using the queue.
+   */
+  std::size_t sizeApprox() const {
+    const std::size_t head = m_head.load(std::memory_order_acquire);
+    const std::size_t tail = m_tail.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+  }
+
+private:
+  struct Cell {
+    std::atomic<std::size_t> sequence;
+    T value;
+  };
+
+  alignas(SVECTOR_CACHE_LINE_SIZE) std::atomic<std::size_t> m_tail;
+  alignas(SVECTOR_CACHE_LINE_SIZE) std::atomic<std::size_t> m_head;
+  alignas(SVECTOR_CACHE_LINE_SIZE) Cell m_cells[Capacity];
+
+  /**
+   * @brief Gets how far the sequence of the slot at an index is from
+   * index + offset; negative means the slot is not there yet.
+   */
+  std::ptrdiff_t distance(const std::size_t index,
+                          const std::size_t offset) const {
+    const std::size_t sequence = m_cells[index & (Capacity - 1)].sequence.load(
+        std::memory_order_acquire);
+    return static_cast<std::ptrdiff_t>(sequence - (index + offset));
+  }
+
+  /**
+   * @brief Counts the slots in a row from an index whose sequence is
+   * index + offset, up to a maximum.
+   *
+   * A slot in that state stays in it until its index is claimed, so the
+   * count is still right if the compare-and-swap that claims them succeeds.
+   */
+  std::size_t countReady(const std::size_t index, const std::size_t maxCount,
+                         const std::size_t offset) const {
+    std::size_t count = 0;
+    while (count < maxCount && this->distance(index + count, offset) == 0) {
+      count++;
+    }
+
+    return count;
+  }
+};
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
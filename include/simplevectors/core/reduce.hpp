@@ -0,0 +1,230 @@
+/**
+ * @file reduce.hpp
+ *
+ * @brief Contains parallel sums over arrays of vectors.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_REDUCE_HPP_
+#define INCLUDE_SVECTOR_REDUCE_HPP_
+
+#include <cmath>       // std::abs, std::isfinite
+#include <cstddef>     // std::size_t
+#include <limits>      // std::numeric_limits
+#include <thread>      // std::thread
+#include <type_traits> // std::is_floating_point
+#include <vector>      // std::vector
+
+#include "simplevectors/core/accumulate.hpp" // svector::Reproducible, ...
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_BATCH
+#include "simplevectors/core/vector.hpp"     // svector::Vector
+
+namespace svector {
+// COMBINER_PY_START
+namespace detail {
+/**
+ * @brief Runs fn(t, begin, end) for each of a number of ranges that split
+ * [0, size), on that many threads including the calling one.
+ */
+template <typename F>
+void forEachRange(const std::size_t size, const std::size_t threads, F fn) {
+  std::vector<std::thread> pool;
+  pool.reserve(threads - 1);
+  for (std::size_t t = 1; t < threads; t++) {
+    pool.emplace_back([&fn, t, size, threads]() {
+      fn(t, size * t / threads, size * (t + 1) / threads);
+    });
+  }
+  fn(0, 0, size / threads);
+  for (std::thread &worker : pool) {
+    worker.join();
+  }
+}
+
+/**
+ * @brief Gets the number of threads to split a sum of an array between.
+ */
+inline std::size_t reduceThreads(const std::size_t size,
+                                 const std::size_t threads) {
+  if (threads <= 1 || size <= 1) {
+    return 1;
+  }
+
+  return threads < size ? threads : size;
+}
+
+/**
+ * @brief Adds up an array of vectors, with one partial sum for each thread.
+ */
+template <std::size_t D, typename T>
+Vector<D, T> threadedSum(const Vector<D, T> *data, const std::size_t size,
+                         const std::size_t threads) {
+  const std::size_t workers = reduceThreads(size, threads);
+  std::vector<Vector<D, T>> partial(workers);
+  forEachRange(size, workers,
+               [data, &partial](const std::size_t t, const std::size_t begin,
+                                const std::size_t end) {
+                 Vector<D, T> result;
+                 for (std::size_t i = begin; i < end; i++) {
+                   result += data[i];
+                 }
+                 partial[t] = result;
+               });
+
+  Vector<D, T> result;
+  for (const Vector<D, T> &part : partial) {
+    result += part;
+  }
+
+  return result;
+}
+
+/**
+ * @brief Sums an array of integer vectors, which is exact in any order.
+ */
+template <std::size_t D, typename T>
+Vector<D, T> reproducibleSum(const Vector<D, T> *data, const std::size_t size,
+                             const std::size_t threads, std::false_type);
+
+/**
+ * @brief Sums an array of floating-point vectors with a ReproducibleSum for
+ * each component.
+ */
+template <std::size_t D, typename T>
+Vector<D, T> reproducibleSum(const Vector<D, T> *data, const std::size_t size,
+                             const std::size_t threads, std::true_type);
+} // namespace detail
+
+/**
+ * @brief Adds up an array of vectors.
+ *
+ * The array is split into one range for each thread, and the sums of the
+ * ranges are added in order. The result depends on the number of threads,
+ * since that changes where the rounding happens; pass Reproducible() as the
+ * last argument for a result that does not.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ *
+ * @param data The vectors.
+ * @param size The number of vectors.
+ * @param threads The number of threads to split the work between. 0 or 1
+ * runs on the calling thread only.
+ *
+ * @returns The sum of the vectors.
+ */
+template <std::size_t D, typename T>
+Vector<D, T> sum(const Vector<D, T> *data, const std::size_t size,
+                 const std::size_t threads = 1) {
+  SVECTOR_INSTRUMENT_BATCH("sum", D, T, size);
+  return detail::threadedSum(data, size, threads);
+}
+
+/**
+ * @brief Adds up an array of vectors, with the same result bit for bit
+ * whatever the number of threads and on any machine.
+ *
+ * See Reproducible for how. The array is read twice, once to find the
+ * largest absolute value of each component.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ *
+ * @param data The vectors.
+ * @param size The number of vectors.
+ * @param threads The number of threads to split the work between.
+ *
+ * @returns The sum of the vectors.
+ */
+template <std::size_t D, typename T>
+Vector<D, T> sum(const Vector<D, T> *data, const std::size_t size,
+                 const std::size_t threads, Reproducible) {
+  SVECTOR_INSTRUMENT_BATCH("sum", D, T, size);
+  return detail::reproducibleSum(data, size, threads,
+                                 std::is_floating_point<T>());
+}
+
+namespace detail {
+template <std::size_t D, typename T>
+Vector<D, T> reproducibleSum(const Vector<D, T> *data, const std::size_t size,
+                             const std::size_t threads, std::false_type) {
+  return threadedSum(data, size, threads);
+}
+
+template <std::size_t D, typename T>
+Vector<D, T> reproducibleSum(const Vector<D, T> *data, const std::size_t size,
+                             const std::size_t threads, std::true_type) {
+  typedef typename accumulate::ReproducibleType<T>::type wide;
+  typedef std::vector<accumulate::ReproducibleSum<wide>> Sums;
+
+  const std::size_t workers = reduceThreads(size, threads);
+
+  // the largest absolute value of each component; a max does not depend on
+  // the order
+  std::vector<Vector<D, wide>> partialMax(workers);
+  forEachRange(size, workers,
+               [data, &partialMax](const std::size_t t,
+                                   const std::size_t begin,
+                                   const std::size_t end) {
+                 Vector<D, wide> maxAbs;
+                 for (std::size_t i = begin; i < end; i++) {
+                   for (std::size_t j = 0; j < D; j++) {
+                     const wide value = std::abs(static_cast<wide>(data[i][j]));
+                     // infinity also stands for nan here
+                     maxAbs[j] = !std::isfinite(value)
+                                     ? std::numeric_limits<wide>::infinity()
+                                     : (value > maxAbs[j] ? value : maxAbs[j]);
+                   }
+                 }
+                 partialMax[t] = maxAbs;
+               });
+
+  Vector<D, wide> maxAbs;
+  for (const Vector<D, wide> &part : partialMax) {
+    for (std::size_t j = 0; j < D; j++) {
+      maxAbs[j] = part[j] > maxAbs[j] ? part[j] : maxAbs[j];
+    }
+  }
+
+  // the sums are made here, since making one can throw
+  Sums empty;
+  for (std::size_t j = 0; j < D; j++) {
+    empty.emplace_back(maxAbs[j], size);
+  }
+  std::vector<Sums> partial(workers, empty);
+  forEachRange(size, workers,
+               [data, &partial](const std::size_t t, const std::size_t begin,
+                                const std::size_t end) {
+                 // each component is copied to a block, so that the sums
+                 // can add whole arrays
+                 Sums &sums = partial[t];
+                 wide block[256];
+                 for (std::size_t start = begin; start < end; start += 256) {
+                   const std::size_t count =
+                       end - start < 256 ? end - start : 256;
+                   for (std::size_t j = 0; j < D; j++) {
+                     for (std::size_t i = 0; i < count; i++) {
+                       block[i] = static_cast<wide>(data[start + i][j]);
+                     }
+                     sums[j].add(block, count);
+                   }
+                 }
+               });
+
+  Vector<D, T> result;
+  for (std::size_t j = 0; j < D; j++) {
+    for (std::size_t t = 1; t < workers; t++) {
+      partial[0][j].merge(partial[t][j]);
+    }
+    result[j] = static_cast<T>(partial[0][j].result());
+  }
+
+  return result;
+}
+} // namespace detail
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
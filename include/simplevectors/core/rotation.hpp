@@ -0,0 +1,387 @@
+/**
+ * @file rotation.hpp
+ *
+ * @brief Contains 2D rotations with a precomputed sine and cosine.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_ROTATION_HPP_
+#define INCLUDE_SVECTOR_ROTATION_HPP_
+
+#include <cmath>       // std::atan2, std::cos, std::fmod, std::sin
+#include <cstddef>     // std::size_t
+#include <type_traits> // std::common_type, std::is_floating_point, ...
+
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_BATCH
+#include "simplevectors/core/matrix.hpp"     // svector::Matrix
+#include "simplevectors/core/simd.hpp"       // svector::simd::detail::Lanes
+#include "simplevectors/core/vector.hpp"     // svector::Vector
+#include "simplevectors/core/vector2d.hpp"   // svector::BasicVector2D
+
+namespace svector {
+// COMBINER_PY_START
+#ifndef SVECTOR_ROTATION_RESYNC_INTERVAL
+/**
+ * @brief The default number of steps after which a BasicRotationStepper2D
+ * computes its rotation from the angle again.
+ */
+#define SVECTOR_ROTATION_RESYNC_INTERVAL 256
+#endif
+
+namespace detail {
+/**
+ * @brief Rotates vectors stored as an array of x-components and an array of
+ * y-components.
+ */
+template <typename T>
+void rotateComponents(const T c, const T s, const T *xs, const T *ys,
+                      T *outXs, T *outYs, const std::size_t size,
+                      std::false_type) {
+  for (std::size_t i = 0; i < size; i++) {
+    const T x = xs[i];
+    const T y = ys[i];
+    outXs[i] = x * c - y * s;
+    outYs[i] = x * s + y * c;
+  }
+}
+
+template <typename T>
+void rotateComponents(const T c, const T s, const T *xs, const T *ys,
+                      T *outXs, T *outYs, const std::size_t size,
+                      std::true_type) {
+  typedef simd::detail::Lanes<T> L;
+
+  const typename L::reg cosines = L::set(c);
+  const typename L::reg sines = L::set(s);
+  const std::size_t simdSize = size - size % L::width;
+  std::size_t i = 0;
+  for (; i < simdSize; i += L::width) {
+    const typename L::reg x = L::load(xs + i);
+    const typename L::reg y = L::load(ys + i);
+    L::store(outXs + i, L::sub(L::mul(x, cosines), L::mul(y, sines)));
+    L::store(outYs + i, L::add(L::mul(x, sines), L::mul(y, cosines)));
+  }
+  rotateComponents(c, s, xs + i, ys + i, outXs + i, outYs + i, size - i,
+                   std::false_type());
+}
+} // namespace detail
+
+/**
+ * @brief A 2D rotation, stored as the cosine and sine of its angle.
+ *
+ * BasicVector2D::rotate() computes a cosine and a sine on every call. A
+ * rotation computes them once, when it is made, and can then rotate any
+ * number of vectors, one at a time or a whole array at a time. Composing two
+ * rotations multiplies them instead of adding their angles, so no sine or
+ * cosine is computed either.
+ *
+ * Use the svector::Rotation2D (double) and svector::Rotation2f (float)
+ * aliases.
+ *
+ * ```cpp
+ * const svector::Rotation2D rotation(heading);
+ * const svector::Vector2D turned = rotation * v;
+ * rotation.apply(points.data(), points.size(), points.data());
+ * ```
+ *
+ * @tparam T Component type.
+ */
+template <typename T> class BasicRotation2D {
+  static_assert(std::is_floating_point<T>::value,
+                "Rotation type must be floating point");
+
+public:
+  typedef T value_type; //!< Component type.
+
+  /**
+   * @brief Creates the rotation by 0.
+   */
+  BasicRotation2D() : m_cos{1}, m_sin{0} {}
+
+  /**
+   * @brief Creates a rotation by an angle.
+   *
+   * The rotation is counterclockwise when the angle is positive, like
+   * BasicVector2D::rotate().
+   *
+   * @param ang The angle, in radians.
+   */
+  explicit BasicRotation2D(const T ang)
+      : m_cos{std::cos(ang)}, m_sin{std::sin(ang)} {}
+
+  /**
+   * @brief Creates a rotation from the cosine and sine of its angle.
+   *
+   * The cosine and sine are used as they are, so c * c + s * s should be 1.
+   *
+   * @param c The cosine.
+   * @param s The sine.
+   */
+  static BasicRotation2D fromCosSin(const T c, const T s) {
+    BasicRotation2D result;
+    result.m_cos = c;
+    result.m_sin = s;
+    return result;
+  }
+
+  /**
+   * @brief Gets the cosine of the angle.
+   */
+  T cos() const { return this->m_cos; }
+
+  /**
+   * @brief Gets the sine of the angle.
+   */
+  T sin() const { return this->m_sin; }
+
+  /**
+   * @brief Gets the angle, in the range (-π, π].
+   */
+  T angle() const { return std::atan2(this->m_sin, this->m_cos); }
+
+  /**
+   * @brief Gets the rotation by the opposite angle.
+   */
+  BasicRotation2D inverse() const {
+    return fromCosSin(this->m_cos, -this->m_sin);
+  }
+
+  /**
+   * @brief Composes two rotations.
+   *
+   * @param other The other rotation.
+   *
+   * @returns The rotation by the sum of the angles.
+   */
+  BasicRotation2D operator*(const BasicRotation2D &other) const {
+    return fromCosSin(this->m_cos * other.m_cos - this->m_sin * other.m_sin,
+                      this->m_sin * other.m_cos + this->m_cos * other.m_sin);
+  }
+
+  /**
+   * @brief Composes another rotation into this one.
+   *
+   * @param other The other rotation.
+   *
+   * @returns A reference to this rotation.
+   */
+  BasicRotation2D &operator*=(const BasicRotation2D &other) {
+    *this = *this * other;
+    return *this;
+  }
+
+  /**
+   * @brief Rotates a vector.
+   *
+   * @param v The vector.
+   *
+   * @returns The rotated vector.
+   */
+  BasicVector2D<T> operator*(const Vector<2, T> &v) const {
+    return BasicVector2D<T>{v[0] * this->m_cos - v[1] * this->m_sin,
+                            v[0] * this->m_sin + v[1] * this->m_cos};
+  }
+
+  /**
+   * @brief Rotates an array of vectors.
+   *
+   * The output may be the same array as the input.
+   *
+   * @tparam V The vector type, such as svector::Vector2D or
+   * svector::Vector<2, double>.
+   *
+   * @param in The vectors.
+   * @param size The number of vectors.
+   * @param out The array to write the rotated vectors to.
+   */
+  template <typename V>
+  void apply(const V *in, const std::size_t size, V *out) const {
+    static_assert(std::is_base_of<Vector<2, T>, V>::value,
+                  "The vectors must be 2D and have the type of the rotation");
+    SVECTOR_INSTRUMENT_BATCH("rotationApply", 2, T, size);
+
+    // copies, so that writing to out does not make the compiler read them
+    // again for each vector
+    const T c = this->m_cos;
+    const T s = this->m_sin;
+    for (std::size_t i = 0; i < size; i++) {
+      const T x = in[i][0];
+      const T y = in[i][1];
+      out[i][0] = x * c - y * s;
+      out[i][1] = x * s + y * c;
+    }
+  }
+
+  /**
+   * @brief Rotates vectors stored as an array of x-components and an array
+   * of y-components.
+   *
+   * Float and double components are rotated several vectors at a time with
+   * SIMD (see simd.hpp). The output arrays may be the same as the input
+   * arrays.
+   *
+   * @param xs The x-components.
+   * @param ys The y-components.
+   * @param outXs The array to write the rotated x-components to.
+   * @param outYs The array to write the rotated y-components to.
+   * @param size The number of vectors.
+   */
+  void applyComponents(const T *xs, const T *ys, T *outXs, T *outYs,
+                       const std::size_t size) const {
+    SVECTOR_INSTRUMENT_BATCH("rotationApplyComponents", 2, T, size);
+    detail::rotateComponents(this->m_cos, this->m_sin, xs, ys, outXs, outYs,
+                             size, simd::detail::HasLanes<T>());
+  }
+
+  /**
+   * @brief Gets the rotation as a matrix, to compose with other transforms.
+   */
+  Matrix<2, 2, T> toMatrix() const {
+    return Matrix<2, 2, T>{this->m_cos, -this->m_sin, this->m_sin,
+                           this->m_cos};
+  }
+
+private:
+  T m_cos;
+  T m_sin;
+};
+
+typedef BasicRotation2D<double> Rotation2D; //!< A rotation of doubles.
+typedef BasicRotation2D<float> Rotation2f;  //!< A rotation of floats.
+
+/**
+ * @brief Steps a rotation by the same small angle again and again, without
+ * computing a sine or a cosine for each step.
+ *
+ * Each step composes the current rotation with the rotation by the step
+ * angle, which takes four multiplications. Each composition rounds, so the
+ * angle and the length slowly drift; every resync interval steps, the
+ * rotation is computed again from start + steps() * step. That angle is
+ * computed in at least double precision and reduced modulo 2π before its
+ * sine and cosine are taken, so that float steppers do not lose the
+ * fraction of a large angle, and the error stays at the size of a few
+ * roundings of T for any realistic number of steps.
+ *
+ * ```cpp
+ * svector::RotationStepper2D heading(start, turnRate * dt);
+ * for (...) {
+ *   position += heading.current() * velocity;
+ *   heading.advance();
+ * }
+ * ```
+ *
+ * @tparam T Component type.
+ */
+template <typename T> class BasicRotationStepper2D {
+  static_assert(std::is_floating_point<T>::value,
+                "Rotation type must be floating point");
+
+public:
+  /**
+   * @brief Creates a stepper at the start angle.
+   *
+   * @param start The first angle, in radians.
+   * @param step The angle added by each step, in radians.
+   * @param resyncInterval The number of steps after which the rotation is
+   * computed from the angle again. 0 means never.
+   */
+  BasicRotationStepper2D(
+      const T start, const T step,
+      const std::size_t resyncInterval = SVECTOR_ROTATION_RESYNC_INTERVAL)
+      : m_start{static_cast<wide_type>(start)},
+        m_step{static_cast<wide_type>(step)}, m_resyncInterval{resyncInterval},
+        m_steps{0}, m_sinceResync{0}, m_stepRotation(step),
+        m_current(start) {}
+
+  /**
+   * @brief Gets the rotation by the current angle.
+   */
+  const BasicRotation2D<T> &current() const { return this->m_current; }
+
+  /**
+   * @brief Gets the number of steps taken.
+   */
+  std::size_t steps() const { return this->m_steps; }
+
+  /**
+   * @brief Gets the current angle, start + steps() * step, in radians.
+   */
+  T angle() const {
+    return static_cast<T>(this->m_start +
+                          static_cast<wide_type>(this->m_steps) * this->m_step);
+  }
+
+  /**
+   * @brief Adds the step angle to the current rotation.
+   */
+  void advance() {
+    this->m_steps++;
+    this->m_sinceResync++;
+    if (this->m_sinceResync == this->m_resyncInterval) {
+      this->resync();
+      this->m_sinceResync = 0;
+    } else {
+      this->m_current *= this->m_stepRotation;
+    }
+  }
+
+  /**
+   * @brief Rotates each vector of an array by the current rotation, and
+   * steps after each one.
+   *
+   * Vector i is rotated by the angle of i steps after the current one, as
+   * for points sampled at a constant rate while turning at a constant rate.
+   * The output may be the same array as the input.
+   *
+   * @tparam V The vector type, such as svector::Vector2D.
+   *
+   * @param in The vectors.
+   * @param size The number of vectors.
+   * @param out The array to write the rotated vectors to.
+   */
+  template <typename V>
+  void apply(const V *in, const std::size_t size, V *out) {
+    SVECTOR_INSTRUMENT_BATCH("rotationStepperApply", 2, T, size);
+
+    for (std::size_t i = 0; i < size; i++) {
+      out[i] = this->m_current * in[i];
+      this->advance();
+    }
+  }
+
+private:
+  // float is widened to double; double and long double are kept
+  typedef typename std::common_type<T, double>::type wide_type;
+
+  wide_type m_start;
+  wide_type m_step;
+  std::size_t m_resyncInterval;
+  std::size_t m_steps;
+  std::size_t m_sinceResync;
+  BasicRotation2D<T> m_stepRotation;
+  BasicRotation2D<T> m_current;
+
+  /**
+   * @brief Computes the current rotation from the angle again.
+   */
+  void resync() {
+    const wide_type twoPi =
+        static_cast<wide_type>(6.283185307179586476925286766559L);
+    const wide_type ang =
+        this->m_start +
+        std::fmod(static_cast<wide_type>(this->m_steps) * this->m_step, twoPi);
+    this->m_current = BasicRotation2D<T>::fromCosSin(
+        static_cast<T>(std::cos(ang)), static_cast<T>(std::sin(ang)));
+  }
+};
+
+typedef BasicRotationStepper2D<double>
+    RotationStepper2D; //!< A rotation stepper of doubles.
+typedef BasicRotationStepper2D<float>
+    RotationStepper2f; //!< A rotation stepper of floats.
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ * @file scatter.hpp
+ *
+ * @brief Contains per-thread accumulators for adding into shared vector
+ * arrays from several threads.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_SCATTER_HPP_
+#define INCLUDE_SVECTOR_SCATTER_HPP_
+
+#include <algorithm> // std::max, std::min
+#include <cstddef>   // std::size_t
+#include <memory>    // std::unique_ptr
+#include <new>       // placement new
+#include <thread>    // std::thread
+#include <utility>   // std::make_pair, std::pair
+#include <vector>    // std::vector
+
+#include "simplevectors/core/alloc.hpp"      // SVECTOR_ALLOC_SCOPE
+#include "simplevectors/core/dynvector.hpp"  // detail::alignedAllocate
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_BATCH
+#include "simplevectors/core/queue.hpp"      // SVECTOR_CACHE_LINE_SIZE
+#include "simplevectors/core/vector.hpp"     // svector::Vector
+
+namespace svector {
+// COMBINER_PY_START
+#ifndef SVECTOR_SCATTER_DENSE_FRACTION
+/**
+ * @brief The default fraction of the array that a thread has to update in
+ * one step before its buffer of a ScatterAccumulator becomes dense.
+ */
+#define SVECTOR_SCATTER_DENSE_FRACTION 0.125
+#endif
+
+/**
+ * @brief Lets several threads add into one array of vectors without atomics
+ * or locks.
+ *
+ * In a parallel force computation, two threads often add to the same
+ * element, such as two particles pushing on a third one. Instead of adding
+ * into the array, each thread adds into a private buffer with add(), and
+ * reduce() adds every buffer into the array at the end, split between
+ * threads by index range so that no two threads write the same element.
+ *
+ * A buffer starts out sparse: it keeps a list of the updates, which costs
+ * nothing when a thread only touches a few elements. Once a thread has made
+ * more than denseFraction * size() updates in a step, its buffer switches to
+ * a dense array with one vector for each element and stays dense, since the
+ * next steps will likely touch as many elements.
+ *
+ * ```cpp
+ * svector::ScatterAccumulator<3, double> forces(particles.size(), 4);
+ *
+ * // on thread t
+ * forces.add(t, i, f);
+ * forces.add(t, j, -f);
+ *
+ * // after joining the threads
+ * forces.reduce(total.data(), 4);
+ * ```
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ */
+template <std::size_t D, typename T> class ScatterAccumulator {
+public:
+  /**
+   * @brief Creates an accumulator with no updates.
+   *
+   * @param size The number of elements of the array.
+   * @param threads The number of threads that add, each with its own
+   * buffer. 0 means 1.
+   * @param denseFraction The fraction of size() updates after which a
+   * buffer becomes dense. 0 makes every buffer dense from the start.
+   */
+  ScatterAccumulator(
+      const std::size_t size, const std::size_t threads,
+      const double denseFraction = SVECTOR_SCATTER_DENSE_FRACTION)
+      : m_size{size},
+        m_denseThreshold{static_cast<std::size_t>(
+            denseFraction * static_cast<double>(size))} {
+    SVECTOR_ALLOC_SCOPE("ScatterAccumulator");
+
+    const std::size_t count = threads == 0 ? 1 : threads;
+    m_buffers.reserve(count);
+    for (std::size_t t = 0; t < count; t++) {
+      void *memory = detail::alignedAllocate(sizeof(Buffer), alignof(Buffer));
+      m_buffers.emplace_back(new (memory) Buffer());
+      if (m_denseThreshold == 0) {
+        m_buffers.back()->dense.resize(m_size);
+      }
+    }
+  }
+
+  /**
+   * @brief Gets the number of elements of the array.
+   */
+  std::size_t size() const { return m_size; }
+
+  /**
+   * @brief Gets the number of threads that can add.
+   */
+  std::size_t numThreads() const { return m_buffers.size(); }
+
+  /**
+   * @brief Checks whether the buffer of a thread is dense.
+   *
+   * @param thread The thread, less than numThreads().
+   */
+  bool isDense(const std::size_t thread) const {
+    return !m_buffers[thread]->dense.empty();
+  }
+
+  /**
+   * @brief Adds a vector to an element, in the buffer of a thread.
+   *
+   * Each thread must only use its own buffer, and no thread may add while
+   * reduce() runs.
+   *
+   * @param thread The thread, less than numThreads().
+   * @param index The element, less than size().
+   * @param value The vector to add.
+   */
+  void add(const std::size_t thread, const std::size_t index,
+           const Vector<D, T> &value) {
+    Buffer &buffer = *m_buffers[thread];
+    if (!buffer.dense.empty()) {
+      buffer.dense[index] += value;
+      return;
+    }
+
+    SVECTOR_ALLOC_SCOPE("ScatterAccumulator");
+    buffer.updates.push_back(std::make_pair(index, value));
+    if (buffer.updates.size() > m_denseThreshold) {
+      buffer.dense.resize(m_size);
+      for (const Update &update : buffer.updates) {
+        buffer.dense[update.first] += update.second;
+      }
+      buffer.updates.clear();
+    }
+  }
+
+  /**
+   * @brief Adds every buffer into an array, and empties the buffers for the
+   * next step.
+   *
+   * The array is split into index ranges, one for each thread, so no
+   * element is written by two threads. Sparse buffers are read by every
+   * thread but only add the updates in its range. Fewer threads are used
+   * when there is little to add.
+   *
+   * @param out The array to add into, with size() elements.
+   * @param threads The number of threads to split the work between. 0 or 1
+   * runs on the calling thread only.
+   */
+  void reduce(Vector<D, T> *out, const std::size_t threads = 1) {
+    SVECTOR_INSTRUMENT_BATCH("scatterReduce", D, T, m_size);
+    SVECTOR_ALLOC_SCOPE("ScatterAccumulator");
+
+    // a dense buffer is read in full, but sparse updates are read by every
+    // thread, so only start threads for work that is worth splitting
+    std::size_t work = 0;
+    for (const BufferPtr &buffer : m_buffers) {
+      work += buffer->dense.empty() ? buffer->updates.size() : m_size;
+    }
+    const std::size_t workers = std::max<std::size_t>(
+        1, std::min(threads, work / MIN_WORK_PER_THREAD));
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t t = 1; t < workers; t++) {
+      pool.emplace_back([this, out, t, workers]() {
+        this->reduceRange(out, m_size * t / workers,
+                          m_size * (t + 1) / workers);
+      });
+    }
+    this->reduceRange(out, 0, m_size / workers);
+    for (std::thread &worker : pool) {
+      worker.join();
+    }
+
+    for (const BufferPtr &buffer : m_buffers) {
+      buffer->updates.clear();
+    }
+  }
+
+private:
+  typedef std::pair<std::size_t, Vector<D, T>> Update;
+
+  // below this many elements and updates for each thread, starting a
+  // thread takes longer than the work it does
+  static constexpr std::size_t MIN_WORK_PER_THREAD = 16384;
+
+  // each buffer starts on its own cache line, and its size is rounded up to
+  // whole lines, so threads growing their own buffers never write to the
+  // same line; the arrays that the buffers point to are allocated separately
+  struct alignas(SVECTOR_CACHE_LINE_SIZE) Buffer {
+    std::vector<Update> updates;     // while sparse
+    std::vector<Vector<D, T>> dense; // once dense, one for each element
+  };
+
+  // a plain new would ignore the alignment before C++17
+  struct BufferDeleter {
+    void operator()(Buffer *buffer) const {
+      buffer->~Buffer();
+      detail::alignedFree(buffer);
+    }
+  };
+  typedef std::unique_ptr<Buffer, BufferDeleter> BufferPtr;
+
+  std::size_t m_size;
+  std::size_t m_denseThreshold;
+  std::vector<BufferPtr> m_buffers;
+
+  /**
+   * @brief Adds the part of every buffer in [begin, end) into the array and
+   * zeroes that part of the dense buffers.
+   */
+  void reduceRange(Vector<D, T> *out, const std::size_t begin,
+                   const std::size_t end) {
+    const Vector<D, T> zero;
+    for (const BufferPtr &buffer : m_buffers) {
+      if (!buffer->dense.empty()) {
+        for (std::size_t i = begin; i < end; i++) {
+          out[i] += buffer->dense[i];
+          buffer->dense[i] = zero;
+        }
+      } else {
+        for (const Update &update : buffer->updates) {
+          if (update.first >= begin && update.first < end) {
+            out[update.first] += update.second;
+          }
+        }
+      }
+    }
+  }
+};
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
@@ -0,0 +1,328 @@
+/**
+ * @file simd.hpp
+ *
+ * @brief SIMD kernels for operations on arrays of components.
+ *
+ * The kernels use AVX when the compiler targets it (for example with
+ * -mavx or -march=native), SSE2 on other x86-64 targets, and plain loops
+ * everywhere else. Only float and double have SIMD versions. Define
+ * SVECTOR_NO_SIMD to always use the plain loops.
+ *
+ * @note The SIMD version of dot() adds the products in a different order
+ * than a plain loop, so float and double results can differ in the last
+ * bits.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_SIMD_HPP_
+#define INCLUDE_SVECTOR_SIMD_HPP_
+
+#include <cstddef>     // std::size_t
+#include <type_traits> // std::integral_constant
+
+#if !defined(SVECTOR_NO_SIMD) && defined(__AVX__)
+#define SVECTOR_SIMD_AVX
+#include <immintrin.h>
+#elif !defined(SVECTOR_NO_SIMD) &&                                             \
+    (defined(__SSE2__) || defined(_M_X64) ||                                   \
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SVECTOR_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace svector {
+// COMBINER_PY_START
+namespace simd {
+namespace detail {
+/**
+ * @brief Wraps the intrinsics for one component type.
+ *
+ * Specializations exist for the types with SIMD support. Each has a
+ * register type, the number of components in a register (width), and
+ * load, store, arithmetic, and horizontal sum functions.
+ */
+template <typename T> struct Lanes {
+  static constexpr bool enabled = false; //!< Whether T has SIMD support.
+};
+
+#if defined(SVECTOR_SIMD_AVX)
+template <> struct Lanes<float> {
+  static constexpr bool enabled = true;
+  static constexpr std::size_t width = 8;
+  typedef __m256 reg;
+
+  static reg load(const float *ptr) { return _mm256_loadu_ps(ptr); }
+  static void store(float *ptr, const reg val) { _mm256_storeu_ps(ptr, val); }
+  static reg set(const float val) { return _mm256_set1_ps(val); }
+  static reg zero() { return _mm256_setzero_ps(); }
+  static reg add(const reg lhs, const reg rhs) {
+    return _mm256_add_ps(lhs, rhs);
+  }
+  static reg sub(const reg lhs, const reg rhs) {
+    return _mm256_sub_ps(lhs, rhs);
+  }
+  static reg mul(const reg lhs, const reg rhs) {
+    return _mm256_mul_ps(lhs, rhs);
+  }
+  static reg div(const reg lhs, const reg rhs) {
+    return _mm256_div_ps(lhs, rhs);
+  }
+  static float sum(const reg val) {
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(val),
+                             _mm256_extractf128_ps(val, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 1));
+    return _mm_cvtss_f32(half);
+  }
+};
+
+template <> struct Lanes<double> {
+  static constexpr bool enabled = true;
+  static constexpr std::size_t width = 4;
+  typedef __m256d reg;
+
+  static reg load(const double *ptr) { return _mm256_loadu_pd(ptr); }
+  static void store(double *ptr, const reg val) { _mm256_storeu_pd(ptr, val); }
+  static reg set(const double val) { return _mm256_set1_pd(val); }
+  static reg zero() { return _mm256_setzero_pd(); }
+  static reg add(const reg lhs, const reg rhs) {
+    return _mm256_add_pd(lhs, rhs);
+  }
+  static reg sub(const reg lhs, const reg rhs) {
+    return _mm256_sub_pd(lhs, rhs);
+  }
+  static reg mul(const reg lhs, const reg rhs) {
+    return _mm256_mul_pd(lhs, rhs);
+  }
+  static reg div(const reg lhs, const reg rhs) {
+    return _mm256_div_pd(lhs, rhs);
+  }
+  static double sum(const reg val) {
+    const __m128d half = _mm_add_pd(_mm256_castpd256_pd128(val),
+                                    _mm256_extractf128_pd(val, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(half, _mm_unpackhi_pd(half, half)));
+  }
+};
+#elif defined(SVECTOR_SIMD_SSE2)
+template <> struct Lanes<float> {
+  static constexpr bool enabled = true;
+  static constexpr std::size_t width = 4;
+  typedef __m128 reg;
+
+  static reg load(const float *ptr) { return _mm_loadu_ps(ptr); }
+  static void store(float *ptr, const reg val) { _mm_storeu_ps(ptr, val); }
+  static reg set(const float val) { return _mm_set1_ps(val); }
+  static reg zero() { return _mm_setzero_ps(); }
+  static reg add(const reg lhs, const reg rhs) { return _mm_add_ps(lhs, rhs); }
+  static reg sub(const reg lhs, const reg rhs) { return _mm_sub_ps(lhs, rhs); }
+  static reg mul(const reg lhs, const reg rhs) { return _mm_mul_ps(lhs, rhs); }
+  static reg div(const reg lhs, const reg rhs) { return _mm_div_ps(lhs, rhs); }
+  static float sum(const reg val) {
+    const reg half = _mm_add_ps(val, _mm_movehl_ps(val, val));
+    return _mm_cvtss_f32(_mm_add_ss(half, _mm_shuffle_ps(half, half, 1)));
+  }
+};
+
+template <> struct Lanes<double> {
+  static constexpr bool enabled = true;
+  static constexpr std::size_t width = 2;
+  typedef __m128d reg;
+
+  static reg load(const double *ptr) { return _mm_loadu_pd(ptr); }
+  static void store(double *ptr, const reg val) { _mm_storeu_pd(ptr, val); }
+  static reg set(const double val) { return _mm_set1_pd(val); }
+  static reg zero() { return _mm_setzero_pd(); }
+  static reg add(const reg lhs, const reg rhs) { return _mm_add_pd(lhs, rhs); }
+  static reg sub(const reg lhs, const reg rhs) { return _mm_sub_pd(lhs, rhs); }
+  static reg mul(const reg lhs, const reg rhs) { return _mm_mul_pd(lhs, rhs); }
+  static reg div(const reg lhs, const reg rhs) { return _mm_div_pd(lhs, rhs); }
+  static double sum(const reg val) {
+    return _mm_cvtsd_f64(_mm_add_sd(val, _mm_unpackhi_pd(val, val)));
+  }
+};
+#endif
+
+/**
+ * @brief Selects the SIMD or the plain version of a kernel.
+ */
+template <typename T>
+using HasLanes = std::integral_constant<bool, Lanes<T>::enabled>;
+
+template <typename T>
+T dot(const T *lhs, const T *rhs, const std::size_t size, std::false_type) {
+  T result = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    result += lhs[i] * rhs[i];
+  }
+
+  return result;
+}
+
+template <typename T>
+T dot(const T *lhs, const T *rhs, const std::size_t size, std::true_type) {
+  typedef Lanes<T> L;
+
+  // two accumulators, so that consecutive additions do not wait on each other
+  typename L::reg acc0 = L::zero();
+  typename L::reg acc1 = L::zero();
+
+  const std::size_t pairSize = size - size % (2 * L::width);
+  std::size_t i = 0;
+  for (; i < pairSize; i += 2 * L::width) {
+    acc0 = L::add(acc0, L::mul(L::load(lhs + i), L::load(rhs + i)));
+    acc1 = L::add(acc1, L::mul(L::load(lhs + i + L::width),
+                               L::load(rhs + i + L::width)));
+  }
+  if (size - i >= L::width) {
+    acc0 = L::add(acc0, L::mul(L::load(lhs + i), L::load(rhs + i)));
+    i += L::width;
+  }
+
+  T result = L::sum(L::add(acc0, acc1));
+  for (; i < size; i++) {
+    result += lhs[i] * rhs[i];
+  }
+
+  return result;
+}
+
+/**
+ * @brief Adds (or subtracts) two arrays element by element.
+ */
+template <bool Subtract, typename T>
+void addSub(const T *lhs, const T *rhs, T *out, const std::size_t size,
+            std::false_type) {
+  for (std::size_t i = 0; i < size; i++) {
+    out[i] = Subtract ? lhs[i] - rhs[i] : lhs[i] + rhs[i];
+  }
+}
+
+template <bool Subtract, typename T>
+void addSub(const T *lhs, const T *rhs, T *out, const std::size_t size,
+            std::true_type) {
+  typedef Lanes<T> L;
+
+  const std::size_t simdSize = size - size % L::width;
+  std::size_t i = 0;
+  for (; i < simdSize; i += L::width) {
+    const typename L::reg left = L::load(lhs + i);
+    const typename L::reg right = L::load(rhs + i);
+    L::store(out + i, Subtract ? L::sub(left, right) : L::add(left, right));
+  }
+  for (; i < size; i++) {
+    out[i] = Subtract ? lhs[i] - rhs[i] : lhs[i] + rhs[i];
+  }
+}
+
+/**
+ * @brief Multiplies (or divides) an array by a scalar.
+ */
+template <bool Divide, typename T>
+void mulDiv(const T *in, const T scalar, T *out, const std::size_t size,
+            std::false_type) {
+  for (std::size_t i = 0; i < size; i++) {
+    out[i] = Divide ? in[i] / scalar : in[i] * scalar;
+  }
+}
+
+template <bool Divide, typename T>
+void mulDiv(const T *in, const T scalar, T *out, const std::size_t size,
+            std::true_type) {
+  typedef Lanes<T> L;
+
+  const typename L::reg factor = L::set(scalar);
+  const std::size_t simdSize = size - size % L::width;
+  std::size_t i = 0;
+  for (; i < simdSize; i += L::width) {
+    const typename L::reg val = L::load(in + i);
+    L::store(out + i, Divide ? L::div(val, factor) : L::mul(val, factor));
+  }
+  for (; i < size; i++) {
+    out[i] = Divide ? in[i] / scalar : in[i] * scalar;
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Calculates the dot product of two arrays.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param size The number of elements in each array.
+ *
+ * @returns The sum of the products of the elements.
+ */
+template <typename T>
+inline T dot(const T *lhs, const T *rhs, const std::size_t size) {
+  return detail::dot(lhs, rhs, size, detail::HasLanes<T>());
+}
+
+/**
+ * @brief Adds two arrays element by element.
+ *
+ * The output may be the same array as one of the inputs.
+ *
+ * @param lhs The first array.
+ * @param rhs The second array.
+ * @param out The array to write the sums to.
+ * @param size The number of elements in each array.
+ */
+template <typename T>
+inline void add(const T *lhs, const T *rhs, T *out, const std::size_t size) {
+  detail::addSub<false>(lhs, rhs, out, size, detail::HasLanes<T>());
+}
+
+/**
+ * @brief Subtracts two arrays element by element.
+ *
+ * The output may be the same array as one of the inputs.
+ *
+ * @param lhs The first array.
+ * @param rhs The array to subtract from the first.
+ * @param out The array to write the differences to.
+ * @param size The number of elements in each array.
+ */
+template <typename T>
+inline void subtract(const T *lhs, const T *rhs, T *out,
+                     const std::size_t size) {
+  detail::addSub<true>(lhs, rhs, out, size, detail::HasLanes<T>());
+}
+
+/**
+ * @brief Multiplies an array by a scalar.
+ *
+ * The output may be the same array as the input.
+ *
+ * @param in The array.
+ * @param scalar The scalar.
+ * @param out The array to write the products to.
+ * @param size The number of elements in each array.
+ */
+template <typename T>
+inline void multiply(const T *in, const T scalar, T *out,
+                     const std::size_t size) {
+  detail::mulDiv<false>(in, scalar, out, size, detail::HasLanes<T>());
+}
+
+/**
+ * @brief Divides an array by a scalar.
+ *
+ * The output may be the same array as the input.
+ *
+ * @param in The array.
+ * @param scalar The scalar.
+ * @param out The array to write the quotients to.
+ * @param size The number of elements in each array.
+ */
+template <typename T>
+inline void divide(const T *in, const T scalar, T *out,
+                   const std::size_t size) {
+  detail::mulDiv<true>(in, scalar, out, size, detail::HasLanes<T>());
+}
+} // namespace simd
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
@@ -0,0 +1,555 @@
+/**
+ * @file sparse.hpp
+ *
+ * @brief Contains a vector that only stores its non-zero components.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_SPARSE_HPP_
+#define INCLUDE_SVECTOR_SPARSE_HPP_
+
+#include <algorithm>   // std::lower_bound, std::min
+#include <cmath>       // std::sqrt
+#include <cstddef>     // std::size_t, std::ptrdiff_t
+#include <cstdint>     // std::uint32_t
+#include <limits>      // std::numeric_limits
+#include <stdexcept>   // std::invalid_argument, std::out_of_range
+#include <type_traits> // std::is_arithmetic
+#include <utility>     // std::move
+#include <vector>      // std::vector
+
+#include "simplevectors/core/alloc.hpp"      // SVECTOR_ALLOC_SCOPE
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_CALL
+#include "simplevectors/core/vector.hpp"
+
+namespace svector {
+// COMBINER_PY_START
+#ifndef SVECTOR_SPARSE_GALLOP_RATIO
+/**
+ * @brief How many times more non-zero components one sparse vector must
+ * have than the other before dot() gallops through it.
+ *
+ * Below this ratio, dot() walks both vectors side by side.
+ */
+#define SVECTOR_SPARSE_GALLOP_RATIO 8
+#endif
+
+/**
+ * @brief A vector that only stores its non-zero components.
+ *
+ * The indices of the non-zero components are kept sorted in one array and
+ * their values in another, so the memory use and the cost of most
+ * operations grow with the number of non-zero components rather than with
+ * the number of dimensions. The number of dimensions is chosen at runtime.
+ *
+ * Operations on two vectors throw std::invalid_argument if the numbers of
+ * dimensions differ.
+ *
+ * @tparam T Vector type.
+ */
+template <typename T = double> class SparseVector {
+public:
+  // makes sure that type is numeric
+  static_assert(std::is_arithmetic<T>::value, "Vector type must be numeric");
+
+  typedef T value_type;             //!< The component type.
+  typedef std::uint32_t index_type; //!< The type of the stored indices.
+
+  /**
+   * @brief No-argument constructor
+   *
+   * Creates a vector with no dimensions.
+   */
+  SparseVector() : m_size{0} {}
+
+  /**
+   * @brief Creates a zero vector.
+   *
+   * Throws an invalid_argument exception if some index below size does not
+   * fit in index_type.
+   *
+   * @param size The number of dimensions.
+   */
+  explicit SparseVector(const std::size_t size)
+      : m_size{checkedSize(size)} {}
+
+  /**
+   * @brief Creates a vector from its non-zero components.
+   *
+   * Throws an invalid_argument exception if some index below size does not
+   * fit in index_type, if the arrays have different lengths, or if the
+   * indices are not strictly increasing and less than size.
+   *
+   * @param size The number of dimensions.
+   * @param indices The indices of the non-zero components.
+   * @param values The values of those components.
+   */
+  SparseVector(const std::size_t size, std::vector<index_type> indices,
+               std::vector<T> values)
+      : m_size{checkedSize(size)}, m_indices(std::move(indices)),
+        m_values(std::move(values)) {
+    if (this->m_indices.size() != this->m_values.size()) {
+      throw std::invalid_argument(
+          "SparseVector: indices and values have different lengths");
+    }
+
+    for (std::size_t i = 0; i < this->m_indices.size(); i++) {
+      if (this->m_indices[i] >= size ||
+          (i > 0 && this->m_indices[i] <= this->m_indices[i - 1])) {
+        throw std::invalid_argument(
+            "SparseVector: indices must be increasing and less than size");
+      }
+    }
+  }
+
+  /**
+   * @brief Creates a vector from the non-zero elements of a buffer.
+   *
+   * Throws an invalid_argument exception if some index below size does not
+   * fit in index_type.
+   *
+   * @param data A pointer to the first component.
+   * @param size The number of dimensions.
+   */
+  SparseVector(const T *data, const std::size_t size)
+      : m_size{checkedSize(size)} {
+    SVECTOR_ALLOC_SCOPE("SparseVector");
+    for (std::size_t i = 0; i < size; i++) {
+      if (data[i] != 0) {
+        this->m_indices.push_back(static_cast<index_type>(i));
+        this->m_values.push_back(data[i]);
+      }
+    }
+  }
+
+  /**
+   * @brief Creates a vector from the non-zero components of a dense vector.
+   *
+   * @param vec The dense vector.
+   */
+  template <std::size_t D>
+  explicit SparseVector(const Vector<D, T> &vec) : SparseVector(&vec[0], D) {}
+
+  /**
+   * @brief Negates a vector.
+   *
+   * @returns A new vector where each component is negated.
+   */
+  SparseVector<T> operator-() const {
+    SVECTOR_ALLOC_SCOPE("SparseVector");
+    SparseVector<T> tmp(*this);
+    for (auto &value : tmp.m_values) {
+      value = -value;
+    }
+
+    return tmp;
+  }
+
+  /**
+   * @brief Unary plus
+   *
+   * @returns A copy of the vector.
+   */
+  SparseVector<T> operator+() const { return *this; }
+
+  /**
+   * @brief Multiplies the current vector by a scalar.
+   *
+   * Components stay stored even if the scalar is 0.
+   *
+   * @param other The scalar.
+   *
+   * @returns A reference to the modified vector.
+   */
+  SparseVector<T> &operator*=(const T other) {
+    for (auto &value : this->m_values) {
+      value *= other;
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Divides the current vector by a scalar.
+   *
+   * @param other The scalar.
+   *
+   * @returns A reference to the modified vector.
+   */
+  SparseVector<T> &operator/=(const T other) {
+    for (auto &value : this->m_values) {
+      value /= other;
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Dot product with another sparse vector.
+   *
+   * Only indices stored in both vectors contribute. If one vector stores
+   * many more components than the other, its indices are searched with
+   * galloping (exponential) search from the last match, so the cost grows
+   * with the size of the smaller vector. Otherwise, the two index arrays are
+   * walked side by side.
+   *
+   * @param other The other vector, with the same number of dimensions.
+   *
+   * @returns The dot product of the two vectors.
+   */
+  T dot(const SparseVector<T> &other) const {
+    this->checkSize(other.m_size);
+
+    const SparseVector<T> &small =
+        this->nonZeros() <= other.nonZeros() ? *this : other;
+    const SparseVector<T> &large =
+        this->nonZeros() <= other.nonZeros() ? other : *this;
+
+    if (small.nonZeros() * SVECTOR_SPARSE_GALLOP_RATIO <= large.nonZeros()) {
+      return gallopDot(small, large);
+    }
+
+    return mergeDot(small, large);
+  }
+
+  /**
+   * @brief Dot product with a dense vector.
+   *
+   * @param other The dense vector, with the same number of dimensions.
+   *
+   * @returns The dot product of the two vectors.
+   */
+  template <std::size_t D> T dot(const Vector<D, T> &other) const {
+    this->checkSize(D);
+    return this->dot(&other[0]);
+  }
+
+  /**
+   * @brief Dot product with the components in a buffer.
+   *
+   * @param data A pointer to the first component of a dense vector with the
+   * same number of dimensions.
+   *
+   * @returns The dot product of the two vectors.
+   */
+  T dot(const T *data) const {
+    T result = 0;
+    for (std::size_t i = 0; i < this->m_indices.size(); i++) {
+      result += this->m_values[i] * data[this->m_indices[i]];
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Magnitude
+   *
+   * @returns The magnitude of the vector.
+   */
+  T magn() const {
+    SVECTOR_INSTRUMENT_CALL("magn", 0, T);
+    return this->magnitude();
+  }
+
+  /**
+   * @brief Normalizes a vector.
+   *
+   * @note This method will result in undefined behavior if the vector is a zero
+   * vector (if the magnitude equals zero).
+   *
+   * @returns A new vector representing the normalized vector.
+   */
+  SparseVector<T> normalize() const {
+    SVECTOR_INSTRUMENT_CALL("normalize", 0, T);
+    SVECTOR_ALLOC_SCOPE("SparseVector");
+
+    SparseVector<T> tmp(*this);
+    tmp /= this->magnitude();
+    return tmp;
+  }
+
+  /**
+   * @brief Determines whether the current vector is a zero vector.
+   *
+   * @returns Whether the current vector is a zero vector.
+   */
+  bool isZero() const { return this->magnitude() == 0; }
+
+  /**
+   * @brief Gets the number of dimensions.
+   *
+   * @returns Number of dimensions.
+   */
+  std::size_t size() const noexcept { return this->m_size; }
+
+  /**
+   * @brief Gets the number of dimensions.
+   *
+   * @returns Number of dimensions.
+   */
+  std::size_t numDimensions() const noexcept { return this->m_size; }
+
+  /**
+   * @brief Gets the number of stored components.
+   *
+   * @returns The number of stored components.
+   */
+  std::size_t nonZeros() const noexcept { return this->m_indices.size(); }
+
+  /**
+   * @brief Gets the indices of the stored components, in increasing order.
+   *
+   * @returns The indices.
+   */
+  const std::vector<index_type> &indices() const noexcept {
+    return this->m_indices;
+  }
+
+  /**
+   * @brief Gets the values of the stored components.
+   *
+   * @returns The values, in the same order as indices().
+   */
+  const std::vector<T> &values() const noexcept { return this->m_values; }
+
+  /**
+   * @brief Value of a certain component of a vector
+   *
+   * Throws an out_of_range exception if the given number is out of bounds.
+   *
+   * @param index The dimension number.
+   *
+   * @returns The component, which is 0 if it is not stored.
+   */
+  T get(const std::size_t index) const {
+    this->checkIndex(index);
+
+    const auto found = std::lower_bound(this->m_indices.begin(),
+                                        this->m_indices.end(), index);
+    if (found == this->m_indices.end() || *found != index) {
+      return 0;
+    }
+
+    return this->m_values[static_cast<std::size_t>(found -
+                                                   this->m_indices.begin())];
+  }
+
+  /**
+   * @brief Sets value of a certain component
+   *
+   * Setting a component to 0 removes it. Inserting in the middle moves the
+   * components after it, so build large vectors with append() instead.
+   *
+   * Throws an out_of_range exception if the given number is out of bounds.
+   *
+   * @param index The dimension number.
+   * @param value The new value.
+   */
+  void set(const std::size_t index, const T value) {
+    this->checkIndex(index);
+
+    const auto found = std::lower_bound(this->m_indices.begin(),
+                                        this->m_indices.end(), index);
+    const auto position = found - this->m_indices.begin();
+
+    if (found != this->m_indices.end() && *found == index) {
+      if (value == 0) {
+        this->m_indices.erase(found);
+        this->m_values.erase(this->m_values.begin() + position);
+      } else {
+        this->m_values[static_cast<std::size_t>(position)] = value;
+      }
+    } else if (value != 0) {
+      SVECTOR_ALLOC_SCOPE("SparseVector");
+      this->m_indices.insert(found, static_cast<index_type>(index));
+      this->m_values.insert(this->m_values.begin() + position, value);
+    }
+  }
+
+  /**
+   * @brief Stores a component after the last stored one.
+   *
+   * Throws an invalid_argument exception if the index is not greater than
+   * the last stored index, or an out_of_range exception if it is out of
+   * bounds.
+   *
+   * @param index The dimension number.
+   * @param value The value, which is stored even if it is 0.
+   */
+  void append(const std::size_t index, const T value) {
+    this->checkIndex(index);
+    if (!this->m_indices.empty() && index <= this->m_indices.back()) {
+      throw std::invalid_argument(
+          "SparseVector::append: index must be greater than the last index");
+    }
+
+    SVECTOR_ALLOC_SCOPE("SparseVector");
+    this->m_indices.push_back(static_cast<index_type>(index));
+    this->m_values.push_back(value);
+  }
+
+  /**
+   * @brief Reserves room for a number of stored components.
+   *
+   * @param count The number of stored components.
+   */
+  void reserve(const std::size_t count) {
+    SVECTOR_ALLOC_SCOPE("SparseVector");
+    this->m_indices.reserve(count);
+    this->m_values.reserve(count);
+  }
+
+  /**
+   * @brief Writes the components to a dense buffer.
+   *
+   * @param out A buffer with size() elements.
+   */
+  void toDense(T *out) const {
+    for (std::size_t i = 0; i < this->m_size; i++) {
+      out[i] = 0;
+    }
+    for (std::size_t i = 0; i < this->m_indices.size(); i++) {
+      out[this->m_indices[i]] = this->m_values[i];
+    }
+  }
+
+  /**
+   * @brief Converts to a dense vector.
+   *
+   * Throws an invalid_argument exception if the vector does not have exactly
+   * D dimensions.
+   *
+   * @tparam D The number of dimensions.
+   *
+   * @returns A dense vector with the same components.
+   */
+  template <std::size_t D> Vector<D, T> toVector() const {
+    this->checkSize(D);
+
+    Vector<D, T> vec;
+    for (std::size_t i = 0; i < this->m_indices.size(); i++) {
+      vec[this->m_indices[i]] = this->m_values[i];
+    }
+
+    return vec;
+  }
+
+private:
+  std::size_t m_size;
+  std::vector<index_type> m_indices;
+  std::vector<T> m_values;
+
+  /**
+   * @brief Magnitude, without counting a call to magn().
+   */
+  T magnitude() const {
+    T sum_of_squares = 0;
+    for (const auto &value : this->m_values) {
+      sum_of_squares += value * value;
+    }
+
+    return std::sqrt(sum_of_squares);
+  }
+
+  /**
+   * @brief Throws if the indices of a number of dimensions do not all fit in
+   * index_type.
+   *
+   * @returns The number of dimensions.
+   */
+  static std::size_t checkedSize(const std::size_t size) {
+    // size - 1 is the largest index, and cannot overflow like max() + 1
+    if (size > 0 && size - 1 > std::numeric_limits<index_type>::max()) {
+      throw std::invalid_argument(
+          "SparseVector: size does not fit in the index type");
+    }
+
+    return size;
+  }
+
+  /**
+   * @brief Throws if another vector has a different number of dimensions.
+   */
+  void checkSize(const std::size_t size) const {
+    if (this->m_size != size) {
+      throw std::invalid_argument("SparseVector sizes do not match");
+    }
+  }
+
+  /**
+   * @brief Throws if an index is out of bounds.
+   */
+  void checkIndex(const std::size_t index) const {
+    if (index >= this->m_size) {
+      throw std::out_of_range("SparseVector: index out of range");
+    }
+  }
+
+  /**
+   * @brief Dot product by walking both index arrays side by side.
+   */
+  static T mergeDot(const SparseVector<T> &lhs, const SparseVector<T> &rhs) {
+    T result = 0;
+
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < lhs.m_indices.size() && j < rhs.m_indices.size()) {
+      const index_type left = lhs.m_indices[i];
+      const index_type right = rhs.m_indices[j];
+      // branchless, since the comparisons are hard to predict
+      const T product = lhs.m_values[i] * rhs.m_values[j];
+      result += left == right ? product : 0;
+
+      i += static_cast<std::size_t>(left <= right);
+      j += static_cast<std::size_t>(right <= left);
+    }
+
+    return result;
+  }
+
+  /**
+   * @brief Dot product by searching the larger vector for each index of the
+   * smaller one.
+   */
+  static T gallopDot(const SparseVector<T> &small,
+                     const SparseVector<T> &large) {
+    T result = 0;
+
+    const std::vector<index_type> &indices = large.m_indices;
+    std::size_t low = 0;
+    for (std::size_t i = 0; i < small.m_indices.size(); i++) {
+      const index_type target = small.m_indices[i];
+
+      // double the step until it passes the target, then search between the
+      // last two steps
+      std::size_t step = 1;
+      std::size_t high = low;
+      while (high < indices.size() && indices[high] < target) {
+        low = high + 1;
+        high += step;
+        step *= 2;
+      }
+
+      const auto end = indices.begin() + static_cast<std::ptrdiff_t>(
+                                             std::min(high, indices.size()));
+      const auto found = std::lower_bound(
+          indices.begin() + static_cast<std::ptrdiff_t>(low), end, target);
+      low = static_cast<std::size_t>(found - indices.begin());
+
+      if (low == indices.size()) {
+        break;
+      }
+      if (*found == target) {
+        result += small.m_values[i] * large.m_values[low];
+      }
+    }
+
+    return result;
+  }
+};
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
@@ -0,0 +1,379 @@
+/**
+ * @file trace.hpp
+ *
+ * @brief Opt-in timeline tracing with Chrome trace JSON export.
+ *
+ * Tracing is off by default. In that case, SVECTOR_TRACE_SCOPE() expands to
+ * nothing and toChromeJSON() returns an empty trace.
+ *
+ * To turn it on, define SVECTOR_TRACE before including simplevectors. Each
+ * SVECTOR_TRACE_SCOPE() then records a span from where it is declared to the
+ * end of the enclosing scope. The library's batch functions record a span
+ * as well. The spans can be exported with toChromeJSON() and opened in
+ * chrome://tracing or https://ui.perfetto.dev.
+ *
+ * @note Define the macro the same way in every translation unit of a
+ * program. Otherwise, the program breaks the one definition rule.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_TRACE_HPP_
+#define INCLUDE_SVECTOR_TRACE_HPP_
+
+#include <cstddef> // std::size_t
+#include <cstdint> // std::uint64_t
+#include <string>  // std::string, std::to_string
+
+#ifdef SVECTOR_TRACE
+#include <atomic> // std::atomic
+#include <chrono> // std::chrono::steady_clock
+#include <memory> // std::shared_ptr
+#include <mutex>  // std::mutex, std::lock_guard
+#include <vector> // std::vector
+#endif
+
+namespace svector {
+// COMBINER_PY_START
+namespace trace {
+#ifdef SVECTOR_TRACE
+#ifndef SVECTOR_TRACE_BUFFER_SIZE
+/**
+ * @brief Maximum number of spans each thread can record.
+ *
+ * Spans past this limit are dropped until clear() is called.
+ */
+#define SVECTOR_TRACE_BUFFER_SIZE 65536
+#endif
+
+namespace detail {
+/**
+ * @brief A finished span.
+ */
+struct Event {
+  const char *name;
+  std::uint64_t start; // nanoseconds since the trace epoch
+  std::uint64_t end;
+  std::uint64_t items;
+};
+
+/**
+ * @brief Spans recorded by one thread.
+ *
+ * Only the owning thread writes events. It publishes each one by
+ * incrementing size, so exporting never blocks recording.
+ */
+struct ThreadBuffer {
+  explicit ThreadBuffer(const std::uint64_t tid)
+      : id{tid}, events(SVECTOR_TRACE_BUFFER_SIZE), size{0}, dropped{0} {}
+
+  std::uint64_t id;
+  std::string name; // guarded by the registry mutex
+  std::vector<Event> events;
+  std::atomic<std::size_t> size;
+  std::atomic<std::uint64_t> dropped;
+};
+
+/**
+ * @brief Global state shared by every thread.
+ */
+struct Registry {
+  Registry() : epoch{std::chrono::steady_clock::now()}, enabled{true} {}
+
+  std::chrono::steady_clock::time_point epoch;
+  std::atomic<bool> enabled;
+  std::mutex mutex;
+  // buffers outlive their threads so that their spans can still be exported
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+};
+
+/**
+ * @brief Gets the global registry.
+ */
+inline Registry &registry() {
+  static Registry reg;
+  return reg;
+}
+
+/**
+ * @brief Gets the buffer of the calling thread, creating it on first use.
+ */
+inline ThreadBuffer &threadBuffer() {
+  static thread_local std::shared_ptr<ThreadBuffer> buffer;
+  if (!buffer) {
+    Registry &reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    buffer = std::make_shared<ThreadBuffer>(reg.buffers.size() + 1);
+    reg.buffers.push_back(buffer);
+  }
+
+  return *buffer;
+}
+
+/**
+ * @brief Gets the current time.
+ *
+ * @returns Nanoseconds since the trace epoch.
+ */
+inline std::uint64_t now() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now() - registry().epoch)
+          .count());
+}
+
+/**
+ * @brief Adds a finished span to the calling thread's buffer.
+ */
+inline void record(const Event &event) {
+  ThreadBuffer &buffer = threadBuffer();
+  const std::size_t size = buffer.size.load(std::memory_order_relaxed);
+  if (size >= buffer.events.size()) {
+    buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  buffer.events[size] = event;
+  buffer.size.store(size + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Escapes a string for a JSON string literal.
+ *
+ * Control characters, which JSON does not allow in a string, are written as
+ * their short escape (for example \\n) or as \\u00XX.
+ */
+inline std::string escape(const std::string &str) {
+  const char *const hex = "0123456789abcdef";
+
+  std::string escaped;
+  for (const char c : str) {
+    switch (c) {
+    case '"':
+      escaped += "\\\"";
+      break;
+    case '\\':
+      escaped += "\\\\";
+      break;
+    case '\b':
+      escaped += "\\b";
+      break;
+    case '\f':
+      escaped += "\\f";
+      break;
+    case '\n':
+      escaped += "\\n";
+      break;
+    case '\r':
+      escaped += "\\r";
+      break;
+    case '\t':
+      escaped += "\\t";
+      break;
+    default:
+      if (static_cast<unsigned char>(c) < 0x20) {
+        escaped += "\\u00";
+        escaped += hex[static_cast<unsigned char>(c) >> 4];
+        escaped += hex[static_cast<unsigned char>(c) & 0xf];
+      } else {
+        escaped += c;
+      }
+    }
+  }
+
+  return escaped;
+}
+
+/**
+ * @brief Formats nanoseconds as microseconds, the Chrome trace time unit.
+ */
+inline std::string micros(const std::uint64_t nanoseconds) {
+  std::string frac = std::to_string(nanoseconds % 1000);
+  frac.insert(0, 3 - frac.size(), '0');
+  return std::to_string(nanoseconds / 1000) + "." + frac;
+}
+} // namespace detail
+
+/**
+ * @brief Records a span for the lifetime of the object.
+ *
+ * Use SVECTOR_TRACE_SCOPE() rather than creating this directly.
+ */
+class Scope {
+public:
+  /**
+   * @brief Starts the span.
+   *
+   * @param name A string literal naming the span.
+   * @param items The number of items processed in the span, or 0.
+   */
+  explicit Scope(const char *name, const std::uint64_t items = 0)
+      : m_name{name}, m_items{items},
+        m_active{detail::registry().enabled.load(std::memory_order_relaxed)},
+        m_start{m_active ? detail::now() : 0} {}
+
+  /**
+   * @brief Ends the span and records it.
+   */
+  ~Scope() {
+    if (m_active) {
+      detail::record(detail::Event{m_name, m_start, detail::now(), m_items});
+    }
+  }
+
+  Scope(const Scope &) = delete;
+  Scope &operator=(const Scope &) = delete;
+
+private:
+  const char *m_name;
+  std::uint64_t m_items;
+  bool m_active;
+  std::uint64_t m_start;
+};
+
+/**
+ * @brief Starts or stops recording spans.
+ *
+ * Recording is on by default. Spans that start while recording is off are
+ * not recorded.
+ *
+ * @param enabled Whether to record spans.
+ */
+inline void setEnabled(const bool enabled) {
+  detail::registry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Names the calling thread in the exported trace.
+ *
+ * @param name The thread name.
+ */
+inline void setThreadName(const std::string &name) {
+  detail::ThreadBuffer &buffer = detail::threadBuffer();
+  detail::Registry &reg = detail::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  buffer.name = name;
+}
+
+/**
+ * @brief Gets the number of spans dropped because a buffer was full.
+ *
+ * @returns The number of dropped spans over every thread.
+ */
+inline std::uint64_t dropped() {
+  detail::Registry &reg = detail::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+
+  std::uint64_t total = 0;
+  for (const auto &buffer : reg.buffers) {
+    total += buffer->dropped.load(std::memory_order_relaxed);
+  }
+
+  return total;
+}
+
+/**
+ * @brief Removes every recorded span.
+ *
+ * @note This must not run while another thread is inside a span.
+ */
+inline void clear() {
+  detail::Registry &reg = detail::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+  for (const auto &buffer : reg.buffers) {
+    buffer->size.store(0, std::memory_order_relaxed);
+    buffer->dropped.store(0, std::memory_order_relaxed);
+  }
+}
+
+/**
+ * @brief Exports the recorded spans of every thread as Chrome trace JSON.
+ *
+ * Spans are complete ("X") events, with thread names as metadata ("M")
+ * events. Spans with an item count have it in "args". Spans that are still
+ * open are not included.
+ *
+ * @returns The JSON text.
+ */
+inline std::string toChromeJSON() {
+  detail::Registry &reg = detail::registry();
+  std::lock_guard<std::mutex> lock(reg.mutex);
+
+  std::string json = "{\"traceEvents\": [";
+  bool first = true;
+  const auto separator = [&first]() {
+    const char *sep = first ? "\n" : ",\n";
+    first = false;
+    return sep;
+  };
+
+  for (const auto &buffer : reg.buffers) {
+    const std::string tid = std::to_string(buffer->id);
+
+    if (!buffer->name.empty()) {
+      json += separator();
+      json += "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+              "\"tid\": " +
+              tid + ", \"args\": {\"name\": \"" +
+              detail::escape(buffer->name) + "\"}}";
+    }
+
+    const std::size_t size = buffer->size.load(std::memory_order_acquire);
+    for (std::size_t i = 0; i < size; i++) {
+      const detail::Event &event = buffer->events[i];
+      json += separator();
+      json += "  {\"name\": \"" + detail::escape(event.name) +
+              "\", \"cat\": \"svector\", \"ph\": \"X\", \"ts\": " +
+              detail::micros(event.start) +
+              ", \"dur\": " + detail::micros(event.end - event.start) +
+              ", \"pid\": 1, \"tid\": " + tid;
+      if (event.items != 0) {
+        json += ", \"args\": {\"items\": " + std::to_string(event.items) + "}";
+      }
+      json += "}";
+    }
+  }
+
+  json += first ? "]}\n" : "\n]}\n";
+  return json;
+}
+
+#define SVECTOR_TRACE_CONCAT_IMPL(a, b) a##b
+#define SVECTOR_TRACE_CONCAT(a, b) SVECTOR_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Records a span from here to the end of the enclosing scope.
+ *
+ * @param name A string literal naming the span.
+ */
+#define SVECTOR_TRACE_SCOPE(name)                                              \
+  const ::svector::trace::Scope SVECTOR_TRACE_CONCAT(svectorTraceScope,        \
+                                                     __LINE__)(name)
+
+/**
+ * @brief Records a span that processes a number of items, from here to the
+ * end of the enclosing scope.
+ *
+ * @param name A string literal naming the span.
+ * @param count The number of items.
+ */
+#define SVECTOR_TRACE_BATCH(name, count)                                       \
+  const ::svector::trace::Scope SVECTOR_TRACE_CONCAT(svectorTraceScope,        \
+                                                     __LINE__)(                \
+      name, static_cast<std::uint64_t>(count))
+#else
+inline void setEnabled(const bool) {}
+inline void setThreadName(const std::string &) {}
+inline std::uint64_t dropped() { return 0; }
+inline void clear() {}
+inline std::string toChromeJSON() { return "{\"traceEvents\": []}\n"; }
+
+#define SVECTOR_TRACE_SCOPE(name) static_cast<void>(0)
+#define SVECTOR_TRACE_BATCH(name, count) static_cast<void>(0)
+#endif
+} // namespace trace
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
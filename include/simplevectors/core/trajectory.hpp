@@ -0,0 +1,529 @@
+/**
+ * @file trajectory.hpp
+ *
+ * @brief Contains a lossless compressed sequence of vectors.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_TRAJECTORY_HPP_
+#define INCLUDE_SVECTOR_TRAJECTORY_HPP_
+
+#include <algorithm>        // std::min
+#include <cstddef>          // std::size_t
+#include <cstdint>          // std::uint8_t, std::uint32_t, std::uint64_t
+#include <cstring>          // std::memcmp, std::memcpy
+#include <initializer_list> // std::initializer_list
+#include <stdexcept>        // std::invalid_argument, std::out_of_range
+#include <type_traits>      // std::is_floating_point
+#include <vector>           // std::vector
+
+#include "simplevectors/core/alloc.hpp"      // SVECTOR_ALLOC_SCOPE
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_BATCH
+#include "simplevectors/core/quantize.hpp"   // detail::BitsOf, ...
+#include "simplevectors/core/vector.hpp"     // svector::Vector
+
+namespace svector {
+// COMBINER_PY_START
+#ifndef SVECTOR_TRAJECTORY_CHUNK_SIZE
+/**
+ * @brief The default number of vectors in each chunk of a
+ * CompressedTrajectory.
+ */
+#define SVECTOR_TRAJECTORY_CHUNK_SIZE 256
+#endif
+
+/**
+ * @brief Predictor enumerator
+ *
+ * An enum representing how a CompressedTrajectory predicts each vector from
+ * the vectors before it.
+ */
+enum TrajectoryPredictor {
+  PREDICT_PREVIOUS, //!< The previous vector (delta encoding)
+  PREDICT_LINEAR    //!< Extrapolated from the previous two vectors
+};
+
+namespace detail {
+/**
+ * @brief Maps the bits of a floating-point value to an unsigned integer
+ * with the same order as the values.
+ *
+ * Nearby values, including values on either side of zero, get nearby
+ * integers.
+ */
+template <typename U> U toOrderedBits(const U bits) {
+  // flips every bit of a negative value, and only the sign of the others
+  const U sign = static_cast<U>(U(1) << (sizeof(U) * 8 - 1));
+  const U negative = static_cast<U>(bits >> (sizeof(U) * 8 - 1));
+  return static_cast<U>(bits ^ (static_cast<U>(0 - negative) | sign));
+}
+
+/**
+ * @brief Reverses toOrderedBits().
+ */
+template <typename U> U fromOrderedBits(const U key) {
+  const U sign = static_cast<U>(U(1) << (sizeof(U) * 8 - 1));
+  const U positive = static_cast<U>(key >> (sizeof(U) * 8 - 1));
+  return static_cast<U>(key ^ (static_cast<U>(positive - 1) | sign));
+}
+
+/**
+ * @brief Appends an unsigned integer as a varint (7 bits per byte, with the
+ * high bit set on every byte except the last).
+ */
+template <typename U>
+void putVarint(std::vector<std::uint8_t> &bytes, U value) {
+  while (value >= 0x80) {
+    bytes.push_back(static_cast<std::uint8_t>(value | 0x80));
+    value = static_cast<U>(value >> 7);
+  }
+  bytes.push_back(static_cast<std::uint8_t>(value));
+}
+
+/**
+ * @brief Reads a varint and moves the pointer past it.
+ *
+ * The varint must be complete; nothing is checked.
+ */
+template <typename U> U getVarint(const std::uint8_t *&ptr) {
+  std::uint64_t value = *ptr++;
+  if (value < 0x80) {
+    // most residuals of a smooth trajectory are small
+    return static_cast<U>(value);
+  }
+
+  value &= 0x7F;
+  for (unsigned shift = 7;; shift += 7) {
+    const std::uint64_t byte = *ptr++;
+    value |= (byte & 0x7F) << shift;
+    if (byte < 0x80) {
+      return static_cast<U>(value);
+    }
+  }
+}
+} // namespace detail
+
+/**
+ * @brief A sequence of vectors, compressed without loss.
+ *
+ * Meant for trajectories: vectors sampled at a fixed rate, where each
+ * vector is close to the ones before it. Each component is predicted from
+ * the same component of the previous vectors (see TrajectoryPredictor), and
+ * only the difference from the prediction is stored, as a varint. The
+ * prediction and the difference are computed on the bits of the component
+ * as an ordered integer, so decoding gives back exactly the same bits,
+ * including for infinities and NaN.
+ *
+ * The vectors are split into chunks of a fixed number of vectors, and the
+ * prediction starts over in each chunk, so a chunk can be decoded without
+ * the chunks before it. Vectors can be appended one at a time with push().
+ *
+ * toBytes() and fromBytes() store the sequence in a little-endian format:
+ *
+ * | Bytes        | Content                                     |
+ * | ------------ | ------------------------------------------- |
+ * | 4            | "SVTC"                                      |
+ * | 1            | format version (1)                          |
+ * | 1            | bytes per component (4 or 8)                |
+ * | 1            | predictor (0 is previous, 1 is linear)      |
+ * | 1            | reserved (0)                                |
+ * | 4            | number of dimensions                        |
+ * | 4            | vectors per chunk                           |
+ * | 8            | number of vectors                           |
+ * | 8 per chunk  | offset of the chunk in the encoded data     |
+ * | rest         | encoded data                                |
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type, float or double.
+ */
+template <std::size_t D, typename T = double> class CompressedTrajectory {
+public:
+  static_assert(std::is_floating_point<T>::value && sizeof(T) <= 8,
+                "CompressedTrajectory components must be float or double");
+
+  typedef T value_type; //!< The component type.
+
+  /**
+   * @brief Creates an empty sequence.
+   *
+   * Throws an invalid_argument exception if chunkSize is 0 or does not fit
+   * in 32 bits.
+   *
+   * @param predictor How each vector is predicted.
+   * @param chunkSize The number of vectors in each chunk.
+   */
+  explicit CompressedTrajectory(
+      const TrajectoryPredictor predictor = PREDICT_LINEAR,
+      const std::size_t chunkSize = SVECTOR_TRAJECTORY_CHUNK_SIZE)
+      : m_predictor{predictor}, m_chunkSize{chunkSize}, m_size{0},
+        m_last{}, m_delta{} {
+    if (chunkSize == 0 || chunkSize > 0xFFFFFFFFU) {
+      throw std::invalid_argument(
+          "CompressedTrajectory: chunk size must be between 1 and 2^32 - 1");
+    }
+  }
+
+  /**
+   * @brief Compresses an array of vectors.
+   *
+   * Throws an invalid_argument exception if chunkSize is 0 or does not fit
+   * in 32 bits.
+   *
+   * @param vectors The vectors to compress, in order.
+   * @param count The number of vectors.
+   * @param predictor How each vector is predicted.
+   * @param chunkSize The number of vectors in each chunk.
+   */
+  CompressedTrajectory(
+      const Vector<D, T> *vectors, const std::size_t count,
+      const TrajectoryPredictor predictor = PREDICT_LINEAR,
+      const std::size_t chunkSize = SVECTOR_TRAJECTORY_CHUNK_SIZE)
+      : CompressedTrajectory(predictor, chunkSize) {
+    SVECTOR_INSTRUMENT_BATCH("trajectoryEncode", D, T, count);
+    SVECTOR_ALLOC_SCOPE("CompressedTrajectory");
+
+    // about 2 bytes per component for a smooth float trajectory
+    m_bytes.reserve(count * D * 2);
+    for (std::size_t i = 0; i < count; i++) {
+      this->push(vectors[i]);
+    }
+  }
+
+  /**
+   * @brief Appends a vector.
+   *
+   * @param vec The vector to append.
+   */
+  void push(const Vector<D, T> &vec) {
+    SVECTOR_ALLOC_SCOPE("CompressedTrajectory");
+
+    const std::size_t k = m_size % m_chunkSize;
+    if (k == 0) {
+      m_chunkOffsets.push_back(m_bytes.size());
+    }
+
+    const bits_type mask = this->deltaMask();
+    for (std::size_t j = 0; j < D; j++) {
+      const bits_type key = toKey(vec[j]);
+      if (k == 0) {
+        // the first vector of a chunk is stored as is
+        detail::putVarint(m_bytes, zigzag(key));
+        m_delta[j] = 0;
+      } else {
+        const bits_type predicted =
+            static_cast<bits_type>(m_last[j] + (m_delta[j] & mask));
+        detail::putVarint(m_bytes,
+                          zigzag(static_cast<bits_type>(key - predicted)));
+        m_delta[j] = static_cast<bits_type>(key - m_last[j]);
+      }
+      m_last[j] = key;
+    }
+
+    m_size++;
+  }
+
+  /**
+   * @brief Gets the number of vectors.
+   */
+  std::size_t size() const { return m_size; }
+
+  /**
+   * @brief Gets the predictor.
+   */
+  TrajectoryPredictor predictor() const { return m_predictor; }
+
+  /**
+   * @brief Gets the number of vectors in each chunk.
+   *
+   * The last chunk can have fewer.
+   */
+  std::size_t chunkSize() const { return m_chunkSize; }
+
+  /**
+   * @brief Gets the number of chunks.
+   */
+  std::size_t numChunks() const { return m_chunkOffsets.size(); }
+
+  /**
+   * @brief Gets the number of vectors in a chunk.
+   *
+   * @param chunk The index of the chunk.
+   */
+  std::size_t chunkLength(const std::size_t chunk) const {
+    return std::min(m_chunkSize, m_size - chunk * m_chunkSize);
+  }
+
+  /**
+   * @brief Gets the number of bytes of encoded data.
+   *
+   * This does not include the chunk offsets.
+   */
+  std::size_t encodedSize() const { return m_bytes.size(); }
+
+  /**
+   * @brief Decodes one chunk.
+   *
+   * Throws an out_of_range exception if the chunk does not exist.
+   *
+   * @param chunk The index of the chunk.
+   * @param out The vectors to write to, with room for chunkLength(chunk)
+   * vectors.
+   */
+  void decodeChunk(const std::size_t chunk, Vector<D, T> *out) const {
+    if (chunk >= this->numChunks()) {
+      throw std::out_of_range("CompressedTrajectory: chunk out of range");
+    }
+
+    const std::size_t length = this->chunkLength(chunk);
+    SVECTOR_INSTRUMENT_BATCH("trajectoryDecode", D, T, length);
+
+    // the same prediction as push(), written so that the loop over the
+    // vectors after the first has no branches other than in the varints
+    const bits_type mask = this->deltaMask();
+    bits_type last[D];
+    bits_type delta[D] = {};
+    const std::uint8_t *ptr = m_bytes.data() + m_chunkOffsets[chunk];
+    for (std::size_t j = 0; j < D; j++) {
+      last[j] = unzigzag(detail::getVarint<bits_type>(ptr));
+      out[0][j] = fromKey(last[j]);
+    }
+
+    for (std::size_t k = 1; k < length; k++) {
+      for (std::size_t j = 0; j < D; j++) {
+        const bits_type predicted =
+            static_cast<bits_type>(last[j] + (delta[j] & mask));
+        const bits_type key = static_cast<bits_type>(
+            unzigzag(detail::getVarint<bits_type>(ptr)) + predicted);
+        delta[j] = static_cast<bits_type>(key - last[j]);
+        last[j] = key;
+        out[k][j] = fromKey(key);
+      }
+    }
+  }
+
+  /**
+   * @brief Decodes every vector.
+   *
+   * @param out The vectors to write to, with room for size() vectors.
+   */
+  void decode(Vector<D, T> *out) const {
+    for (std::size_t chunk = 0; chunk < this->numChunks(); chunk++) {
+      this->decodeChunk(chunk, out + chunk * m_chunkSize);
+    }
+  }
+
+  /**
+   * @brief Stores the sequence as bytes.
+   *
+   * See the class description for the format.
+   *
+   * @returns The bytes.
+   */
+  std::vector<std::uint8_t> toBytes() const {
+    SVECTOR_ALLOC_SCOPE("CompressedTrajectory");
+
+    std::vector<std::uint8_t> bytes;
+    bytes.reserve(HeaderSize + m_chunkOffsets.size() * 8 + m_bytes.size());
+
+    for (const char c : {'S', 'V', 'T', 'C'}) {
+      bytes.push_back(static_cast<std::uint8_t>(c));
+    }
+    bytes.push_back(static_cast<std::uint8_t>(FormatVersion));
+    bytes.push_back(static_cast<std::uint8_t>(sizeof(T)));
+    bytes.push_back(static_cast<std::uint8_t>(m_predictor));
+    bytes.push_back(0);
+    detail::putBytes(bytes, static_cast<std::uint32_t>(D));
+    detail::putBytes(bytes, static_cast<std::uint32_t>(m_chunkSize));
+    detail::putBytes(bytes, static_cast<std::uint64_t>(m_size));
+
+    for (const std::size_t offset : m_chunkOffsets) {
+      detail::putBytes(bytes, static_cast<std::uint64_t>(offset));
+    }
+    bytes.insert(bytes.end(), m_bytes.begin(), m_bytes.end());
+
+    return bytes;
+  }
+
+  /**
+   * @brief Loads a sequence stored with toBytes().
+   *
+   * The encoded data is checked, so that decoding never reads past it.
+   * More vectors can be appended to the loaded sequence.
+   *
+   * Throws an invalid_argument exception if the bytes are not a sequence
+   * with the same number of dimensions and component type, or if the
+   * encoded data is corrupt.
+   *
+   * @param bytes The bytes.
+   * @param size The number of bytes.
+   *
+   * @returns The sequence.
+   */
+  static CompressedTrajectory fromBytes(const std::uint8_t *bytes,
+                                        const std::size_t size) {
+    SVECTOR_ALLOC_SCOPE("CompressedTrajectory");
+
+    if (size < HeaderSize || std::memcmp(bytes, "SVTC", 4) != 0 ||
+        bytes[4] != FormatVersion) {
+      throw std::invalid_argument(
+          "CompressedTrajectory: not a compressed trajectory");
+    }
+    if (bytes[5] != sizeof(T) || bytes[6] > PREDICT_LINEAR ||
+        detail::getBytes<std::uint32_t>(bytes + 8) != D) {
+      throw std::invalid_argument(
+          "CompressedTrajectory: dimensions or types do not match");
+    }
+
+    const std::uint32_t chunkSize = detail::getBytes<std::uint32_t>(bytes + 12);
+    const std::uint64_t count = detail::getBytes<std::uint64_t>(bytes + 16);
+    if (chunkSize == 0) {
+      throw std::invalid_argument("CompressedTrajectory: corrupt data");
+    }
+
+    // every component takes at least one byte, which also keeps a corrupt
+    // count from overflowing below
+    if (count > (size - HeaderSize) / D) {
+      throw std::invalid_argument("CompressedTrajectory: truncated data");
+    }
+
+    CompressedTrajectory trajectory(
+        static_cast<TrajectoryPredictor>(bytes[6]), chunkSize);
+    trajectory.m_size = static_cast<std::size_t>(count);
+    const std::size_t chunks = (trajectory.m_size + chunkSize - 1) / chunkSize;
+    const std::size_t dataStart = HeaderSize + chunks * 8;
+    if (size < dataStart) {
+      throw std::invalid_argument("CompressedTrajectory: truncated data");
+    }
+
+    trajectory.m_chunkOffsets.resize(chunks);
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+      trajectory.m_chunkOffsets[chunk] = static_cast<std::size_t>(
+          detail::getBytes<std::uint64_t>(bytes + HeaderSize + chunk * 8));
+    }
+    trajectory.m_bytes.assign(bytes + dataStart, bytes + size);
+    if (chunks > 0 && trajectory.m_chunkOffsets[0] != 0) {
+      throw std::invalid_argument("CompressedTrajectory: corrupt data");
+    }
+
+    for (std::size_t chunk = 0; chunk < chunks; chunk++) {
+      const std::size_t end = chunk + 1 < chunks
+                                  ? trajectory.m_chunkOffsets[chunk + 1]
+                                  : trajectory.m_bytes.size();
+      if (!trajectory.validChunk(chunk, end)) {
+        throw std::invalid_argument("CompressedTrajectory: corrupt data");
+      }
+    }
+
+    // restores the predictor state, so that push() continues the last chunk
+    if (chunks > 0) {
+      std::vector<Vector<D, T>> tail(trajectory.chunkLength(chunks - 1));
+      trajectory.decodeChunk(chunks - 1, tail.data());
+      const std::size_t n = tail.size();
+      for (std::size_t j = 0; j < D; j++) {
+        trajectory.m_last[j] = toKey(tail[n - 1][j]);
+        trajectory.m_delta[j] =
+            n >= 2 ? static_cast<bits_type>(trajectory.m_last[j] -
+                                            toKey(tail[n - 2][j]))
+                   : 0;
+      }
+    }
+
+    return trajectory;
+  }
+
+private:
+  typedef typename detail::BitsOf<T>::type bits_type;
+
+  enum : std::size_t {
+    HeaderSize = 24,  // bytes before the chunk offsets
+    FormatVersion = 1 // changed with the format
+  };
+
+  TrajectoryPredictor m_predictor;
+  std::size_t m_chunkSize;
+  std::size_t m_size;
+  std::vector<std::uint8_t> m_bytes;      // varints, vector by vector
+  std::vector<std::size_t> m_chunkOffsets; // into m_bytes
+  bits_type m_last[D];  // ordered bits of the last vector
+  bits_type m_delta[D]; // m_last minus the ordered bits of the one before
+
+  /**
+   * @brief Gets the mask applied to the last difference when predicting.
+   *
+   * The prediction is the last value plus the last difference (linear
+   * extrapolation), or plus nothing (the previous value).
+   */
+  bits_type deltaMask() const {
+    return m_predictor == PREDICT_LINEAR ? static_cast<bits_type>(~0ULL) : 0;
+  }
+
+  /**
+   * @brief Gets the ordered bits of a component.
+   */
+  static bits_type toKey(const T value) {
+    bits_type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return detail::toOrderedBits(bits);
+  }
+
+  /**
+   * @brief Gets a component from its ordered bits.
+   */
+  static T fromKey(const bits_type key) {
+    const bits_type bits = detail::fromOrderedBits(key);
+    T value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  /**
+   * @brief Maps small negative and positive residuals to small unsigned
+   * integers (0, -1, 1, -2, ... become 0, 1, 2, 3, ...).
+   */
+  static bits_type zigzag(const bits_type residual) {
+    return static_cast<bits_type>(
+        static_cast<bits_type>(residual << 1) ^
+        static_cast<bits_type>(0 - (residual >> (sizeof(bits_type) * 8 - 1))));
+  }
+
+  /**
+   * @brief Reverses zigzag().
+   */
+  static bits_type unzigzag(const bits_type value) {
+    return static_cast<bits_type>((value >> 1) ^
+                                  static_cast<bits_type>(0 - (value & 1)));
+  }
+
+  /**
+   * @brief Checks that a chunk is exactly its number of complete varints,
+   * each short enough for the component type.
+   */
+  bool validChunk(const std::size_t chunk, const std::size_t end) const {
+    const std::size_t maxLength = (sizeof(bits_type) * 8 + 6) / 7;
+    std::size_t begin = m_chunkOffsets[chunk];
+    if (begin > end || end > m_bytes.size()) {
+      return false;
+    }
+
+    std::size_t varints = 0;
+    std::size_t length = 0;
+    for (; begin < end; begin++) {
+      length++;
+      if (length > maxLength) {
+        return false;
+      }
+      if (m_bytes[begin] < 0x80) {
+        varints++;
+        length = 0;
+      }
+    }
+
+    return length == 0 && varints == this->chunkLength(chunk) * D;
+  }
+};
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
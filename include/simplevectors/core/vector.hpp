@@ -19,8 +19,29 @@
 #include <string>           // std::string, std::to_string
 #include <type_traits>      // std::is_arithmetic
 
+#include "simplevectors/core/alloc.hpp"      // SVECTOR_ALLOC_SCOPE
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_CALL
+
 namespace svector {
 // COMBINER_PY_START
+namespace detail {
+/**
+ * @brief Calculates the magnitude of the first D components of a vector.
+ *
+ * The library functions that need a magnitude use this instead of magn(), so
+ * that they do not add to the instrumentation count of magn().
+ */
+template <std::size_t D, typename T, typename V> T magnitude(const V &v) {
+  T sum_of_squares = 0;
+
+  for (std::size_t i = 0; i < D; i++) {
+    sum_of_squares += v[i] * v[i];
+  }
+
+  return std::sqrt(sum_of_squares);
+}
+} // namespace detail
+
 /**
  * @brief A base vector representation.
  *
@@ -50,6 +71,7 @@ public:
   friend bool operator>=(const Vector<D1, T1> &, const Vector<D2, T2> &);
 #endif
 
+  typedef T value_type; //!< The type of the components.
   typedef
       typename std::array<T, D>::iterator iterator; //!< An std::array::iterator
   typedef typename std::array<T, D>::const_iterator
@@ -151,6 +173,9 @@ public:
    * @returns The string form of the vector.
    */
   virtual std::string toString() const {
+    SVECTOR_INSTRUMENT_CALL("toString", D, T);
+    SVECTOR_ALLOC_SCOPE("toString");
+
     std::string str = "<";
     for (std::size_t i = 0; i < D - 1; i++) {
       str += std::to_string(this->m_components[i]);
@@ -424,13 +449,8 @@ public:
    * @returns The magnitude of the vector.
    */
   T magn() const {
-    T sum_of_squares = 0;
-
-    for (const auto &i : this->m_components) {
-      sum_of_squares += i * i;
-    }
-
-    return std::sqrt(sum_of_squares);
+    SVECTOR_INSTRUMENT_CALL("magn", D, T);
+    return detail::magnitude<D, T>(*this);
   };
 
   /**
@@ -443,7 +463,10 @@ public:
    *
    * @returns A new vector representing the normalized vector.
    */
-  Vector<D, T> normalize() const { return (*this) / this->magn(); }
+  Vector<D, T> normalize() const {
+    SVECTOR_INSTRUMENT_CALL("normalize", D, T);
+    return (*this) / detail::magnitude<D, T>(*this);
+  }
 
   /**
    * @brief Gets the number of dimensions.
@@ -457,7 +480,7 @@ public:
    *
    * @returns Whether the current vector is a zero vector.
    */
-  bool isZero() const { return this->magn() == 0; }
+  bool isZero() const { return detail::magnitude<D, T>(*this) == 0; }
 
   /**
    * @brief Value of a certain component of a vector
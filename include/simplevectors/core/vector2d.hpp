@@ -10,9 +10,11 @@
 #ifndef INCLUDE_SVECTOR_VECTOR2D_HPP_
 #define INCLUDE_SVECTOR_VECTOR2D_HPP_
 
-#include <cmath> // std::atan2, std::cos, std::sin
+#include <cmath>       // std::atan2, std::cos, std::sin
+#include <type_traits> // std::is_floating_point
 
-#include "simplevectors/core/vector.hpp" // svector::Vector
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_CALL
+#include "simplevectors/core/vector.hpp"     // svector::Vector
 
 namespace svector {
 // COMBINER_PY_START
@@ -21,10 +23,14 @@ typedef Vector<2> Vec2_; //!< An alias to Vector<2>.
 
 /**
  * @brief A simple 2D vector representation.
+ *
+ * Use the svector::Vector2D (double) and svector::Vector2f (float) aliases.
+ *
+ * @tparam T Vector type.
  */
-class Vector2D : public Vec2_ {
+template <typename T> class BasicVector2D : public Vector<2, T> {
 public:
-  using Vec2_::Vector;
+  using Vector<2, T>::Vector;
 
   /**
    * @brief Initializes a vector given xy components.
@@ -32,7 +38,7 @@ public:
    * @param x The x-component.
    * @param y The y-component.
    */
-  Vector2D(const double x, const double y) {
+  BasicVector2D(const T x, const T y) {
     this->m_components[0] = x;
     this->m_components[1] = y;
   }
@@ -40,7 +46,7 @@ public:
   /**
    * @brief Copy constructor for base class.
    */
-  Vector2D(const Vec2_ &other) {
+  BasicVector2D(const Vector<2, T> &other) {
     this->m_components[0] = other[0];
     this->m_components[1] = other[1];
   }
@@ -52,7 +58,7 @@ public:
    *
    * @returns x-component of vector.
    */
-  double x() const { return this->m_components[0]; }
+  T x() const { return this->m_components[0]; }
 
   /**
    * @brief Sets x-component
@@ -61,7 +67,7 @@ public:
    *
    * @param newX x-value to set
    */
-  void x(const double &newX) { this->m_components[0] = newX; }
+  void x(const T &newX) { this->m_components[0] = newX; }
 
   /**
    * @brief Gets y-component
@@ -70,7 +76,7 @@ public:
    *
    * @returns y-component of vector.
    */
-  double y() const { return this->m_components[1]; }
+  T y() const { return this->m_components[1]; }
 
   /**
    * @brief Sets y-component
@@ -79,7 +85,7 @@ public:
    *
    * @param newY y-value to set
    */
-  void y(const double &newY) { this->m_components[1] = newY; }
+  void y(const T &newY) { this->m_components[1] = newY; }
 
   /**
    * @brief Angle of vector
@@ -90,7 +96,11 @@ public:
    *
    * @returns The angle of the vector.
    */
-  double angle() const { return std::atan2(this->y(), this->x()); }
+  T angle() const {
+    static_assert(std::is_floating_point<T>::value,
+                  "Vector type must be floating point");
+    return std::atan2(this->y(), this->x());
+  }
 
   /**
    * @brief Rotates vector by a certain angle.
@@ -103,7 +113,11 @@ public:
    *
    * @returns A new, rotated vector.
    */
-  Vector2D rotate(const double ang) const {
+  BasicVector2D rotate(const T ang) const {
+    static_assert(std::is_floating_point<T>::value,
+                  "Vector type must be floating point");
+    SVECTOR_INSTRUMENT_CALL("rotate", 2, T);
+
     //
     // Rotation matrix:
     //
@@ -111,10 +125,12 @@ public:
     // | sin(ang)    cos(ang) | |y|
     //
 
-    const double xPrime = this->x() * std::cos(ang) - this->y() * std::sin(ang);
-    const double yPrime = this->x() * std::sin(ang) + this->y() * std::cos(ang);
+    const T c = std::cos(ang);
+    const T s = std::sin(ang);
+    const T xPrime = this->x() * c - this->y() * s;
+    const T yPrime = this->x() * s + this->y() * c;
 
-    return Vector2D{xPrime, yPrime};
+    return BasicVector2D{xPrime, yPrime};
   }
 
   /**
@@ -129,10 +145,13 @@ public:
    *
    * @returns The converted value.
    */
-  template <typename T> T componentsAs() const {
-    return T{this->x(), this->y()};
+  template <typename U> U componentsAs() const {
+    return U{this->x(), this->y()};
   }
 };
+
+typedef BasicVector2D<double> Vector2D; //!< A 2D vector of doubles.
+typedef BasicVector2D<float> Vector2f;  //!< A 2D vector of floats.
 // COMBINER_PY_END
 } // namespace svector
 
@@ -10,10 +10,12 @@
 #ifndef INCLUDE_SVECTOR_VECTOR3D_HPP_
 #define INCLUDE_SVECTOR_VECTOR3D_HPP_
 
-#include <cmath> // std::acos, std::cos, std::sin
+#include <cmath>       // std::acos, std::cos, std::sin
+#include <type_traits> // std::is_floating_point
 
-#include "simplevectors/core/units.hpp"  // svector::AngleDir
-#include "simplevectors/core/vector.hpp" // svector::Vector
+#include "simplevectors/core/instrument.hpp" // SVECTOR_INSTRUMENT_CALL
+#include "simplevectors/core/units.hpp"      // svector::AngleDir
+#include "simplevectors/core/vector.hpp"     // svector::Vector
 
 namespace svector {
 // COMBINER_PY_START
@@ -22,10 +24,14 @@ typedef Vector<3> Vec3_; //!< An alias to Vector<3>.
 
 /**
  * @brief A simple 3D vector representation.
+ *
+ * Use the svector::Vector3D (double) and svector::Vector3f (float) aliases.
+ *
+ * @tparam T Vector type.
  */
-class Vector3D : public Vec3_ {
+template <typename T> class BasicVector3D : public Vector<3, T> {
 public:
-  using Vec3_::Vector;
+  using Vector<3, T>::Vector;
 
   /**
    * @brief Initializes a vector given xyz components.
@@ -34,7 +40,7 @@ public:
    * @param y The y-component.
    * @param z The z-component.
    */
-  Vector3D(const double x, const double y, const double z) {
+  BasicVector3D(const T x, const T y, const T z) {
     this->m_components[0] = x;
     this->m_components[1] = y;
     this->m_components[2] = z;
@@ -43,7 +49,7 @@ public:
   /**
    * @brief Copy constructor for the base class.
    */
-  Vector3D(const Vec3_ &other) {
+  BasicVector3D(const Vector<3, T> &other) {
     this->m_components[0] = other[0];
     this->m_components[1] = other[1];
     this->m_components[2] = other[2];
@@ -56,7 +62,7 @@ public:
    *
    * @returns x-component of vector.
    */
-  double x() const { return this->m_components[0]; }
+  T x() const { return this->m_components[0]; }
 
   /**
    * @brief Sets x-component
@@ -65,7 +71,7 @@ public:
    *
    * @param newX x-value to set
    */
-  void x(const double &newX) { this->m_components[0] = newX; }
+  void x(const T &newX) { this->m_components[0] = newX; }
 
   /**
    * @brief Gets y-component
@@ -74,7 +80,7 @@ public:
    *
    * @returns y-component of vector.
    */
-  double y() const { return this->m_components[1]; }
+  T y() const { return this->m_components[1]; }
 
   /**
    * @brief Sets y-component
@@ -83,7 +89,7 @@ public:
    *
    * @param newY y-value to set
    */
-  void y(const double &newY) { this->m_components[1] = newY; }
+  void y(const T &newY) { this->m_components[1] = newY; }
 
   /**
    * @brief Gets z-component
@@ -92,7 +98,7 @@ public:
    *
    * @returns z-component of vector.
    */
-  double z() const { return this->m_components[2]; }
+  T z() const { return this->m_components[2]; }
 
   /**
    * @brief Sets z-component
@@ -101,7 +107,7 @@ public:
    *
    * @param newZ z-value to set
    */
-  void z(const double &newZ) { this->m_components[2] = newZ; }
+  void z(const T &newZ) { this->m_components[2] = newZ; }
 
   /**
    * @brief Cross product of two vectors.
@@ -110,12 +116,14 @@ public:
    *
    * @returns The cross product of the two vectors.
    */
-  Vector3D cross(const Vector3D &other) const {
-    const double newx = this->y() * other.z() - this->z() * other.y();
-    const double newy = this->z() * other.x() - this->x() * other.z();
-    const double newz = this->x() * other.y() - this->y() * other.x();
+  BasicVector3D cross(const BasicVector3D &other) const {
+    SVECTOR_INSTRUMENT_CALL("cross", 3, T);
+
+    const T newx = this->y() * other.z() - this->z() * other.y();
+    const T newy = this->z() * other.x() - this->x() * other.z();
+    const T newz = this->x() * other.y() - this->y() * other.x();
 
-    return Vector3D{newx, newy, newz};
+    return BasicVector3D{newx, newy, newz};
   }
 
   /**
@@ -130,8 +138,8 @@ public:
    *
    * @returns The converted value.
    */
-  template <typename T> T componentsAs() const {
-    return T{this->x(), this->y(), this->z()};
+  template <typename U> U componentsAs() const {
+    return U{this->x(), this->y(), this->z()};
   }
 
   /**
@@ -146,8 +154,8 @@ public:
    *
    * @returns Converted value.
    */
-  template <typename T> T anglesAs() const {
-    return T{this->getAlpha(), this->getBeta(), this->getGamma()};
+  template <typename U> U anglesAs() const {
+    return U{this->getAlpha(), this->getBeta(), this->getGamma()};
   }
 
   /**
@@ -165,7 +173,10 @@ public:
    *
    * @returns An angle representing the angle you specified.
    */
-  template <AngleDir D> double angle() const {
+  template <AngleDir D> T angle() const {
+    static_assert(std::is_floating_point<T>::value,
+                  "Vector type must be floating point");
+
     switch (D) {
     case ALPHA:
       return this->getAlpha();
@@ -193,7 +204,10 @@ public:
    *
    * @returns A new, rotated vector.
    */
-  template <AngleDir D> Vector3D rotate(const double &ang) const {
+  template <AngleDir D> BasicVector3D rotate(const T &ang) const {
+    static_assert(std::is_floating_point<T>::value,
+                  "Vector type must be floating point");
+
     switch (D) {
     case ALPHA:
       return this->rotateAlpha(ang);
@@ -212,7 +226,9 @@ private:
    *
    * @returns α
    */
-  double getAlpha() const { return std::acos(this->x() / this->magn()); }
+  T getAlpha() const {
+    return std::acos(this->x() / detail::magnitude<3, T>(*this));
+  }
 
   /**
    * Gets β angle.
@@ -221,7 +237,9 @@ private:
    *
    * @returns β
    */
-  double getBeta() const { return std::acos(this->y() / this->magn()); }
+  T getBeta() const {
+    return std::acos(this->y() / detail::magnitude<3, T>(*this));
+  }
 
   /**
    * Gets γ angle.
@@ -230,12 +248,16 @@ private:
    *
    * @returns γ
    */
-  double getGamma() const { return std::acos(this->z() / this->magn()); }
+  T getGamma() const {
+    return std::acos(this->z() / detail::magnitude<3, T>(*this));
+  }
 
   /**
    * Rotates around x-axis.
    */
-  Vector3D rotateAlpha(const double &ang) const {
+  BasicVector3D rotateAlpha(const T &ang) const {
+    SVECTOR_INSTRUMENT_CALL("rotateAlpha", 3, T);
+
     /**
      * Rotation matrix:
      *
@@ -244,17 +266,21 @@ private:
      * |0  sin(ang)   cos(ang)| |z|
      */
 
-    const double xPrime = this->x();
-    const double yPrime = this->y() * std::cos(ang) - this->z() * std::sin(ang);
-    const double zPrime = this->y() * std::sin(ang) + this->z() * std::cos(ang);
+    const T c = std::cos(ang);
+    const T s = std::sin(ang);
+    const T xPrime = this->x();
+    const T yPrime = this->y() * c - this->z() * s;
+    const T zPrime = this->y() * s + this->z() * c;
 
-    return Vector3D{xPrime, yPrime, zPrime};
+    return BasicVector3D{xPrime, yPrime, zPrime};
   }
 
   /**
    * Rotates around y-axis.
    */
-  Vector3D rotateBeta(const double &ang) const {
+  BasicVector3D rotateBeta(const T &ang) const {
+    SVECTOR_INSTRUMENT_CALL("rotateBeta", 3, T);
+
     /**
      * Rotation matrix:
      *
@@ -263,18 +289,21 @@ private:
      * |−sin(ang)  0  cos(ang)| |z|
      */
 
-    const double xPrime = this->x() * std::cos(ang) + this->z() * std::sin(ang);
-    const double yPrime = this->y();
-    const double zPrime =
-        -this->x() * std::sin(ang) + this->z() * std::cos(ang);
+    const T c = std::cos(ang);
+    const T s = std::sin(ang);
+    const T xPrime = this->x() * c + this->z() * s;
+    const T yPrime = this->y();
+    const T zPrime = -this->x() * s + this->z() * c;
 
-    return Vector3D{xPrime, yPrime, zPrime};
+    return BasicVector3D{xPrime, yPrime, zPrime};
   }
 
   /**
    * Rotates around z-axis.
    */
-  Vector3D rotateGamma(const double &ang) const {
+  BasicVector3D rotateGamma(const T &ang) const {
+    SVECTOR_INSTRUMENT_CALL("rotateGamma", 3, T);
+
     /**
      * Rotation matrix:
      *
@@ -283,13 +312,18 @@ private:
      * |  0         0        1| |z|
      */
 
-    const double xPrime = this->x() * std::cos(ang) - this->y() * std::sin(ang);
-    const double yPrime = this->x() * std::sin(ang) + this->y() * std::cos(ang);
-    const double zPrime = this->z();
+    const T c = std::cos(ang);
+    const T s = std::sin(ang);
+    const T xPrime = this->x() * c - this->y() * s;
+    const T yPrime = this->x() * s + this->y() * c;
+    const T zPrime = this->z();
 
-    return Vector3D{xPrime, yPrime, zPrime};
+    return BasicVector3D{xPrime, yPrime, zPrime};
   }
 };
+
+typedef BasicVector3D<double> Vector3D; //!< A 3D vector of doubles.
+typedef BasicVector3D<float> Vector3f;  //!< A 3D vector of floats.
 // COMBINER_PY_END
 } // namespace svector
 
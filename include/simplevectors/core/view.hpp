@@ -0,0 +1,319 @@
+/**
+ * @file view.hpp
+ *
+ * @brief Contains a non-owning vector over external memory.
+ *
+ * @copyright Copyright (c) 2023 Jonathan Liu. This project is released under
+ * the MIT License. All rights reserved.
+ */
+
+#ifndef INCLUDE_SVECTOR_VIEW_HPP_
+#define INCLUDE_SVECTOR_VIEW_HPP_
+
+#include <cstddef>     // std::size_t
+#include <stdexcept>   // std::out_of_range
+#include <type_traits> // std::remove_const, std::is_const, std::enable_if
+
+#include "simplevectors/core/vector.hpp"
+
+namespace svector {
+// COMBINER_PY_START
+/**
+ * @brief A vector whose components are stored in someone else's memory.
+ *
+ * A view aliases D components starting at a pointer, with a fixed distance
+ * (the stride) between consecutive components. Nothing is copied, so views
+ * can be used on memory-mapped files, driver buffers, or arrays owned by
+ * other libraries. The memory must outlive the view.
+ *
+ * A view behaves like a reference: copying a view aliases the same memory,
+ * and assigning to a view writes the components into that memory. Use
+ * VectorView<D, const T> for read-only memory. A mutable view converts to a
+ * read-only one, and a vector converts to a view of its own components.
+ *
+ * The free functions in functions.hpp and the arithmetic operators accept
+ * views. Operations that make new vectors, such as addition, return an
+ * svector::Vector.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Component type, const-qualified for a read-only view.
+ */
+template <std::size_t D, typename T = double> class VectorView {
+public:
+  typedef typename std::remove_const<T>::type
+      value_type; //!< The component type without const.
+
+  // makes sure that type is numeric
+  static_assert(std::is_arithmetic<value_type>::value,
+                "Vector type must be numeric");
+
+  /**
+   * @brief Creates a view of components in a buffer.
+   *
+   * @param data A pointer to the first component.
+   * @param stride The number of elements from one component to the next. Use
+   * 1 for components stored next to each other, or the number of vectors for
+   * a buffer that stores all of the x-components, then all of the
+   * y-components, and so on.
+   */
+  explicit VectorView(T *data, const std::size_t stride = 1) noexcept
+      : m_data{data}, m_stride{stride} {}
+
+  /**
+   * @brief Creates a view of the components of a vector.
+   *
+   * @param vec The vector, which must outlive the view.
+   */
+  VectorView(Vector<D, value_type> &vec) noexcept
+      : m_data{&vec[0]}, m_stride{1} {}
+
+  /**
+   * @brief Creates a read-only view of the components of a vector.
+   *
+   * @param vec The vector, which must outlive the view.
+   */
+  template <typename U = T, typename = typename std::enable_if<
+                                std::is_const<U>::value>::type>
+  VectorView(const Vector<D, value_type> &vec) noexcept
+      : m_data{&vec[0]}, m_stride{1} {}
+
+  /**
+   * @brief Converts a mutable view to a read-only view.
+   *
+   * @param other The mutable view.
+   */
+  template <typename U, typename = typename std::enable_if<
+                            std::is_same<const U, T>::value &&
+                            !std::is_same<U, T>::value>::type>
+  VectorView(const VectorView<D, U> &other) noexcept
+      : m_data{other.data()}, m_stride{other.stride()} {}
+
+  /**
+   * @brief Copy constructor
+   *
+   * The copy aliases the same memory.
+   */
+  VectorView(const VectorView<D, T> &) noexcept = default;
+
+  /**
+   * @brief Assignment operator
+   *
+   * Writes the components of another view into the memory of this view.
+   * The two views should not overlap.
+   */
+  VectorView<D, T> &operator=(const VectorView<D, T> &other) {
+    for (std::size_t i = 0; i < D; i++) {
+      (*this)[i] = other[i];
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Assigns from a read-only view.
+   *
+   * Writes the components of another view into the memory of this view.
+   * The two views should not overlap.
+   */
+  template <typename U>
+  VectorView<D, T> &operator=(const VectorView<D, U> &other) {
+    for (std::size_t i = 0; i < D; i++) {
+      (*this)[i] = other[i];
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Assigns from a vector.
+   *
+   * Writes the components of the vector into the memory of this view.
+   */
+  VectorView<D, T> &operator=(const Vector<D, value_type> &other) {
+    for (std::size_t i = 0; i < D; i++) {
+      (*this)[i] = other[i];
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Negates a vector.
+   *
+   * @returns A new vector where each component is negated.
+   */
+  Vector<D, value_type> operator-() const {
+    Vector<D, value_type> tmp;
+    for (std::size_t i = 0; i < D; i++) {
+      tmp[i] = -(*this)[i];
+    }
+
+    return tmp;
+  }
+
+  /**
+   * @brief Unary plus
+   *
+   * @returns A new vector where the unary plus operator is applied to each
+   * component.
+   */
+  Vector<D, value_type> operator+() const {
+    Vector<D, value_type> tmp;
+    for (std::size_t i = 0; i < D; i++) {
+      tmp[i] = +(*this)[i];
+    }
+
+    return tmp;
+  }
+
+  /**
+   * @brief Adds another vector to the viewed components.
+   *
+   * @param other A vector or view to add.
+   *
+   * @returns A reference to this view.
+   */
+  VectorView<D, T> &operator+=(const VectorView<D, const value_type> other) {
+    for (std::size_t i = 0; i < D; i++) {
+      (*this)[i] += other[i];
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Subtracts another vector from the viewed components.
+   *
+   * @param other A vector or view to subtract.
+   *
+   * @returns A reference to this view.
+   */
+  VectorView<D, T> &operator-=(const VectorView<D, const value_type> other) {
+    for (std::size_t i = 0; i < D; i++) {
+      (*this)[i] -= other[i];
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Multiplies the viewed components by a scalar.
+   *
+   * @param other The scalar.
+   *
+   * @returns A reference to this view.
+   */
+  VectorView<D, T> &operator*=(const value_type other) {
+    for (std::size_t i = 0; i < D; i++) {
+      (*this)[i] *= other;
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Divides the viewed components by a scalar.
+   *
+   * @param other The scalar.
+   *
+   * @returns A reference to this view.
+   */
+  VectorView<D, T> &operator/=(const value_type other) {
+    for (std::size_t i = 0; i < D; i++) {
+      (*this)[i] /= other;
+    }
+
+    return *this;
+  }
+
+  /**
+   * @brief Gets the number of dimensions.
+   *
+   * @returns Number of dimensions.
+   */
+  constexpr std::size_t numDimensions() const { return D; }
+
+  /**
+   * @brief Gets the pointer to the first component.
+   *
+   * @returns The pointer given when the view was created.
+   */
+  T *data() const noexcept { return this->m_data; }
+
+  /**
+   * @brief Gets the number of elements from one component to the next.
+   *
+   * @returns The stride.
+   */
+  std::size_t stride() const noexcept { return this->m_stride; }
+
+  /**
+   * @brief Value of a certain component of a vector
+   *
+   * Gets a reference to a specific component of the viewed vector given the
+   * dimension number. The view does not own its memory, so the reference can
+   * be changed even through a const view unless T is const.
+   *
+   * @param index The dimension number.
+   *
+   * @returns A reference to that dimension's component of the vector.
+   */
+  T &operator[](const std::size_t index) const {
+    return this->m_data[index * this->m_stride];
+  }
+
+  /**
+   * @brief Value of a certain component of a vector
+   *
+   * Throws an out_of_range exception if the given number is out of bounds.
+   *
+   * @param index The dimension number.
+   *
+   * @returns A reference to that dimension's component of the vector.
+   */
+  T &at(const std::size_t index) const {
+    if (index >= D) {
+      throw std::out_of_range("VectorView::at: index out of range");
+    }
+
+    return (*this)[index];
+  }
+
+  /**
+   * @brief Copies the viewed components into a new vector.
+   *
+   * @returns A vector that owns a copy of the components.
+   */
+  Vector<D, value_type> toVector() const {
+    Vector<D, value_type> vec;
+    for (std::size_t i = 0; i < D; i++) {
+      vec[i] = (*this)[i];
+    }
+
+    return vec;
+  }
+
+private:
+  T *m_data;
+  std::size_t m_stride;
+};
+
+/**
+ * @brief Creates a view of components in a buffer.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Component type. A pointer to const creates a read-only view.
+ *
+ * @param data A pointer to the first component.
+ * @param stride The number of elements from one component to the next.
+ *
+ * @returns A view of the components.
+ */
+template <std::size_t D, typename T>
+VectorView<D, T> makeView(T *data, const std::size_t stride = 1) noexcept {
+  return VectorView<D, T>(data, stride);
+}
+// COMBINER_PY_END
+} // namespace svector
+
+#endif
@@ -38,7 +38,35 @@
 #ifndef INCLUDE_SVECTOR_EMBED_HPP_
 #define INCLUDE_SVECTOR_EMBED_HPP_
 
-#include <math.h> // acosf, atan2f, cosf, sinf, sqrtf
+#include <math.h> // acosf, atan2f, cosf, floorf, sinf, sqrtf
+
+/**
+ * @brief Default number of CORDIC iterations.
+ *
+ * Each iteration adds roughly one bit of precision to the CORDIC functions.
+ * Define this before including embed.h to change the default for every
+ * CORDIC call. Values above 24 are clamped, since a float cannot hold more
+ * precision than that.
+ */
+#ifndef SVECTOR_EMBED_CORDIC_ITERATIONS
+#define SVECTOR_EMBED_CORDIC_ITERATIONS 16
+#endif
+
+/**
+ * @brief Keeps the compiler from moving memory accesses across this point.
+ *
+ * EmbRingBuffer uses it to order its indices and samples on compilers
+ * without the GCC/Clang atomic builtins. It is defined for MSVC. For any
+ * other compiler, define it before including embed.h, for example as
+ * `__memory_barrier()`; EmbRingBuffer does not compile otherwise, since it
+ * would not be safe to use from an interrupt handler. The rest of embed.h
+ * does not need it.
+ */
+#if !defined(SVECTOR_EMBED_COMPILER_BARRIER) && !defined(__GNUC__) &&         \
+    !defined(__clang__) && defined(_MSC_VER)
+#include <intrin.h> // _ReadWriteBarrier
+#define SVECTOR_EMBED_COMPILER_BARRIER() _ReadWriteBarrier()
+#endif
 
 namespace svector {
 /**
@@ -558,8 +586,10 @@ inline EmbVec2D rotate(const EmbVec2D &vec, const float ang) {
   // | sin(ang)    cos(ang) | |y|
   //
 
-  const auto xPrime = vec.x * cosf(ang) - vec.y * sinf(ang);
-  const auto yPrime = vec.x * sinf(ang) + vec.y * cosf(ang);
+  const float c = cosf(ang);
+  const float s = sinf(ang);
+  const auto xPrime = vec.x * c - vec.y * s;
+  const auto yPrime = vec.x * s + vec.y * c;
 
   return EmbVec2D{xPrime, yPrime};
 }
@@ -798,9 +828,11 @@ inline EmbVec3D rotateAlpha(const EmbVec3D &vec, const float ang) {
   // |0  sin(ang)   cos(ang)| |z|
   //
 
+  const float c = cosf(ang);
+  const float s = sinf(ang);
   const auto xPrime = vec.x;
-  const auto yPrime = vec.y * cosf(ang) - vec.z * sinf(ang);
-  const auto zPrime = vec.y * sinf(ang) + vec.z * cosf(ang);
+  const auto yPrime = vec.y * c - vec.z * s;
+  const auto zPrime = vec.y * s + vec.z * c;
 
   return EmbVec3D{xPrime, yPrime, zPrime};
 }
@@ -824,9 +856,11 @@ inline EmbVec3D rotateBeta(const EmbVec3D &vec, const float ang) {
   // |−sin(ang)  0  cos(ang)| |z|
   //
 
-  const auto xPrime = vec.x * cosf(ang) + vec.z * sinf(ang);
+  const float c = cosf(ang);
+  const float s = sinf(ang);
+  const auto xPrime = vec.x * c + vec.z * s;
   const auto yPrime = vec.y;
-  const auto zPrime = -vec.x * sinf(ang) + vec.z * cosf(ang);
+  const auto zPrime = -vec.x * s + vec.z * c;
 
   return EmbVec3D{xPrime, yPrime, zPrime};
 }
@@ -850,12 +884,517 @@ inline EmbVec3D rotateGamma(const EmbVec3D &vec, const float ang) {
   // |  0         0        1| |z|
   //
 
-  const auto xPrime = vec.x * cosf(ang) - vec.y * sinf(ang);
-  const auto yPrime = vec.x * sinf(ang) + vec.y * cosf(ang);
+  const float c = cosf(ang);
+  const float s = sinf(ang);
+  const auto xPrime = vec.x * c - vec.y * s;
+  const auto yPrime = vec.x * s + vec.y * c;
   const auto zPrime = vec.z;
 
   return EmbVec3D{xPrime, yPrime, zPrime};
 }
+
+/**
+ * @brief Polar form of a 2D vector.
+ *
+ * This is returned by svector::cordicPolar(), which computes both values in a
+ * single CORDIC pass.
+ */
+struct EmbPolar2D {
+  float magn;  //!< The magnitude of the vector.
+  float angle; //!< The angle of the vector in radians, in the range (-π, π].
+};
+
+namespace detail {
+/**
+ * @brief Maximum number of CORDIC iterations that are useful for floats.
+ */
+const unsigned int CORDIC_MAX_ITERATIONS = 24;
+
+/**
+ * @brief Gets atan(2^-i), the angle of the i-th CORDIC micro-rotation.
+ *
+ * @param i The iteration number, less than CORDIC_MAX_ITERATIONS.
+ *
+ * @returns The micro-rotation angle in radians.
+ */
+inline float cordicAtan(const unsigned int i) {
+  static const float table[CORDIC_MAX_ITERATIONS] = {
+      7.853981634e-01F, 4.636476090e-01F, 2.449786631e-01F, 1.243549945e-01F,
+      6.241881000e-02F, 3.123983343e-02F, 1.562372862e-02F, 7.812341060e-03F,
+      3.906230132e-03F, 1.953122516e-03F, 9.765621896e-04F, 4.882812112e-04F,
+      2.441406201e-04F, 1.220703119e-04F, 6.103515617e-05F, 3.051757812e-05F,
+      1.525878906e-05F, 7.629394531e-06F, 3.814697266e-06F, 1.907348633e-06F,
+      9.536743164e-07F, 4.768371582e-07F, 2.384185791e-07F, 1.192092896e-07F};
+  return table[i];
+}
+
+/**
+ * @brief Gets the inverse of the CORDIC gain after a number of iterations.
+ *
+ * Every micro-rotation lengthens the vector by sqrt(1 + 2^-2i), so the result
+ * is multiplied by this value once at the end to undo that growth.
+ *
+ * @param iterations The number of iterations, at most CORDIC_MAX_ITERATIONS.
+ *
+ * @returns The product of 1 / sqrt(1 + 2^-2i) for i in [0, iterations).
+ */
+inline float cordicInvGain(const unsigned int iterations) {
+  static const float table[CORDIC_MAX_ITERATIONS + 1] = {
+      1.000000000e+00F, 7.071067812e-01F, 6.324555320e-01F, 6.135719911e-01F,
+      6.088339125e-01F, 6.076482563e-01F, 6.073517701e-01F, 6.072776441e-01F,
+      6.072591123e-01F, 6.072544793e-01F, 6.072533211e-01F, 6.072530315e-01F,
+      6.072529591e-01F, 6.072529410e-01F, 6.072529365e-01F, 6.072529354e-01F,
+      6.072529351e-01F, 6.072529350e-01F, 6.072529350e-01F, 6.072529350e-01F,
+      6.072529350e-01F, 6.072529350e-01F, 6.072529350e-01F, 6.072529350e-01F,
+      6.072529350e-01F};
+  return table[iterations];
+}
+
+/**
+ * @brief Clamps an iteration count to the size of the CORDIC tables.
+ */
+inline unsigned int cordicClamp(const unsigned int iterations) {
+  return iterations > CORDIC_MAX_ITERATIONS ? CORDIC_MAX_ITERATIONS
+                                            : iterations;
+}
+
+/**
+ * @brief Rotates a pair of components with CORDIC in rotation mode.
+ *
+ * Rotates the point (a, b) counterclockwise by the given angle in place.
+ *
+ * The loop only uses additions and multiplications by powers of two, which
+ * are exact exponent adjustments for floats and plain shifts for fixed-point
+ * ports.
+ *
+ * @param a The first component.
+ * @param b The second component.
+ * @param ang The angle to rotate by, in radians.
+ * @param iterations The number of micro-rotations.
+ */
+inline void cordicRotatePair(float &a, float &b, float ang,
+                             const unsigned int iterations) {
+  const float pi = 3.14159265358979F;
+  const float halfPi = 1.57079632679490F;
+
+  // reduce to [-π, π)
+  if (ang >= pi || ang < -pi) {
+    ang -= 2 * pi * floorf((ang + pi) / (2 * pi));
+  }
+
+  // CORDIC only converges for about ±1.74 rad, so quarter turns are done
+  // beforehand by swapping components
+  if (ang > halfPi) {
+    const float tmp = a;
+    a = -b;
+    b = tmp;
+    ang -= halfPi;
+  } else if (ang < -halfPi) {
+    const float tmp = a;
+    a = b;
+    b = -tmp;
+    ang += halfPi;
+  }
+
+  const unsigned int n = cordicClamp(iterations);
+  float pow2 = 1;
+  for (unsigned int i = 0; i < n; i++) {
+    const float aShift = a * pow2;
+    const float bShift = b * pow2;
+
+    if (ang >= 0) {
+      a -= bShift;
+      b += aShift;
+      ang -= cordicAtan(i);
+    } else {
+      a += bShift;
+      b -= aShift;
+      ang += cordicAtan(i);
+    }
+
+    pow2 *= 0.5F;
+  }
+
+  a *= cordicInvGain(n);
+  b *= cordicInvGain(n);
+}
+} // namespace detail
+
+/**
+ * @brief Rotates vector by a certain angle using CORDIC.
+ *
+ * This is an alternative to svector::rotate() that does not call cosf() or
+ * sinf(), which is useful on cores without an FPU. The angle should be given
+ * in radians. The vector rotates counterclockwise when the angle is positive
+ * and clockwise when the angle is negative.
+ *
+ * Each iteration adds roughly one bit of precision; 16 iterations give an
+ * angular error of about 2^-16 rad.
+ *
+ * @param vec A 2D vector.
+ * @param ang The angle to rotate the vector, in radians.
+ * @param iterations The number of CORDIC iterations, at most 24.
+ *
+ * @returns A new, rotated vector.
+ */
+inline EmbVec2D
+cordicRotate(const EmbVec2D &vec, const float ang,
+             const unsigned int iterations = SVECTOR_EMBED_CORDIC_ITERATIONS) {
+  float xPrime = vec.x;
+  float yPrime = vec.y;
+  detail::cordicRotatePair(xPrime, yPrime, ang, iterations);
+
+  return EmbVec2D{xPrime, yPrime};
+}
+
+/**
+ * @brief Gets the magnitude and angle of a 2D vector using CORDIC.
+ *
+ * Runs CORDIC in vectoring mode, which rotates the vector onto the positive
+ * x-axis. The accumulated rotation is the angle and the final x-component is
+ * the magnitude, so both come out of the same pass without calling sqrtf()
+ * or atan2f().
+ *
+ * The angle will be in the range (-π, π]. A zero vector has an angle of 0.
+ *
+ * @param vec A 2D vector.
+ * @param iterations The number of CORDIC iterations, at most 24.
+ *
+ * @returns The magnitude and angle of the vector.
+ */
+inline EmbPolar2D
+cordicPolar(const EmbVec2D &vec,
+            const unsigned int iterations = SVECTOR_EMBED_CORDIC_ITERATIONS) {
+  const float halfPi = 1.57079632679490F;
+
+  if (vec.x == 0 && vec.y == 0) {
+    return EmbPolar2D{0, 0};
+  }
+
+  float xCur = vec.x;
+  float yCur = vec.y;
+  float ang = 0;
+
+  // bring the vector into the right half-plane first
+  if (xCur < 0) {
+    const float tmp = xCur;
+    if (yCur >= 0) {
+      xCur = yCur;
+      yCur = -tmp;
+      ang = halfPi;
+    } else {
+      xCur = -yCur;
+      yCur = tmp;
+      ang = -halfPi;
+    }
+  }
+
+  const unsigned int n = detail::cordicClamp(iterations);
+  float pow2 = 1;
+  for (unsigned int i = 0; i < n; i++) {
+    const float xShift = xCur * pow2;
+    const float yShift = yCur * pow2;
+
+    if (yCur < 0) {
+      xCur -= yShift;
+      yCur += xShift;
+      ang -= detail::cordicAtan(i);
+    } else {
+      xCur += yShift;
+      yCur -= xShift;
+      ang += detail::cordicAtan(i);
+    }
+
+    pow2 *= 0.5F;
+  }
+
+  return EmbPolar2D{xCur * detail::cordicInvGain(n), ang};
+}
+
+/**
+ * @brief Gets the magnitude of a 2D vector using CORDIC.
+ *
+ * @see svector::cordicPolar()
+ *
+ * @param vec A 2D vector.
+ * @param iterations The number of CORDIC iterations, at most 24.
+ *
+ * @returns The magnitude of the vector.
+ */
+inline float
+cordicMagn(const EmbVec2D &vec,
+           const unsigned int iterations = SVECTOR_EMBED_CORDIC_ITERATIONS) {
+  return cordicPolar(vec, iterations).magn;
+}
+
+/**
+ * @brief Gets the angle of a 2D vector in radians using CORDIC.
+ *
+ * The angle will be in the range (-π, π].
+ *
+ * @see svector::cordicPolar()
+ *
+ * @param vec A 2D vector.
+ * @param iterations The number of CORDIC iterations, at most 24.
+ *
+ * @returns The angle of the vector.
+ */
+inline float
+cordicAngle(const EmbVec2D &vec,
+            const unsigned int iterations = SVECTOR_EMBED_CORDIC_ITERATIONS) {
+  return cordicPolar(vec, iterations).angle;
+}
+
+/**
+ * @brief Rotates around x-axis using CORDIC.
+ *
+ * Gives the same result as svector::rotateAlpha() without calling cosf() or
+ * sinf().
+ *
+ * @param vec A 3D vector.
+ * @param ang The angle to rotate the vector, in radians.
+ * @param iterations The number of CORDIC iterations, at most 24.
+ *
+ * @returns A new, rotated vector.
+ */
+inline EmbVec3D cordicRotateAlpha(
+    const EmbVec3D &vec, const float ang,
+    const unsigned int iterations = SVECTOR_EMBED_CORDIC_ITERATIONS) {
+  float yPrime = vec.y;
+  float zPrime = vec.z;
+  detail::cordicRotatePair(yPrime, zPrime, ang, iterations);
+
+  return EmbVec3D{vec.x, yPrime, zPrime};
+}
+
+/**
+ * @brief Rotates around y-axis using CORDIC.
+ *
+ * Gives the same result as svector::rotateBeta() without calling cosf() or
+ * sinf().
+ *
+ * @param vec A 3D vector.
+ * @param ang The angle to rotate the vector, in radians.
+ * @param iterations The number of CORDIC iterations, at most 24.
+ *
+ * @returns A new, rotated vector.
+ */
+inline EmbVec3D cordicRotateBeta(
+    const EmbVec3D &vec, const float ang,
+    const unsigned int iterations = SVECTOR_EMBED_CORDIC_ITERATIONS) {
+  // rotation around the y-axis turns z towards x
+  float zPrime = vec.z;
+  float xPrime = vec.x;
+  detail::cordicRotatePair(zPrime, xPrime, ang, iterations);
+
+  return EmbVec3D{xPrime, vec.y, zPrime};
+}
+
+/**
+ * @brief Rotates around z-axis using CORDIC.
+ *
+ * Gives the same result as svector::rotateGamma() without calling cosf() or
+ * sinf().
+ *
+ * @param vec A 3D vector.
+ * @param ang The angle to rotate the vector, in radians.
+ * @param iterations The number of CORDIC iterations, at most 24.
+ *
+ * @returns A new, rotated vector.
+ */
+inline EmbVec3D cordicRotateGamma(
+    const EmbVec3D &vec, const float ang,
+    const unsigned int iterations = SVECTOR_EMBED_CORDIC_ITERATIONS) {
+  float xPrime = vec.x;
+  float yPrime = vec.y;
+  detail::cordicRotatePair(xPrime, yPrime, ang, iterations);
+
+  return EmbVec3D{xPrime, yPrime, vec.z};
+}
+
+namespace detail {
+/**
+ * @brief Whether ringLoad() and ringStore() order the samples with the
+ * indices on this compiler.
+ */
+#if defined(__GNUC__) || defined(__clang__) ||                                 \
+    defined(SVECTOR_EMBED_COMPILER_BARRIER)
+const bool RING_ORDERED = true;
+#else
+const bool RING_ORDERED = false;
+#endif
+
+/**
+ * @brief Reads an index that another context writes, before reading what it
+ * guards.
+ *
+ * Uses the GCC/Clang atomic builtins when they are there. Otherwise the
+ * index is read through a volatile, which is enough on single-core
+ * microcontrollers where an unsigned int is read in one instruction, and
+ * SVECTOR_EMBED_COMPILER_BARRIER() keeps the samples from being read
+ * before it.
+ */
+inline unsigned int ringLoad(const unsigned int &index) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_load_n(&index, __ATOMIC_ACQUIRE);
+#else
+  const unsigned int value =
+      *static_cast<const volatile unsigned int *>(&index);
+#ifdef SVECTOR_EMBED_COMPILER_BARRIER
+  SVECTOR_EMBED_COMPILER_BARRIER();
+#endif
+  return value;
+#endif
+}
+
+/**
+ * @brief Writes an index that another context reads, after writing what it
+ * guards.
+ */
+inline void ringStore(unsigned int &index, const unsigned int value) {
+#if defined(__GNUC__) || defined(__clang__)
+  __atomic_store_n(&index, value, __ATOMIC_RELEASE);
+#else
+#ifdef SVECTOR_EMBED_COMPILER_BARRIER
+  SVECTOR_EMBED_COMPILER_BARRIER();
+#endif
+  *static_cast<volatile unsigned int *>(&index) = value;
+#endif
+}
+} // namespace detail
+
+/**
+ * @brief A fixed-size ring buffer for passing samples from an interrupt
+ * handler to the main loop.
+ *
+ * Exactly one context may write (usually the interrupt handler) and exactly
+ * one may read (usually the main loop), and neither has to turn interrupts
+ * off. The samples are stored in the buffer itself, so there is no heap,
+ * and the indices wrap with a mask, so there is no division.
+ *
+ * When the buffer is full, push() drops the new sample and returns false,
+ * so that the interrupt handler never waits.
+ *
+ * ```cpp
+ * svector::EmbRingBuffer<svector::EmbVec3D, 32> samples;
+ *
+ * void onAccelerometer() { samples.push(readAccelerometer()); }
+ *
+ * void loop() {
+ *   svector::EmbVec3D batch[8];
+ *   const unsigned int count = samples.read(batch, 8);
+ *   // ...
+ * }
+ * ```
+ *
+ * @tparam T The sample type, usually EmbVec2D or EmbVec3D.
+ * @tparam Capacity The maximum number of samples, a power of 2.
+ */
+template <typename T, unsigned int Capacity> class EmbRingBuffer {
+  static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                "EmbRingBuffer capacity must be a power of 2");
+  // depends on T, so that only using the buffer needs the barrier
+  static_assert(sizeof(T) != 0 && detail::RING_ORDERED,
+                "EmbRingBuffer needs SVECTOR_EMBED_COMPILER_BARRIER() to be "
+                "defined for this compiler");
+
+public:
+  /**
+   * @brief Creates an empty buffer.
+   */
+  EmbRingBuffer() : m_head{0}, m_tail{0} {}
+
+  EmbRingBuffer(const EmbRingBuffer &) = delete;
+  EmbRingBuffer &operator=(const EmbRingBuffer &) = delete;
+
+  /**
+   * @brief Gets the maximum number of samples.
+   */
+  static constexpr unsigned int capacity() { return Capacity; }
+
+  /**
+   * @brief Adds a sample, if there is room. Writer only.
+   *
+   * @param value The sample.
+   *
+   * @returns Whether the sample was added.
+   */
+  bool push(const T &value) { return this->write(&value, 1) == 1; }
+
+  /**
+   * @brief Adds as many samples of an array as there is room for. Writer
+   * only.
+   *
+   * @param data The samples.
+   * @param count The number of samples.
+   *
+   * @returns The number of samples added, from the start of the array.
+   */
+  unsigned int write(const T *data, const unsigned int count) {
+    const unsigned int tail = m_tail;
+    const unsigned int room = Capacity - (tail - detail::ringLoad(m_head));
+    const unsigned int written = count < room ? count : room;
+    for (unsigned int i = 0; i < written; i++) {
+      m_slots[(tail + i) & (Capacity - 1)] = data[i];
+    }
+
+    detail::ringStore(m_tail, tail + written);
+    return written;
+  }
+
+  /**
+   * @brief Removes the oldest sample, if there is one. Reader only.
+   *
+   * @param value Where to copy the sample.
+   *
+   * @returns Whether a sample was removed.
+   */
+  bool pop(T &value) { return this->read(&value, 1) == 1; }
+
+  /**
+   * @brief Removes up to a number of the oldest samples, in order. Reader
+   * only.
+   *
+   * @param out Where to copy the samples.
+   * @param maxCount The largest number of samples to remove.
+   *
+   * @returns The number of samples removed.
+   */
+  unsigned int read(T *out, const unsigned int maxCount) {
+    const unsigned int head = m_head;
+    const unsigned int available = detail::ringLoad(m_tail) - head;
+    const unsigned int count = maxCount < available ? maxCount : available;
+    for (unsigned int i = 0; i < count; i++) {
+      out[i] = m_slots[(head + i) & (Capacity - 1)];
+    }
+
+    detail::ringStore(m_head, head + count);
+    return count;
+  }
+
+  /**
+   * @brief Gets the number of samples.
+   *
+   * The writer can add more right after this returns.
+   */
+  unsigned int size() const {
+    const unsigned int head = detail::ringLoad(m_head);
+    return detail::ringLoad(m_tail) - head;
+  }
+
+  /**
+   * @brief Checks if there are no samples.
+   */
+  bool empty() const { return this->size() == 0; }
+
+private:
+  T m_slots[Capacity];
+
+  // the indices only ever increase and wrap around at the largest unsigned
+  // int; the slot is the index mod Capacity
+  unsigned int m_head; // written by the reader
+  unsigned int m_tail; // written by the writer
+};
 } // namespace svector
 
 #endif
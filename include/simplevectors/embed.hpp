@@ -564,8 +564,10 @@ inline Vec2D rotate(const Vec2D &vec, const double ang) {
   // | sin(ang)    cos(ang) | |y|
   //
 
-  const double xPrime = vec.x * std::cos(ang) - vec.y * std::sin(ang);
-  const double yPrime = vec.x * std::sin(ang) + vec.y * std::cos(ang);
+  const double c = std::cos(ang);
+  const double s = std::sin(ang);
+  const double xPrime = vec.x * c - vec.y * s;
+  const double yPrime = vec.x * s + vec.y * c;
 
   return Vec2D{xPrime, yPrime};
 }
@@ -820,9 +822,11 @@ inline Vec3D rotateAlpha(const Vec3D &vec, const double ang) {
   // |0  sin(ang)   cos(ang)| |z|
   //
 
+  const double c = std::cos(ang);
+  const double s = std::sin(ang);
   const double xPrime = vec.x;
-  const double yPrime = vec.y * std::cos(ang) - vec.z * std::sin(ang);
-  const double zPrime = vec.y * std::sin(ang) + vec.z * std::cos(ang);
+  const double yPrime = vec.y * c - vec.z * s;
+  const double zPrime = vec.y * s + vec.z * c;
 
   return Vec3D{xPrime, yPrime, zPrime};
 }
@@ -846,9 +850,11 @@ inline Vec3D rotateBeta(const Vec3D &vec, const double ang) {
   // |−sin(ang)  0  cos(ang)| |z|
   //
 
-  const double xPrime = vec.x * std::cos(ang) + vec.z * std::sin(ang);
+  const double c = std::cos(ang);
+  const double s = std::sin(ang);
+  const double xPrime = vec.x * c + vec.z * s;
   const double yPrime = vec.y;
-  const double zPrime = -vec.x * std::sin(ang) + vec.z * std::cos(ang);
+  const double zPrime = -vec.x * s + vec.z * c;
 
   return Vec3D{xPrime, yPrime, zPrime};
 }
@@ -872,8 +878,10 @@ inline Vec3D rotateGamma(const Vec3D &vec, const double ang) {
   // |  0         0        1| |z|
   //
 
-  const double xPrime = vec.x * std::cos(ang) - vec.y * std::sin(ang);
-  const double yPrime = vec.x * std::sin(ang) + vec.y * std::cos(ang);
+  const double c = std::cos(ang);
+  const double s = std::sin(ang);
+  const double xPrime = vec.x * c - vec.y * s;
+  const double yPrime = vec.x * s + vec.y * c;
   const double zPrime = vec.z;
 
   return Vec3D{xPrime, yPrime, zPrime};
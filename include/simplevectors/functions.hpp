@@ -18,11 +18,19 @@
 #include <cmath>            // std::atan2, std::acos, std::sqrt
 #include <cstddef>          // std::size_t
 #include <initializer_list> // std::initializer_list
+#include <stdexcept>        // std::invalid_argument
+#include <type_traits>      // std::is_floating_point, std::remove_const, ...
+#include <utility>          // std::declval, std::move
 #include <vector>           // std::vector
 
+#include "simplevectors/core/accumulate.hpp"
+#include "simplevectors/core/dynvector.hpp"
+#include "simplevectors/core/instrument.hpp"
+#include "simplevectors/core/sparse.hpp"
 #include "simplevectors/core/vector.hpp"
 #include "simplevectors/core/vector2d.hpp"
 #include "simplevectors/core/vector3d.hpp"
+#include "simplevectors/core/view.hpp"
 
 namespace svector {
 // COMBINER_PY_START
@@ -37,7 +45,7 @@ namespace svector {
  * @returns A vector whose dimensions reflect the elements in the array.
  */
 template <std::size_t D, typename T>
-Vector<D, T> makeVector(std::array<T, D> array) {
+Vector<D, T> makeVector(const std::array<T, D> &array) {
   Vector<D, T> vec;
   for (std::size_t i = 0; i < D; i++) {
     vec[i] = array[i];
@@ -63,7 +71,7 @@ Vector<D, T> makeVector(std::array<T, D> array) {
  * @returns A vector whose dimensions reflect the elements in the std::vector.
  */
 template <std::size_t D, typename T>
-Vector<D, T> makeVector(std::vector<T> vector) {
+Vector<D, T> makeVector(const std::vector<T> &vector) {
   Vector<D, T> vec;
   for (std::size_t i = 0; i < std::min(D, vector.size()); i++) {
     vec[i] = vector[i];
@@ -72,6 +80,51 @@ Vector<D, T> makeVector(std::vector<T> vector) {
   return vec;
 }
 
+/**
+ * @brief Creates a vector from the first D elements of a buffer.
+ *
+ * @note The buffer must have at least D elements.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ * @param data A pointer to the first element.
+ *
+ * @returns A vector whose dimensions reflect the elements in the buffer.
+ */
+template <std::size_t D, typename T> Vector<D, T> makeVector(const T *data) {
+  Vector<D, T> vec;
+  for (std::size_t i = 0; i < D; i++) {
+    vec[i] = data[i];
+  }
+
+  return vec;
+}
+
+/**
+ * @brief Creates a vector from a buffer with a given size.
+ *
+ * This works like makeVector(const std::vector<T> &) on any contiguous
+ * range, without copying it. If the buffer has fewer elements than the
+ * specified dimensions, then the rest of the elements would be 0. If it has
+ * more, then the extra elements are ignored.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ * @param data A pointer to the first element.
+ * @param size The number of elements in the buffer.
+ *
+ * @returns A vector whose dimensions reflect the elements in the buffer.
+ */
+template <std::size_t D, typename T>
+Vector<D, T> makeVector(const T *data, const std::size_t size) {
+  Vector<D, T> vec;
+  for (std::size_t i = 0; i < std::min(D, size); i++) {
+    vec[i] = data[i];
+  }
+
+  return vec;
+}
+
 /**
  * @brief Creates a vector from an initializer list.
  *
@@ -95,90 +148,197 @@ Vector<D, T> makeVector(const std::initializer_list<T> args) {
   return vec;
 }
 
+namespace detail {
+// only used in decltype() to find the Vector base of a vector type
+template <std::size_t D, typename T>
+std::integral_constant<std::size_t, D> dimensionsOf(const Vector<D, T> &);
+template <std::size_t D, typename T> T componentOf(const Vector<D, T> &);
+} // namespace detail
+
+/**
+ * @brief Converts a flat buffer of components to an array of vectors.
+ *
+ * The buffer holds the components of each vector one after another, like
+ * `x0, y0, z0, x1, y1, z1, ...` for 3D vectors. The components are
+ * converted to the component type of the vectors, so a float buffer can be
+ * loaded into svector::Vector3D objects.
+ *
+ * Each vector stores a pointer to its virtual function table in front of
+ * its components, so an array of vectors is not itself a flat buffer. The
+ * components are copied one vector at a time, with the number of
+ * dimensions known at compile time.
+ *
+ * @tparam V A vector type: svector::Vector or a class derived from it, such
+ * as svector::Vector2D.
+ * @tparam T The component type of the buffer.
+ *
+ * @param data The buffer, with count times the number of dimensions
+ * elements.
+ * @param count The number of vectors.
+ * @param out The vectors to write to, with room for count vectors.
+ */
+template <typename V, typename T>
+inline void fromFlatArray(const T *data, const std::size_t count, V *out) {
+  typedef decltype(detail::dimensionsOf(std::declval<const V &>())) dims;
+  typedef decltype(detail::componentOf(std::declval<const V &>())) component;
+  SVECTOR_INSTRUMENT_BATCH("fromFlatArray", dims::value, component, count);
+
+  for (std::size_t i = 0; i < count; i++) {
+    const T *src = data + i * dims::value;
+    for (std::size_t j = 0; j < dims::value; j++) {
+      out[i][j] = static_cast<component>(src[j]);
+    }
+  }
+}
+
+/**
+ * @brief Converts an array of vectors to a flat buffer of components.
+ *
+ * This does the opposite of fromFlatArray().
+ *
+ * @tparam V A vector type: svector::Vector or a class derived from it, such
+ * as svector::Vector2D.
+ * @tparam T The component type of the buffer.
+ *
+ * @param vectors The vectors to read.
+ * @param count The number of vectors.
+ * @param out The buffer to write to, with room for count times the number
+ * of dimensions elements.
+ */
+template <typename V, typename T>
+inline void toFlatArray(const V *vectors, const std::size_t count, T *out) {
+  typedef decltype(detail::dimensionsOf(std::declval<const V &>())) dims;
+  SVECTOR_INSTRUMENT_BATCH(
+      "toFlatArray", dims::value,
+      decltype(detail::componentOf(std::declval<const V &>())), count);
+
+  for (std::size_t i = 0; i < count; i++) {
+    T *dst = out + i * dims::value;
+    for (std::size_t j = 0; j < dims::value; j++) {
+      dst[j] = static_cast<T>(vectors[i][j]);
+    }
+  }
+}
+
 /**
  * @brief Gets the x-component of a 2D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 2D Vector.
  *
  * @returns x-component of the vector.
  */
-inline double x(const Vector2D &v) { return v[0]; }
+template <typename T> inline T x(const Vector<2, T> &v) { return v[0]; }
 
 /**
  * @brief Sets the x-component of a 2D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 2D Vector.
  * @param xValue The x-value to set to the vector.
  */
-inline void x(Vector2D &v, const double xValue) { v[0] = xValue; }
+template <typename T>
+inline void x(Vector<2, T> &v, const typename Vector<2, T>::value_type xValue) {
+  v[0] = xValue;
+}
 
 /**
  * @brief Gets the x-component of a 3D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D Vector.
  *
  * @returns x-component of the vector.
  */
-inline double x(const Vector3D &v) { return v[0]; }
+template <typename T> inline T x(const Vector<3, T> &v) { return v[0]; }
 
 /**
  * @brief Sets the x-component of a 3D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D Vector.
  * @param xValue The x-value to set to the vector.
  */
-inline void x(Vector3D &v, const double xValue) { v[0] = xValue; }
+template <typename T>
+inline void x(Vector<3, T> &v, const typename Vector<3, T>::value_type xValue) {
+  v[0] = xValue;
+}
 
 /**
  * @brief Gets the y-component of a 2D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 2D Vector.
  *
  * @returns y-component of the vector.
  */
-inline double y(const Vector2D &v) { return v[1]; }
+template <typename T> inline T y(const Vector<2, T> &v) { return v[1]; }
 
 /**
  * @brief Sets the y-component of a 2D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 2D Vector.
  * @param yValue The y-value to set to the vector.
  */
-inline void y(Vector2D &v, const double yValue) { v[1] = yValue; }
+template <typename T>
+inline void y(Vector<2, T> &v, const typename Vector<2, T>::value_type yValue) {
+  v[1] = yValue;
+}
 
 /**
  * @brief Gets the y-component of a 3D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D Vector.
  *
  * @returns y-component of the vector.
  */
-inline double y(const Vector3D &v) { return v[1]; }
+template <typename T> inline T y(const Vector<3, T> &v) { return v[1]; }
 
 /**
  * @brief Sets the y-component of a 3D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D Vector.
  * @param yValue The y value to set to the vector.
  */
-inline void y(Vector3D &v, const double yValue) { v[1] = yValue; }
+template <typename T>
+inline void y(Vector<3, T> &v, const typename Vector<3, T>::value_type yValue) {
+  v[1] = yValue;
+}
 
 /**
  * @brief Gets the z-component of a 3D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D Vector.
  *
  * @returns z-component of the vector.
  */
-inline double z(const Vector3D &v) { return v[2]; }
+template <typename T> inline T z(const Vector<3, T> &v) { return v[2]; }
 
 /**
  * @brief Sets the z-component of a 3D vector.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D Vector.
  * @param zValue The z value to set to the vector.
  */
-inline void z(Vector3D &v, const double zValue) { v[2] = zValue; }
+template <typename T>
+inline void z(Vector<3, T> &v, const typename Vector<3, T>::value_type zValue) {
+  v[2] = zValue;
+}
 
 /**
  * @brief Calculates the dot product of two vectors.
@@ -215,13 +375,50 @@ inline T dot(const Vector<D, T> &lhs, const Vector<D, T> &rhs) {
  * @returns magnitude of vector.
  */
 template <typename T, std::size_t D> inline T magn(const Vector<D, T> &v) {
-  T sum_of_squares = 0;
+  SVECTOR_INSTRUMENT_CALL("magn", D, T);
+  return detail::magnitude<D, T>(v);
+}
 
-  for (std::size_t i = 0; i < D; i++) {
-    sum_of_squares += v[i] * v[i];
-  }
+/**
+ * @brief Calculates the dot product of two vectors with an accumulation
+ * policy.
+ *
+ * See accumulate.hpp for the policies, for example
+ * `svector::dot(a, b, svector::Kahan())`.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ * @tparam Policy The accumulation policy.
+ *
+ * @param lhs First vector.
+ * @param rhs Second vector.
+ * @param policy The accumulation policy tag.
+ *
+ * @returns The dot product of lhs and rhs.
+ */
+template <typename T, std::size_t D, typename Policy>
+inline T dot(const Vector<D, T> &lhs, const Vector<D, T> &rhs,
+             const Policy policy) {
+  return accumulate::dot(&lhs[0], &rhs[0], D, policy);
+}
+
+/**
+ * @brief Gets the magnitude of the vector with an accumulation policy.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ * @tparam Policy The accumulation policy.
+ *
+ * @param v The vector to get magnitude of.
+ * @param policy The accumulation policy tag.
+ *
+ * @returns magnitude of vector.
+ */
+template <typename T, std::size_t D, typename Policy>
+inline T magn(const Vector<D, T> &v, const Policy policy) {
+  SVECTOR_INSTRUMENT_CALL("magn", D, T);
 
-  return std::sqrt(sum_of_squares);
+  return std::sqrt(accumulate::dot(&v[0], &v[0], D, policy));
 }
 
 /**
@@ -241,7 +438,8 @@ template <typename T, std::size_t D> inline T magn(const Vector<D, T> &v) {
  */
 template <typename T, std::size_t D>
 inline Vector<D, T> normalize(const Vector<D, T> &v) {
-  return v / magn(v);
+  SVECTOR_INSTRUMENT_CALL("normalize", D, T);
+  return v / detail::magnitude<D, T>(v);
 }
 
 /**
@@ -253,7 +451,7 @@ inline Vector<D, T> normalize(const Vector<D, T> &v) {
  * @returns Whether the given vector is a zero vector.
  */
 template <typename T, std::size_t D> inline bool isZero(const Vector<D, T> &v) {
-  return magn(v) == 0;
+  return detail::magnitude<D, T>(v) == 0;
 }
 
 /**
@@ -261,11 +459,17 @@ template <typename T, std::size_t D> inline bool isZero(const Vector<D, T> &v) {
  *
  * The angle will be in the range (-π, π].
  *
+ * @tparam T Vector type.
+ *
  * @param v A 2D vector.
  *
  * @returns angle of the vector.
  */
-inline double angle(const Vector2D &v) { return std::atan2(y(v), x(v)); }
+template <typename T> inline T angle(const Vector<2, T> &v) {
+  static_assert(std::is_floating_point<T>::value,
+                "Vector type must be floating point");
+  return std::atan2(y(v), x(v));
+}
 
 /**
  * @brief Rotates a 2D vector by a certain angle.
@@ -274,12 +478,20 @@ inline double angle(const Vector2D &v) { return std::atan2(y(v), x(v)); }
  * counterclockwise when the angle is positive and clockwise
  * when the angle is negative.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 2D vector.
  * @param ang the angle to rotate the vector, in radians.
  *
  * @returns a new, rotated vector.
  */
-inline Vector2D rotate(const Vector2D &v, const double ang) {
+template <typename T>
+inline BasicVector2D<T> rotate(const Vector<2, T> &v,
+                               const typename Vector<2, T>::value_type ang) {
+  static_assert(std::is_floating_point<T>::value,
+                "Vector type must be floating point");
+  SVECTOR_INSTRUMENT_CALL("rotate", 2, T);
+
   //
   // Rotation matrix:
   //
@@ -287,26 +499,34 @@ inline Vector2D rotate(const Vector2D &v, const double ang) {
   // | sin(ang)    cos(ang) | |y|
   //
 
-  const double xPrime = x(v) * std::cos(ang) - y(v) * std::sin(ang);
-  const double yPrime = x(v) * std::sin(ang) + y(v) * std::cos(ang);
+  const T c = std::cos(ang);
+  const T s = std::sin(ang);
+  const T xPrime = x(v) * c - y(v) * s;
+  const T yPrime = x(v) * s + y(v) * c;
 
-  return Vector2D{xPrime, yPrime};
+  return BasicVector2D<T>{xPrime, yPrime};
 }
 
 /**
  * @brief Cross product of two vectors.
  *
+ * @tparam T Vector type.
+ *
  * @param lhs The first vector.
  * @param rhs The second vector, crossed with the first vector.
  *
  * @returns The cross product of the two vectors.
  */
-inline Vector3D cross(const Vector3D &lhs, const Vector3D &rhs) {
-  const double newx = y(lhs) * z(rhs) - z(lhs) * y(rhs);
-  const double newy = z(lhs) * x(rhs) - x(lhs) * z(rhs);
-  const double newz = x(lhs) * y(rhs) - y(lhs) * x(rhs);
+template <typename T>
+inline BasicVector3D<T> cross(const Vector<3, T> &lhs,
+                              const Vector<3, T> &rhs) {
+  SVECTOR_INSTRUMENT_CALL("cross", 3, T);
+
+  const T newx = y(lhs) * z(rhs) - z(lhs) * y(rhs);
+  const T newy = z(lhs) * x(rhs) - x(lhs) * z(rhs);
+  const T newz = x(lhs) * y(rhs) - y(lhs) * x(rhs);
 
-  return Vector3D{newx, newy, newz};
+  return BasicVector3D<T>{newx, newy, newz};
 }
 
 /**
@@ -317,11 +537,17 @@ inline Vector3D cross(const Vector3D &lhs, const Vector3D &rhs) {
  * @note This method will result in undefined behavior if the vector is a zero
  * vector (if the magnitude equals zero).
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D vector.
  *
  * @returns α
  */
-inline double alpha(const Vector3D &v) { return std::acos(x(v) / magn(v)); }
+template <typename T> inline T alpha(const Vector<3, T> &v) {
+  static_assert(std::is_floating_point<T>::value,
+                "Vector type must be floating point");
+  return std::acos(x(v) / detail::magnitude<3, T>(v));
+}
 
 /**
  * @brief Gets β angle.
@@ -331,11 +557,17 @@ inline double alpha(const Vector3D &v) { return std::acos(x(v) / magn(v)); }
  * @note This method will result in undefined behavior if the vector is a zero
  * vector (if the magnitude equals zero).
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D vector.
  *
  * @returns β
  */
-inline double beta(const Vector3D &v) { return std::acos(y(v) / magn(v)); }
+template <typename T> inline T beta(const Vector<3, T> &v) {
+  static_assert(std::is_floating_point<T>::value,
+                "Vector type must be floating point");
+  return std::acos(y(v) / detail::magnitude<3, T>(v));
+}
 
 /**
  * @brief Gets γ angle.
@@ -345,23 +577,38 @@ inline double beta(const Vector3D &v) { return std::acos(y(v) / magn(v)); }
  * @note This method will result in undefined behavior if the vector is a zero
  * vector (if the magnitude equals zero).
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D vector.
  *
  * @returns γ
  */
-inline double gamma(const Vector3D &v) { return std::acos(z(v) / magn(v)); }
+template <typename T> inline T gamma(const Vector<3, T> &v) {
+  static_assert(std::is_floating_point<T>::value,
+                "Vector type must be floating point");
+  return std::acos(z(v) / detail::magnitude<3, T>(v));
+}
 
 /**
  * @brief Rotates around x-axis.
  *
  * Uses the basic gimbal-like 3D rotation matrices for rotation.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D vector.
  * @param ang The angle to rotate the vector, in radians.
  *
  * @returns A new, rotated vector.
  */
-inline Vector3D rotateAlpha(const Vector3D &v, const double &ang) {
+template <typename T>
+inline BasicVector3D<T>
+rotateAlpha(const Vector<3, T> &v,
+            const typename Vector<3, T>::value_type ang) {
+  static_assert(std::is_floating_point<T>::value,
+                "Vector type must be floating point");
+  SVECTOR_INSTRUMENT_CALL("rotateAlpha", 3, T);
+
   //
   // Rotation matrix:
   //
@@ -370,11 +617,13 @@ inline Vector3D rotateAlpha(const Vector3D &v, const double &ang) {
   // |0  sin(ang)   cos(ang)| |z|
   //
 
-  const double xPrime = x(v);
-  const double yPrime = y(v) * std::cos(ang) - z(v) * std::sin(ang);
-  const double zPrime = y(v) * std::sin(ang) + z(v) * std::cos(ang);
+  const T c = std::cos(ang);
+  const T s = std::sin(ang);
+  const T xPrime = x(v);
+  const T yPrime = y(v) * c - z(v) * s;
+  const T zPrime = y(v) * s + z(v) * c;
 
-  return Vector3D{xPrime, yPrime, zPrime};
+  return BasicVector3D<T>{xPrime, yPrime, zPrime};
 }
 
 /**
@@ -382,12 +631,20 @@ inline Vector3D rotateAlpha(const Vector3D &v, const double &ang) {
  *
  * Uses the basic gimbal-like 3D rotation matrices for rotation.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D vector.
  * @param ang The angle to rotate the vector, in radians.
  *
  * @returns A new, rotated vector.
  */
-inline Vector3D rotateBeta(const Vector3D &v, const double &ang) {
+template <typename T>
+inline BasicVector3D<T>
+rotateBeta(const Vector<3, T> &v, const typename Vector<3, T>::value_type ang) {
+  static_assert(std::is_floating_point<T>::value,
+                "Vector type must be floating point");
+  SVECTOR_INSTRUMENT_CALL("rotateBeta", 3, T);
+
   //
   // Rotation matrix:
   //
@@ -396,11 +653,13 @@ inline Vector3D rotateBeta(const Vector3D &v, const double &ang) {
   // |−sin(ang)  0  cos(ang)| |z|
   //
 
-  const double xPrime = x(v) * std::cos(ang) + z(v) * std::sin(ang);
-  const double yPrime = y(v);
-  const double zPrime = -x(v) * std::sin(ang) + z(v) * std::cos(ang);
+  const T c = std::cos(ang);
+  const T s = std::sin(ang);
+  const T xPrime = x(v) * c + z(v) * s;
+  const T yPrime = y(v);
+  const T zPrime = -x(v) * s + z(v) * c;
 
-  return Vector3D{xPrime, yPrime, zPrime};
+  return BasicVector3D<T>{xPrime, yPrime, zPrime};
 }
 
 /**
@@ -408,12 +667,21 @@ inline Vector3D rotateBeta(const Vector3D &v, const double &ang) {
  *
  * Uses the basic gimbal-like 3D rotation matrices for rotation.
  *
+ * @tparam T Vector type.
+ *
  * @param v A 3D vector.
  * @param ang The angle to rotate the vector, in radians.
  *
  * @returns A new, rotated vector.
  */
-inline Vector3D rotateGamma(const Vector3D &v, const double &ang) {
+template <typename T>
+inline BasicVector3D<T>
+rotateGamma(const Vector<3, T> &v,
+            const typename Vector<3, T>::value_type ang) {
+  static_assert(std::is_floating_point<T>::value,
+                "Vector type must be floating point");
+  SVECTOR_INSTRUMENT_CALL("rotateGamma", 3, T);
+
   //
   // Rotation matrix:
   //
@@ -422,11 +690,1066 @@ inline Vector3D rotateGamma(const Vector3D &v, const double &ang) {
   // |  0         0        1| |z|
   //
 
-  const double xPrime = x(v) * std::cos(ang) - y(v) * std::sin(ang);
-  const double yPrime = x(v) * std::sin(ang) + y(v) * std::cos(ang);
-  const double zPrime = z(v);
+  const T c = std::cos(ang);
+  const T s = std::sin(ang);
+  const T xPrime = x(v) * c - y(v) * s;
+  const T yPrime = x(v) * s + y(v) * c;
+  const T zPrime = z(v);
+
+  return BasicVector3D<T>{xPrime, yPrime, zPrime};
+}
+
+namespace detail {
+/**
+ * @brief Finds the component type of an operation on two views.
+ *
+ * The components of the two views must have the same type, apart from const.
+ */
+template <typename T1, typename T2> struct ViewValue {
+  static_assert(std::is_same<typename std::remove_const<T1>::type,
+                             typename std::remove_const<T2>::type>::value,
+                "Vector types must be the same");
+
+  typedef typename std::remove_const<T1>::type type; //!< The component type.
+};
+} // namespace detail
+
+/**
+ * @brief Creates a vector from a view.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T Vector type.
+ * @param view A view.
+ *
+ * @returns A vector with a copy of the viewed components.
+ */
+template <std::size_t D, typename T>
+Vector<D, typename VectorView<D, T>::value_type>
+makeVector(const VectorView<D, T> view) {
+  return view.toVector();
+}
+
+/**
+ * @brief Gets the x-component of a 2D or 3D view.
+ *
+ * @param v A view.
+ *
+ * @returns x-component of the vector.
+ */
+template <std::size_t D, typename T>
+inline typename VectorView<D, T>::value_type x(const VectorView<D, T> v) {
+  static_assert(D == 2 || D == 3, "x() needs a 2D or 3D view");
+  return v[0];
+}
+
+/**
+ * @brief Sets the x-component of a 2D or 3D view.
+ *
+ * @param v A view.
+ * @param xValue The x-value to set to the vector.
+ */
+template <std::size_t D, typename T>
+inline void x(const VectorView<D, T> v,
+              const typename VectorView<D, T>::value_type xValue) {
+  static_assert(D == 2 || D == 3, "x() needs a 2D or 3D view");
+  v[0] = xValue;
+}
+
+/**
+ * @brief Gets the y-component of a 2D or 3D view.
+ *
+ * @param v A view.
+ *
+ * @returns y-component of the vector.
+ */
+template <std::size_t D, typename T>
+inline typename VectorView<D, T>::value_type y(const VectorView<D, T> v) {
+  static_assert(D == 2 || D == 3, "y() needs a 2D or 3D view");
+  return v[1];
+}
+
+/**
+ * @brief Sets the y-component of a 2D or 3D view.
+ *
+ * @param v A view.
+ * @param yValue The y-value to set to the vector.
+ */
+template <std::size_t D, typename T>
+inline void y(const VectorView<D, T> v,
+              const typename VectorView<D, T>::value_type yValue) {
+  static_assert(D == 2 || D == 3, "y() needs a 2D or 3D view");
+  v[1] = yValue;
+}
+
+/**
+ * @brief Gets the z-component of a 3D view.
+ *
+ * @param v A 3D view.
+ *
+ * @returns z-component of the vector.
+ */
+template <typename T>
+inline typename VectorView<3, T>::value_type z(const VectorView<3, T> v) {
+  return v[2];
+}
+
+/**
+ * @brief Sets the z-component of a 3D view.
+ *
+ * @param v A 3D view.
+ * @param zValue The z-value to set to the vector.
+ */
+template <typename T>
+inline void z(const VectorView<3, T> v,
+              const typename VectorView<3, T>::value_type zValue) {
+  v[2] = zValue;
+}
+
+/**
+ * @brief Calculates the dot product of two views.
+ *
+ * @tparam D The number of dimensions.
+ * @tparam T1 Component type of the first view.
+ * @tparam T2 Component type of the second view.
+ *
+ * @param lhs First view.
+ * @param rhs Second view.
+ *
+ * @returns The dot product of lhs and rhs.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline typename detail::ViewValue<T1, T2>::type
+dot(const VectorView<D, T1> lhs, const VectorView<D, T2> rhs) {
+  typename detail::ViewValue<T1, T2>::type result = 0;
+
+  for (std::size_t i = 0; i < D; i++) {
+    result += lhs[i] * rhs[i];
+  }
+
+  return result;
+}
+
+/**
+ * @brief Calculates the dot product of a vector and a view.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline typename detail::ViewValue<T1, T2>::type
+dot(const Vector<D, T1> &lhs, const VectorView<D, T2> rhs) {
+  return dot(VectorView<D, const T1>(lhs), rhs);
+}
+
+/**
+ * @brief Calculates the dot product of a view and a vector.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline typename detail::ViewValue<T1, T2>::type
+dot(const VectorView<D, T1> lhs, const Vector<D, T2> &rhs) {
+  return dot(lhs, VectorView<D, const T2>(rhs));
+}
+
+/**
+ * @brief Gets the magnitude of a view.
+ *
+ * @param v The view to get magnitude of.
+ *
+ * @returns magnitude of vector.
+ */
+template <std::size_t D, typename T>
+inline typename VectorView<D, T>::value_type magn(const VectorView<D, T> v) {
+  typedef typename VectorView<D, T>::value_type value_type;
+  SVECTOR_INSTRUMENT_CALL("magn", D, value_type);
+  return detail::magnitude<D, value_type>(v);
+}
+
+/**
+ * @brief Normalizes a view.
+ *
+ * @note This method will result in undefined behavior if the vector is a zero
+ * vector (if the magnitude equals zero).
+ *
+ * @param v The view to normalize.
+ *
+ * @returns A new, normalized vector.
+ */
+template <std::size_t D, typename T>
+inline Vector<D, typename VectorView<D, T>::value_type>
+normalize(const VectorView<D, T> v) {
+  typedef typename VectorView<D, T>::value_type value_type;
+  SVECTOR_INSTRUMENT_CALL("normalize", D, value_type);
+
+  const value_type magnitude = detail::magnitude<D, value_type>(v);
+  Vector<D, value_type> tmp;
+  for (std::size_t i = 0; i < D; i++) {
+    tmp[i] = v[i] / magnitude;
+  }
+
+  return tmp;
+}
+
+/**
+ * @brief Determines whether a view is a zero vector.
+ *
+ * @returns Whether the given view is a zero vector.
+ */
+template <std::size_t D, typename T>
+inline bool isZero(const VectorView<D, T> v) {
+  typedef typename VectorView<D, T>::value_type value_type;
+  return detail::magnitude<D, value_type>(v) == 0;
+}
+
+/**
+ * @brief Gets the angle of a 2D view in radians.
+ *
+ * The angle will be in the range (-π, π].
+ *
+ * @param v A 2D view.
+ *
+ * @returns angle of the vector.
+ */
+template <typename T>
+inline typename VectorView<2, T>::value_type angle(const VectorView<2, T> v) {
+  typedef typename VectorView<2, T>::value_type value_type;
+  static_assert(std::is_floating_point<value_type>::value,
+                "Vector type must be floating point");
+
+  return std::atan2(y(v), x(v));
+}
+
+/**
+ * @brief Rotates a 2D view by a certain angle.
+ *
+ * @param v A 2D view.
+ * @param ang the angle to rotate the vector, in radians.
+ *
+ * @returns a new, rotated vector.
+ */
+template <typename T>
+inline BasicVector2D<typename VectorView<2, T>::value_type>
+rotate(const VectorView<2, T> v, const double ang) {
+  typedef typename VectorView<2, T>::value_type value_type;
+  static_assert(std::is_floating_point<value_type>::value,
+                "Vector type must be floating point");
+  SVECTOR_INSTRUMENT_CALL("rotate", 2, value_type);
+
+  const double cosAng = std::cos(ang);
+  const double sinAng = std::sin(ang);
 
-  return Vector3D{xPrime, yPrime, zPrime};
+  return BasicVector2D<value_type>{
+      static_cast<value_type>(x(v) * cosAng - y(v) * sinAng),
+      static_cast<value_type>(x(v) * sinAng + y(v) * cosAng)};
+}
+
+/**
+ * @brief Cross product of two 3D views.
+ *
+ * @param lhs The first view.
+ * @param rhs The second view, crossed with the first view.
+ *
+ * @returns The cross product of the two vectors.
+ */
+template <typename T1, typename T2>
+inline BasicVector3D<typename detail::ViewValue<T1, T2>::type>
+cross(const VectorView<3, T1> lhs, const VectorView<3, T2> rhs) {
+  typedef typename detail::ViewValue<T1, T2>::type value_type;
+  SVECTOR_INSTRUMENT_CALL("cross", 3, value_type);
+
+  return BasicVector3D<value_type>{y(lhs) * z(rhs) - z(lhs) * y(rhs),
+                                   z(lhs) * x(rhs) - x(lhs) * z(rhs),
+                                   x(lhs) * y(rhs) - y(lhs) * x(rhs)};
+}
+
+/**
+ * @brief Cross product of a vector and a view.
+ */
+template <typename T1, typename T2>
+inline BasicVector3D<typename detail::ViewValue<T1, T2>::type>
+cross(const Vector<3, T1> &lhs, const VectorView<3, T2> rhs) {
+  return cross(VectorView<3, const T1>(lhs), rhs);
+}
+
+/**
+ * @brief Cross product of a view and a vector.
+ */
+template <typename T1, typename T2>
+inline BasicVector3D<typename detail::ViewValue<T1, T2>::type>
+cross(const VectorView<3, T1> lhs, const Vector<3, T2> &rhs) {
+  return cross(lhs, VectorView<3, const T2>(rhs));
+}
+
+/**
+ * @brief Gets α angle of a 3D view.
+ *
+ * @note This method will result in undefined behavior if the vector is a zero
+ * vector (if the magnitude equals zero).
+ *
+ * @param v A 3D view.
+ *
+ * @returns α
+ */
+template <typename T>
+inline typename VectorView<3, T>::value_type alpha(const VectorView<3, T> v) {
+  typedef typename VectorView<3, T>::value_type value_type;
+  static_assert(std::is_floating_point<value_type>::value,
+                "Vector type must be floating point");
+  return std::acos(x(v) / detail::magnitude<3, value_type>(v));
+}
+
+/**
+ * @brief Gets β angle of a 3D view.
+ *
+ * @note This method will result in undefined behavior if the vector is a zero
+ * vector (if the magnitude equals zero).
+ *
+ * @param v A 3D view.
+ *
+ * @returns β
+ */
+template <typename T>
+inline typename VectorView<3, T>::value_type beta(const VectorView<3, T> v) {
+  typedef typename VectorView<3, T>::value_type value_type;
+  static_assert(std::is_floating_point<value_type>::value,
+                "Vector type must be floating point");
+  return std::acos(y(v) / detail::magnitude<3, value_type>(v));
+}
+
+/**
+ * @brief Gets γ angle of a 3D view.
+ *
+ * @note This method will result in undefined behavior if the vector is a zero
+ * vector (if the magnitude equals zero).
+ *
+ * @param v A 3D view.
+ *
+ * @returns γ
+ */
+template <typename T>
+inline typename VectorView<3, T>::value_type gamma(const VectorView<3, T> v) {
+  typedef typename VectorView<3, T>::value_type value_type;
+  static_assert(std::is_floating_point<value_type>::value,
+                "Vector type must be floating point");
+  return std::acos(z(v) / detail::magnitude<3, value_type>(v));
+}
+
+/**
+ * @brief Rotates a 3D view around the x-axis.
+ *
+ * @param v A 3D view.
+ * @param ang The angle to rotate the vector, in radians.
+ *
+ * @returns A new, rotated vector.
+ */
+template <typename T>
+inline BasicVector3D<typename VectorView<3, T>::value_type>
+rotateAlpha(const VectorView<3, T> v, const double &ang) {
+  typedef typename VectorView<3, T>::value_type value_type;
+  static_assert(std::is_floating_point<value_type>::value,
+                "Vector type must be floating point");
+  SVECTOR_INSTRUMENT_CALL("rotateAlpha", 3, value_type);
+
+  const double cosAng = std::cos(ang);
+  const double sinAng = std::sin(ang);
+
+  return BasicVector3D<value_type>{
+      x(v), static_cast<value_type>(y(v) * cosAng - z(v) * sinAng),
+      static_cast<value_type>(y(v) * sinAng + z(v) * cosAng)};
+}
+
+/**
+ * @brief Rotates a 3D view around the y-axis.
+ *
+ * @param v A 3D view.
+ * @param ang The angle to rotate the vector, in radians.
+ *
+ * @returns A new, rotated vector.
+ */
+template <typename T>
+inline BasicVector3D<typename VectorView<3, T>::value_type>
+rotateBeta(const VectorView<3, T> v, const double &ang) {
+  typedef typename VectorView<3, T>::value_type value_type;
+  static_assert(std::is_floating_point<value_type>::value,
+                "Vector type must be floating point");
+  SVECTOR_INSTRUMENT_CALL("rotateBeta", 3, value_type);
+
+  const double cosAng = std::cos(ang);
+  const double sinAng = std::sin(ang);
+
+  return BasicVector3D<value_type>{
+      static_cast<value_type>(x(v) * cosAng + z(v) * sinAng), y(v),
+      static_cast<value_type>(-x(v) * sinAng + z(v) * cosAng)};
+}
+
+/**
+ * @brief Rotates a 3D view around the z-axis.
+ *
+ * @param v A 3D view.
+ * @param ang The angle to rotate the vector, in radians.
+ *
+ * @returns A new, rotated vector.
+ */
+template <typename T>
+inline BasicVector3D<typename VectorView<3, T>::value_type>
+rotateGamma(const VectorView<3, T> v, const double &ang) {
+  typedef typename VectorView<3, T>::value_type value_type;
+  static_assert(std::is_floating_point<value_type>::value,
+                "Vector type must be floating point");
+  SVECTOR_INSTRUMENT_CALL("rotateGamma", 3, value_type);
+
+  const double cosAng = std::cos(ang);
+  const double sinAng = std::sin(ang);
+
+  return BasicVector3D<value_type>{
+      static_cast<value_type>(x(v) * cosAng - y(v) * sinAng),
+      static_cast<value_type>(x(v) * sinAng + y(v) * cosAng), z(v)};
+}
+
+/**
+ * @brief Adds two views.
+ *
+ * @param lhs The first view.
+ * @param rhs The second view.
+ *
+ * @returns A new vector representing the vector sum.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline Vector<D, typename detail::ViewValue<T1, T2>::type>
+operator+(const VectorView<D, T1> lhs, const VectorView<D, T2> rhs) {
+  Vector<D, typename detail::ViewValue<T1, T2>::type> tmp;
+  for (std::size_t i = 0; i < D; i++) {
+    tmp[i] = lhs[i] + rhs[i];
+  }
+
+  return tmp;
+}
+
+/**
+ * @brief Adds a vector and a view.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline Vector<D, typename detail::ViewValue<T1, T2>::type>
+operator+(const Vector<D, T1> &lhs, const VectorView<D, T2> rhs) {
+  return VectorView<D, const T1>(lhs) + rhs;
+}
+
+/**
+ * @brief Adds a view and a vector.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline Vector<D, typename detail::ViewValue<T1, T2>::type>
+operator+(const VectorView<D, T1> lhs, const Vector<D, T2> &rhs) {
+  return lhs + VectorView<D, const T2>(rhs);
+}
+
+/**
+ * @brief Subtracts two views.
+ *
+ * @param lhs The first view.
+ * @param rhs The second view.
+ *
+ * @returns A new vector representing the vector difference.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline Vector<D, typename detail::ViewValue<T1, T2>::type>
+operator-(const VectorView<D, T1> lhs, const VectorView<D, T2> rhs) {
+  Vector<D, typename detail::ViewValue<T1, T2>::type> tmp;
+  for (std::size_t i = 0; i < D; i++) {
+    tmp[i] = lhs[i] - rhs[i];
+  }
+
+  return tmp;
+}
+
+/**
+ * @brief Subtracts a view from a vector.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline Vector<D, typename detail::ViewValue<T1, T2>::type>
+operator-(const Vector<D, T1> &lhs, const VectorView<D, T2> rhs) {
+  return VectorView<D, const T1>(lhs) - rhs;
+}
+
+/**
+ * @brief Subtracts a vector from a view.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline Vector<D, typename detail::ViewValue<T1, T2>::type>
+operator-(const VectorView<D, T1> lhs, const Vector<D, T2> &rhs) {
+  return lhs - VectorView<D, const T2>(rhs);
+}
+
+/**
+ * @brief Multiplies a view by a scalar.
+ *
+ * @param lhs The view.
+ * @param rhs The scalar.
+ *
+ * @returns A new vector representing the scalar product.
+ */
+template <std::size_t D, typename T, typename T2>
+inline Vector<D, typename VectorView<D, T>::value_type>
+operator*(const VectorView<D, T> lhs, const T2 rhs) {
+  Vector<D, typename VectorView<D, T>::value_type> tmp;
+  for (std::size_t i = 0; i < D; i++) {
+    tmp[i] = lhs[i] * rhs;
+  }
+
+  return tmp;
+}
+
+/**
+ * @brief Divides a view by a scalar.
+ *
+ * @param lhs The view.
+ * @param rhs The scalar.
+ *
+ * @returns A new vector representing the scalar quotient.
+ */
+template <std::size_t D, typename T, typename T2>
+inline Vector<D, typename VectorView<D, T>::value_type>
+operator/(const VectorView<D, T> lhs, const T2 rhs) {
+  Vector<D, typename VectorView<D, T>::value_type> tmp;
+  for (std::size_t i = 0; i < D; i++) {
+    tmp[i] = lhs[i] / rhs;
+  }
+
+  return tmp;
+}
+
+/**
+ * @brief Compares equality of two views.
+ *
+ * The components are compared, not the memory they are stored in.
+ *
+ * @param lhs The first view.
+ * @param rhs The second view.
+ *
+ * @returns A boolean representing whether the two vectors compare equal.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline bool operator==(const VectorView<D, T1> lhs,
+                       const VectorView<D, T2> rhs) {
+  static_assert(std::is_same<typename std::remove_const<T1>::type,
+                             typename std::remove_const<T2>::type>::value,
+                "Vector types must be the same");
+
+  for (std::size_t i = 0; i < D; i++) {
+    if (lhs[i] != rhs[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Compares equality of a vector and a view.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline bool operator==(const Vector<D, T1> &lhs, const VectorView<D, T2> rhs) {
+  return VectorView<D, const T1>(lhs) == rhs;
+}
+
+/**
+ * @brief Compares equality of a view and a vector.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline bool operator==(const VectorView<D, T1> lhs, const Vector<D, T2> &rhs) {
+  return lhs == VectorView<D, const T2>(rhs);
+}
+
+/**
+ * @brief Compares inequality of two views.
+ *
+ * @param lhs The first view.
+ * @param rhs The second view.
+ *
+ * @returns A boolean representing whether the two vectors do not compare equal.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline bool operator!=(const VectorView<D, T1> lhs,
+                       const VectorView<D, T2> rhs) {
+  return !(lhs == rhs);
+}
+
+/**
+ * @brief Compares inequality of a vector and a view.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline bool operator!=(const Vector<D, T1> &lhs, const VectorView<D, T2> rhs) {
+  return !(lhs == rhs);
+}
+
+/**
+ * @brief Compares inequality of a view and a vector.
+ */
+template <std::size_t D, typename T1, typename T2>
+inline bool operator!=(const VectorView<D, T1> lhs, const Vector<D, T2> &rhs) {
+  return !(lhs == rhs);
+}
+
+/**
+ * @brief Calculates the dot product of two runtime-sized vectors.
+ *
+ * Throws an invalid_argument exception if the sizes differ.
+ *
+ * @param lhs First vector.
+ * @param rhs Second vector.
+ *
+ * @returns The dot product of lhs and rhs.
+ */
+template <typename T, std::size_t N>
+inline T dot(const DynVector<T, N> &lhs, const DynVector<T, N> &rhs) {
+  return lhs.dot(rhs);
+}
+
+/**
+ * @brief Gets the magnitude of a runtime-sized vector.
+ *
+ * @param v The vector to get magnitude of.
+ *
+ * @returns magnitude of vector.
+ */
+template <typename T, std::size_t N> inline T magn(const DynVector<T, N> &v) {
+  return v.magn();
+}
+
+/**
+ * @brief Calculates the dot product of two runtime-sized vectors with an
+ * accumulation policy.
+ *
+ * Throws an invalid_argument exception if the sizes differ.
+ *
+ * @param lhs First vector.
+ * @param rhs Second vector.
+ * @param policy The accumulation policy tag.
+ *
+ * @returns The dot product of lhs and rhs.
+ */
+template <typename T, std::size_t N, typename Policy>
+inline T dot(const DynVector<T, N> &lhs, const DynVector<T, N> &rhs,
+             const Policy policy) {
+  if (lhs.size() != rhs.size()) {
+    throw std::invalid_argument("DynVector sizes do not match");
+  }
+
+  return accumulate::dot(lhs.data(), rhs.data(), lhs.size(), policy);
+}
+
+/**
+ * @brief Gets the magnitude of a runtime-sized vector with an accumulation
+ * policy.
+ *
+ * @param v The vector to get magnitude of.
+ * @param policy The accumulation policy tag.
+ *
+ * @returns magnitude of vector.
+ */
+template <typename T, std::size_t N, typename Policy>
+inline T magn(const DynVector<T, N> &v, const Policy policy) {
+  SVECTOR_INSTRUMENT_CALL("magn", 0, T);
+
+  return std::sqrt(accumulate::dot(v.data(), v.data(), v.size(), policy));
+}
+
+/**
+ * @brief Normalizes a runtime-sized vector.
+ *
+ * @note This method will result in undefined behavior if the vector is a zero
+ * vector (if the magnitude equals zero).
+ *
+ * @param v The vector to normalize.
+ *
+ * @returns Normalized vector.
+ */
+template <typename T, std::size_t N>
+inline DynVector<T, N> normalize(const DynVector<T, N> &v) {
+  return v.normalize();
+}
+
+/**
+ * @brief Determines whether a runtime-sized vector is a zero vector.
+ *
+ * @returns Whether the given vector is a zero vector.
+ */
+template <typename T, std::size_t N>
+inline bool isZero(const DynVector<T, N> &v) {
+  return v.isZero();
+}
+
+/**
+ * @brief Adds two runtime-sized vectors.
+ *
+ * Throws an invalid_argument exception if the sizes differ.
+ *
+ * @param lhs The first vector.
+ * @param rhs The second vector.
+ *
+ * @returns A new vector representing the vector sum.
+ */
+template <typename T, std::size_t N>
+inline DynVector<T, N> operator+(const DynVector<T, N> &lhs,
+                                 const DynVector<T, N> &rhs) {
+  DynVector<T, N> tmp(lhs);
+  tmp += rhs;
+  return tmp;
+}
+
+/**
+ * @brief Adds two runtime-sized vectors, reusing the buffer of the first.
+ *
+ * This avoids a heap allocation for each intermediate result of a chain
+ * like `a + b + c`.
+ */
+template <typename T, std::size_t N>
+inline DynVector<T, N> operator+(DynVector<T, N> &&lhs,
+                                 const DynVector<T, N> &rhs) {
+  lhs += rhs;
+  return std::move(lhs);
+}
+
+/**
+ * @brief Subtracts two runtime-sized vectors.
+ *
+ * Throws an invalid_argument exception if the sizes differ.
+ *
+ * @param lhs The first vector.
+ * @param rhs The second vector.
+ *
+ * @returns A new vector representing the vector difference.
+ */
+template <typename T, std::size_t N>
+inline DynVector<T, N> operator-(const DynVector<T, N> &lhs,
+                                 const DynVector<T, N> &rhs) {
+  DynVector<T, N> tmp(lhs);
+  tmp -= rhs;
+  return tmp;
+}
+
+/**
+ * @brief Subtracts two runtime-sized vectors, reusing the buffer of the
+ * first.
+ */
+template <typename T, std::size_t N>
+inline DynVector<T, N> operator-(DynVector<T, N> &&lhs,
+                                 const DynVector<T, N> &rhs) {
+  lhs -= rhs;
+  return std::move(lhs);
+}
+
+/**
+ * @brief Multiplies a runtime-sized vector by a scalar.
+ *
+ * @param lhs The vector.
+ * @param rhs The scalar.
+ *
+ * @returns A new vector representing the scalar product.
+ */
+template <typename T, typename T2, std::size_t N>
+inline DynVector<T, N> operator*(DynVector<T, N> lhs, const T2 rhs) {
+  lhs *= static_cast<T>(rhs);
+  return lhs;
+}
+
+/**
+ * @brief Divides a runtime-sized vector by a scalar.
+ *
+ * @param lhs The vector.
+ * @param rhs The scalar.
+ *
+ * @returns A new vector representing the scalar quotient.
+ */
+template <typename T, typename T2, std::size_t N>
+inline DynVector<T, N> operator/(DynVector<T, N> lhs, const T2 rhs) {
+  lhs /= static_cast<T>(rhs);
+  return lhs;
+}
+
+/**
+ * @brief Compares equality of two runtime-sized vectors.
+ *
+ * Vectors with different sizes are not equal.
+ *
+ * @param lhs The first vector.
+ * @param rhs The second vector.
+ *
+ * @returns A boolean representing whether the two vectors compare equal.
+ */
+template <typename T, std::size_t N>
+inline bool operator==(const DynVector<T, N> &lhs, const DynVector<T, N> &rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+
+  for (std::size_t i = 0; i < lhs.size(); i++) {
+    if (lhs[i] != rhs[i]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Compares inequality of two runtime-sized vectors.
+ *
+ * @param lhs The first vector.
+ * @param rhs The second vector.
+ *
+ * @returns A boolean representing whether the two vectors do not compare equal.
+ */
+template <typename T, std::size_t N>
+inline bool operator!=(const DynVector<T, N> &lhs, const DynVector<T, N> &rhs) {
+  return !(lhs == rhs);
+}
+
+/**
+ * @brief Calculates the dot product of two sparse vectors.
+ *
+ * Throws an invalid_argument exception if the numbers of dimensions differ.
+ *
+ * @param lhs First vector.
+ * @param rhs Second vector.
+ *
+ * @returns The dot product of lhs and rhs.
+ */
+template <typename T>
+inline T dot(const SparseVector<T> &lhs, const SparseVector<T> &rhs) {
+  return lhs.dot(rhs);
+}
+
+/**
+ * @brief Calculates the dot product of a sparse and a dense vector.
+ *
+ * Throws an invalid_argument exception if the numbers of dimensions differ.
+ *
+ * @param lhs The sparse vector.
+ * @param rhs The dense vector.
+ *
+ * @returns The dot product of lhs and rhs.
+ */
+template <typename T, std::size_t D>
+inline T dot(const SparseVector<T> &lhs, const Vector<D, T> &rhs) {
+  return lhs.dot(rhs);
+}
+
+/**
+ * @brief Calculates the dot product of a dense and a sparse vector.
+ *
+ * Throws an invalid_argument exception if the numbers of dimensions differ.
+ *
+ * @param lhs The dense vector.
+ * @param rhs The sparse vector.
+ *
+ * @returns The dot product of lhs and rhs.
+ */
+template <typename T, std::size_t D>
+inline T dot(const Vector<D, T> &lhs, const SparseVector<T> &rhs) {
+  return rhs.dot(lhs);
+}
+
+/**
+ * @brief Gets the magnitude of a sparse vector.
+ *
+ * @param v The vector to get magnitude of.
+ *
+ * @returns magnitude of vector.
+ */
+template <typename T> inline T magn(const SparseVector<T> &v) {
+  return v.magn();
+}
+
+/**
+ * @brief Normalizes a sparse vector.
+ *
+ * @note This method will result in undefined behavior if the vector is a zero
+ * vector (if the magnitude equals zero).
+ *
+ * @param v The vector to normalize.
+ *
+ * @returns Normalized vector.
+ */
+template <typename T>
+inline SparseVector<T> normalize(const SparseVector<T> &v) {
+  return v.normalize();
+}
+
+/**
+ * @brief Determines whether a sparse vector is a zero vector.
+ *
+ * @returns Whether the given vector is a zero vector.
+ */
+template <typename T> inline bool isZero(const SparseVector<T> &v) {
+  return v.isZero();
+}
+
+namespace detail {
+/**
+ * @brief Adds or subtracts two sparse vectors by merging their indices.
+ *
+ * Components that cancel out stay stored as 0.
+ */
+template <bool Subtract, typename T>
+SparseVector<T> mergeSparse(const SparseVector<T> &lhs,
+                            const SparseVector<T> &rhs) {
+  if (lhs.size() != rhs.size()) {
+    throw std::invalid_argument("SparseVector sizes do not match");
+  }
+
+  const std::vector<typename SparseVector<T>::index_type> &left =
+      lhs.indices();
+  const std::vector<typename SparseVector<T>::index_type> &right =
+      rhs.indices();
+
+  SparseVector<T> tmp(lhs.size());
+  tmp.reserve(left.size() + right.size());
+
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < left.size() || j < right.size()) {
+    if (j == right.size() || (i < left.size() && left[i] < right[j])) {
+      tmp.append(left[i], lhs.values()[i]);
+      i++;
+    } else if (i == left.size() || right[j] < left[i]) {
+      tmp.append(right[j], Subtract ? -rhs.values()[j] : rhs.values()[j]);
+      j++;
+    } else {
+      tmp.append(left[i], Subtract ? lhs.values()[i] - rhs.values()[j]
+                                   : lhs.values()[i] + rhs.values()[j]);
+      i++;
+      j++;
+    }
+  }
+
+  return tmp;
+}
+} // namespace detail
+
+/**
+ * @brief Adds two sparse vectors.
+ *
+ * The sum stores every index stored in either vector. Throws an
+ * invalid_argument exception if the numbers of dimensions differ.
+ *
+ * @param lhs The first vector.
+ * @param rhs The second vector.
+ *
+ * @returns A new vector representing the vector sum.
+ */
+template <typename T>
+inline SparseVector<T> operator+(const SparseVector<T> &lhs,
+                                 const SparseVector<T> &rhs) {
+  return detail::mergeSparse<false>(lhs, rhs);
+}
+
+/**
+ * @brief Subtracts two sparse vectors.
+ *
+ * The difference stores every index stored in either vector. Throws an
+ * invalid_argument exception if the numbers of dimensions differ.
+ *
+ * @param lhs The first vector.
+ * @param rhs The second vector.
+ *
+ * @returns A new vector representing the vector difference.
+ */
+template <typename T>
+inline SparseVector<T> operator-(const SparseVector<T> &lhs,
+                                 const SparseVector<T> &rhs) {
+  return detail::mergeSparse<true>(lhs, rhs);
+}
+
+/**
+ * @brief Adds a sparse vector to a dense vector.
+ *
+ * Throws an invalid_argument exception if the numbers of dimensions differ.
+ *
+ * @param lhs The dense vector.
+ * @param rhs The sparse vector.
+ *
+ * @returns A new dense vector representing the vector sum.
+ */
+template <typename T, std::size_t D>
+inline Vector<D, T> operator+(const Vector<D, T> &lhs,
+                              const SparseVector<T> &rhs) {
+  if (rhs.size() != D) {
+    throw std::invalid_argument("SparseVector sizes do not match");
+  }
+
+  Vector<D, T> tmp(lhs);
+  for (std::size_t i = 0; i < rhs.nonZeros(); i++) {
+    tmp[rhs.indices()[i]] += rhs.values()[i];
+  }
+
+  return tmp;
+}
+
+/**
+ * @brief Multiplies a sparse vector by a scalar.
+ *
+ * @param lhs The vector.
+ * @param rhs The scalar.
+ *
+ * @returns A new vector representing the scalar product.
+ */
+template <typename T, typename T2>
+inline SparseVector<T> operator*(SparseVector<T> lhs, const T2 rhs) {
+  lhs *= static_cast<T>(rhs);
+  return lhs;
+}
+
+/**
+ * @brief Divides a sparse vector by a scalar.
+ *
+ * @param lhs The vector.
+ * @param rhs The scalar.
+ *
+ * @returns A new vector representing the scalar quotient.
+ */
+template <typename T, typename T2>
+inline SparseVector<T> operator/(SparseVector<T> lhs, const T2 rhs) {
+  lhs /= static_cast<T>(rhs);
+  return lhs;
+}
+
+/**
+ * @brief Compares equality of two sparse vectors.
+ *
+ * The components are compared, so a stored 0 equals a component that is
+ * not stored.
+ *
+ * @param lhs The first vector.
+ * @param rhs The second vector.
+ *
+ * @returns A boolean representing whether the two vectors compare equal.
+ */
+template <typename T>
+inline bool operator==(const SparseVector<T> &lhs,
+                       const SparseVector<T> &rhs) {
+  if (lhs.size() != rhs.size()) {
+    return false;
+  }
+
+  const SparseVector<T> difference = lhs - rhs;
+  for (const auto &value : difference.values()) {
+    if (value != 0) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+/**
+ * @brief Compares inequality of two sparse vectors.
+ *
+ * @param lhs The first vector.
+ * @param rhs The second vector.
+ *
+ * @returns A boolean representing whether the two vectors do not compare equal.
+ */
+template <typename T>
+inline bool operator!=(const SparseVector<T> &lhs,
+                       const SparseVector<T> &rhs) {
+  return !(lhs == rhs);
 }
 
 #ifndef SVECTOR_USE_CLASS_OPERATORS
@@ -10,10 +10,29 @@
 #ifndef INCLUDE_SVECTOR_VECTOR_HPP_
 #define INCLUDE_SVECTOR_VECTOR_HPP_
 
+#include "simplevectors/core/accumulate.hpp"
+#include "simplevectors/core/alloc.hpp"
+#include "simplevectors/core/dynvector.hpp"
+#include "simplevectors/core/generator.hpp"
+#include "simplevectors/core/half.hpp"
+#include "simplevectors/core/instrument.hpp"
+#include "simplevectors/core/matrix.hpp"
+#include "simplevectors/core/octahedral.hpp"
+#include "simplevectors/core/pipeline.hpp"
+#include "simplevectors/core/quantize.hpp"
+#include "simplevectors/core/queue.hpp"
+#include "simplevectors/core/reduce.hpp"
+#include "simplevectors/core/rotation.hpp"
+#include "simplevectors/core/scatter.hpp"
+#include "simplevectors/core/simd.hpp"
+#include "simplevectors/core/sparse.hpp"
+#include "simplevectors/core/trace.hpp"
+#include "simplevectors/core/trajectory.hpp"
 #include "simplevectors/core/units.hpp"
 #include "simplevectors/core/vector.hpp"
 #include "simplevectors/core/vector2d.hpp"
 #include "simplevectors/core/vector3d.hpp"
+#include "simplevectors/core/view.hpp"
 #include "simplevectors/functions.hpp"
 
 #endif
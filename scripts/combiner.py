@@ -47,14 +47,57 @@ FILE_BEGIN = """/**
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
+#if defined(SVECTOR_INSTRUMENT) || defined(SVECTOR_TRACE)
+#include <chrono>
+#include <mutex>
+#endif
+
+#if !defined(SVECTOR_NO_SIMD) && defined(__AVX__)
+#define SVECTOR_SIMD_AVX
+#include <immintrin.h>
+#elif !defined(SVECTOR_NO_SIMD) && \\
+    (defined(__SSE2__) || defined(_M_X64) || \\
+     (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SVECTOR_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(SVECTOR_SIMD_AVX) && defined(__F16C__)
+#define SVECTOR_SIMD_F16C
+#endif
+
+#if defined(__has_include)
+#if __has_include(<coroutine>) && defined(__cpp_impl_coroutine) && \\
+    (__cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L))
+#define SVECTOR_HAS_COROUTINES
+#endif
+#endif
+
+#ifdef SVECTOR_HAS_COROUTINES
+#include <coroutine>
+#include <istream>
+#include <iterator>
+#include <span>
+#endif
+
 namespace svector {
 """
 
@@ -81,6 +124,11 @@ def combine():
     # get final output file
     output_str = (
         FILE_BEGIN
+        + get_sandwiched(os.path.join("include", "simplevectors", "core", "trace.hpp"))
+        + get_sandwiched(os.path.join("include", "simplevectors", "core", "alloc.hpp"))
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "instrument.hpp")
+        )
         + get_sandwiched(os.path.join("include", "simplevectors", "core", "units.hpp"))
         + get_sandwiched(os.path.join("include", "simplevectors", "core", "vector.hpp"))
         + get_sandwiched(
@@ -89,6 +137,40 @@ def combine():
         + get_sandwiched(
             os.path.join("include", "simplevectors", "core", "vector3d.hpp")
         )
+        + get_sandwiched(os.path.join("include", "simplevectors", "core", "view.hpp"))
+        + get_sandwiched(os.path.join("include", "simplevectors", "core", "simd.hpp"))
+        + get_sandwiched(os.path.join("include", "simplevectors", "core", "matrix.hpp"))
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "rotation.hpp")
+        )
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "dynvector.hpp")
+        )
+        + get_sandwiched(os.path.join("include", "simplevectors", "core", "sparse.hpp"))
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "accumulate.hpp")
+        )
+        + get_sandwiched(os.path.join("include", "simplevectors", "core", "half.hpp"))
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "quantize.hpp")
+        )
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "trajectory.hpp")
+        )
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "octahedral.hpp")
+        )
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "pipeline.hpp")
+        )
+        + get_sandwiched(os.path.join("include", "simplevectors", "core", "queue.hpp"))
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "scatter.hpp")
+        )
+        + get_sandwiched(os.path.join("include", "simplevectors", "core", "reduce.hpp"))
+        + get_sandwiched(
+            os.path.join("include", "simplevectors", "core", "generator.hpp")
+        )
         + get_sandwiched(os.path.join("include", "simplevectors", "functions.hpp"))
         + FILE_END
     )
@@ -0,0 +1,17 @@
+/**
+ * This file is solely for clang-tidy to analyze the simplevectors library.
+ *
+ * It assumes usage of instrumentation with timing, tracing, and allocation
+ * tracking in the non-embeddable library.
+ */
+
+#define SVECTOR_INSTRUMENT
+#define SVECTOR_INSTRUMENT_TIMING
+#define SVECTOR_TRACE
+#define SVECTOR_TRACK_ALLOCS
+
+#include "simplevectors/vectors.hpp"
+
+SVECTOR_DEFINE_ALLOC_HOOKS
+
+int main() { return 0; }
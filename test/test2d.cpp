@@ -360,3 +360,22 @@ TEST(RotationTest2D, ClockwiseRotation) {
               std::round(rotated.y() * 1000) / 1000);
   }
 }
+
+TEST(FloatTest2D, Vector2f) {
+  static_assert(sizeof(svector::Vector2f) < sizeof(svector::Vector2D),
+                "Vector2f should store floats");
+
+  svector::Vector2f vector(3, 4);
+  vector.x(0);
+  EXPECT_EQ(vector.x(), 0.0F);
+  EXPECT_FLOAT_EQ(vector.magn(), 4);
+  EXPECT_FLOAT_EQ(vector.angle(), static_cast<float>(M_PI / 2));
+
+  const svector::Vector2f rotated = vector.rotate(static_cast<float>(M_PI / 2));
+  EXPECT_NEAR(rotated.x(), -4, 1e-5);
+  EXPECT_NEAR(rotated.y(), 0, 1e-5);
+
+  // the sum is a Vector<2, float>, which converts back
+  const svector::Vector2f sum = vector + rotated;
+  EXPECT_NEAR(sum.x(), -4, 1e-5);
+}
@@ -433,3 +433,16 @@ TEST(RotationTest3D, GammaRotation) {
               std::round(rotated.z() * 1000) / 1000);
   }
 }
+
+TEST(FloatTest3D, Vector3f) {
+  const svector::Vector3f lhs(2, 3, 5);
+  const svector::Vector3f rhs(1, 2, 3);
+  EXPECT_EQ(lhs.cross(rhs), svector::Vector3f(-1, -1, 1));
+  EXPECT_FLOAT_EQ(lhs.angle<svector::GAMMA>(),
+                  static_cast<float>(std::acos(5 / std::sqrt(38.0))));
+
+  const svector::Vector3f rotated =
+      rhs.rotate<svector::ALPHA>(static_cast<float>(M_PI));
+  EXPECT_NEAR(rotated.y(), -2, 1e-5);
+  EXPECT_NEAR(rotated.z(), -3, 1e-5);
+}
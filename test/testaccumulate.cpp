@@ -0,0 +1,108 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(AccumulateTest, PoliciesAgreeOnExactSums) {
+  // 37 components, so that the leftover components are used too
+  svector::Vector<37> lhs;
+  svector::Vector<37> rhs;
+  double expected = 0;
+  for (std::size_t i = 0; i < 37; i++) {
+    lhs[i] = static_cast<double>(i);
+    rhs[i] = 2;
+    expected += lhs[i] * rhs[i];
+  }
+
+  EXPECT_EQ(svector::dot(lhs, rhs, svector::Naive()), expected);
+  EXPECT_EQ(svector::dot(lhs, rhs, svector::MultiAccumulator<>()), expected);
+  EXPECT_EQ(svector::dot(lhs, rhs, svector::MultiAccumulator<2>()), expected);
+  EXPECT_EQ(svector::dot(lhs, rhs, svector::Pairwise()), expected);
+  EXPECT_EQ(svector::dot(lhs, rhs, svector::Widened()), expected);
+  EXPECT_EQ(svector::dot(lhs, rhs, svector::Kahan()), expected);
+  EXPECT_EQ(svector::dot(lhs, rhs, svector::Neumaier()), expected);
+  EXPECT_EQ(svector::dot(lhs, rhs, svector::Reproducible()), expected);
+
+  EXPECT_DOUBLE_EQ(svector::magn(rhs, svector::Kahan()), std::sqrt(4.0 * 37));
+}
+
+TEST(AccumulateTest, CompensatedSumsAreAccurate) {
+  // 1 + many values below half an ulp of 1, which plain float addition drops
+  const std::size_t size = 10001;
+  svector::DynVector<float> values(size, 1e-8F);
+  svector::DynVector<float> ones(size, 1);
+  values[0] = 1;
+
+  const float expected = 1.0001F;
+  EXPECT_EQ(svector::dot(values, ones, svector::Naive()), 1);
+  EXPECT_FLOAT_EQ(svector::dot(values, ones, svector::Pairwise()), expected);
+  EXPECT_FLOAT_EQ(svector::dot(values, ones, svector::Widened()), expected);
+  EXPECT_FLOAT_EQ(svector::dot(values, ones, svector::Kahan()), expected);
+  EXPECT_FLOAT_EQ(svector::dot(values, ones, svector::Neumaier()), expected);
+  EXPECT_FLOAT_EQ(svector::dot(values, ones, svector::Reproducible()),
+                  expected);
+
+  // a term larger than the running sum, which Kahan summation loses
+  const double big[] = {1, 1e100, 1, -1e100};
+  const double unit[] = {1, 1, 1, 1};
+  EXPECT_EQ(svector::accumulate::dot(big, unit, 4, svector::Neumaier()), 2);
+  EXPECT_EQ(svector::accumulate::dot(big, unit, 4, svector::Reproducible()),
+            0);
+}
+
+TEST(AccumulateTest, ReproducibleIgnoresOrder) {
+  // values of very different sizes, whose plain sum changes with the order
+  const std::size_t size = 1000;
+  std::vector<double> values(size);
+  for (std::size_t i = 0; i < size; i++) {
+    values[i] = std::sin(static_cast<double>(i)) *
+                std::pow(10.0, static_cast<double>(i % 13) - 6);
+  }
+  const std::vector<double> ones(size, 1);
+  const double forward = svector::accumulate::dot(
+      values.data(), ones.data(), size, svector::Reproducible());
+
+  std::vector<double> reversed(values.rbegin(), values.rend());
+  EXPECT_EQ(svector::accumulate::dot(reversed.data(), ones.data(), size,
+                                     svector::Reproducible()),
+            forward);
+  EXPECT_NE(svector::accumulate::dot(reversed.data(), ones.data(), size,
+                                     svector::Naive()),
+            svector::accumulate::dot(values.data(), ones.data(), size,
+                                     svector::Naive()));
+  EXPECT_NEAR(forward,
+              svector::accumulate::dot(values.data(), ones.data(), size,
+                                       svector::Neumaier()),
+              1e-15 * std::abs(forward));
+
+  // non-finite products pass through, and sums that may overflow throw
+  values[3] = INFINITY;
+  EXPECT_EQ(svector::accumulate::dot(values.data(), ones.data(), size,
+                                     svector::Reproducible()),
+            INFINITY);
+  values[3] = 1e308;
+  EXPECT_THROW(svector::accumulate::dot(values.data(), ones.data(), size,
+                                        svector::Reproducible()),
+               std::overflow_error);
+}
+
+TEST(AccumulateTest, IntegerComponents) {
+  const svector::Vector<2, int> vec{50000, 50000};
+  EXPECT_EQ(svector::dot(vec, svector::Vector<2, int>{1, 1},
+                         svector::MultiAccumulator<4>()),
+            100000);
+
+  const svector::DynVector<int> dyn{3, 4};
+  EXPECT_EQ(svector::magn(dyn, svector::Widened()), 5);
+}
+
+TEST(AccumulateTest, SizeMismatch) {
+  const svector::DynVector<> lhs(3);
+  const svector::DynVector<> rhs(4);
+  EXPECT_THROW(svector::dot(lhs, rhs, svector::Kahan()),
+               std::invalid_argument);
+}
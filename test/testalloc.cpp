@@ -0,0 +1,159 @@
+#include "simplevectors/vectors.hpp"
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+SVECTOR_DEFINE_ALLOC_HOOKS
+
+using namespace svector;
+
+TEST(AllocTest, CountsAllocations) {
+  alloc::reset();
+
+  std::vector<int> *vec = new std::vector<int>(10);
+  const alloc::Stats stats = alloc::threadStats();
+  EXPECT_EQ(stats.allocations, 2);
+  EXPECT_EQ(stats.deallocations, 0);
+  EXPECT_GE(stats.bytes, sizeof(std::vector<int>) + 10 * sizeof(int));
+
+  delete vec;
+  EXPECT_EQ(alloc::threadStats().deallocations, 2);
+}
+
+TEST(AllocTest, HotPathsDoNotAllocate) {
+  Vector<3, double> vec{1, 2, 3};
+  Vector2D vec2(3, 4);
+  Vector3D vec3(1, 2, 3);
+  const std::array<double, 3> array{{1, 2, 3}};
+
+  alloc::reset();
+
+  volatile double sink = 0;
+  sink = sink + svector::magn(vec) + svector::dot(vec, vec);
+  sink = sink + svector::normalize(vec)[0] + (vec + vec)[0] + (vec * 2.0)[0];
+  sink = sink + svector::rotate(vec2, 1)[0] + svector::angle(vec2);
+  sink = sink + svector::cross(vec3, vec3)[0] + svector::alpha(vec3);
+  sink = sink + svector::makeVector(array)[0];
+  sink = sink + vec3.rotate<BETA>(1)[0];
+
+  EXPECT_EQ(alloc::threadStats().allocations, 0);
+}
+
+TEST(AllocTest, DynVectorSpills) {
+  alloc::reset();
+  {
+    DynVector<float, 8> small(8);
+    small += small;
+  }
+  EXPECT_EQ(alloc::threadStats().allocations, 0);
+
+  {
+    DynVector<float, 8> large(9);
+    const DynVector<float, 8> other(9);
+    // the temporary from the first addition is reused by the second
+    const DynVector<float, 8> sum = large + other + other;
+  }
+  EXPECT_EQ(alloc::threadStats().allocations, 3);
+}
+
+TEST(AllocTest, AttributesToLibraryFunctions) {
+  const Vector<64, double> vec;
+
+  alloc::reset();
+  const std::string str = vec.toString();
+  {
+    SVECTOR_ALLOC_SCOPE("user");
+    const std::vector<int> ints(100);
+    {
+      // the innermost scope is used
+      SVECTOR_ALLOC_SCOPE("inner");
+      const std::vector<int> more(100);
+    }
+  }
+
+  const std::vector<alloc::Entry> entries = alloc::threadSnapshot();
+  ASSERT_EQ(entries.size(), 3);
+  EXPECT_EQ(entries[0].scope, "toString");
+  EXPECT_GE(entries[0].allocations, 1);
+  EXPECT_GE(entries[0].bytes, str.size());
+  EXPECT_EQ(entries[1].scope, "user");
+  EXPECT_EQ(entries[1].allocations, 1);
+  EXPECT_EQ(entries[1].bytes, 100 * sizeof(int));
+  EXPECT_EQ(entries[2].scope, "inner");
+  EXPECT_EQ(entries[2].allocations, 1);
+}
+
+TEST(AllocTest, AttributesToLibraryTypes) {
+  alloc::reset();
+  {
+    DynVector<double, 4> dyn(5);
+    SparseVector<double> sparse(100);
+    sparse.set(3, 1);
+    const ScatterAccumulator<3, double> scatter(10, 2);
+  }
+
+  const std::vector<alloc::Entry> entries = alloc::threadSnapshot();
+  ASSERT_EQ(entries.size(), 3);
+  EXPECT_EQ(entries[0].scope, "DynVector");
+  EXPECT_EQ(entries[0].allocations, 1);
+  EXPECT_EQ(entries[1].scope, "SparseVector");
+  EXPECT_EQ(entries[1].allocations, 2);
+  EXPECT_EQ(entries[2].scope, "ScatterAccumulator");
+  EXPECT_GE(entries[2].allocations, 2);
+}
+
+#if defined(__cpp_aligned_new) && __cpp_aligned_new >= 201606L
+TEST(AllocTest, CountsAlignedAllocations) {
+  struct alignas(128) Aligned {
+    double value;
+  };
+
+  alloc::reset();
+
+  Aligned *single = new Aligned();
+  Aligned *array = new Aligned[3];
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(single) % 128, 0);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(array) % 128, 0);
+  delete single;
+  delete[] array;
+
+  const alloc::Stats stats = alloc::threadStats();
+  EXPECT_EQ(stats.allocations, 2);
+  EXPECT_EQ(stats.deallocations, 2);
+  EXPECT_GE(stats.bytes, 4 * sizeof(Aligned));
+}
+#endif
+
+TEST(AllocTest, CountingAllocator) {
+  alloc::reset();
+
+  {
+    std::vector<double, alloc::CountingAllocator<double>> vec;
+    vec.reserve(8);
+    vec.push_back(1);
+  }
+
+  // the allocator uses malloc, so it is not counted twice by the hooks
+  const alloc::Stats stats = alloc::threadStats();
+  EXPECT_EQ(stats.allocations, 1);
+  EXPECT_EQ(stats.deallocations, 1);
+  EXPECT_EQ(stats.bytes, 8 * sizeof(double));
+}
+
+TEST(AllocTest, PerThread) {
+  alloc::reset();
+
+  alloc::Stats workerStats{0, 0, 0};
+  std::thread worker([&workerStats] {
+    const std::vector<int> ints(10);
+    workerStats = alloc::threadStats();
+  });
+  worker.join();
+
+  EXPECT_EQ(workerStats.allocations, 1);
+}
@@ -0,0 +1,144 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+
+#include <gtest/gtest.h>
+
+TEST(DynVectorTest, Constructors) {
+  const svector::DynVector<> empty;
+  EXPECT_EQ(empty.size(), 0);
+  EXPECT_TRUE(empty.isInline());
+
+  const svector::DynVector<> zeros(3);
+  EXPECT_EQ(zeros.size(), 3);
+  EXPECT_EQ(zeros[2], 0);
+
+  const svector::DynVector<float> filled(5, 2);
+  EXPECT_EQ(filled[4], 2);
+
+  const svector::DynVector<> list{1, 2, 3};
+  EXPECT_EQ(list.numDimensions(), 3);
+  EXPECT_EQ(list[1], 2);
+
+  const double buffer[] = {4, 5};
+  const svector::DynVector<> fromBuffer(buffer, 2);
+  EXPECT_EQ(fromBuffer[0], 4);
+
+  const svector::DynVector<> fromVector(svector::Vector3D{1, 2, 3});
+  EXPECT_EQ(fromVector, list);
+}
+
+TEST(DynVectorTest, SpillsToAlignedHeap) {
+  svector::DynVector<float, 4> vec{1, 2, 3, 4};
+  EXPECT_TRUE(vec.isInline());
+  EXPECT_EQ(vec.capacity(), 4);
+
+  vec.resize(100);
+  EXPECT_FALSE(vec.isInline());
+  EXPECT_GE(vec.capacity(), 100);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(vec.data()) %
+                SVECTOR_DYNVECTOR_ALIGNMENT,
+            0);
+
+  // components are kept, and new ones are 0
+  EXPECT_EQ(vec[3], 4);
+  EXPECT_EQ(vec[99], 0);
+}
+
+TEST(DynVectorTest, CopyAndMove) {
+  svector::DynVector<double, 2> heap(10, 1);
+  const double *data = heap.data();
+
+  const svector::DynVector<double, 2> copy(heap);
+  EXPECT_EQ(copy, heap);
+  EXPECT_NE(copy.data(), data);
+
+  svector::DynVector<double, 2> moved(std::move(heap));
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(heap.size(), 0);
+
+  svector::DynVector<double, 2> small{1, 2};
+  moved = std::move(small);
+  EXPECT_TRUE(moved.isInline());
+  EXPECT_EQ(moved[1], 2);
+
+  moved = copy;
+  EXPECT_EQ(moved.size(), 10);
+}
+
+TEST(DynVectorTest, Operations) {
+  // large enough to use both the SIMD loop and the leftover components
+  const std::size_t size = 37;
+  svector::DynVector<float> lhs(size);
+  svector::DynVector<float> rhs(size);
+  float expectedDot = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    lhs[i] = static_cast<float>(i);
+    rhs[i] = 2;
+    expectedDot += lhs[i] * rhs[i];
+  }
+
+  EXPECT_FLOAT_EQ(svector::dot(lhs, rhs), expectedDot);
+  EXPECT_FLOAT_EQ(svector::magn(rhs), std::sqrt(4.0F * size));
+
+  const svector::DynVector<float> sum = lhs + rhs;
+  const svector::DynVector<float> difference = lhs - rhs;
+  const svector::DynVector<float> product = lhs * 3;
+  const svector::DynVector<float> quotient = lhs / 2;
+  for (std::size_t i = 0; i < size; i++) {
+    EXPECT_EQ(sum[i], lhs[i] + 2);
+    EXPECT_EQ(difference[i], lhs[i] - 2);
+    EXPECT_EQ(product[i], lhs[i] * 3);
+    EXPECT_EQ(quotient[i], lhs[i] / 2);
+  }
+
+  EXPECT_EQ(-rhs, svector::DynVector<float>(size, -2));
+  EXPECT_FLOAT_EQ(svector::normalize(lhs).magn(), 1);
+  EXPECT_FALSE(svector::isZero(lhs));
+  EXPECT_TRUE(svector::isZero(svector::DynVector<float>(size)));
+}
+
+TEST(DynVectorTest, SizeMismatch) {
+  svector::DynVector<> lhs(3);
+  const svector::DynVector<> rhs(4);
+
+  EXPECT_THROW(svector::dot(lhs, rhs), std::invalid_argument);
+  EXPECT_THROW(lhs += rhs, std::invalid_argument);
+  EXPECT_THROW(lhs.at(3), std::out_of_range);
+  EXPECT_NE(lhs, rhs);
+}
+
+TEST(DynVectorTest, ToVector) {
+  const svector::DynVector<> vec{1, 2, 3};
+  const svector::Vector<3> fixed = vec.toVector<3>();
+  EXPECT_EQ(fixed, (svector::Vector<3>{1, 2, 3}));
+  EXPECT_THROW(vec.toVector<2>(), std::invalid_argument);
+
+  // the lenient conversion pads or truncates, like a std::vector
+  const svector::Vector<2> truncated =
+      svector::makeVector<2>(vec.data(), vec.size());
+  EXPECT_EQ(truncated, (svector::Vector<2>{1, 2}));
+}
+
+TEST(SimdTest, MatchesPlainLoops) {
+  double lhs[11];
+  double rhs[11];
+  double out[11];
+  for (std::size_t i = 0; i < 11; i++) {
+    lhs[i] = static_cast<double>(i) + 1;
+    rhs[i] = 0.5;
+  }
+
+  EXPECT_DOUBLE_EQ(svector::simd::dot(lhs, rhs, 11), 33);
+
+  svector::simd::subtract(lhs, rhs, out, 11);
+  EXPECT_EQ(out[10], 10.5);
+  svector::simd::divide(lhs, 4.0, out, 11);
+  EXPECT_EQ(out[10], 2.75);
+
+  int ints[3] = {1, 2, 3};
+  EXPECT_EQ(svector::simd::dot(ints, ints, 3), 14);
+}
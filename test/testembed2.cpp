@@ -5,6 +5,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <regex>
+#include <thread>
 #include <utility>
 
 #ifndef M_PI
@@ -674,3 +675,147 @@ TEST(Embed2IsZeroTest, IsZeroTestNonZeroDimensionVector) {
   svector::EmbVec3D v2{0, 0, 0};
   EXPECT_TRUE(isZero(v2));
 }
+
+TEST(Embed2CordicTest2D, RotateMatchesRotate) {
+  std::vector<std::vector<float>> tests{
+      {1, 0, M_PI / 6},  {1, 1, M_PI / 4},   {1.732, 1, M_PI / 3},
+      {0, 1, -M_PI / 4}, {-1, 0, 2 * M_PI},  {-0.5, -0.866, 3},
+      {3, -4, -3},       {0.707, -0.707, 7}, {2, 5, -10},
+  };
+
+  for (const auto &testcase : tests) {
+    EmbVec2D vector(testcase[0], testcase[1]);
+
+    EmbVec2D expected = rotate(vector, testcase[2]);
+    EmbVec2D rotated = cordicRotate(vector, testcase[2]);
+
+    EXPECT_LT(std::abs(expected.x - rotated.x), 0.001);
+    EXPECT_LT(std::abs(expected.y - rotated.y), 0.001);
+  }
+}
+
+TEST(Embed2CordicTest2D, PolarMatchesMagnAngle) {
+  std::vector<std::vector<float>> tests{
+      {1, 0},  {1, 1},     {1.732, 1}, {0, 1},  {-1, 0},
+      {0, -1}, {-3, -0.5}, {-3, 0.5},  {3, -4}, {0.001, 0.002},
+  };
+
+  for (const auto &testcase : tests) {
+    EmbVec2D vector(testcase[0], testcase[1]);
+    EmbPolar2D polar = cordicPolar(vector);
+
+    EXPECT_LT(std::abs(polar.magn - magn(vector)), 0.001 * magn(vector));
+    EXPECT_LT(std::abs(polar.angle - angle(vector)), 0.001);
+    EXPECT_EQ(cordicMagn(vector), polar.magn);
+    EXPECT_EQ(cordicAngle(vector), polar.angle);
+  }
+
+  EmbVec2D zero;
+  EXPECT_EQ(cordicMagn(zero), 0);
+  EXPECT_EQ(cordicAngle(zero), 0);
+}
+
+TEST(Embed2CordicTest2D, IterationsTradePrecision) {
+  EmbVec2D vector(3, 4);
+  float coarse = std::abs(cordicAngle(vector, 4) - angle(vector));
+  float fine = std::abs(cordicAngle(vector, 24) - angle(vector));
+
+  EXPECT_LT(fine, coarse);
+  EXPECT_LT(fine, 0.00001);
+
+  // iteration counts above the table size are clamped
+  EXPECT_EQ(cordicAngle(vector, 100), cordicAngle(vector, 24));
+}
+
+TEST(Embed2CordicTest3D, RotateMatchesRotate) {
+  std::vector<std::vector<float>> tests{
+      {1, 0, 3, M_PI / 6},  {1, 1, 3, M_PI / 4},   {1.732, 1, -3, M_PI / 3},
+      {0, 1, 3, -M_PI / 4}, {-1, 0, 3, 5},         {-0.5, -0.866, 3, -2},
+      {0, -1, 3, M_PI},     {0.707, -0.707, 3, 9},
+  };
+
+  for (const auto &testcase : tests) {
+    EmbVec3D vector(testcase[0], testcase[1], testcase[2]);
+
+    EmbVec3D expected = rotateAlpha(vector, testcase[3]);
+    EmbVec3D rotated = cordicRotateAlpha(vector, testcase[3]);
+    EXPECT_LT(std::abs(expected.x - rotated.x), 0.001);
+    EXPECT_LT(std::abs(expected.y - rotated.y), 0.001);
+    EXPECT_LT(std::abs(expected.z - rotated.z), 0.001);
+
+    expected = rotateBeta(vector, testcase[3]);
+    rotated = cordicRotateBeta(vector, testcase[3]);
+    EXPECT_LT(std::abs(expected.x - rotated.x), 0.001);
+    EXPECT_LT(std::abs(expected.y - rotated.y), 0.001);
+    EXPECT_LT(std::abs(expected.z - rotated.z), 0.001);
+
+    expected = rotateGamma(vector, testcase[3]);
+    rotated = cordicRotateGamma(vector, testcase[3]);
+    EXPECT_LT(std::abs(expected.x - rotated.x), 0.001);
+    EXPECT_LT(std::abs(expected.y - rotated.y), 0.001);
+    EXPECT_LT(std::abs(expected.z - rotated.z), 0.001);
+  }
+}
+
+TEST(Embed2RingBufferTest, BulkReadWrapsAround) {
+  EmbRingBuffer<EmbVec2D, 4> buffer;
+  EXPECT_EQ(buffer.capacity(), 4);
+  EXPECT_TRUE(buffer.empty());
+
+  EmbVec2D out[4];
+  EXPECT_EQ(buffer.read(out, 4), 0);
+
+  unsigned int pushed = 0;
+  unsigned int popped = 0;
+  for (int round = 0; round < 10; round++) {
+    while (buffer.push(EmbVec2D(static_cast<float>(pushed), 1))) {
+      pushed++;
+    }
+    EXPECT_EQ(buffer.size(), 4);
+
+    const unsigned int count = buffer.read(out, 3);
+    EXPECT_EQ(count, 3);
+    for (unsigned int i = 0; i < count; i++) {
+      EXPECT_EQ(out[i], EmbVec2D(static_cast<float>(popped + i), 1));
+    }
+    popped += count;
+  }
+
+  EmbVec2D last;
+  EXPECT_TRUE(buffer.pop(last));
+  EXPECT_EQ(last, EmbVec2D(static_cast<float>(popped), 1));
+  EXPECT_FALSE(buffer.pop(last));
+}
+
+// a thread stands in for the interrupt handler
+TEST(Embed2RingBufferTest, ThreadAsInterrupt) {
+  const unsigned int count = 50000;
+  EmbRingBuffer<EmbVec3D, 16> buffer;
+  std::thread isr([&buffer, count]() {
+    for (unsigned int i = 0; i < count; i++) {
+      const float t = static_cast<float>(i);
+      while (!buffer.push(EmbVec3D(t, -t, 2))) {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  unsigned int received = 0;
+  bool ordered = true;
+  EmbVec3D batch[5];
+  while (received < count) {
+    const unsigned int read = buffer.read(batch, 5);
+    for (unsigned int i = 0; i < read; i++) {
+      const float t = static_cast<float>(received + i);
+      ordered = ordered && batch[i] == EmbVec3D(t, -t, 2);
+    }
+    received += read;
+    if (read == 0) {
+      std::this_thread::yield();
+    }
+  }
+  isr.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_TRUE(buffer.empty());
+}
@@ -71,6 +71,60 @@ TEST(MakeVectorTestUtil, MakeVectorInitializerListTooMany) {
   EXPECT_EQ(v3[4], 6);
 }
 
+TEST(MakeVectorTestUtil, MakeVectorPointer) {
+  const float buf[] = {1, 2, 3, 4};
+  svector::Vector<3, float> vec = svector::makeVector<3>(buf + 1);
+  svector::Vector<3, float> control = {2, 3, 4};
+  EXPECT_EQ(vec, control);
+}
+
+TEST(MakeVectorTestUtil, MakeVectorPointerSize) {
+  const double buf[] = {1, 2, 3, 4};
+  svector::Vector<3> vec = svector::makeVector<3>(buf, 4);
+  svector::Vector<3> control = {1, 2, 3};
+  EXPECT_EQ(vec, control);
+
+  svector::Vector<3> vec2 = svector::makeVector<3>(buf, 2);
+  svector::Vector<3> control2 = {1, 2, 0};
+  EXPECT_EQ(vec2, control2);
+}
+
+TEST(FlatArrayTestUtil, FromFlatArray) {
+  const float buf[] = {1, 2, 3, 4, 5, 6};
+  svector::Vector<3, float> vecs[2];
+  svector::fromFlatArray(buf, 2, vecs);
+  EXPECT_EQ(vecs[0], (svector::Vector<3, float>{1, 2, 3}));
+  EXPECT_EQ(vecs[1], (svector::Vector<3, float>{4, 5, 6}));
+
+  // converts to the component type of derived vectors
+  svector::Vector2D vecs2[3];
+  svector::fromFlatArray(buf, 3, vecs2);
+  EXPECT_EQ(vecs2[0], svector::Vector2D(1, 2));
+  EXPECT_EQ(vecs2[2], svector::Vector2D(5, 6));
+
+  std::vector<svector::Vector3D> vecs3(2);
+  svector::fromFlatArray(buf, vecs3.size(), vecs3.data());
+  EXPECT_EQ(vecs3[1], svector::Vector3D(4, 5, 6));
+}
+
+TEST(FlatArrayTestUtil, ToFlatArray) {
+  const svector::Vector3D vecs[] = {{1, 2, 3}, {4, 5, 6}};
+  float buf[7] = {0, 0, 0, 0, 0, 0, -1};
+  svector::toFlatArray(vecs, 2, buf);
+  for (int i = 0; i < 6; i++) {
+    EXPECT_EQ(buf[i], i + 1);
+  }
+  EXPECT_EQ(buf[6], -1);
+
+  svector::Vector<4, int> back[1];
+  const int ints[] = {7, 8, 9, 10};
+  svector::fromFlatArray(ints, 1, back);
+  int roundTrip[4];
+  svector::toFlatArray(back, 1, roundTrip);
+  EXPECT_EQ(std::vector<int>(roundTrip, roundTrip + 4),
+            std::vector<int>(ints, ints + 4));
+}
+
 TEST(OperatorTestUtil, DotTest2D) {
   svector::Vector2D lhs(2, 5);
   svector::Vector2D rhs(-3, -4);
@@ -100,6 +154,23 @@ TEST(OperatorTestUtil, CrossProduct) {
   EXPECT_EQ(svector::cross(v2, v1), -res);
 }
 
+TEST(OperatorTestUtil, FloatFunctions) {
+  svector::Vector3f v1(2, 3, 5);
+  const svector::Vector3f v2(1, 2, 3);
+  const svector::Vector3f res = svector::cross(v1, v2);
+  EXPECT_EQ(res, svector::Vector3f(-1, -1, 1));
+
+  svector::z(v1, 0.5);
+  EXPECT_EQ(svector::z(v1), 0.5F);
+
+  const svector::Vector2f flat(0, 2);
+  const svector::Vector2f rotated = svector::rotate(flat, M_PI / 2);
+  EXPECT_NEAR(svector::x(rotated), -2, 1e-5);
+  EXPECT_FLOAT_EQ(svector::angle(flat), static_cast<float>(M_PI / 2));
+  EXPECT_FLOAT_EQ(svector::gamma(svector::rotateGamma(v2, 1)),
+                  svector::gamma(v2));
+}
+
 TEST(XYMagnitudeTestUtil, TestMagnitudeGivenXY) {
   svector::Vector2D vector(4.612, -3.322);
   double magn = svector::magn(vector);
@@ -0,0 +1,128 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cstddef>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#ifdef SVECTOR_HAS_COROUTINES
+namespace {
+typedef svector::Vector<2, double> Vec;
+
+std::vector<Vec> points(const std::size_t count) {
+  std::vector<Vec> result(count);
+  for (std::size_t i = 0; i < count; i++) {
+    result[i] = Vec{static_cast<double>(i), static_cast<double>(i) / 4};
+  }
+
+  return result;
+}
+} // namespace
+
+TEST(GeneratorTest, ArrayChunks) {
+  const std::vector<Vec> data = points(10);
+  std::vector<std::size_t> sizes;
+  for (const std::span<const Vec> chunk :
+       svector::stream::fromArray(data.data(), data.size(), 4)) {
+    sizes.push_back(chunk.size());
+  }
+
+  EXPECT_EQ(sizes, (std::vector<std::size_t>{4, 4, 2}));
+  EXPECT_EQ(svector::stream::collect(
+                svector::stream::fromArray(data.data(), data.size(), 3)),
+            data);
+  EXPECT_TRUE(
+      svector::stream::collect(svector::stream::fromArray(data.data(), 0))
+          .empty());
+}
+
+TEST(GeneratorTest, ReadText) {
+  std::istringstream text("1 2\n3 4.5\n -1e3 0\n");
+  EXPECT_EQ(svector::stream::collect(svector::stream::readText<2>(text, 2)),
+            (std::vector<Vec>{Vec{1, 2}, Vec{3, 4.5}, Vec{-1000, 0}}));
+
+  std::istringstream incomplete("1 2 3");
+  EXPECT_THROW(
+      svector::stream::collect(svector::stream::readText<2>(incomplete)),
+      std::invalid_argument);
+  std::istringstream garbage("1 2 x 4");
+  EXPECT_THROW(svector::stream::collect(svector::stream::readText<2>(garbage)),
+               std::invalid_argument);
+}
+
+TEST(GeneratorTest, ReadBinary) {
+  const std::vector<Vec> data = points(11);
+  std::string bytes;
+  for (const Vec &vec : data) {
+    bytes.append(reinterpret_cast<const char *>(&vec[0]), 2 * sizeof(double));
+  }
+
+  std::istringstream in(bytes);
+  EXPECT_EQ(svector::stream::collect(svector::stream::readBinary<2>(in, 5)),
+            data);
+
+  std::istringstream truncated(bytes.substr(0, bytes.size() - 1));
+  EXPECT_THROW(
+      svector::stream::collect(svector::stream::readBinary<2>(truncated, 5)),
+      std::invalid_argument);
+}
+
+TEST(GeneratorTest, ZeroChunkSizeIsDefault) {
+  const std::vector<Vec> data = points(10);
+  std::vector<std::size_t> sizes;
+  for (const std::span<const Vec> chunk :
+       svector::stream::fromArray(data.data(), data.size(), 0)) {
+    sizes.push_back(chunk.size());
+  }
+  EXPECT_EQ(sizes, (std::vector<std::size_t>{10}));
+
+  std::istringstream text("1 2\n3 4\n");
+  EXPECT_EQ(svector::stream::collect(svector::stream::readText<2>(text, 0)),
+            (std::vector<Vec>{Vec{1, 2}, Vec{3, 4}}));
+
+  std::string bytes;
+  for (const Vec &vec : data) {
+    bytes.append(reinterpret_cast<const char *>(&vec[0]), 2 * sizeof(double));
+  }
+  std::istringstream in(bytes);
+  EXPECT_EQ(svector::stream::collect(svector::stream::readBinary<2>(in, 0)),
+            data);
+}
+
+TEST(GeneratorTest, PipeIsLazy) {
+  const std::vector<Vec> data = points(100);
+  std::size_t mapped = 0;
+  const svector::Pipeline<Vec> steps =
+      svector::Pipeline<Vec>()
+          .map([&mapped](const Vec &v) {
+            mapped++;
+            return v * 2.0;
+          })
+          .filter([](const Vec &v) { return v[0] >= 100; });
+
+  svector::VectorStream<Vec> stream = svector::stream::pipe(
+      svector::stream::fromArray(data.data(), data.size(), 10), steps);
+  EXPECT_EQ(mapped, 0);
+
+  // the first 5 chunks are filtered out, so the first chunk out is the 6th
+  ASSERT_TRUE(stream.next());
+  EXPECT_EQ(mapped, 60);
+  EXPECT_EQ(stream.value().size(), 10);
+  EXPECT_EQ(stream.value()[0], (Vec{100, 25}));
+
+  std::size_t chunks = 1;
+  while (stream.next()) {
+    chunks++;
+  }
+  EXPECT_EQ(chunks, 5);
+  EXPECT_EQ(mapped, 100);
+}
+#else
+TEST(GeneratorTest, NotSupported) {
+  GTEST_SKIP() << "The compiler does not support C++20 coroutines";
+}
+#endif
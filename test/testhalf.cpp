@@ -0,0 +1,86 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(HalfTest, Conversions) {
+  EXPECT_EQ(svector::Half(1).bits(), 0x3C00);
+  EXPECT_EQ(svector::Half(-2).bits(), 0xC000);
+  EXPECT_EQ(svector::Half(65504).bits(), 0x7BFF);
+  EXPECT_EQ(static_cast<float>(svector::Half::fromBits(0x3555)),
+            0.333251953125F);
+
+  // ties round to even
+  EXPECT_EQ(svector::Half(2049).bits(), svector::Half(2048).bits());
+  EXPECT_EQ(svector::Half(2051).bits(), svector::Half(2052).bits());
+
+  // subnormals, overflow, infinity, and NaN
+  EXPECT_EQ(svector::Half(std::ldexp(1.0F, -24)).bits(), 0x0001);
+  EXPECT_EQ(svector::Half(std::ldexp(1.0F, -25)).bits(), 0x0000);
+  EXPECT_EQ(static_cast<float>(svector::Half::fromBits(0x0200)),
+            std::ldexp(1.0F, -15));
+  EXPECT_EQ(svector::Half(65520).bits(), 0x7C00);
+  EXPECT_EQ(svector::Half(-std::numeric_limits<float>::infinity()).bits(),
+            0xFC00);
+  EXPECT_TRUE(std::isnan(static_cast<float>(
+      svector::Half(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(HalfTest, BFloat16Conversions) {
+  EXPECT_EQ(svector::BFloat16(1).bits(), 0x3F80);
+  EXPECT_EQ(static_cast<float>(svector::BFloat16(3.0e38F)), 3.0040553e38F);
+
+  // 1 + 2^-8 is halfway between 1 and 1 + 2^-7, so it rounds to even (1)
+  EXPECT_EQ(static_cast<float>(svector::BFloat16(1.00390625F)), 1);
+  EXPECT_EQ(static_cast<float>(svector::BFloat16(1.01171875F)), 1.015625F);
+  EXPECT_TRUE(std::isnan(static_cast<float>(
+      svector::BFloat16(std::numeric_limits<float>::quiet_NaN()))));
+}
+
+TEST(HalfTest, BatchMatchesScalar) {
+  // long enough to use both the SIMD loop and the leftover elements
+  const std::size_t size = 37;
+  std::vector<float> floats(size);
+  for (std::size_t i = 0; i < size; i++) {
+    floats[i] = (static_cast<float>(i) - 18) * 0.37F;
+  }
+
+  std::vector<svector::Half> halves(size);
+  std::vector<svector::BFloat16> bfloats(size);
+  svector::half::fromFloat(floats.data(), halves.data(), size);
+  svector::half::fromFloat(floats.data(), bfloats.data(), size);
+
+  std::vector<float> fromHalves(size);
+  std::vector<float> fromBFloats(size);
+  svector::half::toFloat(halves.data(), fromHalves.data(), size);
+  svector::half::toFloat(bfloats.data(), fromBFloats.data(), size);
+
+  float halfDot = 0;
+  float bfloatDot = 0;
+  for (std::size_t i = 0; i < size; i++) {
+    EXPECT_EQ(halves[i].bits(), svector::Half(floats[i]).bits());
+    EXPECT_EQ(bfloats[i].bits(), svector::BFloat16(floats[i]).bits());
+    EXPECT_EQ(fromHalves[i], static_cast<float>(halves[i]));
+    EXPECT_EQ(fromBFloats[i], static_cast<float>(bfloats[i]));
+    halfDot += fromHalves[i] * floats[i];
+    bfloatDot += fromBFloats[i] * fromBFloats[i];
+  }
+
+  EXPECT_FLOAT_EQ(svector::half::dot(halves.data(), floats.data(), size),
+                  halfDot);
+  EXPECT_FLOAT_EQ(svector::half::dot(bfloats.data(), bfloats.data(), size),
+                  bfloatDot);
+}
+
+TEST(HalfTest, Vectors) {
+  const svector::Vector<3, float> vec{0.5F, -1, 1000};
+  svector::Half stored[3];
+  svector::half::fromVector(vec, stored);
+  EXPECT_EQ(svector::half::toVector<3>(stored), vec);
+  EXPECT_FLOAT_EQ(svector::half::dot(stored, stored, 3), vec.dot(vec));
+}
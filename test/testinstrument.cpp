@@ -0,0 +1,200 @@
+#include "simplevectors/vectors.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace svector;
+
+namespace {
+std::uint64_t callsOf(const std::vector<instrument::Entry> &entries,
+                      const std::string &op, const std::size_t dims,
+                      const std::string &type) {
+  for (const auto &entry : entries) {
+    if (entry.op == op && entry.dims == dims && entry.type == type) {
+      return entry.calls;
+    }
+  }
+
+  return 0;
+}
+
+const instrument::Entry *find(const std::vector<instrument::Entry> &entries,
+                              const std::string &op) {
+  for (const auto &entry : entries) {
+    if (entry.op == op) {
+      return &entry;
+    }
+  }
+
+  return nullptr;
+}
+} // namespace
+
+TEST(InstrumentTest, CountsPerDimensionAndType) {
+  instrument::reset();
+
+  Vector<3, float> vec3f{1, 2, 3};
+  Vector<4, int> vec4i{1, 2, 3, 4};
+  vec3f.magn();
+  vec3f.magn();
+  svector::magn(vec3f);
+  vec4i.magn();
+  vec4i.toString();
+
+  const auto entries = instrument::snapshot();
+  EXPECT_EQ(callsOf(entries, "magn", 3, "float"), 3);
+  EXPECT_EQ(callsOf(entries, "magn", 4, "int"), 1);
+  EXPECT_EQ(callsOf(entries, "toString", 4, "int"), 1);
+  EXPECT_EQ(callsOf(entries, "toString", 3, "float"), 0);
+}
+
+TEST(InstrumentTest, CountsInstrumentedFunctions) {
+  instrument::reset();
+
+  Vector2D vec2(3, 4);
+  Vector3D vec3(1, 2, 3);
+  vec2.rotate(1);
+  svector::rotate(vec2, 1);
+  vec3.cross(vec3);
+  svector::cross(vec3, vec3);
+  vec3.rotate<ALPHA>(1);
+  svector::rotateGamma(vec3, 1);
+  vec2.normalize();
+  svector::normalize(vec2);
+  DynVector<double>({3, 4}).normalize();
+  const double dense[] = {3, 0, 4};
+  SparseVector<double>(dense, 3).normalize();
+
+  const auto entries = instrument::snapshot();
+  EXPECT_EQ(callsOf(entries, "rotate", 2, "double"), 2);
+  EXPECT_EQ(callsOf(entries, "cross", 3, "double"), 2);
+  EXPECT_EQ(callsOf(entries, "rotateAlpha", 3, "double"), 1);
+  EXPECT_EQ(callsOf(entries, "rotateGamma", 3, "double"), 1);
+  EXPECT_EQ(callsOf(entries, "normalize", 2, "double"), 2);
+  // normalize() computes the magnitude without counting a call to magn()
+  EXPECT_EQ(callsOf(entries, "magn", 2, "double"), 0);
+  EXPECT_EQ(callsOf(entries, "normalize", 0, "double"), 2);
+  EXPECT_EQ(callsOf(entries, "magn", 0, "double"), 0);
+}
+
+TEST(InstrumentTest, Reset) {
+  Vector2D vec(3, 4);
+  vec.magn();
+  EXPECT_NE(callsOf(instrument::snapshot(), "magn", 2, "double"), 0);
+
+  instrument::reset();
+  EXPECT_TRUE(instrument::snapshot().empty());
+}
+
+TEST(InstrumentTest, Threads) {
+  instrument::reset();
+
+  Vector2D vec(3, 4);
+  vec.magn();
+
+  std::vector<instrument::Entry> workerEntries;
+  std::thread worker([&workerEntries] {
+    Vector2D other(1, 1);
+    for (int i = 0; i < 10; i++) {
+      other.magn();
+    }
+    workerEntries = instrument::threadSnapshot();
+  });
+  worker.join();
+
+  // only the worker's own calls
+  EXPECT_EQ(callsOf(workerEntries, "magn", 2, "double"), 10);
+  EXPECT_EQ(callsOf(instrument::threadSnapshot(), "magn", 2, "double"), 1);
+
+  // counts of exited threads are kept
+  EXPECT_EQ(callsOf(instrument::snapshot(), "magn", 2, "double"), 11);
+}
+
+TEST(InstrumentTest, Batch) {
+  instrument::reset();
+
+  {
+    SVECTOR_INSTRUMENT_BATCH("transform", 3, double, 100);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  {
+    SVECTOR_INSTRUMENT_BATCH("transform", 3, double, 50);
+  }
+
+  const auto entries = instrument::snapshot();
+  const instrument::Entry *entry = find(entries, "transform");
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(entry->calls, 0);
+  EXPECT_EQ(entry->batches, 2);
+  EXPECT_EQ(entry->items, 150);
+  EXPECT_GE(entry->nanoseconds, 1000000);
+}
+
+TEST(InstrumentTest, BatchFunctions) {
+  instrument::reset();
+
+  const std::vector<Vector3D> vectors(10, Vector3D{1, 2, 3});
+  std::vector<Octahedral<16>> directions(vectors.size());
+  std::vector<Vector3D> decoded(vectors.size());
+  octahedral::encode(vectors.data(), directions.data(), vectors.size());
+  octahedral::decode(directions.data(), decoded.data(), directions.size());
+  // two chunks of 5, on two threads
+  Pipeline<Vector3D>(5).run(vectors.data(), vectors.size(), decoded.data(), 2);
+  ScatterAccumulator<3, double> scatter(10, 1);
+  scatter.add(0, 4, Vector3D{1, 1, 1});
+  scatter.reduce(decoded.data());
+  svector::sum(vectors.data(), vectors.size(), 2);
+  svector::sum(vectors.data(), vectors.size(), 2, Reproducible());
+  svector::transform(Matrix3D::identity(), vectors.data(), vectors.size(),
+                     decoded.data());
+  std::vector<double> xs(10);
+  double *components[] = {xs.data(), xs.data(), xs.data()};
+  svector::transformComponents(Affine3D::identity(), components, components,
+                               xs.size());
+  std::vector<Vector2D> points(10);
+  Rotation2D(0.5).apply(points.data(), points.size(), points.data());
+  Rotation2D(0.5).applyComponents(xs.data(), xs.data(), xs.data(), xs.data(),
+                                  xs.size());
+
+  const auto entries = instrument::snapshot();
+  for (const char *op :
+       {"octahedralEncode", "octahedralDecode", "pipeline", "scatterReduce",
+        "transform", "transformComponents", "rotationApply",
+        "rotationApplyComponents"}) {
+    const instrument::Entry *entry = find(entries, op);
+    ASSERT_NE(entry, nullptr) << op;
+    EXPECT_EQ(entry->dims, std::string(op).find("rotation") == 0 ? 2 : 3)
+        << op;
+    EXPECT_EQ(entry->type, "double") << op;
+    EXPECT_EQ(entry->batches, 1) << op;
+    EXPECT_EQ(entry->items, 10) << op;
+  }
+
+  // once for each call, including the reproducible one
+  const instrument::Entry *sums = find(entries, "sum");
+  ASSERT_NE(sums, nullptr);
+  EXPECT_EQ(sums->batches, 2);
+  EXPECT_EQ(sums->items, 20);
+
+  // one batch for each worker range
+  const instrument::Entry *worker = find(entries, "pipelineWorker");
+  ASSERT_NE(worker, nullptr);
+  EXPECT_EQ(worker->batches, 2);
+  EXPECT_EQ(worker->items, 10);
+}
+
+TEST(InstrumentTest, DumpJSON) {
+  instrument::reset();
+  EXPECT_EQ(instrument::dumpJSON(), "{\"counters\": []}\n");
+
+  Vector<2, int> vec{3, 4};
+  vec.magn();
+  EXPECT_EQ(instrument::dumpJSON(),
+            "{\"counters\": [\n"
+            "  {\"op\": \"magn\", \"dims\": 2, \"type\": \"int\", "
+            "\"calls\": 1, \"batches\": 0, \"items\": 0, \"nanoseconds\": 0}\n"
+            "]}\n");
+}
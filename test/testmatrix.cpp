@@ -0,0 +1,155 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+template <std::size_t R, std::size_t C, typename T>
+void expectNear(const svector::Matrix<R, C, T> &actual,
+                const svector::Matrix<R, C, T> &expected, const T tolerance) {
+  for (std::size_t i = 0; i < R; i++) {
+    for (std::size_t j = 0; j < C; j++) {
+      EXPECT_NEAR(actual(i, j), expected(i, j), tolerance)
+          << "at (" << i << ", " << j << ")";
+    }
+  }
+}
+} // namespace
+
+TEST(MatrixTest, MultiplyAndTranspose) {
+  const svector::Matrix<2, 3, int> a{1, 2, 3, 4, 5, 6};
+  const svector::Matrix<3, 2, int> b{7, 8, 9, 10, 11, 12};
+  EXPECT_EQ(a * b, (svector::Matrix<2, 2, int>{58, 64, 139, 154}));
+  EXPECT_EQ(a.transpose(), (svector::Matrix<3, 2, int>{1, 4, 2, 5, 3, 6}));
+  EXPECT_EQ((a * svector::Vector<3, int>{1, 0, -1}),
+            (svector::Vector<2, int>{-2, -2}));
+
+  // 4x4 rows fill whole registers, and are added in the same order as the
+  // plain loop
+  svector::Matrix4D m;
+  svector::Matrix4D n;
+  for (std::size_t i = 0; i < 4; i++) {
+    for (std::size_t j = 0; j < 4; j++) {
+      m(i, j) = static_cast<double>(i * 4 + j) / 3;
+      n(i, j) = std::sin(static_cast<double>(i + 2 * j));
+    }
+  }
+  const svector::Matrix4D product = m * n;
+  for (std::size_t i = 0; i < 4; i++) {
+    for (std::size_t j = 0; j < 4; j++) {
+      double expected = 0;
+      for (std::size_t k = 0; k < 4; k++) {
+        expected += m(i, k) * n(k, j);
+      }
+      EXPECT_NEAR(product(i, j), expected, 1e-15 * 16);
+    }
+  }
+  EXPECT_EQ(m * svector::Matrix4D::identity(), m);
+}
+
+TEST(MatrixTest, Inverse) {
+  const svector::Matrix3D m{2, 0, 1, 1, 3, 2, 1, 1, 2};
+  expectNear(svector::inverse(m) * m, svector::Matrix3D::identity(), 1e-12);
+
+  // needs a row swap
+  const svector::Matrix2D swap{0, 1, 2, 0};
+  EXPECT_EQ(svector::inverse(swap), (svector::Matrix2D{0, 0.5, 1, 0}));
+
+  EXPECT_THROW(svector::inverse(svector::Matrix3D{1, 2, 3, 2, 4, 6, 0, 0, 1}),
+               std::invalid_argument);
+
+  const svector::Affine3D a =
+      svector::translationMatrix(svector::Vector3D{1, -2, 3}) *
+      svector::affineMatrix(svector::rotationMatrix<svector::BETA>(0.7) *
+                            svector::scalingMatrix(svector::Vector3D{2, 3, 4}));
+  expectNear(svector::inverse(a) * a, svector::Affine3D::identity(), 1e-12);
+}
+
+TEST(MatrixTest, MatchesVectorRotate) {
+  const svector::Vector3D v{1.5, -2, 0.25};
+  const svector::Vector3D offset{4, 5, 6};
+  const svector::Vector3D expected =
+      v.rotate<svector::ALPHA>(0.3).rotate<svector::BETA>(-1.1).rotate<
+          svector::GAMMA>(2) +
+      offset;
+
+  const svector::Affine3D m =
+      svector::translationMatrix(offset) *
+      svector::affineMatrix(svector::rotationMatrix<svector::GAMMA>(2.0)) *
+      svector::affineMatrix(svector::rotationMatrix<svector::BETA>(-1.1)) *
+      svector::affineMatrix(svector::rotationMatrix<svector::ALPHA>(0.3));
+  const svector::Vector3D actual = m * v;
+  for (std::size_t j = 0; j < 3; j++) {
+    EXPECT_NEAR(actual[j], expected[j], 1e-12);
+  }
+
+  const svector::Vector2D u = svector::rotationMatrix(0.5) *
+                              svector::Vector2D{3, 1};
+  EXPECT_NEAR(u.x(), svector::Vector2D(3, 1).rotate(0.5).x(), 1e-12);
+  EXPECT_NEAR(u.y(), svector::Vector2D(3, 1).rotate(0.5).y(), 1e-12);
+}
+
+TEST(MatrixTest, TransformArray) {
+  // more than one block, and a size that is not a multiple of any register
+  std::vector<svector::Vector3D> points(601);
+  for (std::size_t i = 0; i < points.size(); i++) {
+    const double t = static_cast<double>(i);
+    points[i] = svector::Vector3D{std::sin(t), std::cos(t), t / 100};
+  }
+
+  const svector::Affine3D m =
+      svector::translationMatrix(svector::Vector3D{1, 2, 3}) *
+      svector::affineMatrix(svector::rotationMatrix<svector::ALPHA>(0.4) *
+                            svector::rotationMatrix<svector::GAMMA>(1.2));
+  std::vector<svector::Vector3D> out(points.size());
+  svector::transform(m, points.data(), points.size(), out.data());
+  for (std::size_t i = 0; i < points.size(); i++) {
+    const svector::Vector3D expected = m * points[i];
+    for (std::size_t j = 0; j < 3; j++) {
+      EXPECT_NEAR(out[i][j], expected[j], 1e-12);
+    }
+  }
+
+  // in place, with a linear matrix and floats
+  std::vector<svector::Vector2f> flat(37);
+  for (std::size_t i = 0; i < flat.size(); i++) {
+    flat[i] = svector::Vector2f{static_cast<float>(i), 1};
+  }
+  const svector::Matrix<2, 2, float> swap{0, 1, 1, 0};
+  svector::transform(swap, flat.data(), flat.size(), flat.data());
+  for (std::size_t i = 0; i < flat.size(); i++) {
+    EXPECT_EQ(flat[i], (svector::Vector2f{1, static_cast<float>(i)}));
+  }
+}
+
+TEST(MatrixTest, TransformComponents) {
+  const std::size_t size = 103;
+  std::vector<double> xs(size);
+  std::vector<double> ys(size);
+  std::vector<double> zs(size);
+  for (std::size_t i = 0; i < size; i++) {
+    xs[i] = static_cast<double>(i);
+    ys[i] = std::sqrt(static_cast<double>(i));
+    zs[i] = -1;
+  }
+  const std::vector<double> oldXs = xs;
+  const std::vector<double> oldYs = ys;
+
+  const svector::Affine3D m =
+      svector::translationMatrix(svector::Vector3D{0.5, 0, -2}) *
+      svector::affineMatrix(svector::rotationMatrix<svector::BETA>(0.9));
+  const double *in[] = {xs.data(), ys.data(), zs.data()};
+  double *out[] = {xs.data(), ys.data(), zs.data()};
+  svector::transformComponents(m, in, out, size);
+  for (std::size_t i = 0; i < size; i++) {
+    const svector::Vector3D expected =
+        m * svector::Vector3D{oldXs[i], oldYs[i], -1};
+    EXPECT_NEAR(xs[i], expected.x(), 1e-12);
+    EXPECT_NEAR(ys[i], expected.y(), 1e-12);
+    EXPECT_NEAR(zs[i], expected.z(), 1e-12);
+  }
+}
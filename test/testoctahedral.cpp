@@ -0,0 +1,86 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+std::vector<svector::Vector3D> randomDirections(const std::size_t count) {
+  std::mt19937 random(1);
+  std::normal_distribution<double> normal;
+  std::vector<svector::Vector3D> directions(count);
+  for (svector::Vector3D &direction : directions) {
+    direction = svector::Vector3D(normal(random), normal(random),
+                                  normal(random));
+  }
+
+  return directions;
+}
+
+// angle in degrees between a vector and a unit vector
+double angleBetween(const svector::Vector3D &vec,
+                    const svector::Vector3D &unit) {
+  const double cross = svector::magn(svector::cross(vec, unit));
+  return std::atan2(cross, vec.dot(unit)) * 180 / 3.14159265358979323846;
+}
+
+template <std::size_t Bits> void expectAccurate(const double bound) {
+  const std::vector<svector::Vector3D> directions = randomDirections(20000);
+  std::vector<svector::Octahedral<Bits>> encoded(directions.size());
+  svector::octahedral::encode(directions.data(), encoded.data(),
+                              directions.size());
+  std::vector<svector::Vector3D> decoded(directions.size());
+  svector::octahedral::decode(encoded.data(), decoded.data(),
+                              directions.size());
+
+  for (std::size_t i = 0; i < directions.size(); i++) {
+    // the batches give the same result as one direction at a time
+    const svector::Octahedral<Bits> single(directions[i]);
+    EXPECT_EQ(encoded[i].bits(), single.bits());
+    const svector::Vector3D singleDecoded = single.toVector();
+    for (std::size_t j = 0; j < 3; j++) {
+      EXPECT_FLOAT_EQ(decoded[i][j], singleDecoded[j]);
+    }
+
+    EXPECT_LT(angleBetween(directions[i], decoded[i]), bound);
+    EXPECT_NEAR(svector::magn(decoded[i]), 1, 1e-6);
+  }
+}
+} // namespace
+
+TEST(OctahedralTest, Sizes) {
+  EXPECT_EQ(sizeof(svector::Octahedral<16>), 2);
+  EXPECT_EQ(sizeof(svector::Octahedral<24>), 3);
+  EXPECT_EQ(sizeof(svector::Octahedral<32>), 4);
+  EXPECT_EQ(svector::Octahedral<24>::fromBits(0xABCDEF).bits(), 0xABCDEF);
+}
+
+TEST(OctahedralTest, ExactDirections) {
+  const svector::Vector3D axes[] = {
+      svector::Vector3D(2, 0, 0),  svector::Vector3D(-1, 0, 0),
+      svector::Vector3D(0, 5, 0),  svector::Vector3D(0, -1, 0),
+      svector::Vector3D(0, 0, 1),  svector::Vector3D(0, 0, -0.5)};
+  for (const svector::Vector3D &axis : axes) {
+    const svector::Vector3D unit = svector::normalize(axis);
+    EXPECT_EQ(svector::Octahedral<16>(axis).toVector(), unit);
+    EXPECT_EQ(svector::Octahedral<32>(axis).toVector(), unit);
+  }
+
+  // the zero vector is +z
+  EXPECT_EQ(svector::Octahedral<24>(svector::Vector3D()).toVector(),
+            svector::Vector3D(0, 0, 1));
+
+  // float vectors
+  const svector::Vector3f decoded =
+      svector::Octahedral<32>(svector::Vector3f(0, -3, 0)).toVector<float>();
+  EXPECT_EQ(decoded, svector::Vector3f(0, -1, 0));
+}
+
+TEST(OctahedralTest, Accuracy16) { expectAccurate<16>(0.95); }
+
+TEST(OctahedralTest, Accuracy24) { expectAccurate<24>(0.06); }
+
+TEST(OctahedralTest, Accuracy32) { expectAccurate<32>(0.0037); }
@@ -0,0 +1,113 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+std::vector<svector::Vector3D> points(const std::size_t count) {
+  std::vector<svector::Vector3D> result(count);
+  for (std::size_t i = 0; i < count; i++) {
+    const double t = static_cast<double>(i);
+    result[i] = svector::Vector3D(t, -t / 2, static_cast<double>(i % 7) - 3);
+  }
+
+  return result;
+}
+
+svector::Vector3D rotate(const svector::Vector3D &v) {
+  return svector::rotateGamma(v, 0.5);
+}
+
+bool above(const svector::Vector3D &v) { return v.z() > 0; }
+
+// the same steps as a pipeline, with an array after each step
+std::vector<svector::Vector3D>
+materialized(const std::vector<svector::Vector3D> &in) {
+  std::vector<svector::Vector3D> rotated;
+  for (const svector::Vector3D &v : in) {
+    rotated.push_back(rotate(v));
+  }
+  std::vector<svector::Vector3D> filtered;
+  for (const svector::Vector3D &v : rotated) {
+    if (above(v)) {
+      filtered.push_back(v);
+    }
+  }
+  std::vector<svector::Vector3D> scaled;
+  for (const svector::Vector3D &v : filtered) {
+    scaled.push_back(v * 3.0);
+  }
+
+  return scaled;
+}
+
+svector::Pipeline<svector::Vector3D> steps(const std::size_t chunkSize) {
+  return svector::Pipeline<svector::Vector3D>(chunkSize)
+      .map(rotate)
+      .filter(above)
+      .transform([](svector::Vector3D *data, const std::size_t size) {
+        for (std::size_t i = 0; i < size; i++) {
+          data[i] *= 3.0;
+        }
+      });
+}
+} // namespace
+
+TEST(PipelineTest, MatchesMaterialized) {
+  const std::vector<svector::Vector3D> in = points(1000);
+  const std::vector<svector::Vector3D> expected = materialized(in);
+
+  // chunk sizes that do and do not divide the input
+  for (const std::size_t chunkSize : {7, 256, 5000}) {
+    const svector::Pipeline<svector::Vector3D> pipeline = steps(chunkSize);
+    EXPECT_EQ(pipeline.numStages(), 3);
+    EXPECT_EQ(pipeline.collect(in.data(), in.size()), expected);
+  }
+}
+
+TEST(PipelineTest, InPlaceAndEmpty) {
+  std::vector<svector::Vector3D> data = points(100);
+  const std::vector<svector::Vector3D> expected = materialized(data);
+
+  const std::size_t written = steps(16).run(data.data(), data.size(),
+                                            data.data());
+  data.resize(written);
+  EXPECT_EQ(data, expected);
+
+  // no steps copies the input; no input writes nothing
+  const svector::Pipeline<svector::Vector3D> copy;
+  EXPECT_EQ(copy.collect(expected.data(), expected.size()), expected);
+  EXPECT_EQ(steps(16).run(nullptr, 0, nullptr, 4), 0);
+}
+
+TEST(PipelineTest, Threads) {
+  const std::vector<svector::Vector3D> in = points(1000);
+  const std::vector<svector::Vector3D> expected = materialized(in);
+
+  // more threads than chunks, and threads with uneven numbers of chunks
+  for (const std::size_t threads : {2, 3, 100}) {
+    EXPECT_EQ(steps(64).collect(in.data(), in.size(), threads), expected);
+
+    std::vector<svector::Vector3D> data = in;
+    data.resize(steps(64).run(data.data(), data.size(), data.data(), threads));
+    EXPECT_EQ(data, expected);
+  }
+}
+
+TEST(PipelineTest, Exceptions) {
+  const std::vector<svector::Vector3D> in = points(1000);
+  const svector::Pipeline<svector::Vector3D> pipeline =
+      svector::Pipeline<svector::Vector3D>(10).map(
+          [](const svector::Vector3D &v) {
+            if (v.x() == 900) {
+              throw std::runtime_error("bad vector");
+            }
+            return v;
+          });
+
+  EXPECT_THROW(pipeline.collect(in.data(), in.size()), std::runtime_error);
+  EXPECT_THROW(pipeline.collect(in.data(), in.size(), 4), std::runtime_error);
+}
@@ -0,0 +1,151 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+std::vector<svector::Vector3D> positions(const std::size_t count) {
+  std::vector<svector::Vector3D> points(count);
+  for (std::size_t i = 0; i < count; i++) {
+    const double t = static_cast<double>(i);
+    points[i] = svector::Vector3D(std::sin(t) * 100, t * 0.25, 7);
+  }
+
+  return points;
+}
+} // namespace
+
+TEST(QuantizeTest, RoundTripWithinMaxError) {
+  // 3 blocks, the last one shorter
+  const std::vector<svector::Vector3D> points = positions(250);
+  const svector::QuantizedArray<3> array(points.data(), points.size(), 100);
+  EXPECT_EQ(array.size(), 250);
+  EXPECT_EQ(array.numBlocks(), 3);
+  EXPECT_EQ(array.blockLength(2), 50);
+
+  // half a step of the widest range (200 in x), and not 0
+  EXPECT_GT(array.maxError(), 0);
+  EXPECT_LE(array.maxError(), 200.0 / 65535 / 2 * 1.001);
+
+  std::vector<svector::Vector3D> decoded(points.size());
+  array.decode(decoded.data());
+  for (std::size_t i = 0; i < points.size(); i++) {
+    for (std::size_t j = 0; j < 3; j++) {
+      EXPECT_LE(std::abs(decoded[i][j] - points[i][j]), array.maxError());
+      EXPECT_DOUBLE_EQ(array.at(i)[j], decoded[i][j]);
+    }
+
+    // a constant dimension is exact
+    EXPECT_EQ(decoded[i].z(), 7);
+  }
+}
+
+TEST(QuantizeTest, RandomAccessByBlock) {
+  const std::vector<svector::Vector3D> points = positions(250);
+  const svector::QuantizedArray<3> array(points.data(), points.size(), 100);
+
+  std::vector<svector::Vector3D> all(points.size());
+  array.decode(all.data());
+  std::vector<svector::Vector3D> block(100);
+  array.decodeBlock(2, block.data());
+  for (std::size_t k = 0; k < array.blockLength(2); k++) {
+    EXPECT_EQ(block[k], all[200 + k]);
+  }
+
+  EXPECT_THROW(array.decodeBlock(3, block.data()), std::out_of_range);
+  EXPECT_THROW(array.at(250), std::out_of_range);
+}
+
+TEST(QuantizeTest, FloatSimdMatchesScalar) {
+  // 37 components per dimension, so that the SIMD loop and the leftover
+  // components are both used
+  std::vector<svector::Vector<2, float>> points(37);
+  for (std::size_t i = 0; i < points.size(); i++) {
+    points[i][0] = static_cast<float>(i) * 0.3F - 4;
+    points[i][1] = static_cast<float>(i * i);
+  }
+
+  const svector::QuantizedArray<2, float> array(points.data(), points.size());
+  std::vector<svector::Vector<2, float>> decoded(points.size());
+  array.decode(decoded.data());
+  for (std::size_t i = 0; i < points.size(); i++) {
+    EXPECT_NEAR(decoded[i][0], points[i][0], array.maxError());
+    EXPECT_NEAR(decoded[i][1], points[i][1], array.maxError());
+  }
+  // the smallest component of each dimension is the offset, so it is exact
+  EXPECT_EQ(decoded.front(), points.front());
+}
+
+TEST(QuantizeTest, DoubleSimdMatchesScalar) {
+  // 37 components per dimension, as above
+  std::vector<svector::Vector<2, double>> points(37);
+  for (std::size_t i = 0; i < points.size(); i++) {
+    points[i][0] = static_cast<double>(i) * 0.3 - 4;
+    points[i][1] = static_cast<double>(i * i);
+  }
+
+  const svector::QuantizedArray<2, double> words(points.data(), points.size());
+  const svector::QuantizedArray<2, double, std::uint8_t> bytes(points.data(),
+                                                               points.size());
+  std::vector<svector::Vector<2, double>> decodedWords(points.size());
+  std::vector<svector::Vector<2, double>> decodedBytes(points.size());
+  words.decode(decodedWords.data());
+  bytes.decode(decodedBytes.data());
+  for (std::size_t i = 0; i < points.size(); i++) {
+    for (std::size_t j = 0; j < 2; j++) {
+      EXPECT_NEAR(decodedWords[i][j], points[i][j], words.maxError());
+      EXPECT_NEAR(decodedBytes[i][j], points[i][j], bytes.maxError());
+    }
+  }
+  EXPECT_EQ(decodedWords.front(), points.front());
+  EXPECT_EQ(decodedBytes.front(), points.front());
+  // the largest component is the last level, so it rounds to the last code
+  EXPECT_NEAR(decodedBytes.back()[1], points.back()[1], 1e-9);
+  EXPECT_LE(bytes.maxError(), 36.0 * 36 / 255 / 2 * 1.001);
+}
+
+TEST(QuantizeTest, Bytes) {
+  const std::vector<svector::Vector3D> points = positions(250);
+  const svector::QuantizedArray<3, double, std::uint32_t> array(
+      points.data(), points.size(), 64);
+  EXPECT_LT(array.maxError(), 1e-7);
+
+  const std::vector<std::uint8_t> bytes = array.toBytes();
+  EXPECT_EQ(bytes.size(), 32 + 4 * 3 * 2 * 8 + 250 * 3 * 4);
+
+  const svector::QuantizedArray<3, double, std::uint32_t> loaded =
+      svector::QuantizedArray<3, double, std::uint32_t>::fromBytes(
+          bytes.data(), bytes.size());
+  EXPECT_EQ(loaded.maxError(), array.maxError());
+  EXPECT_EQ(loaded.blockSize(), 64);
+  for (std::size_t i = 0; i < points.size(); i++) {
+    EXPECT_EQ(loaded.at(i), array.at(i));
+  }
+
+  // wrong types, truncated data, and garbage
+  EXPECT_THROW(
+      svector::QuantizedArray<3>::fromBytes(bytes.data(), bytes.size()),
+      std::invalid_argument);
+  EXPECT_THROW(
+      (svector::QuantizedArray<3, double, std::uint32_t>::fromBytes(
+          bytes.data(), bytes.size() - 1)),
+      std::invalid_argument);
+  const std::uint8_t garbage[40] = {};
+  EXPECT_THROW(svector::QuantizedArray<3>::fromBytes(garbage, 40),
+               std::invalid_argument);
+}
+
+TEST(QuantizeTest, RejectsNonFinite) {
+  std::vector<svector::Vector3D> points = positions(10);
+  points[4][1] = std::numeric_limits<double>::infinity();
+  EXPECT_THROW(svector::QuantizedArray<3>(points.data(), points.size()),
+               std::invalid_argument);
+  EXPECT_THROW(svector::QuantizedArray<3>(points.data(), points.size(), 0),
+               std::invalid_argument);
+}
@@ -0,0 +1,185 @@
+#include "simplevectors/vectors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+svector::Vector3D sample(const std::size_t i) {
+  const double t = static_cast<double>(i);
+  return svector::Vector3D(t, 2 * t, -t);
+}
+
+// pushes count samples, one batch of up to batchSize at a time
+template <typename Queue>
+void produce(Queue &queue, const std::size_t first, const std::size_t count,
+             const std::size_t batchSize) {
+  std::vector<svector::Vector3D> batch;
+  std::size_t next = first;
+  while (next < first + count) {
+    batch.clear();
+    for (std::size_t i = next; i < first + count && batch.size() < batchSize;
+         i++) {
+      batch.push_back(sample(i));
+    }
+
+    std::size_t sent = 0;
+    while (sent < batch.size()) {
+      sent += queue.pushBatch(batch.data() + sent, batch.size() - sent);
+      std::this_thread::yield();
+    }
+    next += batch.size();
+  }
+}
+} // namespace
+
+TEST(QueueTest, SpscBatchesWrapAround) {
+  svector::SpscQueue<svector::Vector3D, 8> queue;
+  EXPECT_EQ(queue.capacity(), 8);
+
+  svector::Vector3D out[8];
+  EXPECT_EQ(queue.popBatch(out, 8), 0);
+
+  // keep the queue partly full so that the batches wrap around the ring
+  std::size_t pushed = 0;
+  std::size_t popped = 0;
+  for (int round = 0; round < 20; round++) {
+    svector::Vector3D in[5];
+    for (std::size_t i = 0; i < 5; i++) {
+      in[i] = sample(pushed + i);
+    }
+    const std::size_t added = queue.pushBatch(in, 5);
+    EXPECT_EQ(added, std::min<std::size_t>(5, 8 - (pushed - popped)));
+    pushed += added;
+    EXPECT_EQ(queue.sizeApprox(), pushed - popped);
+
+    const std::size_t removed = queue.popBatch(out, 3);
+    for (std::size_t i = 0; i < removed; i++) {
+      EXPECT_EQ(out[i], sample(popped + i));
+    }
+    popped += removed;
+  }
+
+  svector::Vector3D last;
+  while (queue.tryPop(last)) {
+    EXPECT_EQ(last, sample(popped));
+    popped++;
+  }
+  EXPECT_EQ(popped, pushed);
+  EXPECT_TRUE(queue.tryPush(sample(0)));
+}
+
+TEST(QueueTest, MpmcFullAndEmpty) {
+  svector::MpmcQueue<svector::Vector3D, 4> queue;
+  svector::Vector3D value;
+  EXPECT_FALSE(queue.tryPop(value));
+
+  const svector::Vector3D in[6] = {sample(0), sample(1), sample(2),
+                                   sample(3), sample(4), sample(5)};
+  EXPECT_EQ(queue.pushBatch(in, 3), 3);
+  EXPECT_EQ(queue.pushBatch(in + 3, 3), 1);
+  EXPECT_FALSE(queue.tryPush(in[4]));
+  EXPECT_EQ(queue.sizeApprox(), 4);
+
+  svector::Vector3D out[4];
+  EXPECT_EQ(queue.popBatch(out, 2), 2);
+  EXPECT_EQ(queue.pushBatch(in + 4, 2), 2);
+  EXPECT_EQ(queue.popBatch(out, 4), 4);
+  for (std::size_t i = 0; i < 4; i++) {
+    EXPECT_EQ(out[i], sample(i + 2));
+  }
+  EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(QueueTest, SpscKeepsOrderAcrossThreads) {
+  const std::size_t count = 100000;
+  svector::SpscQueue<svector::Vector3D, 256> queue;
+  std::thread producer(
+      [&queue, count]() { produce(queue, 0, count, 37); });
+
+  std::size_t received = 0;
+  bool ordered = true;
+  svector::Vector3D batch[64];
+  while (received < count) {
+    const std::size_t popped = queue.popBatch(batch, 64);
+    for (std::size_t i = 0; i < popped; i++) {
+      ordered = ordered && batch[i] == sample(received + i);
+    }
+    received += popped;
+    if (popped == 0) {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(queue.sizeApprox(), 0);
+}
+
+TEST(QueueTest, MpmcDeliversEachElementOnce) {
+  const std::size_t producers = 3;
+  const std::size_t consumers = 3;
+  const std::size_t perProducer = 20000;
+  svector::MpmcQueue<svector::Vector3D, 128> queue;
+
+  std::vector<std::thread> threads;
+  for (std::size_t p = 0; p < producers; p++) {
+    threads.emplace_back([&queue, p, perProducer]() {
+      produce(queue, p * perProducer, perProducer, 16);
+    });
+  }
+
+  // each consumer marks what it receives; every sample has to be seen once
+  std::vector<std::vector<int>> seen(
+      consumers, std::vector<int>(producers * perProducer, 0));
+  std::atomic<std::size_t> received{0};
+  for (std::size_t c = 0; c < consumers; c++) {
+    threads.emplace_back([&queue, &seen, &received, c, producers,
+                          perProducer]() {
+      svector::Vector3D batch[16];
+      while (received.load() < producers * perProducer) {
+        const std::size_t popped = queue.popBatch(batch, 16);
+        for (std::size_t i = 0; i < popped; i++) {
+          seen[c][static_cast<std::size_t>(batch[i].x())]++;
+        }
+        received += popped;
+        if (popped == 0) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+
+  bool once = true;
+  for (std::size_t i = 0; i < producers * perProducer; i++) {
+    int total = 0;
+    for (std::size_t c = 0; c < consumers; c++) {
+      total += seen[c][i];
+    }
+    once = once && total == 1;
+  }
+  EXPECT_TRUE(once);
+}
+
+TEST(QueueTest, BatchesAsElements) {
+  typedef std::array<svector::Vector3D, 16> Batch;
+  svector::SpscQueue<Batch, 4> queue;
+
+  Batch batch;
+  for (std::size_t i = 0; i < batch.size(); i++) {
+    batch[i] = sample(i);
+  }
+  EXPECT_TRUE(queue.tryPush(batch));
+
+  Batch out;
+  EXPECT_TRUE(queue.tryPop(out));
+  EXPECT_EQ(out, batch);
+}
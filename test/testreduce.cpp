@@ -0,0 +1,86 @@
+#include "simplevectors/vectors.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+// components of very different sizes, whose plain sum changes with the
+// number of threads
+template <typename T>
+std::vector<svector::Vector<3, T>> values(const std::size_t size) {
+  std::vector<svector::Vector<3, T>> result(size);
+  for (std::size_t i = 0; i < size; i++) {
+    const double t = static_cast<double>(i);
+    const double scale = std::pow(10.0, static_cast<double>(i % 11) - 5);
+    result[i] = svector::Vector<3, T>{static_cast<T>(std::sin(t) * scale),
+                                      static_cast<T>(std::cos(t) * scale),
+                                      static_cast<T>(1 / (t + 1))};
+  }
+
+  return result;
+}
+} // namespace
+
+TEST(ReduceTest, FastSum) {
+  const std::vector<svector::Vector<3, double>> data = values<double>(1000);
+  svector::Vector<3, double> expected;
+  for (const svector::Vector<3, double> &v : data) {
+    expected += v;
+  }
+
+  EXPECT_EQ(svector::sum(data.data(), data.size()), expected);
+  const svector::Vector<3, double> split = svector::sum(data.data(), 1000, 4);
+  for (std::size_t j = 0; j < 3; j++) {
+    EXPECT_NEAR(split[j], expected[j], 1e-12 * std::abs(expected[j]));
+  }
+  EXPECT_EQ(svector::sum(data.data(), 0, 4), (svector::Vector<3, double>()));
+}
+
+TEST(ReduceTest, ReproducibleAcrossThreadsAndOrder) {
+  std::vector<svector::Vector<3, double>> data = values<double>(5000);
+  const svector::Vector<3, double> expected =
+      svector::sum(data.data(), data.size(), 1, svector::Reproducible());
+
+  for (const std::size_t threads : {2, 3, 7}) {
+    EXPECT_EQ(svector::sum(data.data(), data.size(), threads,
+                           svector::Reproducible()),
+              expected);
+  }
+
+  std::reverse(data.begin(), data.end());
+  EXPECT_EQ(svector::sum(data.data(), data.size(), 3, svector::Reproducible()),
+            expected);
+
+  const svector::Vector<3, double> fast = svector::sum(data.data(), 5000);
+  for (std::size_t j = 0; j < 3; j++) {
+    EXPECT_NEAR(expected[j], fast[j], 1e-12 * std::abs(expected[j]));
+  }
+}
+
+TEST(ReduceTest, ReproducibleFloatAndInt) {
+  const std::vector<svector::Vector<3, float>> data = values<float>(3000);
+  const svector::Vector<3, float> expected =
+      svector::sum(data.data(), data.size(), 1, svector::Reproducible());
+  EXPECT_EQ(svector::sum(data.data(), data.size(), 5, svector::Reproducible()),
+            expected);
+
+  // added in double, so more accurate than a float sum
+  svector::Vector<3, double> exact;
+  for (const svector::Vector<3, float> &v : data) {
+    for (std::size_t j = 0; j < 3; j++) {
+      exact[j] += static_cast<double>(v[j]);
+    }
+  }
+  for (std::size_t j = 0; j < 3; j++) {
+    EXPECT_EQ(expected[j], static_cast<float>(exact[j]));
+  }
+
+  const std::vector<svector::Vector<2, int>> ints(
+      100, svector::Vector<2, int>{1, -2});
+  EXPECT_EQ(svector::sum(ints.data(), 100, 3, svector::Reproducible()),
+            (svector::Vector<2, int>{100, -200}));
+}
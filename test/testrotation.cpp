@@ -0,0 +1,106 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(RotationTest, MatchesVectorRotate) {
+  const svector::Vector2D v{3, -1.5};
+  for (const double ang : {0.0, 0.4, -2.5, 3.0}) {
+    const svector::Rotation2D rotation(ang);
+    const svector::Vector2D expected = v.rotate(ang);
+    EXPECT_EQ(rotation * v, expected);
+    EXPECT_EQ(rotation * v, svector::rotate(v, ang));
+    EXPECT_NEAR(rotation.angle(), ang, 1e-15);
+  }
+
+  EXPECT_EQ(svector::Rotation2D() * v, v);
+  const svector::Vector2D back =
+      svector::Rotation2D(0.7).inverse() * (svector::Rotation2D(0.7) * v);
+  EXPECT_NEAR(back.x(), v.x(), 1e-15);
+  EXPECT_NEAR(back.y(), v.y(), 1e-15);
+}
+
+TEST(RotationTest, Compose) {
+  svector::Rotation2D rotation(0.3);
+  rotation *= svector::Rotation2D(1.1);
+  EXPECT_NEAR(rotation.cos(), std::cos(1.4), 1e-15);
+  EXPECT_NEAR(rotation.sin(), std::sin(1.4), 1e-15);
+
+  const svector::Matrix2D m = rotation.toMatrix();
+  EXPECT_EQ(m, svector::Matrix2D(
+                   {rotation.cos(), -rotation.sin(), rotation.sin(),
+                    rotation.cos()}));
+}
+
+TEST(RotationTest, ApplyArrays) {
+  // not a multiple of any register width
+  const std::size_t size = 71;
+  std::vector<svector::Vector2D> points(size);
+  std::vector<double> xs(size);
+  std::vector<double> ys(size);
+  for (std::size_t i = 0; i < size; i++) {
+    const double t = static_cast<double>(i);
+    points[i] = svector::Vector2D{t, std::sin(t)};
+    xs[i] = t;
+    ys[i] = std::sin(t);
+  }
+
+  const svector::Rotation2D rotation(-0.8);
+  std::vector<svector::Vector2D> rotated(size);
+  rotation.apply(points.data(), size, rotated.data());
+  rotation.applyComponents(xs.data(), ys.data(), xs.data(), ys.data(), size);
+  rotation.apply(points.data(), size, points.data());
+  for (std::size_t i = 0; i < size; i++) {
+    const svector::Vector2D expected =
+        svector::Vector2D{static_cast<double>(i),
+                          std::sin(static_cast<double>(i))}
+            .rotate(-0.8);
+    EXPECT_NEAR(rotated[i].x(), expected.x(), 1e-12);
+    EXPECT_NEAR(rotated[i].y(), expected.y(), 1e-12);
+    EXPECT_EQ(points[i], rotated[i]);
+    EXPECT_NEAR(xs[i], expected.x(), 1e-12);
+    EXPECT_NEAR(ys[i], expected.y(), 1e-12);
+  }
+}
+
+TEST(RotationTest, Stepper) {
+  const double start = 0.25;
+  const double step = 1e-3;
+  svector::RotationStepper2D stepper(start, step);
+  for (std::size_t i = 0; i < 10000; i++) {
+    stepper.advance();
+  }
+  EXPECT_EQ(stepper.steps(), 10000u);
+  EXPECT_DOUBLE_EQ(stepper.angle(), start + 10000 * step);
+  EXPECT_NEAR(stepper.current().cos(), std::cos(stepper.angle()), 1e-13);
+  EXPECT_NEAR(stepper.current().sin(), std::sin(stepper.angle()), 1e-13);
+
+  // without resyncing, float steps drift, but stay close for short runs
+  svector::RotationStepper2f floats(0, 0.01f, 0);
+  std::vector<svector::Vector2f> points(100, svector::Vector2f{1, 0});
+  floats.apply(points.data(), points.size(), points.data());
+  for (std::size_t i = 0; i < points.size(); i++) {
+    const float ang = 0.01f * static_cast<float>(i);
+    EXPECT_NEAR(points[i].x(), std::cos(ang), 1e-5);
+    EXPECT_NEAR(points[i].y(), std::sin(ang), 1e-5);
+  }
+}
+
+TEST(RotationTest, StepperManySteps) {
+  // the angle reaches about 2e4 radians, where a float only keeps about 1e-3
+  // of the fraction
+  const float step = 0.001f;
+  const std::size_t count = 20000000;
+  svector::RotationStepper2f stepper(0.25f, step);
+  for (std::size_t i = 0; i < count; i++) {
+    stepper.advance();
+  }
+
+  const long double ang =
+      0.25L + static_cast<long double>(count) * static_cast<long double>(step);
+  EXPECT_NEAR(stepper.current().cos(), std::cos(ang), 1e-6);
+  EXPECT_NEAR(stepper.current().sin(), std::sin(ang), 1e-6);
+}
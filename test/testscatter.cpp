@@ -0,0 +1,100 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+typedef svector::Vector<3, int> Vec;
+
+// the pairs of elements that thread t pushes apart
+std::size_t first(const std::size_t t, const std::size_t k,
+                  const std::size_t size) {
+  return (t * 7919 + k * 104729) % size;
+}
+
+std::size_t second(const std::size_t t, const std::size_t k,
+                   const std::size_t size) {
+  return (t * 31 + k * 7) % size;
+}
+
+Vec force(const std::size_t t, const std::size_t k) {
+  return Vec{static_cast<int>(k % 5), static_cast<int>(t), 1};
+}
+
+// adds the same forces once serially and once from threads; integer
+// components make both sums exact
+void checkMatchesSerial(const std::size_t size, const std::size_t pairs,
+                        const double denseFraction) {
+  const std::size_t threads = 4;
+  std::vector<Vec> expected(size, Vec{1, 1, 1});
+  for (std::size_t t = 0; t < threads; t++) {
+    for (std::size_t k = 0; k < pairs; k++) {
+      expected[first(t, k, size)] += force(t, k);
+      expected[second(t, k, size)] -= force(t, k);
+    }
+  }
+
+  svector::ScatterAccumulator<3, int> accumulator(size, threads,
+                                                  denseFraction);
+  std::vector<std::thread> pool;
+  for (std::size_t t = 0; t < threads; t++) {
+    pool.emplace_back([&accumulator, t, pairs, size]() {
+      for (std::size_t k = 0; k < pairs; k++) {
+        accumulator.add(t, first(t, k, size), force(t, k));
+        accumulator.add(t, second(t, k, size), -force(t, k));
+      }
+    });
+  }
+  for (std::thread &thread : pool) {
+    thread.join();
+  }
+
+  std::vector<Vec> out(size, Vec{1, 1, 1});
+  accumulator.reduce(out.data(), 3);
+  EXPECT_EQ(out, expected);
+}
+} // namespace
+
+TEST(ScatterTest, SparseMatchesSerial) {
+  checkMatchesSerial(1000, 20, 0.125);
+}
+
+TEST(ScatterTest, DenseMatchesSerial) {
+  checkMatchesSerial(20000, 4000, 0.125);
+}
+
+TEST(ScatterTest, BecomesDenseAndEmpties) {
+  svector::ScatterAccumulator<3, int> accumulator(16, 2, 0.25);
+  EXPECT_EQ(accumulator.size(), 16);
+  EXPECT_EQ(accumulator.numThreads(), 2);
+
+  // 4 updates stay sparse; the fifth makes the buffer dense
+  for (std::size_t i = 0; i < 4; i++) {
+    accumulator.add(0, i, Vec{1, 2, 3});
+  }
+  EXPECT_FALSE(accumulator.isDense(0));
+  accumulator.add(0, 0, Vec{1, 2, 3});
+  EXPECT_TRUE(accumulator.isDense(0));
+  EXPECT_FALSE(accumulator.isDense(1));
+  accumulator.add(1, 15, Vec{0, 0, 1});
+
+  std::vector<Vec> out(16);
+  accumulator.reduce(out.data(), 8);
+  EXPECT_EQ(out[0], (Vec{2, 4, 6}));
+  EXPECT_EQ(out[3], (Vec{1, 2, 3}));
+  EXPECT_EQ(out[4], (Vec{0, 0, 0}));
+  EXPECT_EQ(out[15], (Vec{0, 0, 1}));
+
+  // the buffers are empty after a reduction, and stay dense
+  std::vector<Vec> again(16);
+  accumulator.reduce(again.data());
+  EXPECT_EQ(again, std::vector<Vec>(16));
+  EXPECT_TRUE(accumulator.isDense(0));
+
+  svector::ScatterAccumulator<3, int> dense(16, 0, 0);
+  EXPECT_EQ(dense.numThreads(), 1);
+  EXPECT_TRUE(dense.isDense(0));
+}
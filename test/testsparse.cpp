@@ -0,0 +1,128 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+TEST(SparseVectorTest, Constructors) {
+  const svector::SparseVector<> empty(10);
+  EXPECT_EQ(empty.size(), 10);
+  EXPECT_EQ(empty.nonZeros(), 0);
+
+  const svector::SparseVector<> vec(10, {1, 5}, {2, 3});
+  EXPECT_EQ(vec.get(1), 2);
+  EXPECT_EQ(vec.get(2), 0);
+  EXPECT_EQ(vec.get(5), 3);
+  EXPECT_THROW(vec.get(10), std::out_of_range);
+
+  EXPECT_THROW(svector::SparseVector<>(10, {5, 1}, {2, 3}),
+               std::invalid_argument);
+  EXPECT_THROW(svector::SparseVector<>(10, {1, 10}, {2, 3}),
+               std::invalid_argument);
+  EXPECT_THROW(svector::SparseVector<>(10, {1}, {2, 3}), std::invalid_argument);
+
+  // every index must fit in 32 bits
+  const std::size_t maxSize =
+      static_cast<std::size_t>(
+          std::numeric_limits<svector::SparseVector<>::index_type>::max()) +
+      1;
+  if (maxSize != 0) {
+    svector::SparseVector<> widest(maxSize);
+    widest.set(maxSize - 1, 1);
+    EXPECT_EQ(widest.get(maxSize - 1), 1);
+    EXPECT_THROW(svector::SparseVector<>(maxSize + 1), std::invalid_argument);
+    EXPECT_THROW(svector::SparseVector<>(maxSize + 1, {}, {}),
+                 std::invalid_argument);
+  }
+}
+
+TEST(SparseVectorTest, DenseConversion) {
+  const svector::Vector<5> dense{0, 1, 0, 0, 2};
+  const svector::SparseVector<> sparse(dense);
+  EXPECT_EQ(sparse.nonZeros(), 2);
+  EXPECT_EQ(sparse.indices()[1], 4);
+
+  EXPECT_EQ(sparse.toVector<5>(), dense);
+  EXPECT_THROW(sparse.toVector<4>(), std::invalid_argument);
+
+  double out[5] = {9, 9, 9, 9, 9};
+  sparse.toDense(out);
+  EXPECT_EQ(out[0], 0);
+  EXPECT_EQ(out[4], 2);
+}
+
+TEST(SparseVectorTest, SetAndAppend) {
+  svector::SparseVector<float> vec(100);
+  vec.append(3, 1);
+  vec.append(50, 2);
+  EXPECT_THROW(vec.append(50, 2), std::invalid_argument);
+
+  vec.set(10, 5);
+  vec.set(3, 0);
+  vec.set(50, 4);
+  EXPECT_EQ(vec.nonZeros(), 2);
+  EXPECT_EQ(vec.indices()[0], 10);
+  EXPECT_EQ(vec.get(50), 4);
+}
+
+TEST(SparseVectorTest, Dot) {
+  // unbalanced, so the larger vector is searched with galloping
+  svector::SparseVector<> large(1000);
+  std::vector<double> dense(1000, 0);
+  for (std::size_t i = 0; i < 1000; i += 2) {
+    large.append(i, static_cast<double>(i));
+    dense[i] = static_cast<double>(i);
+  }
+  const svector::SparseVector<> small(1000, {0, 3, 500, 998, 999},
+                                      {1, 1, 2, 1, 1});
+  EXPECT_EQ(svector::dot(small, large), 1998);
+  EXPECT_EQ(svector::dot(large, small), 1998);
+  EXPECT_EQ(small.dot(dense.data()), 1998);
+
+  // balanced, so both are walked side by side
+  const svector::SparseVector<> other(1000, {2, 3, 4}, {1, 1, 1});
+  const svector::SparseVector<> balanced(1000, {1, 2, 4}, {1, 2, 3});
+  EXPECT_EQ(svector::dot(other, balanced), 5);
+
+  const svector::Vector<3> vec{1, 2, 3};
+  const svector::SparseVector<> sparse3(3, {0, 2}, {2, 2});
+  EXPECT_EQ(svector::dot(sparse3, vec), 8);
+  EXPECT_EQ(svector::dot(vec, sparse3), 8);
+
+  EXPECT_THROW(svector::dot(small, sparse3), std::invalid_argument);
+}
+
+TEST(SparseVectorTest, Operations) {
+  const svector::SparseVector<> lhs(10, {1, 4}, {3, 4});
+  const svector::SparseVector<> rhs(10, {4, 7}, {1, 2});
+
+  EXPECT_EQ(svector::magn(lhs), 5);
+  EXPECT_EQ(svector::normalize(lhs).get(1), 0.6);
+  EXPECT_FALSE(svector::isZero(lhs));
+
+  const svector::SparseVector<> sum = lhs + rhs;
+  EXPECT_EQ(sum.nonZeros(), 3);
+  EXPECT_EQ(sum.get(4), 5);
+  EXPECT_EQ(sum.get(7), 2);
+
+  const svector::SparseVector<> difference = lhs - rhs;
+  EXPECT_EQ(difference.get(4), 3);
+  EXPECT_EQ(difference.get(7), -2);
+
+  EXPECT_EQ((lhs * 2).get(1), 6);
+  EXPECT_EQ((lhs / 2).get(4), 2);
+  EXPECT_EQ((-lhs).get(1), -3);
+
+  // a stored zero equals a missing component
+  EXPECT_EQ(lhs - lhs, svector::SparseVector<>(10));
+  EXPECT_NE(lhs, rhs);
+
+  const svector::Vector<3> dense{1, 1, 1};
+  const svector::Vector<3> denseSum =
+      dense + svector::SparseVector<>(3, {1}, {2});
+  EXPECT_EQ(denseSum, (svector::Vector<3>{1, 3, 1}));
+}
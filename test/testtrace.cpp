@@ -0,0 +1,126 @@
+#include "simplevectors/vectors.hpp"
+
+#include <gtest/gtest.h>
+
+#include <iterator>
+#include <regex>
+#include <string>
+#include <thread>
+
+using namespace svector;
+
+namespace {
+std::size_t countMatches(const std::string &str, const std::regex &re) {
+  return static_cast<std::size_t>(
+      std::distance(std::sregex_iterator(str.begin(), str.end(), re),
+                    std::sregex_iterator()));
+}
+} // namespace
+
+TEST(TraceTest, Empty) {
+  trace::clear();
+  EXPECT_EQ(trace::toChromeJSON(), "{\"traceEvents\": []}\n");
+}
+
+TEST(TraceTest, NestedSpans) {
+  trace::clear();
+
+  {
+    SVECTOR_TRACE_SCOPE("outer");
+    SVECTOR_TRACE_SCOPE("inner");
+  }
+
+  const std::string json = trace::toChromeJSON();
+  const std::regex outer(
+      R"(\{"name": "outer", "cat": "svector", "ph": "X", "ts": \d+\.\d{3}, )"
+      R"("dur": \d+\.\d{3}, "pid": 1, "tid": \d+\})");
+  EXPECT_EQ(countMatches(json, outer), 1);
+  EXPECT_EQ(countMatches(json, std::regex(R"("name": "inner")")), 1);
+
+  // inner ends first, so it is recorded first
+  EXPECT_LT(json.find("inner"), json.find("outer"));
+}
+
+TEST(TraceTest, BatchItems) {
+  trace::clear();
+
+  {
+    SVECTOR_TRACE_BATCH("transform", 100);
+  }
+  {
+    SVECTOR_INSTRUMENT_BATCH("scale", 3, double, 7);
+  }
+
+  const std::string json = trace::toChromeJSON();
+  EXPECT_EQ(countMatches(json, std::regex(R"("name": "transform".*"args": )"
+                                          R"(\{"items": 100\})")),
+            1);
+  EXPECT_EQ(countMatches(json, std::regex(R"("name": "scale".*"args": )"
+                                          R"(\{"items": 7\})")),
+            1);
+}
+
+TEST(TraceTest, Threads) {
+  trace::clear();
+
+  std::thread worker([] {
+    trace::setThreadName("worker");
+    SVECTOR_TRACE_SCOPE("work");
+  });
+  worker.join();
+
+  {
+    SVECTOR_TRACE_SCOPE("main");
+  }
+
+  // the worker has exited, but its spans are kept
+  const std::string json = trace::toChromeJSON();
+  std::smatch work;
+  std::smatch name;
+  std::smatch main;
+  ASSERT_TRUE(std::regex_search(
+      json, work, std::regex(R"("name": "work".*"tid": (\d+))")));
+  ASSERT_TRUE(std::regex_search(
+      json, name,
+      std::regex(R"("name": "thread_name", "ph": "M", "pid": 1, )"
+                 R"("tid": (\d+), "args": \{"name": "worker"\})")));
+  ASSERT_TRUE(std::regex_search(
+      json, main, std::regex(R"("name": "main".*"tid": (\d+))")));
+  EXPECT_EQ(work[1], name[1]);
+  EXPECT_NE(work[1], main[1]);
+}
+
+TEST(TraceTest, Escape) {
+  trace::clear();
+
+  {
+    SVECTOR_TRACE_SCOPE("a\"b\\c\nd\te\x01");
+  }
+
+  EXPECT_NE(trace::toChromeJSON().find(R"("name": "a\"b\\c\nd\te\u0001")"),
+            std::string::npos);
+}
+
+TEST(TraceTest, Disabled) {
+  trace::clear();
+
+  trace::setEnabled(false);
+  {
+    SVECTOR_TRACE_SCOPE("ignored");
+  }
+  trace::setEnabled(true);
+
+  EXPECT_EQ(trace::toChromeJSON().find("ignored"), std::string::npos);
+}
+
+TEST(TraceTest, Dropped) {
+  trace::clear();
+
+  for (int i = 0; i < SVECTOR_TRACE_BUFFER_SIZE + 5; i++) {
+    SVECTOR_TRACE_SCOPE("span");
+  }
+
+  EXPECT_EQ(trace::dropped(), 5);
+  trace::clear();
+  EXPECT_EQ(trace::dropped(), 0);
+}
@@ -0,0 +1,137 @@
+#include "simplevectors/vectors.hpp"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace {
+template <typename T>
+std::vector<svector::Vector<3, T>> trajectory(const std::size_t count) {
+  std::vector<svector::Vector<3, T>> points(count);
+  for (std::size_t i = 0; i < count; i++) {
+    const T t = static_cast<T>(i) * static_cast<T>(0.01);
+    points[i][0] = std::cos(t) * 50;
+    points[i][1] = std::sin(t) * 50;
+    points[i][2] = t * 3 - 1;
+  }
+
+  return points;
+}
+
+template <typename T>
+void expectSameBits(const svector::Vector<3, T> &lhs,
+                    const svector::Vector<3, T> &rhs) {
+  EXPECT_EQ(std::memcmp(&lhs[0], &rhs[0], sizeof(T)), 0);
+  EXPECT_EQ(std::memcmp(&lhs[1], &rhs[1], sizeof(T)), 0);
+  EXPECT_EQ(std::memcmp(&lhs[2], &rhs[2], sizeof(T)), 0);
+}
+} // namespace
+
+TEST(TrajectoryTest, Lossless) {
+  const std::vector<svector::Vector<3, float>> points =
+      trajectory<float>(250);
+  for (const svector::TrajectoryPredictor predictor :
+       {svector::PREDICT_PREVIOUS, svector::PREDICT_LINEAR}) {
+    const svector::CompressedTrajectory<3, float> compressed(
+        points.data(), points.size(), predictor, 100);
+    EXPECT_EQ(compressed.size(), 250);
+    EXPECT_EQ(compressed.numChunks(), 3);
+    EXPECT_EQ(compressed.chunkLength(2), 50);
+
+    std::vector<svector::Vector<3, float>> decoded(points.size());
+    compressed.decode(decoded.data());
+    for (std::size_t i = 0; i < points.size(); i++) {
+      expectSameBits(decoded[i], points[i]);
+    }
+  }
+
+  // a smooth trajectory compresses well, and better with extrapolation
+  const svector::CompressedTrajectory<3, float> previous(
+      points.data(), points.size(), svector::PREDICT_PREVIOUS);
+  const svector::CompressedTrajectory<3, float> linear(points.data(),
+                                                       points.size());
+  EXPECT_LT(previous.encodedSize(), points.size() * 3 * sizeof(float));
+  EXPECT_LT(linear.encodedSize(), previous.encodedSize());
+}
+
+TEST(TrajectoryTest, SpecialValues) {
+  std::vector<svector::Vector<3, double>> points = trajectory<double>(20);
+  points[3][0] = std::numeric_limits<double>::infinity();
+  points[4][0] = -std::numeric_limits<double>::infinity();
+  points[5][1] = std::numeric_limits<double>::quiet_NaN();
+  points[6][1] = -0.0;
+  points[7][1] = std::numeric_limits<double>::denorm_min();
+  points[8][1] = -std::numeric_limits<double>::max();
+
+  const svector::CompressedTrajectory<3> compressed(points.data(),
+                                                    points.size());
+  std::vector<svector::Vector<3, double>> decoded(points.size());
+  compressed.decode(decoded.data());
+  for (std::size_t i = 0; i < points.size(); i++) {
+    expectSameBits(decoded[i], points[i]);
+  }
+}
+
+TEST(TrajectoryTest, RandomAccessByChunk) {
+  const std::vector<svector::Vector<3, double>> points =
+      trajectory<double>(250);
+  const svector::CompressedTrajectory<3> compressed(
+      points.data(), points.size(), svector::PREDICT_LINEAR, 64);
+
+  std::vector<svector::Vector<3, double>> chunk(64);
+  compressed.decodeChunk(3, chunk.data());
+  for (std::size_t k = 0; k < compressed.chunkLength(3); k++) {
+    expectSameBits(chunk[k], points[192 + k]);
+  }
+
+  EXPECT_THROW(compressed.decodeChunk(4, chunk.data()), std::out_of_range);
+  EXPECT_THROW(svector::CompressedTrajectory<3>(svector::PREDICT_LINEAR, 0),
+               std::invalid_argument);
+}
+
+TEST(TrajectoryTest, Streaming) {
+  const std::vector<svector::Vector<3, double>> points =
+      trajectory<double>(250);
+  const svector::CompressedTrajectory<3> batch(
+      points.data(), points.size(), svector::PREDICT_LINEAR, 100);
+
+  // pushing one at a time, and continuing after loading, give the same data
+  svector::CompressedTrajectory<3> streamed(svector::PREDICT_LINEAR, 100);
+  for (std::size_t i = 0; i < 120; i++) {
+    streamed.push(points[i]);
+  }
+
+  const std::vector<std::uint8_t> partial = streamed.toBytes();
+  svector::CompressedTrajectory<3> loaded =
+      svector::CompressedTrajectory<3>::fromBytes(partial.data(),
+                                                  partial.size());
+  for (std::size_t i = 120; i < points.size(); i++) {
+    loaded.push(points[i]);
+  }
+  EXPECT_EQ(loaded.toBytes(), batch.toBytes());
+}
+
+TEST(TrajectoryTest, CorruptBytes) {
+  const std::vector<svector::Vector<3, double>> points = trajectory<double>(50);
+  const svector::CompressedTrajectory<3> compressed(points.data(),
+                                                    points.size());
+  std::vector<std::uint8_t> bytes = compressed.toBytes();
+
+  // wrong type, truncated data, and an unfinished varint
+  EXPECT_THROW((svector::CompressedTrajectory<3, float>::fromBytes(
+                   bytes.data(), bytes.size())),
+               std::invalid_argument);
+  EXPECT_THROW(svector::CompressedTrajectory<3>::fromBytes(bytes.data(),
+                                                           bytes.size() - 1),
+               std::invalid_argument);
+  bytes.back() |= 0x80;
+  EXPECT_THROW(
+      svector::CompressedTrajectory<3>::fromBytes(bytes.data(), bytes.size()),
+      std::invalid_argument);
+}
@@ -0,0 +1,161 @@
+#include "simplevectors/vectors.hpp"
+
+#include <array>
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#include <gtest/gtest.h>
+
+TEST(ViewTest, ViewsBuffer) {
+  std::array<double, 6> buffer{{1, 2, 3, 4, 5, 6}};
+  svector::VectorView<3> view(buffer.data() + 3);
+
+  EXPECT_EQ(view.numDimensions(), 3);
+  EXPECT_EQ(view[0], 4);
+  EXPECT_EQ(view[2], 6);
+  EXPECT_EQ(view.at(1), 5);
+  EXPECT_THROW(view.at(3), std::out_of_range);
+
+  view[1] = 10;
+  EXPECT_EQ(buffer[4], 10);
+}
+
+TEST(ViewTest, Stride) {
+  // x-components, then y-components
+  std::array<float, 6> buffer{{1, 2, 3, 4, 5, 6}};
+  svector::VectorView<2, float> view =
+      svector::makeView<2>(buffer.data() + 1, 3);
+
+  EXPECT_EQ(view.stride(), 3);
+  EXPECT_EQ(view[0], 2);
+  EXPECT_EQ(view[1], 5);
+
+  const svector::Vector<2, float> control{2, 5};
+  EXPECT_EQ(view.toVector(), control);
+  EXPECT_EQ(svector::makeVector(view), control);
+}
+
+TEST(ViewTest, ReadOnly) {
+  const std::array<double, 3> buffer{{3, 4, 0}};
+  svector::VectorView<3, const double> view(buffer.data());
+  EXPECT_EQ(svector::magn(view), 5);
+
+  double mutableBuffer[3] = {1, 2, 3};
+  svector::VectorView<3> mutableView(mutableBuffer);
+  const svector::VectorView<3, const double> converted = mutableView;
+  EXPECT_EQ(converted.data(), mutableBuffer);
+}
+
+TEST(ViewTest, ViewOfVector) {
+  svector::Vector3D vec{1, 2, 3};
+  svector::VectorView<3> view = vec;
+  view[0] = 7;
+  EXPECT_EQ(vec[0], 7);
+
+  const svector::Vector3D constVec{1, 2, 3};
+  const svector::VectorView<3, const double> constView = constVec;
+  EXPECT_EQ(constView[2], 3);
+}
+
+TEST(ViewTest, AssignmentWritesThrough) {
+  double buffer[6] = {1, 2, 3, 4, 5, 6};
+  svector::VectorView<3> first(buffer);
+  svector::VectorView<3> second(buffer + 3);
+
+  first = second;
+  EXPECT_EQ(buffer[0], 4);
+  EXPECT_EQ(first.data(), buffer);
+
+  first = svector::Vector3D{7, 8, 9};
+  EXPECT_EQ(buffer[2], 9);
+
+  first += second;
+  EXPECT_EQ(buffer[0], 11);
+  first -= svector::Vector3D{1, 1, 1};
+  EXPECT_EQ(buffer[0], 10);
+  first *= 2;
+  EXPECT_EQ(buffer[1], 24);
+  first /= 4;
+  EXPECT_EQ(buffer[1], 6);
+}
+
+TEST(ViewTest, Operators) {
+  double buffer[4] = {1, 2, 3, 4};
+  const svector::VectorView<2> lhs(buffer);
+  const svector::VectorView<2, const double> rhs(buffer + 2);
+  const svector::Vector2D vec{1, 1};
+
+  EXPECT_EQ(lhs + rhs, (svector::Vector2D{4, 6}));
+  EXPECT_EQ(lhs - rhs, (svector::Vector2D{-2, -2}));
+  EXPECT_EQ(vec + lhs, (svector::Vector2D{2, 3}));
+  EXPECT_EQ(lhs - vec, (svector::Vector2D{0, 1}));
+  EXPECT_EQ(lhs * 2, (svector::Vector2D{2, 4}));
+  EXPECT_EQ(rhs / 2, (svector::Vector2D{1.5, 2}));
+  EXPECT_EQ(-lhs, (svector::Vector2D{-1, -2}));
+  EXPECT_EQ(+lhs, (svector::Vector2D{1, 2}));
+
+  EXPECT_TRUE(lhs == (svector::Vector2D{1, 2}));
+  EXPECT_TRUE(lhs != rhs);
+  EXPECT_TRUE(vec != lhs);
+}
+
+TEST(ViewTest, Functions2D) {
+  double buffer[2] = {3, 4};
+  const svector::VectorView<2> view(buffer);
+
+  EXPECT_EQ(svector::x(view), 3);
+  EXPECT_EQ(svector::y(view), 4);
+  EXPECT_EQ(svector::dot(view, view), 25);
+  EXPECT_EQ(svector::dot(svector::Vector2D{1, 1}, view), 7);
+  EXPECT_EQ(svector::normalize(view), (svector::Vector2D{0.6, 0.8}));
+  EXPECT_FALSE(svector::isZero(view));
+  EXPECT_DOUBLE_EQ(svector::angle(view), std::atan2(4, 3));
+
+  const svector::Vector2D rotated = svector::rotate(view, M_PI / 2);
+  EXPECT_NEAR(rotated[0], -4, 1e-9);
+  EXPECT_NEAR(rotated[1], 3, 1e-9);
+  // the result is a 2D vector, with its accessors
+  EXPECT_NEAR(svector::rotate(view, M_PI / 2).x(), -4, 1e-9);
+
+  svector::x(view, 1);
+  svector::y(view, 2);
+  EXPECT_EQ(buffer[0], 1);
+  EXPECT_EQ(buffer[1], 2);
+}
+
+TEST(ViewTest, Functions3D) {
+  // two 3D vectors stored component by component
+  float buffer[6] = {1, 0, 0, 1, 0, 0};
+  const svector::VectorView<3, float> lhs(buffer, 2);
+  const svector::VectorView<3, float> rhs(buffer + 1, 2);
+
+  const svector::Vector<3, float> crossed = svector::cross(lhs, rhs);
+  EXPECT_EQ(crossed, (svector::Vector<3, float>{0, 0, 1}));
+  EXPECT_EQ(svector::cross(lhs, rhs).z(), 1);
+  EXPECT_EQ(svector::z(lhs), 0);
+
+  const svector::Vector3D vec{0, 0, 1};
+  double buffer3D[3] = {1, 0, 0};
+  const svector::VectorView<3> view(buffer3D);
+  EXPECT_EQ(svector::cross(vec, view), (svector::Vector3D{0, 1, 0}));
+  EXPECT_EQ(svector::cross(view, vec), (svector::Vector3D{0, -1, 0}));
+  EXPECT_DOUBLE_EQ(svector::alpha(view), 0);
+  EXPECT_DOUBLE_EQ(svector::beta(view), M_PI / 2);
+  EXPECT_DOUBLE_EQ(svector::gamma(view), M_PI / 2);
+
+  const svector::Vector3D aroundZ = svector::rotateGamma(view, M_PI / 2);
+  EXPECT_NEAR(aroundZ[0], 0, 1e-9);
+  EXPECT_NEAR(aroundZ[1], 1, 1e-9);
+  EXPECT_NEAR(svector::rotateGamma(view, M_PI / 2).y(), 1, 1e-9);
+  const svector::Vector3D aroundY = svector::rotateBeta(view, M_PI / 2);
+  EXPECT_NEAR(aroundY[2], -1, 1e-9);
+  EXPECT_EQ(svector::rotateAlpha(view, M_PI / 2), (svector::Vector3D{1, 0, 0}));
+
+  svector::z(view, 5);
+  EXPECT_EQ(buffer3D[2], 5);
+}